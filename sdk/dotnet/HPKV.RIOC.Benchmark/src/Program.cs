@@ -41,6 +41,9 @@ class Options
 
     [Option('v', "verify", Default = false, HelpText = "Verify values")]
     public bool VerifyValues { get; set; }
+
+    [Option('w', "workload", Default = "", HelpText = "Run a workload file from bench/workloads instead of the fixed phases")]
+    public string WorkloadPath { get; set; } = "";
 }
 
 class ThreadStats
@@ -74,7 +77,17 @@ class Program
     static void Main(string[] args)
     {
         Parser.Default.ParseArguments<Options>(args)
-            .WithParsed(RunBenchmark);
+            .WithParsed(options =>
+            {
+                if (!string.IsNullOrEmpty(options.WorkloadPath))
+                {
+                    Environment.ExitCode = WorkloadRunner.Run(options);
+                }
+                else
+                {
+                    RunBenchmark(options);
+                }
+            });
     }
 
     static void RunBenchmark(Options options)
@@ -213,7 +226,8 @@ class Program
 
                     // Measure only the batch execute time
                     var batchStartTime = DateTime.UtcNow;
-                    batch.ExecuteAsync().Wait();
+                    using var tracker = batch.ExecuteAsync();
+                    tracker.Wait();
                     var latency = (DateTime.UtcNow - batchStartTime).TotalMicroseconds / count;
 
                     if (options.VerifyValues)
@@ -489,7 +503,8 @@ class Program
                                 {
                                     // Measure only the batch execute time
                                     var batchStartTime = DateTime.UtcNow;
-                                    batch.ExecuteAsync().Wait();
+                                    using var tracker = batch.ExecuteAsync();
+                                    tracker.Wait();
                                     var latency = (DateTime.UtcNow - batchStartTime).TotalMicroseconds / queriesInBatch;
                                     
                                     // Process results (not timed)
@@ -0,0 +1,362 @@
+using System.Diagnostics;
+using System.Text;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+
+namespace HPKV.RIOC.TestApps.Benchmark;
+
+/// <summary>
+/// A workload file from bench/workloads. Every SDK runner and rioc_bench read the same format.
+/// </summary>
+class WorkloadSpec
+{
+    public static readonly string[] OpNames = { "get", "insert", "delete", "range_query", "atomic_inc_dec" };
+
+    [JsonPropertyName("name")] public string Name { get; set; } = "unnamed";
+    [JsonPropertyName("description")] public string? Description { get; set; }
+    [JsonPropertyName("threads")] public int Threads { get; set; } = 1;
+    [JsonPropertyName("ops_per_thread")] public int OpsPerThread { get; set; } = 10000;
+    [JsonPropertyName("warmup_ops")] public int WarmupOps { get; set; }
+    [JsonPropertyName("batch_size")] public int BatchSize { get; set; } = 1;
+    [JsonPropertyName("key_count")] public int KeyCount { get; set; } = 1000;
+    [JsonPropertyName("key_distribution")] public string KeyDistribution { get; set; } = "uniform";
+    [JsonPropertyName("value_size")] public int ValueSize { get; set; } = 100;
+    [JsonPropertyName("range_rows")] public int RangeRows { get; set; } = 10;
+    [JsonPropertyName("seed")] public int Seed { get; set; } = 1;
+    [JsonPropertyName("get")] public int Get { get; set; }
+    [JsonPropertyName("insert")] public int Insert { get; set; }
+    [JsonPropertyName("delete")] public int Delete { get; set; }
+    [JsonPropertyName("range_query")] public int RangeQuery { get; set; }
+    [JsonPropertyName("atomic_inc_dec")] public int AtomicIncDec { get; set; }
+
+    public int[] Weights => new[] { Get, Insert, Delete, RangeQuery, AtomicIncDec };
+
+    public static WorkloadSpec Load(string path)
+    {
+        var options = new JsonSerializerOptions { UnmappedMemberHandling = JsonUnmappedMemberHandling.Disallow };
+        var spec = JsonSerializer.Deserialize<WorkloadSpec>(File.ReadAllText(path), options)
+            ?? throw new InvalidDataException($"Empty workload file: {path}");
+
+        if (spec.Weights.Sum() <= 0)
+            throw new InvalidDataException("Workload mix must give at least one operation a positive weight");
+        if (spec.KeyDistribution != "uniform" && spec.KeyDistribution != "sequential")
+            throw new InvalidDataException("key_distribution must be uniform or sequential");
+        if (spec.BatchSize < 1 || spec.BatchSize > WorkloadRunner.MaxBatchSize)
+            throw new InvalidDataException($"batch_size must be between 1 and {WorkloadRunner.MaxBatchSize}");
+        return spec;
+    }
+
+    /// <summary>
+    /// Generates the (op type, key index) sequence every runner produces for a thread.
+    /// </summary>
+    public (int Type, uint Key)[] GenerateOps(int threadId)
+    {
+        uint state = unchecked((uint)Seed + 0x9E3779B9u * (uint)(threadId + 1));
+        if (state == 0) state = 1;
+        uint Next()
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        var weights = Weights;
+        var totalWeight = (uint)weights.Sum();
+        var count = WarmupOps + OpsPerThread;
+        var ops = new (int Type, uint Key)[count];
+        for (var i = 0; i < count; i++)
+        {
+            var r = Next() % totalWeight;
+            var type = 0;
+            while (r >= weights[type])
+            {
+                r -= (uint)weights[type];
+                type++;
+            }
+            var key = KeyDistribution == "sequential"
+                ? (uint)(((long)threadId * count + i) % KeyCount)
+                : Next() % (uint)KeyCount;
+            ops[i] = (type, key);
+        }
+        return ops;
+    }
+}
+
+/// <summary>
+/// Executes a workload and prints one result object in the shared schema (bench/README.md),
+/// so the results can be compared with rioc_bench --workload to measure P/Invoke overhead.
+/// </summary>
+static class WorkloadRunner
+{
+    public const int MaxBatchSize = 128;
+
+    class ThreadState
+    {
+        public (int Type, uint Key)[] Ops = Array.Empty<(int, uint)>();
+        public List<double> Latencies { get; } = new();
+        public long[] OpCounts { get; } = new long[WorkloadSpec.OpNames.Length];
+        public long Errors { get; set; }
+        public long EndTicks { get; set; }
+        public bool Failed { get; set; }
+    }
+
+    static byte[] DataKey(uint index) => Encoding.ASCII.GetBytes($"wl:{index:D8}");
+    static byte[] CounterKey(uint index) => Encoding.ASCII.GetBytes($"wl:ctr:{index:D8}");
+    static uint RangeEnd(WorkloadSpec spec, uint start) => Math.Min(start + (uint)spec.RangeRows - 1, (uint)spec.KeyCount - 1);
+
+    // Executes one operation through the single-op API; returns the number of failed ops
+    static int ExecuteSingle(RiocClient client, WorkloadSpec spec, (int Type, uint Key) op, byte[] value)
+    {
+        try
+        {
+            switch (op.Type)
+            {
+                case 0:
+                    client.Get(DataKey(op.Key));
+                    break;
+                case 1:
+                    client.Insert(DataKey(op.Key), value, RiocClient.GetTimestamp());
+                    break;
+                case 2:
+                    client.Delete(DataKey(op.Key), RiocClient.GetTimestamp());
+                    break;
+                case 3:
+                    client.RangeQuery(DataKey(op.Key), DataKey(RangeEnd(spec, op.Key)));
+                    break;
+                default:
+                    client.AtomicIncDec(CounterKey(op.Key), 1, RiocClient.GetTimestamp());
+                    break;
+            }
+            return 0;
+        }
+        catch (RiocKeyNotFoundException)
+        {
+            return 0;
+        }
+        catch (RiocException)
+        {
+            return 1;
+        }
+    }
+
+    // Executes ops as one batch and materializes every result; returns the number of failed ops
+    static int ExecuteBatch(RiocClient client, WorkloadSpec spec, ArraySegment<(int Type, uint Key)> ops, byte[] value)
+    {
+        try
+        {
+            using var batch = client.CreateBatch();
+            foreach (var op in ops)
+            {
+                switch (op.Type)
+                {
+                    case 0:
+                        batch.AddGet(DataKey(op.Key));
+                        break;
+                    case 1:
+                        batch.AddInsert(DataKey(op.Key), value, RiocClient.GetTimestamp());
+                        break;
+                    case 2:
+                        batch.AddDelete(DataKey(op.Key), RiocClient.GetTimestamp());
+                        break;
+                    case 3:
+                        batch.AddRangeQuery(DataKey(op.Key), DataKey(RangeEnd(spec, op.Key)));
+                        break;
+                    default:
+                        batch.AddAtomicIncDec(CounterKey(op.Key), 1, RiocClient.GetTimestamp());
+                        break;
+                }
+            }
+
+            using var tracker = batch.ExecuteAsync();
+            tracker.Wait();
+            var errors = 0;
+            for (var i = 0; i < ops.Count; i++)
+            {
+                try
+                {
+                    switch (ops[i].Type)
+                    {
+                        case 3:
+                            tracker.GetRangeQueryResponse((nuint)i);
+                            break;
+                        case 4:
+                            tracker.GetAtomicResult((nuint)i);
+                            break;
+                        default:
+                            tracker.GetResponse((nuint)i);
+                            break;
+                    }
+                }
+                catch (RiocKeyNotFoundException)
+                {
+                }
+                catch (RiocException)
+                {
+                    errors++;
+                }
+            }
+            return errors;
+        }
+        catch (RiocException)
+        {
+            return ops.Count;
+        }
+    }
+
+    static void RunOps(RiocClient client, WorkloadSpec spec, ThreadState state, int offset, int count, byte[] value, bool record)
+    {
+        for (var i = 0; i < count; i += spec.BatchSize)
+        {
+            var chunk = new ArraySegment<(int Type, uint Key)>(state.Ops, offset + i, Math.Min(spec.BatchSize, count - i));
+            var start = Stopwatch.GetTimestamp();
+            var errors = spec.BatchSize == 1
+                ? ExecuteSingle(client, spec, chunk[0], value)
+                : ExecuteBatch(client, spec, chunk, value);
+            var elapsed = Stopwatch.GetElapsedTime(start);
+            if (record)
+            {
+                state.Latencies.Add(elapsed.TotalMicroseconds);
+                state.Errors += errors;
+                foreach (var op in chunk)
+                {
+                    state.OpCounts[op.Type]++;
+                }
+            }
+        }
+    }
+
+    // Preloads the data keys, or deletes them and the counters after the run
+    static void PrepareKeys(RiocClient client, WorkloadSpec spec, byte[] value, bool remove)
+    {
+        var keySets = remove ? new Func<uint, byte[]>[] { DataKey, CounterKey } : new Func<uint, byte[]>[] { DataKey };
+        foreach (var makeKey in keySets)
+        {
+            for (var start = 0; start < spec.KeyCount; start += MaxBatchSize)
+            {
+                using var batch = client.CreateBatch();
+                for (var i = start; i < Math.Min(start + MaxBatchSize, spec.KeyCount); i++)
+                {
+                    if (remove)
+                        batch.AddDelete(makeKey((uint)i), RiocClient.GetTimestamp());
+                    else
+                        batch.AddInsert(makeKey((uint)i), value, RiocClient.GetTimestamp());
+                }
+                using var tracker = batch.ExecuteAsync();
+                tracker.Wait();
+            }
+        }
+    }
+
+    public static int Run(Options options)
+    {
+        var spec = WorkloadSpec.Load(options.WorkloadPath);
+        var config = new RiocConfig
+        {
+            Host = options.Host,
+            Port = options.Port,
+            TimeoutMs = 5000,
+            Tls = options.UseTls ? new RiocTlsConfig
+            {
+                CaPath = options.CaPath,
+                CertificatePath = options.ClientCertPath,
+                KeyPath = options.ClientKeyPath,
+                VerifyHostname = options.Host,
+                VerifyPeer = !string.IsNullOrEmpty(options.CaPath)
+            } : null
+        };
+
+        Console.Error.WriteLine($"Workload {spec.Name}: {spec.Threads} threads x {spec.OpsPerThread} ops, " +
+                                $"batch size {spec.BatchSize}, {spec.KeyCount} keys, {spec.ValueSize} byte values");
+
+        var value = new byte[spec.ValueSize];
+        Array.Fill(value, (byte)'x');
+        using var client = new RiocClient(config);
+        PrepareKeys(client, spec, value, false);
+
+        var states = new ThreadState[spec.Threads];
+        var threads = new Thread[spec.Threads];
+        // The main thread is the last participant, so its release marks the start of the run
+        using var ready = new Barrier(spec.Threads + 1);
+        for (var t = 0; t < spec.Threads; t++)
+        {
+            var state = states[t] = new ThreadState { Ops = spec.GenerateOps(t) };
+            threads[t] = new Thread(() =>
+            {
+                RiocClient? threadClient = null;
+                try
+                {
+                    threadClient = new RiocClient(config);
+                }
+                catch (RiocException ex)
+                {
+                    Console.Error.WriteLine($"Failed to connect: {ex.Message}");
+                    state.Failed = true;
+                }
+
+                if (threadClient != null)
+                    RunOps(threadClient, spec, state, 0, spec.WarmupOps, value, false);
+                ready.SignalAndWait();
+                if (threadClient != null)
+                {
+                    RunOps(threadClient, spec, state, spec.WarmupOps, spec.OpsPerThread, value, true);
+                    state.EndTicks = Stopwatch.GetTimestamp();
+                    threadClient.Dispose();
+                }
+            });
+            threads[t].Start();
+        }
+
+        ready.SignalAndWait();
+        var startTicks = Stopwatch.GetTimestamp();
+        foreach (var thread in threads)
+        {
+            thread.Join();
+        }
+
+        var failed = states.Any(s => s.Failed);
+        if (!failed)
+        {
+            var elapsedSec = (double)(states.Max(s => s.EndTicks) - startTicks) / Stopwatch.Frequency;
+            Console.WriteLine(FormatResult(spec, states, elapsedSec));
+        }
+
+        PrepareKeys(client, spec, value, true);
+        return failed ? 1 : 0;
+    }
+
+    static string FormatResult(WorkloadSpec spec, ThreadState[] states, double elapsedSec)
+    {
+        var latencies = states.SelectMany(s => s.Latencies).OrderBy(l => l).ToList();
+        double Percentile(double q) => latencies[Math.Min((int)Math.Floor(latencies.Count * q), latencies.Count - 1)];
+        var opCounts = Enumerable.Range(0, WorkloadSpec.OpNames.Length).Select(i => states.Sum(s => s.OpCounts[i])).ToArray();
+        var ops = opCounts.Sum();
+
+        var result = new Dictionary<string, object>
+        {
+            ["schema"] = "rioc-bench-result/1",
+            ["runner"] = "dotnet",
+            ["workload"] = spec.Name,
+            ["threads"] = states.Length,
+            ["batch_size"] = spec.BatchSize,
+            ["value_size"] = spec.ValueSize,
+            ["ops"] = ops,
+            ["calls"] = latencies.Count,
+            ["errors"] = states.Sum(s => s.Errors),
+            ["ops_by_type"] = WorkloadSpec.OpNames.Zip(opCounts).ToDictionary(p => p.First, p => p.Second),
+            ["elapsed_sec"] = Math.Round(elapsedSec, 6),
+            ["ops_per_sec"] = Math.Round(elapsedSec > 0 ? ops / elapsedSec : 0, 2),
+            ["latency_us"] = new Dictionary<string, double>
+            {
+                ["min"] = Math.Round(latencies[0], 3),
+                ["avg"] = Math.Round(latencies.Average(), 3),
+                ["p50"] = Math.Round(Percentile(0.50), 3),
+                ["p95"] = Math.Round(Percentile(0.95), 3),
+                ["p99"] = Math.Round(Percentile(0.99), 3),
+                ["p999"] = Math.Round(Percentile(0.999), 3),
+                ["max"] = Math.Round(latencies[^1], 3)
+            }
+        };
+        return JsonSerializer.Serialize(result);
+    }
+}
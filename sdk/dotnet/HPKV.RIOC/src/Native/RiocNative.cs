@@ -94,9 +94,36 @@ internal static unsafe class RiocNative
                                              byte* end_key, nuint end_key_len, 
                                              NativeRangeResult** results, nuint* result_count);
 
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void rioc_value_free(void* value);
+
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void rioc_free_range_results(NativeRangeResult* results, nuint count);
 
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_range_query_columns(void* client, byte* start_key, nuint start_key_len,
+                                                     byte* end_key, nuint end_key_len,
+                                                     NativeRangeColumns* columns);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void rioc_free_range_columns(NativeRangeColumns* columns);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_range_cursor_open(void* client, byte* start_key, nuint start_key_len,
+                                                    byte* end_key, nuint end_key_len, void** cursor);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_range_cursor_next(void* cursor, NativeRangeResult* row);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern nuint rioc_range_cursor_remaining(void* cursor);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void rioc_range_cursor_cancel(void* cursor);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_range_cursor_close(void* cursor);
+
     // Batch operations
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void* rioc_batch_create(void* client);
@@ -117,6 +144,9 @@ internal static unsafe class RiocNative
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern int rioc_batch_add_atomic_inc_dec(void* batch, byte* key, nuint key_len, long increment, ulong timestamp);
 
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_batch_add_packed(void* batch, byte* packed, nuint packed_len);
+
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void* rioc_batch_execute_async(void* batch);
 
@@ -126,12 +156,43 @@ internal static unsafe class RiocNative
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern int rioc_batch_get_response_async(void* tracker, nuint index, byte** value, nuint* value_len);
 
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_batch_get_packed_responses(void* tracker, byte** packed, nuint* packed_len);
+
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void rioc_batch_tracker_free(void* tracker);
 
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void rioc_batch_free(void* batch);
 
+    // Asynchronous operations; callbacks run on the native I/O thread
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void* rioc_async_create(void* client);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void rioc_async_free(void* async);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_async_get(void* async, byte* key, nuint key_len,
+                                            delegate* unmanaged[Cdecl]<void*, int, byte*, nuint, void> callback, void* arg);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_async_insert(void* async, byte* key, nuint key_len, byte* value, nuint value_len, ulong timestamp,
+                                               delegate* unmanaged[Cdecl]<void*, int, byte*, nuint, void> callback, void* arg);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_async_delete(void* async, byte* key, nuint key_len, ulong timestamp,
+                                               delegate* unmanaged[Cdecl]<void*, int, byte*, nuint, void> callback, void* arg);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_async_range_query(void* async, byte* start_key, nuint start_key_len,
+                                                    byte* end_key, nuint end_key_len,
+                                                    delegate* unmanaged[Cdecl]<void*, int, byte*, nuint, void> callback, void* arg);
+
+    [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int rioc_async_atomic_inc_dec(void* async, byte* key, nuint key_len, long increment, ulong timestamp,
+                                                       delegate* unmanaged[Cdecl]<void*, int, byte*, nuint, void> callback, void* arg);
+
     // Platform functions
     [DllImport(WindowsLibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern ulong rioc_get_timestamp_ns();
@@ -153,6 +214,8 @@ internal unsafe struct NativeClientConfig
     public uint port;
     public uint timeout_ms;
     public NativeTlsConfig* tls;
+    public uint flags;
+    public int cpu;
 }
 
 [StructLayout(LayoutKind.Sequential)]
@@ -173,4 +236,34 @@ internal unsafe struct NativeRangeResult
     public nuint key_len;
     public byte* value;
     public nuint value_len;
-} 
\ No newline at end of file
+} 
+
+// Columnar range query rows (struct rioc_range_columns)
+[StructLayout(LayoutKind.Sequential)]
+internal unsafe struct NativeRangeColumns
+{
+    public nuint count;
+    public long* key_offsets;
+    public byte* key_data;
+    public long* value_offsets;
+    public byte* value_data;
+}
+
+// Record header of a packed batch request (struct rioc_op_header)
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativeOpHeader
+{
+    public ushort command;
+    public ushort key_len;
+    public uint value_len;
+    public ulong timestamp;
+}
+
+// Per-op header of a packed batch response (struct rioc_packed_result)
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativePackedResult
+{
+    public int status;
+    public uint count;
+    public ulong data_len;
+}
@@ -0,0 +1,389 @@
+using System.Buffers;
+using System.Collections.Concurrent;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Threading.Tasks.Sources;
+using HPKV.RIOC.Native;
+using Microsoft.Extensions.Logging;
+
+namespace HPKV.RIOC;
+
+/// <summary>
+/// A client whose operations complete asynchronously without blocking a thread per request.
+/// </summary>
+/// <remarks>
+/// Operations are queued to a native I/O thread that sends everything queued while a round trip
+/// is in flight as one batch. Each operation completes a pooled <see cref="IValueTaskSource{TResult}"/>
+/// from the native callback, so awaiting an operation does not allocate a task. Keys and values are
+/// copied when an operation is submitted. The client opens its own connection and is thread-safe,
+/// but must not be disposed while other threads are still submitting operations.
+/// </remarks>
+public sealed unsafe class RiocAsyncClient : IAsyncDisposable, IDisposable
+{
+    private readonly RiocClient _client;
+    private readonly ILogger? _logger;
+    private readonly void* _async;
+    private int _disposed;
+
+    /// <summary>
+    /// Creates a new asynchronous RIOC client.
+    /// </summary>
+    /// <param name="config">The client configuration.</param>
+    /// <param name="logger">Optional logger for client operations.</param>
+    /// <exception cref="RiocException">Thrown when the client fails to initialize.</exception>
+    public RiocAsyncClient(RiocConfig config, ILogger? logger = null)
+    {
+        _logger = logger;
+        _client = new RiocClient(config, logger);
+
+        _async = RiocNative.rioc_async_create(_client.Handle);
+        if (_async == null)
+        {
+            _client.Dispose();
+            _logger?.LogError("Failed to start the asynchronous I/O thread");
+            throw RiocExceptionFactory.Create(-2);
+        }
+    }
+
+    /// <summary>
+    /// Gets the value associated with the specified key.
+    /// </summary>
+    /// <param name="key">The key to get.</param>
+    /// <returns>The value associated with the key.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ValueTask<byte[]> GetAsync(ReadOnlySpan<byte> key)
+    {
+        void* async = Handle;
+        var operation = RiocAsyncOperation<byte[]>.Rent(&RiocAsyncOperation.ToArray);
+        void* arg = operation.Pin();
+        fixed (byte* keyPtr = key)
+        {
+            int result = RiocNative.rioc_async_get(async, keyPtr, (nuint)key.Length, RiocAsyncOperation.Callback, arg);
+            return operation.Submitted(result, arg, _logger);
+        }
+    }
+
+    /// <summary>
+    /// Gets the value associated with the specified key into a buffer writer.
+    /// </summary>
+    /// <param name="key">The key to get.</param>
+    /// <param name="destination">The writer the value is written to before the operation completes.</param>
+    /// <returns>The length of the value.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ValueTask<int> GetAsync(ReadOnlySpan<byte> key, IBufferWriter<byte> destination)
+    {
+        ArgumentNullException.ThrowIfNull(destination);
+
+        void* async = Handle;
+        var operation = RiocAsyncOperation<int>.Rent(&RiocAsyncOperation.ToWriter, destination);
+        void* arg = operation.Pin();
+        fixed (byte* keyPtr = key)
+        {
+            int result = RiocNative.rioc_async_get(async, keyPtr, (nuint)key.Length, RiocAsyncOperation.Callback, arg);
+            return operation.Submitted(result, arg, _logger);
+        }
+    }
+
+    /// <summary>
+    /// Inserts or updates a key-value pair.
+    /// </summary>
+    /// <param name="key">The key to insert or update.</param>
+    /// <param name="value">The value to store.</param>
+    /// <param name="timestamp">The timestamp for the operation.</param>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ValueTask InsertAsync(ReadOnlySpan<byte> key, ReadOnlySpan<byte> value, ulong timestamp)
+    {
+        void* async = Handle;
+        var operation = RiocAsyncOperation<bool>.Rent(&RiocAsyncOperation.ToNone);
+        void* arg = operation.Pin();
+        fixed (byte* keyPtr = key)
+        fixed (byte* valuePtr = value)
+        {
+            int result = RiocNative.rioc_async_insert(async, keyPtr, (nuint)key.Length, valuePtr, (nuint)value.Length,
+                                                      timestamp, RiocAsyncOperation.Callback, arg);
+            return operation.SubmittedVoid(result, arg, _logger);
+        }
+    }
+
+    /// <summary>
+    /// Deletes the specified key.
+    /// </summary>
+    /// <param name="key">The key to delete.</param>
+    /// <param name="timestamp">The timestamp for the operation.</param>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ValueTask DeleteAsync(ReadOnlySpan<byte> key, ulong timestamp)
+    {
+        void* async = Handle;
+        var operation = RiocAsyncOperation<bool>.Rent(&RiocAsyncOperation.ToNone);
+        void* arg = operation.Pin();
+        fixed (byte* keyPtr = key)
+        {
+            int result = RiocNative.rioc_async_delete(async, keyPtr, (nuint)key.Length, timestamp,
+                                                      RiocAsyncOperation.Callback, arg);
+            return operation.SubmittedVoid(result, arg, _logger);
+        }
+    }
+
+    /// <summary>
+    /// Performs a range query and returns the rows in pooled buffers.
+    /// </summary>
+    /// <param name="startKey">The start key of the range (inclusive).</param>
+    /// <param name="endKey">The end key of the range (inclusive).</param>
+    /// <returns>The rows within the specified range; dispose it to return its buffers to the pool.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ValueTask<RiocRangeResult> RangeQueryAsync(ReadOnlySpan<byte> startKey, ReadOnlySpan<byte> endKey)
+    {
+        void* async = Handle;
+        var operation = RiocAsyncOperation<RiocRangeResult>.Rent(&RiocAsyncOperation.ToRangeResult, rangeRows: true);
+        void* arg = operation.Pin();
+        fixed (byte* startKeyPtr = startKey)
+        fixed (byte* endKeyPtr = endKey)
+        {
+            int result = RiocNative.rioc_async_range_query(async, startKeyPtr, (nuint)startKey.Length,
+                                                           endKeyPtr, (nuint)endKey.Length,
+                                                           RiocAsyncOperation.Callback, arg);
+            return operation.Submitted(result, arg, _logger);
+        }
+    }
+
+    /// <summary>
+    /// Atomically increments or decrements a counter stored at the specified key.
+    /// </summary>
+    /// <param name="key">The key of the counter.</param>
+    /// <param name="increment">The value to add to the counter (can be negative to decrement).</param>
+    /// <param name="timestamp">The timestamp for the operation.</param>
+    /// <returns>The new value of the counter after the operation.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ValueTask<long> AtomicIncDecAsync(ReadOnlySpan<byte> key, long increment, ulong timestamp)
+    {
+        void* async = Handle;
+        var operation = RiocAsyncOperation<long>.Rent(&RiocAsyncOperation.ToInt64);
+        void* arg = operation.Pin();
+        fixed (byte* keyPtr = key)
+        {
+            int result = RiocNative.rioc_async_atomic_inc_dec(async, keyPtr, (nuint)key.Length, increment, timestamp,
+                                                              RiocAsyncOperation.Callback, arg);
+            return operation.Submitted(result, arg, _logger);
+        }
+    }
+
+    private void* Handle
+    {
+        get
+        {
+            ObjectDisposedException.ThrowIf(Volatile.Read(ref _disposed) != 0, this);
+            return _async;
+        }
+    }
+
+    /// <summary>
+    /// Completes the operations already submitted and disposes the client.
+    /// </summary>
+    public ValueTask DisposeAsync()
+    {
+        if (Interlocked.Exchange(ref _disposed, 1) != 0)
+        {
+            return ValueTask.CompletedTask;
+        }
+
+        // Stopping the I/O thread waits for the queued operations to complete
+        return new ValueTask(Task.Run(Free));
+    }
+
+    /// <summary>
+    /// Completes the operations already submitted and disposes the client, blocking until they finish.
+    /// </summary>
+    public void Dispose()
+    {
+        if (Interlocked.Exchange(ref _disposed, 1) == 0)
+        {
+            Free();
+        }
+    }
+
+    private void Free()
+    {
+        RiocNative.rioc_async_free(_async);
+        _client.Dispose();
+    }
+}
+
+// An operation in flight on the native I/O thread, completed by its callback
+internal abstract unsafe class RiocAsyncOperation
+{
+    internal static readonly delegate* unmanaged[Cdecl]<void*, int, byte*, nuint, void> Callback = &OnComplete;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void OnComplete(void* arg, int status, byte* value, nuint valueLen)
+    {
+        GCHandle handle = GCHandle.FromIntPtr((IntPtr)arg);
+        var operation = (RiocAsyncOperation)handle.Target!;
+        handle.Free();
+        operation.Complete(status, value, valueLen);
+    }
+
+    protected abstract void Complete(int status, byte* value, nuint valueLen);
+
+    // Result conversions; they run on the I/O thread and must copy what they keep
+
+    internal static byte[] ToArray(byte* value, nuint valueLen, IBufferWriter<byte>? destination)
+    {
+        return value == null || valueLen == 0 ? Array.Empty<byte>() : new ReadOnlySpan<byte>(value, (int)valueLen).ToArray();
+    }
+
+    internal static int ToWriter(byte* value, nuint valueLen, IBufferWriter<byte>? destination)
+    {
+        return RiocClient.WriteValue(value, valueLen, destination!);
+    }
+
+    internal static RiocRangeResult ToRangeResult(byte* value, nuint valueLen, IBufferWriter<byte>? destination)
+    {
+        return RiocRangeResult.FromRows((NativeRangeResult*)value, value == null ? 0 : valueLen);
+    }
+
+    internal static long ToInt64(byte* value, nuint valueLen, IBufferWriter<byte>? destination)
+    {
+        return value != null && valueLen >= sizeof(long) ? *(long*)value : 0;
+    }
+
+    internal static bool ToNone(byte* value, nuint valueLen, IBufferWriter<byte>? destination)
+    {
+        return true;
+    }
+}
+
+internal sealed unsafe class RiocAsyncOperation<T> : RiocAsyncOperation, IValueTaskSource<T>, IValueTaskSource
+{
+    private static readonly ConcurrentQueue<RiocAsyncOperation<T>> Pool = new();
+
+    // Continuations run on the thread pool rather than the native I/O thread
+    private ManualResetValueTaskSourceCore<T> _core = new() { RunContinuationsAsynchronously = true };
+    private delegate*<byte*, nuint, IBufferWriter<byte>?, T> _convert;
+    private IBufferWriter<byte>? _destination;
+    private bool _rangeRows;
+
+    internal static RiocAsyncOperation<T> Rent(delegate*<byte*, nuint, IBufferWriter<byte>?, T> convert,
+                                               IBufferWriter<byte>? destination = null, bool rangeRows = false)
+    {
+        if (!Pool.TryDequeue(out RiocAsyncOperation<T>? operation))
+        {
+            operation = new RiocAsyncOperation<T>();
+        }
+        operation._convert = convert;
+        operation._destination = destination;
+        operation._rangeRows = rangeRows;
+        return operation;
+    }
+
+    // Keeps the operation alive until the native callback runs
+    internal void* Pin()
+    {
+        return (void*)GCHandle.ToIntPtr(GCHandle.Alloc(this));
+    }
+
+    internal ValueTask<T> Submitted(int result, void* arg, ILogger? logger)
+    {
+        ThrowIfNotQueued(result, arg, logger);
+        return new ValueTask<T>(this, _core.Version);
+    }
+
+    internal ValueTask SubmittedVoid(int result, void* arg, ILogger? logger)
+    {
+        ThrowIfNotQueued(result, arg, logger);
+        return new ValueTask(this, _core.Version);
+    }
+
+    private void ThrowIfNotQueued(int result, void* arg, ILogger? logger)
+    {
+        if (result != 0)
+        {
+            GCHandle.FromIntPtr((IntPtr)arg).Free();
+            Return();
+            logger?.LogError("Failed to queue asynchronous operation. Error code: {ErrorCode}", result);
+            throw RiocExceptionFactory.Create(result);
+        }
+    }
+
+    protected override void Complete(int status, byte* value, nuint valueLen)
+    {
+        T result = default!;
+        Exception? error = null;
+        try
+        {
+            if (status == 0)
+            {
+                result = _convert(value, valueLen, _destination);
+            }
+            else
+            {
+                error = RiocExceptionFactory.Create(status);
+            }
+        }
+        catch (Exception e)
+        {
+            error = e;
+        }
+        finally
+        {
+            // The callback owns the value
+            if (_rangeRows)
+            {
+                RiocNative.rioc_free_range_results((NativeRangeResult*)value, valueLen);
+            }
+            else
+            {
+                RiocNative.rioc_value_free(value);
+            }
+        }
+
+        _destination = null;
+        if (error != null)
+        {
+            _core.SetException(error);
+        }
+        else
+        {
+            _core.SetResult(result);
+        }
+    }
+
+    private void Return()
+    {
+        _core.Reset();
+        _destination = null;
+        Pool.Enqueue(this);
+    }
+
+    public T GetResult(short token)
+    {
+        try
+        {
+            return _core.GetResult(token);
+        }
+        finally
+        {
+            Return();
+        }
+    }
+
+    void IValueTaskSource.GetResult(short token)
+    {
+        GetResult(token);
+    }
+
+    public ValueTaskSourceStatus GetStatus(short token)
+    {
+        return _core.GetStatus(token);
+    }
+
+    public void OnCompleted(Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+    {
+        _core.OnCompleted(continuation, state, token, flags);
+    }
+}
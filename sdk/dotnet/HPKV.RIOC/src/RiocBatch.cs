@@ -1,3 +1,4 @@
+using System.Buffers;
 using System.Runtime.InteropServices;
 using HPKV.RIOC.Native;
 using Microsoft.Extensions.Logging;
@@ -8,10 +9,27 @@ namespace HPKV.RIOC;
 /// <summary>
 /// Represents a batch of RIOC operations that can be executed together.
 /// </summary>
+/// <remarks>
+/// Operations are packed into one buffer and handed to the native library in a single call
+/// when the batch is executed.
+/// </remarks>
 public sealed unsafe class RiocBatch : IDisposable
 {
+    private const int MaxBatchSize = 128;
+    private const int MaxKeySize = 512;
+    private const int MaxValueSize = 100 * 1024;
+
+    private const ushort CmdGet = 1;
+    private const ushort CmdInsert = 2;
+    private const ushort CmdDelete = 3;
+    private const ushort CmdRangeQuery = 6;
+    private const ushort CmdAtomicIncDec = 7;
+
     private readonly void* _handle;
     private readonly ILogger? _logger;
+    private byte[] _packed = new byte[4096];
+    private int _packedLength;
+    private int _count;
     private bool _disposed;
 
     internal RiocBatch(void* handle, ILogger? logger = null)
@@ -28,17 +46,7 @@ public sealed unsafe class RiocBatch : IDisposable
     /// <exception cref="ObjectDisposedException">Thrown when the batch has been disposed.</exception>
     public void AddGet(ReadOnlySpan<byte> key)
     {
-        ThrowIfDisposed();
-
-        fixed (byte* keyPtr = key)
-        {
-            int result = RiocNative.rioc_batch_add_get(_handle, keyPtr, (nuint)key.Length);
-            if (result != 0)
-            {
-                _logger?.LogError("Failed to add GET operation to batch. Error code: {ErrorCode}", result);
-                throw RiocExceptionFactory.Create(result);
-            }
-        }
+        AddOp(CmdGet, key, ReadOnlySpan<byte>.Empty, 0, "GET");
     }
 
     /// <summary>
@@ -51,18 +59,7 @@ public sealed unsafe class RiocBatch : IDisposable
     /// <exception cref="ObjectDisposedException">Thrown when the batch has been disposed.</exception>
     public void AddInsert(ReadOnlySpan<byte> key, ReadOnlySpan<byte> value, ulong timestamp)
     {
-        ThrowIfDisposed();
-
-        fixed (byte* keyPtr = key)
-        fixed (byte* valuePtr = value)
-        {
-            int result = RiocNative.rioc_batch_add_insert(_handle, keyPtr, (nuint)key.Length, valuePtr, (nuint)value.Length, timestamp);
-            if (result != 0)
-            {
-                _logger?.LogError("Failed to add INSERT operation to batch. Error code: {ErrorCode}", result);
-                throw RiocExceptionFactory.Create(result);
-            }
-        }
+        AddOp(CmdInsert, key, value, timestamp, "INSERT");
     }
 
     /// <summary>
@@ -74,17 +71,7 @@ public sealed unsafe class RiocBatch : IDisposable
     /// <exception cref="ObjectDisposedException">Thrown when the batch has been disposed.</exception>
     public void AddDelete(ReadOnlySpan<byte> key, ulong timestamp)
     {
-        ThrowIfDisposed();
-
-        fixed (byte* keyPtr = key)
-        {
-            int result = RiocNative.rioc_batch_add_delete(_handle, keyPtr, (nuint)key.Length, timestamp);
-            if (result != 0)
-            {
-                _logger?.LogError("Failed to add DELETE operation to batch. Error code: {ErrorCode}", result);
-                throw RiocExceptionFactory.Create(result);
-            }
-        }
+        AddOp(CmdDelete, key, ReadOnlySpan<byte>.Empty, timestamp, "DELETE");
     }
 
     /// <summary>
@@ -98,17 +85,13 @@ public sealed unsafe class RiocBatch : IDisposable
     {
         ThrowIfDisposed();
 
-        fixed (byte* startKeyPtr = startKey)
-        fixed (byte* endKeyPtr = endKey)
+        if (endKey.Length > MaxKeySize)
         {
-            int result = RiocNative.rioc_batch_add_range_query(_handle, startKeyPtr, (nuint)startKey.Length, 
-                                                             endKeyPtr, (nuint)endKey.Length);
-            if (result != 0)
-            {
-                _logger?.LogError("Failed to add RANGE QUERY operation to batch. Error code: {ErrorCode}", result);
-                throw RiocExceptionFactory.Create(result);
-            }
+            _logger?.LogError("Failed to add RANGE QUERY operation to batch. Error code: {ErrorCode}", -1);
+            throw RiocExceptionFactory.Create(-1);
         }
+
+        AddOp(CmdRangeQuery, startKey, endKey, 0, "RANGE QUERY");
     }
 
     /// <summary>
@@ -121,17 +104,9 @@ public sealed unsafe class RiocBatch : IDisposable
     /// <exception cref="ObjectDisposedException">Thrown when the batch has been disposed.</exception>
     public void AddAtomicIncDec(ReadOnlySpan<byte> key, long increment, ulong timestamp)
     {
-        ThrowIfDisposed();
-
-        fixed (byte* keyPtr = key)
-        {
-            int result = RiocNative.rioc_batch_add_atomic_inc_dec(_handle, keyPtr, (nuint)key.Length, increment, timestamp);
-            if (result != 0)
-            {
-                _logger?.LogError("Failed to add ATOMIC_INC_DEC operation to batch. Error code: {ErrorCode}", result);
-                throw RiocExceptionFactory.Create(result);
-            }
-        }
+        Span<byte> value = stackalloc byte[sizeof(long)];
+        MemoryMarshal.Write(value, in increment);
+        AddOp(CmdAtomicIncDec, key, value, timestamp, "ATOMIC_INC_DEC");
     }
 
     /// <summary>
@@ -157,6 +132,21 @@ public sealed unsafe class RiocBatch : IDisposable
     {
         ThrowIfDisposed();
 
+        // Hand every operation added since the last execution to the native batch at once
+        if (_packedLength > 0)
+        {
+            fixed (byte* packedPtr = _packed)
+            {
+                int result = RiocNative.rioc_batch_add_packed(_handle, packedPtr, (nuint)_packedLength);
+                if (result != 0)
+                {
+                    _logger?.LogError("Failed to add packed operations to batch. Error code: {ErrorCode}", result);
+                    throw RiocExceptionFactory.Create(result);
+                }
+            }
+            _packedLength = 0;
+        }
+
         void* tracker = RiocNative.rioc_batch_execute_async(_handle);
         if (tracker == null)
         {
@@ -167,6 +157,39 @@ public sealed unsafe class RiocBatch : IDisposable
         return new RiocBatchTracker(tracker, _logger);
     }
 
+    // Appends one record in the layout read by rioc_batch_add_packed
+    private void AddOp(ushort command, ReadOnlySpan<byte> key, ReadOnlySpan<byte> value, ulong timestamp, string operation)
+    {
+        ThrowIfDisposed();
+
+        if (_count >= MaxBatchSize || key.Length > MaxKeySize || value.Length > MaxValueSize)
+        {
+            _logger?.LogError("Failed to add {Operation} operation to batch. Error code: {ErrorCode}", operation, -1);
+            throw RiocExceptionFactory.Create(-1);
+        }
+
+        int size = sizeof(NativeOpHeader) + key.Length + value.Length;
+        if (_packedLength + size > _packed.Length)
+        {
+            Array.Resize(ref _packed, Math.Max(_packed.Length * 2, _packedLength + size));
+        }
+
+        var header = new NativeOpHeader
+        {
+            command = command,
+            key_len = (ushort)key.Length,
+            value_len = (uint)value.Length,
+            timestamp = timestamp
+        };
+        Span<byte> record = _packed.AsSpan(_packedLength, size);
+        MemoryMarshal.Write(record, in header);
+        key.CopyTo(record.Slice(sizeof(NativeOpHeader)));
+        value.CopyTo(record.Slice(sizeof(NativeOpHeader) + key.Length));
+
+        _packedLength += size;
+        _count++;
+    }
+
     private void ThrowIfDisposed()
     {
         if (_disposed)
@@ -191,10 +214,17 @@ public sealed unsafe class RiocBatch : IDisposable
 /// <summary>
 /// Tracks the execution of a batch of RIOC operations.
 /// </summary>
+/// <remarks>
+/// All responses are copied out of the native tracker in one call on first access into a
+/// buffer rented from <see cref="ArrayPool{T}.Shared"/>, and sliced per operation on demand.
+/// The buffer is returned to the pool when the tracker is disposed.
+/// </remarks>
 public sealed unsafe class RiocBatchTracker : IDisposable
 {
     private readonly void* _handle;
     private readonly ILogger? _logger;
+    private byte[]? _packed;
+    private List<int>? _offsets;
     private bool _disposed;
 
     internal RiocBatchTracker(void* handle, ILogger? logger = null)
@@ -230,26 +260,36 @@ public sealed unsafe class RiocBatchTracker : IDisposable
     /// <exception cref="ObjectDisposedException">Thrown when the tracker has been disposed.</exception>
     public byte[] GetResponse(nuint index)
     {
-        ThrowIfDisposed();
-
-        byte* valuePtr;
-        nuint valueLen;
-
-        int result = RiocNative.rioc_batch_get_response_async(_handle, index, &valuePtr, &valueLen);
-        if (result != 0)
-        {
-            _logger?.LogError("Failed to get batch response at index {Index}. Error code: {ErrorCode}", index, result);
-            throw RiocExceptionFactory.Create(result);
-        }
+        ReadOnlySpan<byte> data = GetResult(index, out _);
+        return data.IsEmpty ? Array.Empty<byte>() : data.ToArray();
+    }
 
-        if (valuePtr == null || valueLen == 0)
-        {
-            return Array.Empty<byte>();
-        }
+    /// <summary>
+    /// Gets the response for a GET operation in the batch without copying it.
+    /// </summary>
+    /// <param name="index">The index of the operation in the batch.</param>
+    /// <returns>The value for the GET operation, valid until the tracker is disposed.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the tracker has been disposed.</exception>
+    public ReadOnlySpan<byte> GetResponseSpan(nuint index)
+    {
+        return GetResult(index, out _);
+    }
 
-        byte[] value = new byte[valueLen];
-        Marshal.Copy((IntPtr)valuePtr, value, 0, (int)valueLen);
-        return value;
+    /// <summary>
+    /// Writes the response for a GET operation in the batch to a buffer writer.
+    /// </summary>
+    /// <param name="index">The index of the operation in the batch.</param>
+    /// <param name="destination">The writer the value is written to.</param>
+    /// <returns>The length of the value.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the tracker has been disposed.</exception>
+    public int GetResponse(nuint index, IBufferWriter<byte> destination)
+    {
+        ArgumentNullException.ThrowIfNull(destination);
+        ReadOnlySpan<byte> data = GetResult(index, out _);
+        destination.Write(data);
+        return data.Length;
     }
 
     /// <summary>
@@ -261,40 +301,20 @@ public sealed unsafe class RiocBatchTracker : IDisposable
     /// <exception cref="ObjectDisposedException">Thrown when the tracker has been disposed.</exception>
     public List<KeyValuePair<byte[], byte[]>> GetRangeQueryResponse(nuint index)
     {
-        ThrowIfDisposed();
-
-        byte* valuePtr;
-        nuint valueLen;
-
-        int result = RiocNative.rioc_batch_get_response_async(_handle, index, &valuePtr, &valueLen);
-        if (result != 0)
-        {
-            _logger?.LogError("Failed to get batch range query response at index {Index}. Error code: {ErrorCode}", index, result);
-            throw RiocExceptionFactory.Create(result);
-        }
+        ReadOnlySpan<byte> data = GetResult(index, out uint count);
+        List<KeyValuePair<byte[], byte[]>> results = new List<KeyValuePair<byte[], byte[]>>((int)count);
 
-        if (valuePtr == null || valueLen == 0)
+        // Each row is a key length, a value length, the key and the value
+        for (uint i = 0; i < count; i++)
         {
-            return new List<KeyValuePair<byte[], byte[]>>();
-        }
+            int keyLen = (int)MemoryMarshal.Read<uint>(data);
+            int valueLen = (int)MemoryMarshal.Read<uint>(data.Slice(sizeof(uint)));
+            data = data.Slice(2 * sizeof(uint));
 
-        // For range query, valueLen is the count of results
-        // and valuePtr points to an array of NativeRangeResult structs
-        NativeRangeResult* resultsPtr = (NativeRangeResult*)valuePtr;
-        List<KeyValuePair<byte[], byte[]>> results = new List<KeyValuePair<byte[], byte[]>>((int)valueLen);
+            byte[] key = data.Slice(0, keyLen).ToArray();
+            byte[] value = data.Slice(keyLen, valueLen).ToArray();
+            data = data.Slice(keyLen + valueLen);
 
-        for (nuint i = 0; i < valueLen; i++)
-        {
-            NativeRangeResult rangeResult = resultsPtr[i];
-            
-            // Copy key
-            byte[] key = new byte[rangeResult.key_len];
-            Marshal.Copy((IntPtr)rangeResult.key, key, 0, (int)rangeResult.key_len);
-            
-            // Copy value
-            byte[] value = new byte[rangeResult.value_len];
-            Marshal.Copy((IntPtr)rangeResult.value, value, 0, (int)rangeResult.value_len);
-            
             results.Add(new KeyValuePair<byte[], byte[]>(key, value));
         }
 
@@ -342,6 +362,54 @@ public sealed unsafe class RiocBatchTracker : IDisposable
         return BitConverter.ToInt64(responseBytes, 0);
     }
 
+    // Returns the data of a successful operation from the packed responses
+    private ReadOnlySpan<byte> GetResult(nuint index, out uint count)
+    {
+        ThrowIfDisposed();
+
+        if (_packed == null)
+        {
+            byte* packedPtr;
+            nuint packedLen;
+
+            int status = RiocNative.rioc_batch_get_packed_responses(_handle, &packedPtr, &packedLen);
+            if (status != 0)
+            {
+                _logger?.LogError("Failed to get batch responses. Error code: {ErrorCode}", status);
+                throw RiocExceptionFactory.Create(status);
+            }
+
+            byte[] packed = ArrayPool<byte>.Shared.Rent(Math.Max((int)packedLen, 1));
+            new ReadOnlySpan<byte>(packedPtr, (int)packedLen).CopyTo(packed);
+            var offsets = new List<int>();
+            for (int offset = 0; offset < (int)packedLen;)
+            {
+                offsets.Add(offset);
+                offset += sizeof(NativePackedResult) +
+                          (int)MemoryMarshal.Read<NativePackedResult>(packed.AsSpan(offset)).data_len;
+            }
+            _packed = packed;
+            _offsets = offsets;
+        }
+
+        if (index >= (nuint)_offsets!.Count)
+        {
+            _logger?.LogError("Invalid batch response index {Index}", index);
+            throw RiocExceptionFactory.Create(-1);
+        }
+
+        int resultOffset = _offsets[(int)index];
+        NativePackedResult result = MemoryMarshal.Read<NativePackedResult>(_packed.AsSpan(resultOffset));
+        if (result.status != 0)
+        {
+            _logger?.LogError("Failed to get batch response at index {Index}. Error code: {ErrorCode}", index, result.status);
+            throw RiocExceptionFactory.Create(result.status);
+        }
+
+        count = result.count;
+        return _packed.AsSpan(resultOffset + sizeof(NativePackedResult), (int)result.data_len);
+    }
+
     private void ThrowIfDisposed()
     {
         if (_disposed)
@@ -358,6 +426,11 @@ public sealed unsafe class RiocBatchTracker : IDisposable
         if (!_disposed)
         {
             RiocNative.rioc_batch_tracker_free(_handle);
+            if (_packed != null)
+            {
+                ArrayPool<byte>.Shared.Return(_packed);
+                _packed = null;
+            }
             _disposed = true;
         }
     }
@@ -1,3 +1,4 @@
+using System.Buffers;
 using System.Runtime.InteropServices;
 using System.Text;
 using HPKV.RIOC.Native;
@@ -11,6 +12,7 @@ namespace HPKV.RIOC;
 public sealed unsafe class RiocClient : IDisposable
 {
     private readonly void* _handle;
+    private readonly RiocConfig _config;
     private readonly ILogger? _logger;
     private bool _disposed;
 
@@ -22,6 +24,7 @@ public sealed unsafe class RiocClient : IDisposable
     /// <exception cref="RiocException">Thrown when the client fails to initialize.</exception>
     public RiocClient(RiocConfig config, ILogger? logger = null)
     {
+        _config = config;
         _logger = logger;
 
         // Initialize platform
@@ -110,14 +113,66 @@ public sealed unsafe class RiocClient : IDisposable
 
         if (valuePtr == null || valueLen == 0)
         {
+            RiocNative.rioc_value_free(valuePtr);
             return Array.Empty<byte>();
         }
 
         byte[] value = new byte[valueLen];
         Marshal.Copy((IntPtr)valuePtr, value, 0, (int)valueLen);
+        RiocNative.rioc_value_free(valuePtr);
         return value;
     }
 
+    /// <summary>
+    /// Gets the value associated with the specified key into a buffer writer, without allocating.
+    /// </summary>
+    /// <param name="key">The key to get.</param>
+    /// <param name="destination">The writer the value is written to.</param>
+    /// <returns>The length of the value.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public int Get(ReadOnlySpan<byte> key, IBufferWriter<byte> destination)
+    {
+        ThrowIfDisposed();
+        ArgumentNullException.ThrowIfNull(destination);
+
+        byte* valuePtr;
+        nuint valueLen;
+
+        fixed (byte* keyPtr = key)
+        {
+            int result = RiocNative.rioc_get(_handle, keyPtr, (nuint)key.Length, &valuePtr, &valueLen);
+            if (result != 0)
+            {
+                _logger?.LogError("Failed to get value. Error code: {ErrorCode}", result);
+                throw RiocExceptionFactory.Create(result);
+            }
+        }
+
+        try
+        {
+            return WriteValue(valuePtr, valueLen, destination);
+        }
+        finally
+        {
+            RiocNative.rioc_value_free(valuePtr);
+        }
+    }
+
+    // Copies a native value into a buffer writer
+    internal static int WriteValue(byte* value, nuint valueLen, IBufferWriter<byte> destination)
+    {
+        if (value == null || valueLen == 0)
+        {
+            return 0;
+        }
+
+        var source = new ReadOnlySpan<byte>(value, (int)valueLen);
+        source.CopyTo(destination.GetSpan(source.Length));
+        destination.Advance(source.Length);
+        return source.Length;
+    }
+
     /// <summary>
     /// Gets the value associated with the specified key as a UTF-8 string.
     /// </summary>
@@ -264,6 +319,63 @@ public sealed unsafe class RiocClient : IDisposable
         return results;
     }
 
+    /// <summary>
+    /// Performs a range query and returns the rows in pooled buffers.
+    /// </summary>
+    /// <param name="startKey">The start key of the range (inclusive).</param>
+    /// <param name="endKey">The end key of the range (inclusive).</param>
+    /// <returns>The rows within the specified range; dispose it to return its buffers to the pool.</returns>
+    /// <exception cref="RiocException">Thrown when the operation fails.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public RiocRangeResult RangeQueryPooled(ReadOnlySpan<byte> startKey, ReadOnlySpan<byte> endKey)
+    {
+        ThrowIfDisposed();
+
+        NativeRangeColumns columns;
+        fixed (byte* startKeyPtr = startKey)
+        fixed (byte* endKeyPtr = endKey)
+        {
+            int result = RiocNative.rioc_range_query_columns(_handle, startKeyPtr, (nuint)startKey.Length,
+                                                             endKeyPtr, (nuint)endKey.Length, &columns);
+            if (result != 0)
+            {
+                _logger?.LogError("Failed to perform range query. Error code: {ErrorCode}", result);
+                throw RiocExceptionFactory.Create(result);
+            }
+        }
+
+        try
+        {
+            return RiocRangeResult.FromColumns(&columns);
+        }
+        finally
+        {
+            RiocNative.rioc_free_range_columns(&columns);
+        }
+    }
+
+    /// <summary>
+    /// Streams the key-value pairs within the specified range without materializing the result.
+    /// </summary>
+    /// <remarks>
+    /// The scan runs on a dedicated connection and rows are read from it as the enumeration advances, so memory
+    /// stays bounded for any result size. Each row is only valid until the enumerator advances. Cancelling the
+    /// token, or leaving the enumeration early, shuts the scan's connection down so the server stops sending.
+    /// </remarks>
+    /// <param name="startKey">The start key of the range (inclusive).</param>
+    /// <param name="endKey">The end key of the range (inclusive).</param>
+    /// <param name="cancellationToken">A token that aborts the scan.</param>
+    /// <returns>The rows within the specified range, in key order.</returns>
+    /// <exception cref="RiocException">Thrown when the scan fails.</exception>
+    /// <exception cref="OperationCanceledException">Thrown when the scan is cancelled.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public IAsyncEnumerable<RiocRangeRow> ScanAsync(ReadOnlySpan<byte> startKey, ReadOnlySpan<byte> endKey,
+                                                    CancellationToken cancellationToken = default)
+    {
+        ThrowIfDisposed();
+        return RiocRangeScan.ScanAsync(_config, _logger, startKey.ToArray(), endKey.ToArray(), cancellationToken);
+    }
+
     /// <summary>
     /// Performs a range query to retrieve all key-value pairs within the specified range using UTF-8 strings.
     /// </summary>
@@ -355,6 +467,15 @@ public sealed unsafe class RiocClient : IDisposable
         return AtomicIncDec(keyBytes, increment, timestamp);
     }
 
+    internal void* Handle
+    {
+        get
+        {
+            ThrowIfDisposed();
+            return _handle;
+        }
+    }
+
     private void ThrowIfDisposed()
     {
         if (_disposed)
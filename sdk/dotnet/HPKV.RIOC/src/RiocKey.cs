@@ -0,0 +1,390 @@
+using System.Buffers.Binary;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace HPKV.RIOC;
+
+/// <summary>
+/// Builds order-preserving keys from typed fields.
+/// </summary>
+/// <remarks>
+/// Range queries compare keys as raw bytes. Keys built here compare field by field in the fields' own
+/// order, and are byte for byte the keys the native rioc_key_* functions build:
+/// integers are big-endian with the sign bit flipped for signed types, strings escape 0x00 as 0x00 0xFF
+/// and end with 0x00 0x01, and descending fields are the bitwise complement.
+/// A builder can be cleared and reused, so building keys in a loop does not allocate.
+/// </remarks>
+public sealed class RiocKeyBuilder
+{
+    private byte[] _buffer;
+    private int _length;
+
+    /// <summary>
+    /// Initializes a new builder.
+    /// </summary>
+    /// <param name="capacity">The initial buffer size in bytes.</param>
+    public RiocKeyBuilder(int capacity = 64)
+    {
+        _buffer = new byte[Math.Max(capacity, 16)];
+    }
+
+    /// <summary>
+    /// Gets the length of the key built so far.
+    /// </summary>
+    public int Length => _length;
+
+    /// <summary>
+    /// Gets the key built so far, valid until the builder is next modified.
+    /// </summary>
+    public ReadOnlySpan<byte> AsSpan() => _buffer.AsSpan(0, _length);
+
+    /// <summary>
+    /// Copies the key built so far into a new array.
+    /// </summary>
+    public byte[] ToArray() => AsSpan().ToArray();
+
+    /// <summary>
+    /// Empties the builder, keeping its buffer.
+    /// </summary>
+    public RiocKeyBuilder Clear()
+    {
+        _length = 0;
+        return this;
+    }
+
+    /// <summary>Appends an unsigned 32-bit field.</summary>
+    public RiocKeyBuilder AddUInt32(uint value, bool descending = false)
+    {
+        BinaryPrimitives.WriteUInt32BigEndian(Reserve(sizeof(uint)), descending ? ~value : value);
+        return this;
+    }
+
+    /// <summary>Appends an unsigned 64-bit field.</summary>
+    public RiocKeyBuilder AddUInt64(ulong value, bool descending = false)
+    {
+        BinaryPrimitives.WriteUInt64BigEndian(Reserve(sizeof(ulong)), descending ? ~value : value);
+        return this;
+    }
+
+    /// <summary>Appends a signed 32-bit field.</summary>
+    public RiocKeyBuilder AddInt32(int value, bool descending = false) =>
+        AddUInt32((uint)value ^ 0x80000000u, descending);
+
+    /// <summary>Appends a signed 64-bit field.</summary>
+    public RiocKeyBuilder AddInt64(long value, bool descending = false) =>
+        AddUInt64((ulong)value ^ 0x8000000000000000ul, descending);
+
+    /// <summary>Appends a string field, encoded as UTF-8.</summary>
+    public RiocKeyBuilder AddString(string value, bool descending = false)
+    {
+        ArgumentNullException.ThrowIfNull(value);
+        int maxBytes = Encoding.UTF8.GetMaxByteCount(value.Length);
+        if (maxBytes <= 256)
+        {
+            Span<byte> utf8 = stackalloc byte[maxBytes];
+            return AddBytes(utf8[..Encoding.UTF8.GetBytes(value, utf8)], descending);
+        }
+        return AddBytes(Encoding.UTF8.GetBytes(value), descending);
+    }
+
+    /// <summary>Appends a byte string field.</summary>
+    public RiocKeyBuilder AddBytes(ReadOnlySpan<byte> value, bool descending = false)
+    {
+        int zeros = value.Count((byte)0);
+        Span<byte> output = Reserve(value.Length + zeros + 2);
+        int pos = 0;
+        foreach (byte b in value)
+        {
+            output[pos++] = b;
+            if (b == 0)
+            {
+                output[pos++] = 0xFF;
+            }
+        }
+        output[pos++] = 0x00;
+        output[pos] = 0x01;
+        if (descending)
+        {
+            RiocKey.Complement(output);
+        }
+        return this;
+    }
+
+    /// <summary>
+    /// Appends bytes as they are, such as a prefix built earlier. Raw bytes are not self-delimiting,
+    /// so they only keep the order when every key has the same raw bytes at the same position.
+    /// </summary>
+    public RiocKeyBuilder AddRaw(ReadOnlySpan<byte> value)
+    {
+        value.CopyTo(Reserve(value.Length));
+        return this;
+    }
+
+    private Span<byte> Reserve(int count)
+    {
+        if (_buffer.Length - _length < count)
+        {
+            Array.Resize(ref _buffer, Math.Max(_buffer.Length * 2, _length + count));
+        }
+        Span<byte> span = _buffer.AsSpan(_length, count);
+        _length += count;
+        return span;
+    }
+}
+
+/// <summary>
+/// Reads the fields of a key built by <see cref="RiocKeyBuilder"/> or the native rioc_key_* functions,
+/// such as the key of a range query row.
+/// </summary>
+/// <remarks>
+/// Fields are read in the order they were added, with the same direction.
+/// A read that does not match the key throws <see cref="FormatException"/> and leaves the reader unchanged.
+/// </remarks>
+public ref struct RiocKeyReader
+{
+    private readonly ReadOnlySpan<byte> _key;
+    private int _position;
+
+    /// <summary>
+    /// Initializes a reader at the start of a key.
+    /// </summary>
+    public RiocKeyReader(ReadOnlySpan<byte> key)
+    {
+        _key = key;
+        _position = 0;
+    }
+
+    /// <summary>
+    /// Gets the number of bytes read so far.
+    /// </summary>
+    public readonly int Position => _position;
+
+    /// <summary>
+    /// Gets whether every byte of the key has been read.
+    /// </summary>
+    public readonly bool End => _position == _key.Length;
+
+    /// <summary>Reads an unsigned 32-bit field.</summary>
+    public uint ReadUInt32(bool descending = false)
+    {
+        uint value = BinaryPrimitives.ReadUInt32BigEndian(Take(sizeof(uint)));
+        return descending ? ~value : value;
+    }
+
+    /// <summary>Reads an unsigned 64-bit field.</summary>
+    public ulong ReadUInt64(bool descending = false)
+    {
+        ulong value = BinaryPrimitives.ReadUInt64BigEndian(Take(sizeof(ulong)));
+        return descending ? ~value : value;
+    }
+
+    /// <summary>Reads a signed 32-bit field.</summary>
+    public int ReadInt32(bool descending = false) => (int)(ReadUInt32(descending) ^ 0x80000000u);
+
+    /// <summary>Reads a signed 64-bit field.</summary>
+    public long ReadInt64(bool descending = false) => (long)(ReadUInt64(descending) ^ 0x8000000000000000ul);
+
+    /// <summary>Reads a string field.</summary>
+    public string ReadString(bool descending = false) => Encoding.UTF8.GetString(ReadBytes(descending));
+
+    /// <summary>Reads a byte string field.</summary>
+    public byte[] ReadBytes(bool descending = false)
+    {
+        byte flip = descending ? (byte)0xFF : (byte)0x00;
+        ReadOnlySpan<byte> input = _key[_position..];
+
+        // Find the terminator and the decoded length first, so a failed read leaves the reader where it was
+        int decoded = 0;
+        int end = 0;
+        while (true)
+        {
+            if (end >= input.Length)
+            {
+                throw new FormatException("Key ends inside a string field");
+            }
+            if ((byte)(input[end] ^ flip) != 0x00)
+            {
+                decoded++;
+                end++;
+                continue;
+            }
+            if (end + 1 >= input.Length)
+            {
+                throw new FormatException("Key ends inside a string field");
+            }
+            byte next = (byte)(input[end + 1] ^ flip);
+            if (next == 0x01)
+            {
+                break;
+            }
+            if (next != 0xFF)
+            {
+                throw new FormatException("Invalid escape in a string field");
+            }
+            decoded++;
+            end += 2;
+        }
+
+        var value = new byte[decoded];
+        int pos = 0;
+        for (int i = 0; i < end; i++)
+        {
+            byte b = (byte)(input[i] ^ flip);
+            value[pos++] = b;
+            if (b == 0x00)
+            {
+                i++;    // Skip the escape byte
+            }
+        }
+        _position += end + 2;
+        return value;
+    }
+
+    private ReadOnlySpan<byte> Take(int count)
+    {
+        if (_key.Length - _position < count)
+        {
+            throw new FormatException("Key ends inside an integer field");
+        }
+        ReadOnlySpan<byte> span = _key.Slice(_position, count);
+        _position += count;
+        return span;
+    }
+}
+
+/// <summary>
+/// Helpers for order-preserving keys that work on whole scans and columns.
+/// </summary>
+public static class RiocKey
+{
+    /// <summary>
+    /// Returns the smallest key above every key that starts with <paramref name="prefix"/>, as the end key
+    /// of a scan over the prefix. Range ends are inclusive, but keys built from the same fields as the
+    /// prefix are always longer than the successor.
+    /// </summary>
+    /// <returns>The successor, or null if the prefix is empty or all 0xFF bytes, when no key bounds the scan.</returns>
+    public static byte[]? PrefixSuccessor(ReadOnlySpan<byte> prefix)
+    {
+        ReadOnlySpan<byte> trimmed = prefix.TrimEnd((byte)0xFF);
+        if (trimmed.IsEmpty)
+        {
+            return null;
+        }
+        byte[] successor = trimmed.ToArray();
+        successor[^1]++;
+        return successor;
+    }
+
+    /// <summary>
+    /// Encodes a column of signed 64-bit fields, one key every <paramref name="stride"/> bytes.
+    /// </summary>
+    /// <remarks>
+    /// The field is written at the start of each stride, so a shared prefix written with
+    /// <see cref="FillPrefix"/> is placed by offsetting <paramref name="destination"/> by the prefix length.
+    /// When the stride is the field width the column is byte-swapped with vectorized instructions.
+    /// </remarks>
+    public static void EncodeInt64s(ReadOnlySpan<long> values, Span<byte> destination, int stride = sizeof(long),
+                                    bool descending = false) =>
+        EncodeColumn(MemoryMarshal.Cast<long, ulong>(values), 0x8000000000000000ul, descending, destination, stride);
+
+    /// <summary>
+    /// Encodes a column of unsigned 64-bit fields, one key every <paramref name="stride"/> bytes.
+    /// </summary>
+    public static void EncodeUInt64s(ReadOnlySpan<ulong> values, Span<byte> destination, int stride = sizeof(ulong),
+                                     bool descending = false) =>
+        EncodeColumn(values, 0, descending, destination, stride);
+
+    /// <summary>
+    /// Encodes a column of signed 32-bit fields, one key every <paramref name="stride"/> bytes.
+    /// </summary>
+    public static void EncodeInt32s(ReadOnlySpan<int> values, Span<byte> destination, int stride = sizeof(int),
+                                    bool descending = false) =>
+        EncodeColumn(MemoryMarshal.Cast<int, uint>(values), 0x80000000u, descending, destination, stride);
+
+    /// <summary>
+    /// Encodes a column of unsigned 32-bit fields, one key every <paramref name="stride"/> bytes.
+    /// </summary>
+    public static void EncodeUInt32s(ReadOnlySpan<uint> values, Span<byte> destination, int stride = sizeof(uint),
+                                     bool descending = false) =>
+        EncodeColumn(values, 0, descending, destination, stride);
+
+    /// <summary>
+    /// Copies a prefix to the start of <paramref name="count"/> keys laid out every <paramref name="stride"/> bytes.
+    /// </summary>
+    public static void FillPrefix(ReadOnlySpan<byte> prefix, int count, Span<byte> destination, int stride)
+    {
+        CheckColumn(count, prefix.Length, destination, stride);
+        for (int i = 0; i < count && !prefix.IsEmpty; i++)
+        {
+            prefix.CopyTo(destination.Slice(i * stride));
+        }
+    }
+
+    internal static void Complement(Span<byte> bytes)
+    {
+        for (int i = 0; i < bytes.Length; i++)
+        {
+            bytes[i] = (byte)~bytes[i];
+        }
+    }
+
+    private static void EncodeColumn(ReadOnlySpan<ulong> values, ulong sign, bool descending,
+                                     Span<byte> destination, int stride)
+    {
+        CheckColumn(values.Length, sizeof(ulong), destination, stride);
+        ulong mask = sign ^ (descending ? ulong.MaxValue : 0);
+        if (stride == sizeof(ulong))
+        {
+            Span<ulong> output = MemoryMarshal.Cast<byte, ulong>(destination[..(values.Length * sizeof(ulong))]);
+            for (int i = 0; i < values.Length; i++)
+            {
+                output[i] = values[i] ^ mask;
+            }
+            if (BitConverter.IsLittleEndian)
+            {
+                BinaryPrimitives.ReverseEndianness(output, output);
+            }
+            return;
+        }
+        for (int i = 0; i < values.Length; i++)
+        {
+            BinaryPrimitives.WriteUInt64BigEndian(destination.Slice(i * stride), values[i] ^ mask);
+        }
+    }
+
+    private static void EncodeColumn(ReadOnlySpan<uint> values, uint sign, bool descending,
+                                     Span<byte> destination, int stride)
+    {
+        CheckColumn(values.Length, sizeof(uint), destination, stride);
+        uint mask = sign ^ (descending ? uint.MaxValue : 0);
+        if (stride == sizeof(uint))
+        {
+            Span<uint> output = MemoryMarshal.Cast<byte, uint>(destination[..(values.Length * sizeof(uint))]);
+            for (int i = 0; i < values.Length; i++)
+            {
+                output[i] = values[i] ^ mask;
+            }
+            if (BitConverter.IsLittleEndian)
+            {
+                BinaryPrimitives.ReverseEndianness(output, output);
+            }
+            return;
+        }
+        for (int i = 0; i < values.Length; i++)
+        {
+            BinaryPrimitives.WriteUInt32BigEndian(destination.Slice(i * stride), values[i] ^ mask);
+        }
+    }
+
+    private static void CheckColumn(int count, int width, Span<byte> destination, int stride)
+    {
+        if (stride < width)
+        {
+            throw new ArgumentOutOfRangeException(nameof(stride), "Stride is smaller than the field");
+        }
+        if (count > 0 && (long)(count - 1) * stride + width > destination.Length)
+        {
+            throw new ArgumentException("Destination is too small for the column", nameof(destination));
+        }
+    }
+}
@@ -0,0 +1,122 @@
+using System.Buffers;
+using HPKV.RIOC.Native;
+
+namespace HPKV.RIOC;
+
+/// <summary>
+/// Rows of a range query held in buffers rented from <see cref="ArrayPool{T}.Shared"/>.
+/// </summary>
+/// <remarks>
+/// Keys and values are slices of one rented buffer, so a result costs two pooled arrays
+/// regardless of the row count. Spans returned by <see cref="GetKey"/> and <see cref="GetValue"/>
+/// are valid until the result is disposed, which returns the buffers to the pool.
+/// </remarks>
+public sealed unsafe class RiocRangeResult : IDisposable
+{
+    private byte[] _data;
+    // Row i's key starts at _offsets[2 * i], its value at _offsets[2 * i + 1] and both end at the next offset
+    private int[] _offsets;
+    private bool _disposed;
+
+    private RiocRangeResult(int count, int dataLength)
+    {
+        Count = count;
+        _data = ArrayPool<byte>.Shared.Rent(Math.Max(dataLength, 1));
+        _offsets = ArrayPool<int>.Shared.Rent(2 * count + 1);
+    }
+
+    /// <summary>
+    /// Gets the number of rows.
+    /// </summary>
+    public int Count { get; }
+
+    /// <summary>
+    /// Gets the key of a row.
+    /// </summary>
+    /// <param name="index">The index of the row.</param>
+    /// <returns>The key, valid until the result is disposed.</returns>
+    /// <exception cref="ObjectDisposedException">Thrown when the result has been disposed.</exception>
+    public ReadOnlySpan<byte> GetKey(int index) => Slice(2 * index);
+
+    /// <summary>
+    /// Gets the value of a row.
+    /// </summary>
+    /// <param name="index">The index of the row.</param>
+    /// <returns>The value, valid until the result is disposed.</returns>
+    /// <exception cref="ObjectDisposedException">Thrown when the result has been disposed.</exception>
+    public ReadOnlySpan<byte> GetValue(int index) => Slice(2 * index + 1);
+
+    private ReadOnlySpan<byte> Slice(int field)
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+        if ((uint)field >= (uint)(2 * Count))
+        {
+            throw new ArgumentOutOfRangeException("index");
+        }
+        return _data.AsSpan(_offsets[field], _offsets[field + 1] - _offsets[field]);
+    }
+
+    // Copies rows returned by rioc_range_query or an async range query
+    internal static RiocRangeResult FromRows(NativeRangeResult* rows, nuint count)
+    {
+        long dataLength = 0;
+        for (nuint i = 0; i < count; i++)
+        {
+            dataLength += (long)rows[i].key_len + (long)rows[i].value_len;
+        }
+
+        var result = new RiocRangeResult(checked((int)count), checked((int)dataLength));
+        int offset = 0;
+        for (int i = 0; i < result.Count; i++)
+        {
+            result._offsets[2 * i] = offset;
+            offset = result.Append(offset, rows[i].key, rows[i].key_len);
+            result._offsets[2 * i + 1] = offset;
+            offset = result.Append(offset, rows[i].value, rows[i].value_len);
+        }
+        result._offsets[2 * result.Count] = offset;
+        return result;
+    }
+
+    // Copies rows returned by rioc_range_query_columns
+    internal static RiocRangeResult FromColumns(NativeRangeColumns* columns)
+    {
+        int count = checked((int)columns->count);
+        long dataLength = count == 0 ? 0 : columns->key_offsets[count] + columns->value_offsets[count];
+
+        var result = new RiocRangeResult(count, checked((int)dataLength));
+        int offset = 0;
+        for (int i = 0; i < count; i++)
+        {
+            result._offsets[2 * i] = offset;
+            offset = result.Append(offset, columns->key_data + columns->key_offsets[i],
+                                   (nuint)(columns->key_offsets[i + 1] - columns->key_offsets[i]));
+            result._offsets[2 * i + 1] = offset;
+            offset = result.Append(offset, columns->value_data + columns->value_offsets[i],
+                                   (nuint)(columns->value_offsets[i + 1] - columns->value_offsets[i]));
+        }
+        result._offsets[2 * count] = offset;
+        return result;
+    }
+
+    private int Append(int offset, byte* source, nuint length)
+    {
+        new ReadOnlySpan<byte>(source, (int)length).CopyTo(_data.AsSpan(offset));
+        return offset + (int)length;
+    }
+
+    /// <summary>
+    /// Returns the buffers to the pool.
+    /// </summary>
+    public void Dispose()
+    {
+        if (!_disposed)
+        {
+            _disposed = true;
+            ArrayPool<byte>.Shared.Return(_data);
+            ArrayPool<int>.Shared.Return(_offsets);
+            _data = Array.Empty<byte>();
+            _offsets = Array.Empty<int>();
+        }
+    }
+}
@@ -0,0 +1,214 @@
+using System.Buffers;
+using System.Runtime.CompilerServices;
+using HPKV.RIOC.Native;
+using Microsoft.Extensions.Logging;
+
+namespace HPKV.RIOC;
+
+/// <summary>
+/// A row of a streaming range scan.
+/// </summary>
+/// <remarks>
+/// The key and value are slices of a pooled buffer that is reused for later rows, so they are
+/// only valid until the enumerator advances. Copy them to keep them longer.
+/// </remarks>
+public readonly struct RiocRangeRow
+{
+    internal RiocRangeRow(ReadOnlyMemory<byte> key, ReadOnlyMemory<byte> value)
+    {
+        Key = key;
+        Value = value;
+    }
+
+    /// <summary>
+    /// Gets the key of the row.
+    /// </summary>
+    public ReadOnlyMemory<byte> Key { get; }
+
+    /// <summary>
+    /// Gets the value of the row.
+    /// </summary>
+    public ReadOnlyMemory<byte> Value { get; }
+}
+
+internal static class RiocRangeScan
+{
+    internal static async IAsyncEnumerable<RiocRangeRow> ScanAsync(RiocConfig config, ILogger? logger,
+                                                                   byte[] startKey, byte[] endKey,
+                                                                   [EnumeratorCancellation] CancellationToken cancellationToken)
+    {
+        // Connecting and reading block in native code, so both run on the thread pool
+        using RiocRangeCursor cursor = await Task.Run(() => RiocRangeCursor.Open(config, logger, startKey, endKey),
+                                                      cancellationToken).ConfigureAwait(false);
+        while (true)
+        {
+            int count = await Task.Run(() => cursor.Fill(cancellationToken), CancellationToken.None).ConfigureAwait(false);
+            if (count == 0)
+            {
+                yield break;
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                yield return cursor.GetRow(i);
+            }
+        }
+    }
+}
+
+// A native range cursor on its own connection, read a chunk of rows at a time into pooled buffers
+internal sealed unsafe class RiocRangeCursor : IDisposable
+{
+    // The first chunk is small so rows are delivered as soon as they arrive; later chunks grow to amortize
+    // the hop to the thread pool
+    private const int InitialChunkSize = 4 * 1024;
+    private const int MaxChunkSize = 64 * 1024;
+    private const int NoMoreRows = -6;
+
+    private readonly RiocClient _connection;
+    private readonly ILogger? _logger;
+    private void* _cursor;
+    private byte[] _data;
+    // Row i's key starts at _offsets[2 * i], its value at _offsets[2 * i + 1] and both end at the next offset
+    private int[] _offsets;
+    private int _count;
+    private int _chunkSize = InitialChunkSize;
+
+    private RiocRangeCursor(RiocClient connection, void* cursor, ILogger? logger)
+    {
+        _connection = connection;
+        _cursor = cursor;
+        _logger = logger;
+        _data = ArrayPool<byte>.Shared.Rent(InitialChunkSize);
+        _offsets = ArrayPool<int>.Shared.Rent(64);
+    }
+
+    internal static RiocRangeCursor Open(RiocConfig config, ILogger? logger, byte[] startKey, byte[] endKey)
+    {
+        // The cursor reserves its connection until it is closed and cancelling shuts the connection down,
+        // so each scan gets its own
+        var connection = new RiocClient(config, logger);
+        try
+        {
+            void* cursor;
+            fixed (byte* startKeyPtr = startKey)
+            fixed (byte* endKeyPtr = endKey)
+            {
+                int result = RiocNative.rioc_range_cursor_open(connection.Handle, startKeyPtr, (nuint)startKey.Length,
+                                                               endKeyPtr, (nuint)endKey.Length, &cursor);
+                if (result != 0)
+                {
+                    logger?.LogError("Failed to start range scan. Error code: {ErrorCode}", result);
+                    throw RiocExceptionFactory.Create(result);
+                }
+            }
+            return new RiocRangeCursor(connection, cursor, logger);
+        }
+        catch
+        {
+            connection.Dispose();
+            throw;
+        }
+    }
+
+    // Reads rows until the chunk holds at least the chunk size or the scan ends; returns the row count
+    internal int Fill(CancellationToken cancellationToken)
+    {
+        cancellationToken.ThrowIfCancellationRequested();
+
+        _count = 0;
+        int used = 0;
+        // Cancelling shuts the connection down, which ends the scan on the server and wakes up a blocked read
+        using (cancellationToken.UnsafeRegister(static state => ((RiocRangeCursor)state!).Cancel(), this))
+        {
+            while (used < _chunkSize)
+            {
+                NativeRangeResult row;
+                int result = RiocNative.rioc_range_cursor_next(_cursor, &row);
+                if (result == NoMoreRows)
+                {
+                    break;
+                }
+                if (result != 0)
+                {
+                    cancellationToken.ThrowIfCancellationRequested();
+                    _logger?.LogError("Failed to read range scan row. Error code: {ErrorCode}", result);
+                    throw RiocExceptionFactory.Create(result);
+                }
+                used = Append(used, &row);
+            }
+        }
+
+        _chunkSize = Math.Min(_chunkSize * 2, MaxChunkSize);
+        return _count;
+    }
+
+    internal RiocRangeRow GetRow(int index)
+    {
+        int key = _offsets[2 * index];
+        int value = _offsets[2 * index + 1];
+        int end = _offsets[2 * index + 2];
+        return new RiocRangeRow(_data.AsMemory(key, value - key), _data.AsMemory(value, end - value));
+    }
+
+    private int Append(int used, NativeRangeResult* row)
+    {
+        int keyLength = (int)row->key_len;
+        int valueLength = (int)row->value_len;
+        EnsureCapacity(used, keyLength + valueLength);
+
+        _offsets[2 * _count] = used;
+        new ReadOnlySpan<byte>(row->key, keyLength).CopyTo(_data.AsSpan(used));
+        used += keyLength;
+        _offsets[2 * _count + 1] = used;
+        new ReadOnlySpan<byte>(row->value, valueLength).CopyTo(_data.AsSpan(used));
+        used += valueLength;
+        _count++;
+        _offsets[2 * _count] = used;
+        return used;
+    }
+
+    private void EnsureCapacity(int used, int rowLength)
+    {
+        if (used + rowLength > _data.Length)
+        {
+            byte[] data = ArrayPool<byte>.Shared.Rent(Math.Max(used + rowLength, 2 * _data.Length));
+            _data.AsSpan(0, used).CopyTo(data);
+            ArrayPool<byte>.Shared.Return(_data);
+            _data = data;
+        }
+        if (2 * _count + 3 > _offsets.Length)
+        {
+            int[] offsets = ArrayPool<int>.Shared.Rent(2 * _offsets.Length);
+            _offsets.AsSpan(0, 2 * _count + 1).CopyTo(offsets);
+            ArrayPool<int>.Shared.Return(_offsets);
+            _offsets = offsets;
+        }
+    }
+
+    private void Cancel()
+    {
+        RiocNative.rioc_range_cursor_cancel(_cursor);
+    }
+
+    public void Dispose()
+    {
+        if (_cursor != null)
+        {
+            // Abort a scan that was left early instead of reading the rest of it
+            if (RiocNative.rioc_range_cursor_remaining(_cursor) > 0)
+            {
+                RiocNative.rioc_range_cursor_cancel(_cursor);
+            }
+            RiocNative.rioc_range_cursor_close(_cursor);
+            _cursor = null;
+
+            _connection.Dispose();
+            ArrayPool<byte>.Shared.Return(_data);
+            ArrayPool<int>.Shared.Return(_offsets);
+            _data = Array.Empty<byte>();
+            _offsets = Array.Empty<int>();
+        }
+    }
+}
@@ -7,6 +7,7 @@ namespace HPKV.RIOC.Tests;
 public class RiocClientTests : IDisposable
 {
     private readonly RiocClient _client;
+    private readonly RiocConfig _config;
     private readonly ILogger<RiocClient> _logger;
 
     // Test configuration from environment variables with defaults
@@ -59,6 +60,7 @@ public class RiocClientTests : IDisposable
         }
 
         // Create client
+        _config = config;
         _client = new RiocClient(config, _logger);
     }
 
@@ -155,6 +157,48 @@ public class RiocClientTests : IDisposable
         Assert.Throws<RiocKeyNotFoundException>(() => _client.Get(key2));
     }
 
+    [Fact]
+    public void BatchOperations_FullBatch_ShouldSucceedAndRejectOneMore()
+    {
+        // Arrange
+        byte[][] keys = Enumerable.Range(0, 128)
+            .Select(i => Encoding.UTF8.GetBytes($"packed_key{i}"))
+            .ToArray();
+
+        using (var insertBatch = _client.CreateBatch())
+        {
+            foreach (byte[] key in keys)
+            {
+                insertBatch.AddInsert(key, key, RiocClient.GetTimestamp());
+            }
+            Assert.Throws<RiocInvalidParameterException>(() => insertBatch.AddGet(Encoding.UTF8.GetBytes("packed_overflow")));
+
+            using var insertTracker = insertBatch.ExecuteAsync();
+            insertTracker.Wait(1000);
+        }
+
+        // Act
+        using var batch = _client.CreateBatch();
+        foreach (byte[] key in keys)
+        {
+            batch.AddGet(key);
+        }
+
+        using var tracker = batch.ExecuteAsync();
+        tracker.Wait(1000);
+
+        // Assert
+        for (int i = 0; i < keys.Length; i++)
+        {
+            Assert.Equal(keys[i], tracker.GetResponse((nuint)i));
+        }
+
+        foreach (byte[] key in keys)
+        {
+            _client.Delete(key, RiocClient.GetTimestamp());
+        }
+    }
+
     [Fact]
     public void GetTimestamp_ShouldReturnIncreasingValues()
     {
@@ -535,6 +579,197 @@ public class RiocClientTests : IDisposable
         _client.DeleteString(key, timestamp++);
     }
 
+    [Fact]
+    public void Get_WithBufferWriter_ShouldWriteValue()
+    {
+        // Arrange
+        byte[] key = Encoding.UTF8.GetBytes("buffer_writer_key");
+        byte[] value = Encoding.UTF8.GetBytes("buffer_writer_value");
+        _client.Insert(key, value, RiocClient.GetTimestamp());
+        var writer = new System.Buffers.ArrayBufferWriter<byte>();
+
+        // Act
+        int written = _client.Get(key, writer);
+
+        // Assert
+        Assert.Equal(value.Length, written);
+        Assert.Equal(value, writer.WrittenSpan.ToArray());
+
+        _client.Delete(key, RiocClient.GetTimestamp());
+    }
+
+    [Fact]
+    public void RangeQueryPooled_ShouldReturnRows()
+    {
+        // Arrange
+        for (int i = 0; i < 3; i++)
+        {
+            _client.InsertString($"pooled_range_{i}", $"value_{i}", RiocClient.GetTimestamp());
+        }
+
+        // Act
+        using RiocRangeResult result = _client.RangeQueryPooled(
+            Encoding.UTF8.GetBytes("pooled_range_0"), Encoding.UTF8.GetBytes("pooled_range_2"));
+
+        // Assert
+        Assert.Equal(3, result.Count);
+        for (int i = 0; i < result.Count; i++)
+        {
+            Assert.Equal($"pooled_range_{i}", Encoding.UTF8.GetString(result.GetKey(i)));
+            Assert.Equal($"value_{i}", Encoding.UTF8.GetString(result.GetValue(i)));
+        }
+
+        for (int i = 0; i < 3; i++)
+        {
+            _client.DeleteString($"pooled_range_{i}", RiocClient.GetTimestamp());
+        }
+    }
+
+    [Fact]
+    public void BatchOperations_GetResponseSpan_ShouldReturnValue()
+    {
+        // Arrange
+        byte[] key = Encoding.UTF8.GetBytes("span_batch_key");
+        byte[] value = Encoding.UTF8.GetBytes("span_batch_value");
+        _client.Insert(key, value, RiocClient.GetTimestamp());
+
+        // Act
+        using var batch = _client.CreateBatch();
+        batch.AddGet(key);
+        using var tracker = batch.ExecuteAsync();
+        tracker.Wait(1000);
+
+        // Assert
+        Assert.Equal(value, tracker.GetResponseSpan(0).ToArray());
+        var writer = new System.Buffers.ArrayBufferWriter<byte>();
+        Assert.Equal(value.Length, tracker.GetResponse(0, writer));
+        Assert.Equal(value, writer.WrittenSpan.ToArray());
+
+        _client.Delete(key, RiocClient.GetTimestamp());
+    }
+
+    [Fact]
+    public async Task AsyncClient_ConcurrentOperations_ShouldSucceed()
+    {
+        // Arrange
+        await using var client = new RiocAsyncClient(_config, _logger);
+        byte[][] keys = Enumerable.Range(0, 1000)
+            .Select(i => Encoding.UTF8.GetBytes($"async_key{i}"))
+            .ToArray();
+
+        // Act
+        await Task.WhenAll(keys.Select(key => client.InsertAsync(key, key, RiocClient.GetTimestamp()).AsTask()));
+        byte[][] values = await Task.WhenAll(keys.Select(key => client.GetAsync(key).AsTask()));
+
+        // Assert
+        Assert.Equal(keys, values);
+        var writer = new System.Buffers.ArrayBufferWriter<byte>();
+        Assert.Equal(keys[0].Length, await client.GetAsync(keys[0], writer));
+        Assert.Equal(keys[0], writer.WrittenSpan.ToArray());
+
+        await Task.WhenAll(keys.Select(key => client.DeleteAsync(key, RiocClient.GetTimestamp()).AsTask()));
+        await Assert.ThrowsAsync<RiocKeyNotFoundException>(async () => await client.GetAsync(keys[0]));
+    }
+
+    [Fact]
+    public async Task AsyncClient_RangeQueryAndAtomic_ShouldSucceed()
+    {
+        // Arrange
+        await using var client = new RiocAsyncClient(_config, _logger);
+        for (int i = 0; i < 3; i++)
+        {
+            await client.InsertAsync(Encoding.UTF8.GetBytes($"async_range_{i}"),
+                                     Encoding.UTF8.GetBytes($"value_{i}"), RiocClient.GetTimestamp());
+        }
+        byte[] counter = Encoding.UTF8.GetBytes($"async_counter_{RiocClient.GetTimestamp()}");
+
+        // Act
+        using (RiocRangeResult result = await client.RangeQueryAsync(
+            Encoding.UTF8.GetBytes("async_range_0"), Encoding.UTF8.GetBytes("async_range_2")))
+        {
+            // Assert
+            Assert.Equal(3, result.Count);
+            Assert.Equal("async_range_2", Encoding.UTF8.GetString(result.GetKey(2)));
+            Assert.Equal("value_2", Encoding.UTF8.GetString(result.GetValue(2)));
+        }
+
+        Assert.Equal(10, await client.AtomicIncDecAsync(counter, 10, RiocClient.GetTimestamp()));
+        Assert.Equal(7, await client.AtomicIncDecAsync(counter, -3, RiocClient.GetTimestamp()));
+
+        await client.DeleteAsync(counter, RiocClient.GetTimestamp());
+        for (int i = 0; i < 3; i++)
+        {
+            await client.DeleteAsync(Encoding.UTF8.GetBytes($"async_range_{i}"), RiocClient.GetTimestamp());
+        }
+    }
+
+    [Fact]
+    public async Task ScanAsync_ShouldStreamRowsInOrder()
+    {
+        // Arrange
+        for (int i = 0; i < 500; i++)
+        {
+            _client.InsertString($"scan_key{i:D4}", $"value_{i}", RiocClient.GetTimestamp());
+        }
+
+        // Act
+        var keys = new List<string>();
+        await foreach (RiocRangeRow row in _client.ScanAsync(Encoding.UTF8.GetBytes("scan_key0000"),
+                                                             Encoding.UTF8.GetBytes("scan_key0499")))
+        {
+            string key = Encoding.UTF8.GetString(row.Key.Span);
+            Assert.Equal($"value_{keys.Count}", Encoding.UTF8.GetString(row.Value.Span));
+            keys.Add(key);
+        }
+
+        // Assert
+        Assert.Equal(Enumerable.Range(0, 500).Select(i => $"scan_key{i:D4}"), keys);
+
+        // Leaving early aborts the scan without affecting the client
+        await foreach (RiocRangeRow row in _client.ScanAsync(Encoding.UTF8.GetBytes("scan_key0000"),
+                                                             Encoding.UTF8.GetBytes("scan_key0499")))
+        {
+            break;
+        }
+        Assert.Equal("value_7", _client.GetString("scan_key0007"));
+
+        for (int i = 0; i < 500; i++)
+        {
+            _client.DeleteString($"scan_key{i:D4}", RiocClient.GetTimestamp());
+        }
+    }
+
+    [Fact]
+    public async Task ScanAsync_Cancelled_ShouldThrow()
+    {
+        // Arrange
+        for (int i = 0; i < 100; i++)
+        {
+            _client.InsertString($"scan_cancel{i:D3}", "value", RiocClient.GetTimestamp());
+        }
+        using var cts = new CancellationTokenSource();
+        int rows = 0;
+
+        // Act & Assert
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(async () =>
+        {
+            await foreach (RiocRangeRow row in _client.ScanAsync(Encoding.UTF8.GetBytes("scan_cancel000"),
+                                                                 Encoding.UTF8.GetBytes("scan_cancel099"), cts.Token))
+            {
+                if (++rows == 10)
+                {
+                    cts.Cancel();
+                }
+            }
+        });
+        Assert.Equal(10, rows);
+
+        for (int i = 0; i < 100; i++)
+        {
+            _client.DeleteString($"scan_cancel{i:D3}", RiocClient.GetTimestamp());
+        }
+    }
+
     public void Dispose()
     {
         _client.Dispose();
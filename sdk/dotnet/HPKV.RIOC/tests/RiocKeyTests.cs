@@ -0,0 +1,128 @@
+using Xunit;
+
+namespace HPKV.RIOC.Tests;
+
+public class RiocKeyTests
+{
+    [Fact]
+    public void Keys_MatchNativeEncoding()
+    {
+        var key = new RiocKeyBuilder();
+        key.AddUInt32(7).AddBytes("a\0b"u8).AddInt64(-9, descending: true);
+        Assert.Equal("000000076100FF6200018000000000000008", Convert.ToHexString(key.AsSpan()));
+
+        key.Clear().AddInt32(-1).AddUInt64(1, descending: true).AddString("hi", descending: true);
+        Assert.Equal("7FFFFFFFFFFFFFFFFFFFFFFE9796FFFE", Convert.ToHexString(key.AsSpan()));
+
+        key.Clear().AddInt64(0).AddString("");
+        Assert.Equal("80000000000000000001", Convert.ToHexString(key.AsSpan()));
+    }
+
+    [Fact]
+    public void Keys_SortFieldByField()
+    {
+        string[] strings = { "", "\0", "a\0b", "a", "ab", "b", "é" };
+        var fields = new List<(uint Group, string Name, long Time)>();
+        for (int i = 0; i < 300; i++)
+        {
+            fields.Add(((uint)(i % 2), strings[i * 7 % strings.Length], i * 5 % 7 - 3));
+        }
+
+        var key = new RiocKeyBuilder();
+        byte[] Encode((uint Group, string Name, long Time) f) =>
+            key.Clear().AddUInt32(f.Group).AddString(f.Name).AddInt64(f.Time, descending: true).ToArray();
+
+        var byKey = fields.OrderBy(Encode, Comparer<byte[]>.Create((a, b) => a.AsSpan().SequenceCompareTo(b))).ToList();
+        var expected = fields
+            .OrderBy(f => f.Group)
+            .ThenBy(f => System.Text.Encoding.UTF8.GetBytes(f.Name),
+                    Comparer<byte[]>.Create((a, b) => a.AsSpan().SequenceCompareTo(b)))
+            .ThenByDescending(f => f.Time)
+            .ToList();
+        Assert.Equal(expected, byKey);
+    }
+
+    [Fact]
+    public void Reader_ReadsFieldsBack()
+    {
+        byte[] key = new RiocKeyBuilder()
+            .AddUInt32(7).AddString("a\0b").AddInt64(-9, descending: true).AddBytes(new byte[] { 0 }, descending: true)
+            .ToArray();
+
+        var reader = new RiocKeyReader(key);
+        Assert.Equal(7u, reader.ReadUInt32());
+        Assert.Equal("a\0b", reader.ReadString());
+        Assert.Equal(-9L, reader.ReadInt64(descending: true));
+        Assert.Equal(new byte[] { 0 }, reader.ReadBytes(descending: true));
+        Assert.True(reader.End);
+
+        // A failed read leaves the reader where it was
+        var truncated = new RiocKeyReader(new byte[] { 0x00, 0x00, 0x00, 0x01, 0x61, 0x00 });
+        Assert.Equal(1u, truncated.ReadUInt32());
+        bool threw = false;
+        try
+        {
+            truncated.ReadString();
+        }
+        catch (FormatException)
+        {
+            threw = true;
+        }
+        Assert.True(threw);
+        Assert.Equal(4, truncated.Position);
+        Assert.Throws<FormatException>(() => new RiocKeyReader(new byte[] { 0x61, 0x00, 0x02 }).ReadBytes());
+        Assert.Throws<FormatException>(() => new RiocKeyReader(new byte[] { 0, 0 }).ReadUInt32());
+    }
+
+    [Fact]
+    public void PrefixSuccessor_BoundsPrefixScans()
+    {
+        Assert.Equal("ac"u8.ToArray(), RiocKey.PrefixSuccessor(new byte[] { 0x61, 0x62, 0xFF, 0xFF }));
+        Assert.Equal(new RiocKeyBuilder().AddUInt32(8).ToArray(),
+                     RiocKey.PrefixSuccessor(new RiocKeyBuilder().AddUInt32(7).AsSpan()));
+        Assert.Null(RiocKey.PrefixSuccessor(new byte[] { 0xFF }));
+        Assert.Null(RiocKey.PrefixSuccessor(ReadOnlySpan<byte>.Empty));
+    }
+
+    [Theory]
+    [InlineData(false)]
+    [InlineData(true)]
+    public void EncodeColumns_MatchBuilder(bool descending)
+    {
+        byte[] prefix = new RiocKeyBuilder().AddUInt32(3).ToArray();
+        long[] values = { long.MinValue, -1, 0, long.MaxValue };
+        var key = new RiocKeyBuilder();
+
+        // Prefixed keys take the strided path
+        int stride = prefix.Length + sizeof(long);
+        var keys = new byte[values.Length * stride];
+        RiocKey.FillPrefix(prefix, values.Length, keys, stride);
+        RiocKey.EncodeInt64s(values, keys.AsSpan(prefix.Length), stride, descending);
+        for (int i = 0; i < values.Length; i++)
+        {
+            key.Clear().AddRaw(prefix).AddInt64(values[i], descending);
+            Assert.Equal(key.ToArray(), keys.AsSpan(i * stride, stride).ToArray());
+        }
+
+        // Bare fields take the contiguous path
+        int[] ints = { int.MinValue, -5, 0, int.MaxValue };
+        var column = new byte[ints.Length * sizeof(int)];
+        RiocKey.EncodeInt32s(ints, column, descending: descending);
+        for (int i = 0; i < ints.Length; i++)
+        {
+            key.Clear().AddInt32(ints[i], descending);
+            Assert.Equal(key.ToArray(), column.AsSpan(i * sizeof(int), sizeof(int)).ToArray());
+        }
+
+        ulong[] ulongs = { 0, 1, ulong.MaxValue };
+        column = new byte[ulongs.Length * sizeof(ulong)];
+        RiocKey.EncodeUInt64s(ulongs, column, descending: descending);
+        for (int i = 0; i < ulongs.Length; i++)
+        {
+            key.Clear().AddUInt64(ulongs[i], descending);
+            Assert.Equal(key.ToArray(), column.AsSpan(i * sizeof(ulong), sizeof(ulong)).ToArray());
+        }
+
+        Assert.Throws<ArgumentException>(() => RiocKey.EncodeUInt32s(new uint[] { 1, 2 }, new byte[7], descending: descending));
+    }
+}
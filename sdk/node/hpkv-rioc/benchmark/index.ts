@@ -0,0 +1,346 @@
+import { readFileSync } from 'fs';
+import { RiocClient, RiocConfig } from '../src';
+
+/**
+ * Workload runner for the HPKV RIOC Node.js SDK.
+ *
+ * Executes a workload file from bench/workloads and prints one result object in the
+ * shared schema (bench/README.md), so the results can be compared with
+ * `rioc_bench --workload` to measure the per-op cost of the N-API binding.
+ *
+ * The synchronous API blocks the event loop, so every thread of the workload runs its
+ * operation sequence on its own client, one thread after another.
+ */
+
+const OP_NAMES = ['get', 'insert', 'delete', 'range_query', 'atomic_inc_dec'] as const;
+const RIOC_ERR_NOENT = -6;
+const MAX_BATCH_SIZE = 128;
+
+interface WorkloadSpec {
+  name: string;
+  threads: number;
+  ops_per_thread: number;
+  warmup_ops: number;
+  batch_size: number;
+  key_count: number;
+  key_distribution: 'uniform' | 'sequential';
+  value_size: number;
+  range_rows: number;
+  seed: number;
+  get: number;
+  insert: number;
+  delete: number;
+  range_query: number;
+  atomic_inc_dec: number;
+}
+
+interface Op {
+  type: number;
+  key: number;
+}
+
+interface ThreadStats {
+  latencies: number[];
+  opCounts: number[];
+  errors: number;
+}
+
+const DEFAULTS: WorkloadSpec = {
+  name: 'unnamed',
+  threads: 1,
+  ops_per_thread: 10000,
+  warmup_ops: 0,
+  batch_size: 1,
+  key_count: 1000,
+  key_distribution: 'uniform',
+  value_size: 100,
+  range_rows: 10,
+  seed: 1,
+  get: 0,
+  insert: 0,
+  delete: 0,
+  range_query: 0,
+  atomic_inc_dec: 0
+};
+
+function loadWorkload(path: string): WorkloadSpec {
+  const raw = JSON.parse(readFileSync(path, 'utf8'));
+  const unknown = Object.keys(raw).filter(k => k !== 'description' && !(k in DEFAULTS));
+  if (unknown.length > 0) {
+    throw new Error(`Unknown workload fields: ${unknown.join(', ')}`);
+  }
+  const spec: WorkloadSpec = { ...DEFAULTS, ...raw };
+  if (OP_NAMES.reduce((sum, name) => sum + spec[name], 0) <= 0) {
+    throw new Error('Workload mix must give at least one operation a positive weight');
+  }
+  if (spec.key_distribution !== 'uniform' && spec.key_distribution !== 'sequential') {
+    throw new Error('key_distribution must be uniform or sequential');
+  }
+  if (spec.batch_size < 1 || spec.batch_size > MAX_BATCH_SIZE) {
+    throw new Error(`batch_size must be between 1 and ${MAX_BATCH_SIZE}`);
+  }
+  return spec;
+}
+
+/**
+ * Generates the (op type, key index) sequence every runner produces for a thread.
+ */
+function generateOps(spec: WorkloadSpec, threadId: number): Op[] {
+  let state = (spec.seed + Math.imul(0x9e3779b9, threadId + 1)) >>> 0;
+  if (state === 0) {
+    state = 1;
+  }
+  const next = (): number => {
+    state ^= state << 13;
+    state ^= state >>> 17;
+    state ^= state << 5;
+    state >>>= 0;
+    return state;
+  };
+
+  const weights = OP_NAMES.map(name => spec[name]);
+  const totalWeight = weights.reduce((a, b) => a + b, 0);
+  const count = spec.warmup_ops + spec.ops_per_thread;
+  const ops: Op[] = new Array(count);
+  for (let i = 0; i < count; i++) {
+    let r = next() % totalWeight;
+    let type = 0;
+    while (r >= weights[type]) {
+      r -= weights[type];
+      type++;
+    }
+    const key = spec.key_distribution === 'sequential'
+      ? (threadId * count + i) % spec.key_count
+      : next() % spec.key_count;
+    ops[i] = { type, key };
+  }
+  return ops;
+}
+
+const dataKey = (index: number): Buffer => Buffer.from(`wl:${index.toString().padStart(8, '0')}`);
+const counterKey = (index: number): Buffer => Buffer.from(`wl:ctr:${index.toString().padStart(8, '0')}`);
+const rangeEnd = (spec: WorkloadSpec, start: number): number =>
+  Math.min(start + spec.range_rows - 1, spec.key_count - 1);
+
+function isError(err: unknown): boolean {
+  return (err as { code?: number }).code !== RIOC_ERR_NOENT;
+}
+
+/**
+ * Executes one operation through the single-op API; returns the number of failed ops.
+ */
+function executeSingle(client: RiocClient, spec: WorkloadSpec, op: Op, value: Buffer): number {
+  try {
+    switch (op.type) {
+      case 0:
+        client.get(dataKey(op.key));
+        break;
+      case 1:
+        client.insert(dataKey(op.key), value, RiocClient.getTimestamp());
+        break;
+      case 2:
+        client.delete(dataKey(op.key), RiocClient.getTimestamp());
+        break;
+      case 3:
+        client.rangeQuery(dataKey(op.key), dataKey(rangeEnd(spec, op.key)));
+        break;
+      default:
+        client.atomicIncDec(counterKey(op.key), 1, RiocClient.getTimestamp());
+        break;
+    }
+  } catch (err) {
+    return isError(err) ? 1 : 0;
+  }
+  return 0;
+}
+
+/**
+ * Executes ops as one batch and materializes every result; returns the number of failed ops.
+ */
+function executeBatch(client: RiocClient, spec: WorkloadSpec, ops: Op[], value: Buffer): number {
+  const batch = client.createBatch();
+  try {
+    for (const op of ops) {
+      switch (op.type) {
+        case 0:
+          batch.addGet(dataKey(op.key));
+          break;
+        case 1:
+          batch.addInsert(dataKey(op.key), value, RiocClient.getTimestamp());
+          break;
+        case 2:
+          batch.addDelete(dataKey(op.key), RiocClient.getTimestamp());
+          break;
+        case 3:
+          batch.addRangeQuery(dataKey(op.key), dataKey(rangeEnd(spec, op.key)));
+          break;
+        default:
+          batch.addAtomicIncDec(counterKey(op.key), 1, RiocClient.getTimestamp());
+          break;
+      }
+    }
+    const tracker = batch.executeAsync();
+    try {
+      tracker.wait();
+      let errors = 0;
+      ops.forEach((op, i) => {
+        try {
+          if (op.type === 3) {
+            tracker.getRangeQueryResponse(i);
+          } else if (op.type === 4) {
+            tracker.getAtomicResult(i);
+          } else {
+            tracker.getResponse(i);
+          }
+        } catch (err) {
+          errors += isError(err) ? 1 : 0;
+        }
+      });
+      return errors;
+    } finally {
+      tracker.dispose();
+    }
+  } catch {
+    return ops.length;
+  } finally {
+    batch.dispose();
+  }
+}
+
+function runOps(client: RiocClient, spec: WorkloadSpec, ops: Op[], value: Buffer, stats?: ThreadStats): void {
+  for (let i = 0; i < ops.length; i += spec.batch_size) {
+    const chunk = ops.slice(i, i + spec.batch_size);
+    const start = process.hrtime.bigint();
+    const errors = spec.batch_size === 1
+      ? executeSingle(client, spec, chunk[0], value)
+      : executeBatch(client, spec, chunk, value);
+    const end = process.hrtime.bigint();
+    if (stats) {
+      stats.latencies.push(Number(end - start) / 1000);
+      stats.errors += errors;
+      for (const op of chunk) {
+        stats.opCounts[op.type]++;
+      }
+    }
+  }
+}
+
+/**
+ * Preloads the data keys, or deletes them and the counters after the run.
+ */
+function prepareKeys(client: RiocClient, spec: WorkloadSpec, value: Buffer, remove: boolean): void {
+  const keySets = remove ? [dataKey, counterKey] : [dataKey];
+  for (const makeKey of keySets) {
+    for (let start = 0; start < spec.key_count; start += MAX_BATCH_SIZE) {
+      const batch = client.createBatch();
+      try {
+        for (let i = start; i < Math.min(start + MAX_BATCH_SIZE, spec.key_count); i++) {
+          if (remove) {
+            batch.addDelete(makeKey(i), RiocClient.getTimestamp());
+          } else {
+            batch.addInsert(makeKey(i), value, RiocClient.getTimestamp());
+          }
+        }
+        const tracker = batch.executeAsync();
+        try {
+          tracker.wait();
+        } finally {
+          tracker.dispose();
+        }
+      } finally {
+        batch.dispose();
+      }
+    }
+  }
+}
+
+function argValue(name: string, fallback: string): string {
+  const index = process.argv.indexOf(name);
+  return index >= 0 && index + 1 < process.argv.length ? process.argv[index + 1] : fallback;
+}
+
+function main(): void {
+  const workloadPath = process.argv[2];
+  if (!workloadPath || workloadPath.startsWith('--')) {
+    console.error('Usage: npm run benchmark -- <workload.json> [--host HOST] [--port PORT] [--tls]');
+    process.exit(1);
+  }
+
+  const spec = loadWorkload(workloadPath);
+  const host = argValue('--host', '127.0.0.1');
+  const config: RiocConfig = {
+    host,
+    port: parseInt(argValue('--port', '8000'), 10),
+    timeoutMs: 5000
+  };
+  if (process.argv.includes('--tls')) {
+    config.tls = {
+      caPath: process.env.RIOC_CA_PATH || '',
+      certificatePath: process.env.RIOC_CERT_PATH || '',
+      keyPath: process.env.RIOC_KEY_PATH || '',
+      verifyHostname: host,
+      verifyPeer: !!process.env.RIOC_CA_PATH
+    };
+  }
+
+  console.error(`Workload ${spec.name}: ${spec.threads} threads x ${spec.ops_per_thread} ops, ` +
+    `batch size ${spec.batch_size}, ${spec.key_count} keys, ${spec.value_size} byte values`);
+
+  const value = Buffer.alloc(spec.value_size, 'x');
+  const client = new RiocClient(config);
+  try {
+    prepareKeys(client, spec, value, false);
+
+    const stats: ThreadStats = { latencies: [], opCounts: OP_NAMES.map(() => 0), errors: 0 };
+    const threadClients: RiocClient[] = [];
+    const threadOps: Op[][] = [];
+    for (let t = 0; t < spec.threads; t++) {
+      threadClients.push(new RiocClient(config));
+      threadOps.push(generateOps(spec, t));
+      runOps(threadClients[t], spec, threadOps[t].slice(0, spec.warmup_ops), value);
+    }
+
+    const start = process.hrtime.bigint();
+    for (let t = 0; t < spec.threads; t++) {
+      runOps(threadClients[t], spec, threadOps[t].slice(spec.warmup_ops), value, stats);
+    }
+    const elapsedSec = Number(process.hrtime.bigint() - start) / 1e9;
+    threadClients.forEach(c => c.dispose());
+
+    const latencies = stats.latencies.sort((a, b) => a - b);
+    const percentile = (q: number): number =>
+      latencies[Math.min(Math.floor(latencies.length * q), latencies.length - 1)];
+    const round = (v: number, digits: number): number => Number(v.toFixed(digits));
+    const ops = stats.opCounts.reduce((a, b) => a + b, 0);
+    const result = {
+      schema: 'rioc-bench-result/1',
+      runner: 'node',
+      workload: spec.name,
+      threads: 1,
+      batch_size: spec.batch_size,
+      value_size: spec.value_size,
+      ops,
+      calls: latencies.length,
+      errors: stats.errors,
+      ops_by_type: Object.fromEntries(OP_NAMES.map((name, i) => [name, stats.opCounts[i]])),
+      elapsed_sec: round(elapsedSec, 6),
+      ops_per_sec: round(elapsedSec > 0 ? ops / elapsedSec : 0, 2),
+      latency_us: {
+        min: round(latencies[0], 3),
+        avg: round(latencies.reduce((a, b) => a + b, 0) / latencies.length, 3),
+        p50: round(percentile(0.5), 3),
+        p95: round(percentile(0.95), 3),
+        p99: round(percentile(0.99), 3),
+        p999: round(percentile(0.999), 3),
+        max: round(latencies[latencies.length - 1], 3)
+      }
+    };
+    console.log(JSON.stringify(result));
+
+    prepareKeys(client, spec, value, true);
+  } finally {
+    client.dispose();
+  }
+}
+
+main();
@@ -1,4 +1,5 @@
 /// <reference types="node" />
+import { Readable } from 'stream';
 import { RiocConfig } from './config';
 import { createError } from './errors';
 import Debug from 'debug';
@@ -16,6 +17,14 @@ export interface RangeQueryResult {
   value: Buffer;
 }
 
+/**
+ * A handle to a client's native connection that can be posted to a worker thread.
+ * It does not keep the connection open; see {@link RiocClient.share}.
+ */
+export interface RiocSharedHandle {
+  readonly riocSharedConnection: number;
+}
+
 /**
  * Main client class for interacting with RIOC.
  */
@@ -25,11 +34,42 @@ export class RiocClient {
 
   /**
    * Creates a new RIOC client.
-   * @param config The client configuration.
+   * @param config The client configuration, or a handle from {@link RiocClient.share}.
+   */
+  constructor(config: RiocConfig | RiocSharedHandle) {
+    if ('riocSharedConnection' in config) {
+      debug('Attaching to shared connection', config.riocSharedConnection);
+      this.client = new native.RiocClient(config.riocSharedConnection);
+    } else {
+      debug('Initializing client with config:', config);
+      this.client = new native.RiocClient(config);
+    }
+  }
+
+  /**
+   * Creates a client on a connection shared by another thread.
+   * @param handle A handle from {@link RiocClient.share}, posted to this thread.
    */
-  constructor(config: RiocConfig) {
-    debug('Initializing client with config:', config);
-    this.client = new native.RiocClient(config);
+  static fromShared(handle: RiocSharedHandle): RiocClient {
+    return new RiocClient(handle);
+  }
+
+  /**
+   * Shares this client's asynchronous connection with other worker threads.
+   *
+   * The handle is plain data, so it can be passed in `workerData` or `postMessage`. A client
+   * created from it in another thread sends its operations over the same thread-safe native
+   * connection instead of opening its own; its synchronous methods block that thread until
+   * the I/O thread completes them. The connection is closed once every client using it has
+   * been disposed. Batches need a connection of their own and are not available on a client
+   * created from a handle.
+   * @returns A handle for {@link RiocClient.fromShared}.
+   */
+  share(): RiocSharedHandle {
+    if (this.isDisposed) {
+      throw new Error('Client is disposed');
+    }
+    return { riocSharedConnection: this.client.share() };
   }
 
   /**
@@ -82,6 +122,24 @@ export class RiocClient {
     return this.client.rangeQuery(startKey, endKey);
   }
 
+  /**
+   * Streams the key-value pairs within the specified range.
+   *
+   * Rows are read incrementally on a dedicated connection, and only while the stream's
+   * buffer has room, so a scan of any size can be piped to a file or an HTTP response
+   * without holding it in memory. Destroying the stream before its end aborts the scan.
+   * @param startKey The start key of the range (inclusive).
+   * @param endKey The end key of the range (inclusive).
+   * @param options Stream options; highWaterMark is the number of rows to buffer.
+   * @returns An object-mode stream of key-value pairs in key order.
+   */
+  rangeQueryStream(startKey: Buffer, endKey: Buffer, options?: { highWaterMark?: number }): RangeQueryStream {
+    if (this.isDisposed) {
+      throw new Error('Client is disposed');
+    }
+    return new RangeQueryStream(this.client.createRangeCursor(startKey, endKey), options?.highWaterMark);
+  }
+
   /**
    * Creates a new batch operation.
    * @returns A new batch instance.
@@ -114,8 +172,77 @@ export class RiocClient {
     return this.client.atomicIncDec(key, value, timestamp);
   }
 
+  /**
+   * Gets a value by key without blocking the event loop.
+   *
+   * Asynchronous operations run on a second connection owned by a native I/O thread,
+   * which sends everything issued during one round trip as a single batch.
+   * @param key The key to get.
+   * @returns A promise for the value; rejects with code -6 if the key is not found.
+   */
+  getAsync(key: Buffer): Promise<Buffer | null> {
+    if (this.isDisposed) {
+      return Promise.reject(new Error('Client is disposed'));
+    }
+    return this.client.getAsync(key);
+  }
+
+  /**
+   * Inserts or updates a key-value pair without blocking the event loop.
+   * @param key The key to insert.
+   * @param value The value to insert.
+   * @param timestamp The timestamp for the operation.
+   */
+  insertAsync(key: Buffer, value: Buffer, timestamp: bigint): Promise<void> {
+    if (this.isDisposed) {
+      return Promise.reject(new Error('Client is disposed'));
+    }
+    return this.client.insertAsync(key, value, timestamp);
+  }
+
+  /**
+   * Deletes a key-value pair without blocking the event loop.
+   * @param key The key to delete.
+   * @param timestamp The timestamp for the operation.
+   */
+  deleteAsync(key: Buffer, timestamp: bigint): Promise<void> {
+    if (this.isDisposed) {
+      return Promise.reject(new Error('Client is disposed'));
+    }
+    return this.client.deleteAsync(key, timestamp);
+  }
+
+  /**
+   * Performs a range query without blocking the event loop.
+   * @param startKey The start key of the range (inclusive).
+   * @param endKey The end key of the range (inclusive).
+   * @returns A promise for the key-value pairs within the specified range.
+   */
+  rangeQueryAsync(startKey: Buffer, endKey: Buffer): Promise<RangeQueryResult[]> {
+    if (this.isDisposed) {
+      return Promise.reject(new Error('Client is disposed'));
+    }
+    return this.client.rangeQueryAsync(startKey, endKey);
+  }
+
+  /**
+   * Atomically increments or decrements a counter without blocking the event loop.
+   * @param key The key of the counter.
+   * @param value The value to add (positive) or subtract (negative).
+   * @param timestamp The timestamp for the operation.
+   * @returns A promise for the new value of the counter.
+   */
+  atomicIncDecAsync(key: Buffer, value: number, timestamp: bigint): Promise<bigint> {
+    if (this.isDisposed) {
+      return Promise.reject(new Error('Client is disposed'));
+    }
+    return this.client.atomicIncDecAsync(key, value, timestamp);
+  }
+
   /**
    * Disposes the client resources.
+   *
+   * Pending asynchronous operations are completed before the connection is closed.
    */
   dispose(): void {
     if (!this.isDisposed) {
@@ -126,23 +253,115 @@ export class RiocClient {
   }
 }
 
+// The first chunk is small so rows are delivered as soon as they arrive; later chunks
+// grow to amortize the hop to the libuv thread pool
+const INITIAL_STREAM_CHUNK_SIZE = 4 * 1024;
+const MAX_STREAM_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * A readable stream of range query rows, fed from a native cursor.
+ * The native side reads the next chunk of rows only when the stream asks for more, so a
+ * slow consumer stops reads from the socket and TCP flow control holds the server back.
+ * Row buffers are views into the chunk they were read with.
+ */
+export class RangeQueryStream extends Readable {
+  private reading = false;
+  private chunkSize = INITIAL_STREAM_CHUNK_SIZE;
+
+  constructor(private cursor: any, highWaterMark = 1024) {
+    super({ objectMode: true, highWaterMark });
+  }
+
+  _read(): void {
+    if (this.reading) {
+      return;
+    }
+    this.reading = true;
+    this.cursor.read(this.chunkSize).then((chunk: Buffer | null) => {
+      this.reading = false;
+      if (this.destroyed) {
+        return;
+      }
+      if (chunk === null) {
+        this.push(null);
+        return;
+      }
+      this.chunkSize = Math.min(this.chunkSize * 2, MAX_STREAM_CHUNK_SIZE);
+
+      // Rows are packed as a uint32 key length, a uint32 value length, the key and the value
+      for (let position = 0; position < chunk.length;) {
+        const keyLen = chunk.readUInt32LE(position);
+        const valueLen = chunk.readUInt32LE(position + 4);
+        position += 8;
+        const key = chunk.subarray(position, position + keyLen);
+        position += keyLen;
+        const value = chunk.subarray(position, position + valueLen);
+        position += valueLen;
+        this.push({ key, value });
+      }
+    }, (error: any) => {
+      this.reading = false;
+      this.destroy(createError(error.code ?? -3, 'Failed to read range query rows')); // RIOC_ERR_IO
+    });
+  }
+
+  _destroy(error: Error | null, callback: (error?: Error | null) => void): void {
+    debug('Closing range query stream');
+    this.cursor.close();
+    callback(error);
+  }
+}
+
+// Wire layout shared with rioc_batch_add_packed and rioc_batch_get_packed_responses
+const CMD_GET = 1;
+const CMD_INSERT = 2;
+const CMD_DELETE = 3;
+const CMD_RANGE_QUERY = 6;
+const CMD_ATOMIC_INC_DEC = 7;
+const OP_HEADER_SIZE = 16;
+const RESULT_HEADER_SIZE = 16;
+const MAX_BATCH_SIZE = 128;
+const MAX_KEY_SIZE = 512;
+const MAX_VALUE_SIZE = 100 * 1024;
+
+interface PackedOp {
+  command: number;
+  key: Buffer;
+  value: Buffer | null;
+  timestamp: bigint;
+}
+
 /**
  * Represents a batch of operations to be executed together.
+ * Operations are collected in JavaScript and handed to the native batch in one call.
  */
 export class RiocBatch {
   private isDisposed = false;
+  private pending: PackedOp[] = [];
+  private pendingBytes = 0;
+  private count = 0;
 
   constructor(private batch: any) {}
 
+  private add(command: number, key: Buffer, value: Buffer | null, timestamp: bigint, name: string): void {
+    if (this.isDisposed) {
+      throw new Error('Batch is disposed');
+    }
+    const valueLen = value ? value.length : 0;
+    if (this.count >= MAX_BATCH_SIZE || key.length > MAX_KEY_SIZE || valueLen > MAX_VALUE_SIZE) {
+      throw createError(-1, `Failed to add ${name} operation to batch`); // RIOC_ERR_PARAM
+    }
+    this.pending.push({ command, key, value, timestamp });
+    this.pendingBytes += OP_HEADER_SIZE + key.length + valueLen;
+    this.count++;
+  }
+
   /**
    * Adds a get operation to the batch.
    * @param key The key to get.
    */
   addGet(key: Buffer): void {
-    if (this.isDisposed) {
-      throw new Error('Batch is disposed');
-    }
-    this.batch.addGet(key);
+    this.add(CMD_GET, key, null, 0n, 'get');
   }
 
   /**
@@ -152,10 +371,7 @@ export class RiocBatch {
    * @param timestamp The timestamp for the operation.
    */
   addInsert(key: Buffer, value: Buffer, timestamp: bigint): void {
-    if (this.isDisposed) {
-      throw new Error('Batch is disposed');
-    }
-    this.batch.addInsert(key, value, timestamp);
+    this.add(CMD_INSERT, key, value, timestamp, 'insert');
   }
 
   /**
@@ -164,10 +380,7 @@ export class RiocBatch {
    * @param timestamp The timestamp for the operation.
    */
   addDelete(key: Buffer, timestamp: bigint): void {
-    if (this.isDisposed) {
-      throw new Error('Batch is disposed');
-    }
-    this.batch.addDelete(key, timestamp);
+    this.add(CMD_DELETE, key, null, timestamp, 'delete');
   }
 
   /**
@@ -176,10 +389,10 @@ export class RiocBatch {
    * @param endKey The end key of the range (inclusive).
    */
   addRangeQuery(startKey: Buffer, endKey: Buffer): void {
-    if (this.isDisposed) {
-      throw new Error('Batch is disposed');
+    if (endKey.length > MAX_KEY_SIZE) {
+      throw createError(-1, 'Failed to add range query operation to batch'); // RIOC_ERR_PARAM
     }
-    this.batch.addRangeQuery(startKey, endKey);
+    this.add(CMD_RANGE_QUERY, startKey, endKey, 0n, 'range query');
   }
 
   /**
@@ -189,10 +402,35 @@ export class RiocBatch {
    * @param timestamp The timestamp for the operation.
    */
   addAtomicIncDec(key: Buffer, value: number, timestamp: bigint): void {
-    if (this.isDisposed) {
-      throw new Error('Batch is disposed');
+    const increment = Buffer.allocUnsafe(8);
+    increment.writeBigInt64LE(BigInt(Math.trunc(value)));
+    this.add(CMD_ATOMIC_INC_DEC, key, increment, timestamp, 'atomic increment/decrement');
+  }
+
+  // Packs the operations added since the last call into the native batch
+  private flush(): void {
+    if (this.pending.length === 0) {
+      return;
     }
-    this.batch.addAtomicIncDec(key, value, timestamp);
+
+    // Records use the host byte order of the native library, little-endian on every supported platform
+    const packed = Buffer.allocUnsafe(this.pendingBytes);
+    let offset = 0;
+    for (const op of this.pending) {
+      const valueLen = op.value ? op.value.length : 0;
+      offset = packed.writeUInt16LE(op.command, offset);
+      offset = packed.writeUInt16LE(op.key.length, offset);
+      offset = packed.writeUInt32LE(valueLen, offset);
+      offset = packed.writeBigUInt64LE(op.timestamp, offset);
+      offset += op.key.copy(packed, offset);
+      if (op.value) {
+        offset += op.value.copy(packed, offset);
+      }
+    }
+
+    this.pending = [];
+    this.pendingBytes = 0;
+    this.batch.addPacked(packed);
   }
 
   /**
@@ -203,6 +441,7 @@ export class RiocBatch {
     if (this.isDisposed) {
       throw new Error('Batch is disposed');
     }
+    this.flush();
     return new RiocBatchTracker(this.batch.executeAsync());
   }
 
@@ -220,9 +459,14 @@ export class RiocBatch {
 
 /**
  * Tracks the execution of a batch operation.
+ * All responses are fetched from the native tracker in one call on first read and sliced lazily;
+ * returned buffers are views into that single copy.
  */
 export class RiocBatchTracker {
   private isDisposed = false;
+  private packed: Buffer | null = null;
+  private offsets: number[] = [];
+  private responses: unknown[] = [];
 
   constructor(private tracker: any) {}
 
@@ -237,16 +481,61 @@ export class RiocBatchTracker {
     this.tracker.wait(timeoutMs);
   }
 
+  /**
+   * Waits for the batch execution to complete on a worker thread.
+   * @param timeoutMs Optional timeout in milliseconds.
+   */
+  waitAsync(timeoutMs?: number): Promise<void> {
+    if (this.isDisposed) {
+      return Promise.reject(new Error('Tracker is disposed'));
+    }
+    return this.tracker.waitAsync(timeoutMs);
+  }
+
+  // Returns the offset of the result header of an operation
+  private resultOffset(index: number): number {
+    if (this.isDisposed) {
+      throw new Error('Tracker is disposed');
+    }
+    if (!this.packed) {
+      const packed: Buffer = this.tracker.getPackedResponses();
+      for (let offset = 0; offset < packed.length;) {
+        this.offsets.push(offset);
+        offset += RESULT_HEADER_SIZE + Number(packed.readBigUInt64LE(offset + 8));
+      }
+      this.packed = packed;
+    }
+    if (!Number.isInteger(index) || index < 0 || index >= this.offsets.length) {
+      throw createError(-1, 'Invalid batch operation index'); // RIOC_ERR_PARAM
+    }
+    return this.offsets[index];
+  }
+
   /**
    * Gets the response for a specific operation in the batch.
    * @param index The index of the operation.
    * @returns The response value if it's a get operation.
    */
   getResponse(index: number): Buffer | null {
-    if (this.isDisposed) {
-      throw new Error('Tracker is disposed');
+    const offset = this.resultOffset(index);
+    if (this.responses[index] !== undefined) {
+      return this.responses[index] as Buffer;
+    }
+
+    const packed = this.packed!;
+    const status = packed.readInt32LE(offset);
+    if (status === -6) { // RIOC_ERR_NOENT
+      return null;
+    }
+    if (status !== 0) {
+      throw createError(status, 'Failed to get batch response');
     }
-    return this.tracker.getResponse(index);
+
+    const dataLen = Number(packed.readBigUInt64LE(offset + 8));
+    const start = offset + RESULT_HEADER_SIZE;
+    const value = dataLen > 0 ? packed.subarray(start, start + dataLen) : null;
+    this.responses[index] = value;
+    return value;
   }
 
   /**
@@ -255,10 +544,34 @@ export class RiocBatchTracker {
    * @returns An array of key-value pairs within the specified range.
    */
   getRangeQueryResponse(index: number): RangeQueryResult[] {
-    if (this.isDisposed) {
-      throw new Error('Tracker is disposed');
+    const offset = this.resultOffset(index);
+    if (this.responses[index] !== undefined) {
+      return this.responses[index] as RangeQueryResult[];
     }
-    return this.tracker.getRangeQueryResponse(index);
+
+    const packed = this.packed!;
+    const status = packed.readInt32LE(offset);
+    if (status !== 0) {
+      throw createError(status, 'Failed to get batch response');
+    }
+
+    const count = packed.readUInt32LE(offset + 4);
+    const results: RangeQueryResult[] = [];
+    let position = offset + RESULT_HEADER_SIZE;
+    for (let i = 0; i < count; i++) {
+      const keyLen = packed.readUInt32LE(position);
+      const valueLen = packed.readUInt32LE(position + 4);
+      position += 8;
+      const key = packed.subarray(position, position + keyLen);
+      position += keyLen;
+      const value = packed.subarray(position, position + valueLen);
+      position += valueLen;
+      results.push({ key, value });
+    }
+
+    const response = count > 0 ? results : null;
+    this.responses[index] = response;
+    return response as RangeQueryResult[];
   }
 
   /**
@@ -267,10 +580,15 @@ export class RiocBatchTracker {
    * @returns The new value of the counter after the operation.
    */
   getAtomicResult(index: number): bigint {
-    if (this.isDisposed) {
-      throw new Error('Tracker is disposed');
+    const offset = this.resultOffset(index);
+    const packed = this.packed!;
+    const status = packed.readInt32LE(offset);
+    if (status !== 0) {
+      throw createError(status, 'Failed to get atomic result from batch');
     }
-    return this.tracker.getAtomicResult(index);
+
+    const dataLen = Number(packed.readBigUInt64LE(offset + 8));
+    return dataLen >= 8 ? packed.readBigInt64LE(offset + RESULT_HEADER_SIZE) : 0n;
   }
 
   /**
@@ -283,4 +601,4 @@ export class RiocBatchTracker {
       this.isDisposed = true;
     }
   }
-}
\ No newline at end of file
+}
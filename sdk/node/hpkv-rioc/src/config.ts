@@ -29,6 +29,19 @@ export interface RiocTlsConfig {
   verifyPeer?: boolean;
 }
 
+/**
+ * Client options for {@link RiocConfig.flags}; combine them with `|`.
+ */
+export enum RiocClientFlags {
+  None = 0,
+  /** Map batch value buffers with 2MB huge pages, falling back to ordinary pages. */
+  HugePages = 0x1,
+  /** Pin the response threads to {@link RiocConfig.cpu} and place buffers on its NUMA node (Linux only). */
+  PinCpu = 0x2,
+  /** Spin instead of sleeping while waiting for responses, trading a CPU core for latency. */
+  BusyPoll = 0x4
+}
+
 /**
  * Configuration options for RIOC client.
  */
@@ -53,4 +66,16 @@ export interface RiocConfig {
    * TLS configuration.
    */
   tls?: RiocTlsConfig;
+
+  /**
+   * Client options, a combination of {@link RiocClientFlags}.
+   * @default RiocClientFlags.None
+   */
+  flags?: number;
+
+  /**
+   * CPU for {@link RiocClientFlags.PinCpu}.
+   * @default 0
+   */
+  cpu?: number;
 }
\ No newline at end of file
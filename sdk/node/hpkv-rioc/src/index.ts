@@ -1,5 +1,5 @@
-export { RiocClient, RiocBatch, RiocBatchTracker, RangeQueryResult } from './client';
-export { RiocConfig, RiocTlsConfig } from './config';
+export { RiocClient, RiocBatch, RiocBatchTracker, RangeQueryResult, RangeQueryStream, RiocSharedHandle } from './client';
+export { RiocConfig, RiocTlsConfig, RiocClientFlags } from './config';
 export {
   RiocError,
   RiocKeyNotFoundError,
@@ -9,4 +9,5 @@ export {
   RiocProtocolError,
   RiocDeviceError,
   RiocBusyError
-} from './errors';
\ No newline at end of file
+} from './errors';
+export * as keys from './keys';
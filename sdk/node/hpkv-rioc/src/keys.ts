@@ -0,0 +1,236 @@
+/**
+ * Order-preserving key encoding.
+ *
+ * Range queries compare keys as raw bytes. Keys built here compare field by field in
+ * the fields' own order, and are byte for byte the keys the rioc_key_* C functions build:
+ * - Integers are big-endian with the sign bit flipped for signed types.
+ * - Strings (UTF-8) and Buffers escape 0x00 as 0x00 0xFF and end with 0x00 0x01, so a
+ *   string sorts before any longer string it is a prefix of.
+ * - Fields wrapped with desc() are complemented, so they sort in reverse.
+ */
+
+export type KeyIntKind = 'u32' | 'u64' | 'i32' | 'i64';
+export type KeyKind = KeyIntKind | 'string' | 'bytes' | { desc: KeyKind };
+
+/**
+ * An integer key field of a fixed width.
+ */
+export class KeyInt {
+  constructor(readonly kind: KeyIntKind, readonly value: number | bigint) {}
+}
+
+/**
+ * A key field that sorts in reverse.
+ */
+export class KeyDesc {
+  constructor(readonly field: KeyField) {}
+}
+
+/**
+ * A key field. Plain numbers and bigints encode as i64.
+ */
+export type KeyField = number | bigint | string | Buffer | KeyInt | KeyDesc;
+
+export const u32 = (value: number | bigint): KeyInt => new KeyInt('u32', value);
+export const u64 = (value: number | bigint): KeyInt => new KeyInt('u64', value);
+export const i32 = (value: number | bigint): KeyInt => new KeyInt('i32', value);
+export const i64 = (value: number | bigint): KeyInt => new KeyInt('i64', value);
+export const desc = (field: KeyField): KeyDesc => new KeyDesc(field);
+
+const WIDTH: Record<KeyIntKind, number> = { u32: 4, u64: 8, i32: 4, i64: 8 };
+const TERMINATOR = Buffer.from([0x00, 0x01]);
+
+function complement(buf: Buffer): Buffer {
+  for (let i = 0; i < buf.length; i++) {
+    buf[i] = ~buf[i] & 0xff;
+  }
+  return buf;
+}
+
+function encodeInt(kind: KeyIntKind, value: number | bigint): Buffer {
+  const buf = Buffer.allocUnsafe(WIDTH[kind]);
+  switch (kind) {
+    case 'u32':
+      buf.writeUInt32BE(Number(value));
+      break;
+    case 'i32':
+      buf.writeUInt32BE((Number(value) ^ 0x80000000) >>> 0);
+      break;
+    case 'u64':
+      buf.writeBigUInt64BE(BigInt(value));
+      break;
+    case 'i64':
+      buf.writeBigUInt64BE(BigInt.asUintN(64, BigInt(value)) ^ (1n << 63n));
+      break;
+  }
+  return buf;
+}
+
+function encodeString(value: Buffer): Buffer {
+  const parts: Buffer[] = [];
+  let start = 0;
+  for (let zero = value.indexOf(0); zero >= 0; zero = value.indexOf(0, start)) {
+    parts.push(value.subarray(start, zero + 1), Buffer.from([0xff]));
+    start = zero + 1;
+  }
+  parts.push(value.subarray(start), TERMINATOR);
+  return Buffer.concat(parts);
+}
+
+function encodeField(field: KeyField): Buffer {
+  if (field instanceof KeyDesc) {
+    return complement(encodeField(field.field));
+  }
+  if (field instanceof KeyInt) {
+    return encodeInt(field.kind, field.value);
+  }
+  if (typeof field === 'number' || typeof field === 'bigint') {
+    if (typeof field === 'number' && !Number.isSafeInteger(field)) {
+      throw new RangeError(`key field ${field} is not a safe integer`);
+    }
+    return encodeInt('i64', field);
+  }
+  if (typeof field === 'string') {
+    return encodeString(Buffer.from(field, 'utf8'));
+  }
+  if (Buffer.isBuffer(field)) {
+    return encodeString(field);
+  }
+  throw new TypeError(`unsupported key field ${String(field)}`);
+}
+
+/**
+ * Encodes fields into one key.
+ */
+export function encodeKey(...fields: KeyField[]): Buffer {
+  return Buffer.concat(fields.map(encodeField));
+}
+
+function decodeField(kind: KeyKind, key: Buffer, pos: number): [unknown, number] {
+  if (typeof kind === 'object') {
+    // The field's length is only known once decoded, so complement the rest
+    const rest = complement(Buffer.from(key.subarray(pos)));
+    const [value, used] = decodeField(kind.desc, rest, 0);
+    return [value, pos + used];
+  }
+  if (kind === 'string' || kind === 'bytes') {
+    const parts: Buffer[] = [];
+    for (;;) {
+      const zero = key.indexOf(0, pos);
+      if (zero < 0 || zero + 1 >= key.length) {
+        throw new RangeError('key ends inside a string field');
+      }
+      parts.push(key.subarray(pos, zero));
+      const marker = key[zero + 1];
+      pos = zero + 2;
+      if (marker === 0x01) {
+        break;
+      }
+      if (marker !== 0xff) {
+        throw new RangeError('invalid escape in a string field');
+      }
+      parts.push(Buffer.from([0]));
+    }
+    const value = Buffer.concat(parts);
+    return [kind === 'string' ? value.toString('utf8') : value, pos];
+  }
+  const width = WIDTH[kind];
+  if (width === undefined) {
+    throw new TypeError(`unsupported key field kind ${String(kind)}`);
+  }
+  if (key.length - pos < width) {
+    throw new RangeError('key ends inside an integer field');
+  }
+  switch (kind) {
+    case 'u32':
+      return [key.readUInt32BE(pos), pos + 4];
+    case 'i32':
+      return [(key.readUInt32BE(pos) ^ 0x80000000) | 0, pos + 4];
+    case 'u64':
+      return [key.readBigUInt64BE(pos), pos + 8];
+    case 'i64':
+      return [BigInt.asIntN(64, key.readBigUInt64BE(pos) ^ (1n << 63n)), pos + 8];
+  }
+}
+
+/**
+ * Decodes a key built from fields of the given kinds, such as a range query row's key.
+ * u32 and i32 fields decode to numbers, u64 and i64 fields to bigints.
+ * @throws RangeError if the key does not match the kinds.
+ */
+export function decodeKey(key: Buffer, ...kinds: KeyKind[]): unknown[] {
+  let pos = 0;
+  const values = kinds.map((kind) => {
+    const [value, next] = decodeField(kind, key, pos);
+    pos = next;
+    return value;
+  });
+  if (pos !== key.length) {
+    throw new RangeError('key has bytes after its last field');
+  }
+  return values;
+}
+
+/**
+ * Returns the smallest key above every key that starts with prefix, as the end key of
+ * a scan over the prefix. Range ends are inclusive, but keys built from the same fields
+ * as the prefix are always longer than the successor.
+ * @returns null if the prefix is empty or all 0xFF bytes, when no key bounds the scan.
+ */
+export function prefixSuccessor(prefix: Buffer): Buffer | null {
+  let len = prefix.length;
+  while (len > 0 && prefix[len - 1] === 0xff) {
+    len--;
+  }
+  if (len === 0) {
+    return null;
+  }
+  const successor = Buffer.from(prefix.subarray(0, len));
+  successor[len - 1]++;
+  return successor;
+}
+
+/**
+ * Encodes many keys of the form prefix + one integer field. All keys are written into
+ * one allocation and returned as views of it.
+ */
+export function encodeKeys(
+  values: ArrayLike<number | bigint>,
+  kind: KeyIntKind = 'i64',
+  prefix: Buffer = Buffer.alloc(0),
+  descending = false
+): Buffer[] {
+  const width = WIDTH[kind];
+  if (width === undefined) {
+    throw new TypeError(`unsupported key field kind ${String(kind)}`);
+  }
+  const stride = prefix.length + width;
+  const out = Buffer.allocUnsafe(values.length * stride);
+  const view = new DataView(out.buffer, out.byteOffset, out.byteLength);
+  const flip32 = descending ? 0xffffffff : 0;
+  const flip64 = descending ? 0xffffffffffffffffn : 0n;
+  const keys: Buffer[] = new Array(values.length);
+
+  for (let i = 0; i < values.length; i++) {
+    const at = i * stride;
+    prefix.copy(out, at);
+    const value = values[i];
+    switch (kind) {
+      case 'u32':
+        view.setUint32(at + prefix.length, (Number(value) ^ flip32) >>> 0);
+        break;
+      case 'i32':
+        view.setUint32(at + prefix.length, (Number(value) ^ 0x80000000 ^ flip32) >>> 0);
+        break;
+      case 'u64':
+        view.setBigUint64(at + prefix.length, BigInt.asUintN(64, BigInt(value) ^ flip64));
+        break;
+      case 'i64':
+        view.setBigUint64(at + prefix.length,
+          BigInt.asUintN(64, BigInt(value) ^ (1n << 63n) ^ flip64));
+        break;
+    }
+    keys[i] = out.subarray(at, at + stride);
+  }
+  return keys;
+}
@@ -1,7 +1,11 @@
 #include "binding.h"
 #include <string>
+#include <cstring>
 #include <memory>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 
 // Define the range result struct to match the C API
 struct rioc_range_result {
@@ -11,9 +15,120 @@ struct rioc_range_result {
   size_t value_len;
 };
 
-Napi::FunctionReference RiocClient::constructor;
-Napi::FunctionReference RiocBatch::constructor;
-Napi::FunctionReference RiocBatchTracker::constructor;
+// Values at least this large are handed to JS without a copy. Smaller values are
+// copied, since an external buffer's finalizer costs more than copying them.
+static const size_t kExternalBufferThreshold = 1024;
+
+// Wraps a value allocated by the C library in a Buffer that takes ownership of it.
+// Memory the binding allocated itself passes free as the release function.
+static Napi::Buffer<char> TakeBuffer(Napi::Env env, char* data, size_t length,
+                                     void (*release)(void*) = rioc_value_free) {
+  if (length < kExternalBufferThreshold) {
+    Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, data, length);
+    release(data);
+    return buffer;
+  }
+
+  // Report the allocation so V8 accounts for it when scheduling GC
+  Napi::MemoryManagement::AdjustExternalMemory(env, static_cast<int64_t>(length));
+  return Napi::Buffer<char>::NewOrCopy(env, data, length, [length, release](Napi::Env env, char* data) {
+    release(data);
+    Napi::MemoryManagement::AdjustExternalMemory(env, -static_cast<int64_t>(length));
+  });
+}
+
+// Converts range results to an array of {key, value} pairs, taking ownership of every
+// key and value and freeing the results array
+static Napi::Array TakeRangeResults(Napi::Env env, struct rioc_range_result* results, size_t count) {
+  Napi::Array resultArray = Napi::Array::New(env, count);
+
+  for (size_t i = 0; i < count; i++) {
+    Napi::Object pair = Napi::Object::New(env);
+    pair.Set("key", TakeBuffer(env, results[i].key, results[i].key_len));
+    pair.Set("value", TakeBuffer(env, results[i].value, results[i].value_len));
+    results[i].key = nullptr;
+    results[i].value = nullptr;
+    resultArray[i] = pair;
+  }
+
+  if (results != nullptr) {
+    rioc_free_range_results(results, count);
+  }
+  return resultArray;
+}
+
+// Constructors are kept per environment, since each worker_thread loads the addon
+// into its own isolate
+struct AddonData {
+  Napi::FunctionReference client;
+  Napi::FunctionReference batch;
+  Napi::FunctionReference tracker;
+  Napi::FunctionReference range_cursor;
+};
+
+// Shared connections
+//
+// The rioc_async engine is thread-safe, so one engine and its connection can serve
+// clients in several worker_threads. share() registers the engine under a numeric id
+// that can be posted to a worker, where constructing a RiocClient from the id attaches
+// to it. Every client holds a reference and the last one to close frees the engine.
+struct SharedConnection {
+  uint64_t id = 0;                   // 0 until share() registers it
+  size_t refs = 1;
+  struct rioc_client* client = nullptr;
+  struct rioc_async* async = nullptr;
+  ConnectionSettings settings;
+};
+
+static std::mutex shared_lock;
+static std::unordered_map<uint64_t, SharedConnection*> shared_connections;
+static uint64_t next_shared_id = 0;
+
+// Per-environment view of a shared connection
+struct AsyncContext {
+  Napi::ThreadSafeFunction tsfn;
+  SharedConnection* shared = nullptr;
+  size_t pending = 0;
+  bool closing = false;              // Released its reference; waiting for pending operations
+};
+
+// A blocking call through the shared engine, for the sync methods of an attached
+// client, which has no connection of its own. Blocking is what a sync call does
+// anyway, and the engine's I/O thread completes it.
+struct SyncCall {
+  std::mutex lock;
+  std::condition_variable completed;
+  bool done = false;
+  int status = 0;
+  char* value = nullptr;
+  size_t value_len = 0;
+};
+
+static void OnSyncComplete(void* arg, int status, char* value, size_t value_len) {
+  SyncCall* call = static_cast<SyncCall*>(arg);
+  std::lock_guard<std::mutex> guard(call->lock);
+  call->status = status;
+  call->value = value;
+  call->value_len = value_len;
+  call->done = true;
+  call->completed.notify_one();
+}
+
+template <typename Submit>
+static int CallShared(AsyncContext* context, SyncCall* call, Submit submit) {
+  if (!context) {
+    return -1;  // RIOC_ERR_PARAM, as for a disposed client
+  }
+
+  int result = submit(context->shared->async);
+  if (result != 0) {
+    return result;
+  }
+
+  std::unique_lock<std::mutex> guard(call->lock);
+  call->completed.wait(guard, [call] { return call->done; });
+  return call->status;
+}
 
 // RiocClient implementation
 Napi::Object RiocClient::Init(Napi::Env env, Napi::Object exports) {
@@ -27,11 +142,17 @@ Napi::Object RiocClient::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("atomicIncDec", &RiocClient::AtomicIncDec),
     InstanceMethod("dispose", &RiocClient::Dispose),
     InstanceMethod("createBatch", &RiocClient::CreateBatch),
+    InstanceMethod("getAsync", &RiocClient::GetAsync),
+    InstanceMethod("insertAsync", &RiocClient::InsertAsync),
+    InstanceMethod("deleteAsync", &RiocClient::DeleteAsync),
+    InstanceMethod("rangeQueryAsync", &RiocClient::RangeQueryAsync),
+    InstanceMethod("atomicIncDecAsync", &RiocClient::AtomicIncDecAsync),
+    InstanceMethod("createRangeCursor", &RiocClient::CreateRangeCursor),
+    InstanceMethod("share", &RiocClient::Share),
     StaticMethod("getTimestamp", &RiocClient::GetTimestamp)
   });
 
-  constructor = Napi::Persistent(func);
-  constructor.SuppressDestruct();
+  env.GetInstanceData<AddonData>()->client = Napi::Persistent(func);
 
   exports.Set("RiocClient", func);
   return exports;
@@ -41,57 +162,57 @@ RiocClient::RiocClient(const Napi::CallbackInfo& info) : Napi::ObjectWrap<RiocCl
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
 
+  // A number is a handle from share() in another thread
+  if (info.Length() >= 1 && info[0].IsNumber()) {
+    Attach(env, static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value()));
+    return;
+  }
+
   if (info.Length() < 1 || !info[0].IsObject()) {
     Napi::TypeError::New(env, "Config object expected").ThrowAsJavaScriptException();
     return;
   }
 
   Napi::Object config = info[0].As<Napi::Object>();
-  rioc_client_config native_config = {};
 
   // Extract config values
-  std::string host = config.Get("host").As<Napi::String>().Utf8Value();
-  native_config.host = const_cast<char*>(host.c_str());
-  native_config.port = config.Get("port").As<Napi::Number>().Uint32Value();
-  native_config.timeout_ms = config.Has("timeoutMs") ? 
+  settings.host = config.Get("host").As<Napi::String>().Utf8Value();
+  settings.port = config.Get("port").As<Napi::Number>().Uint32Value();
+  settings.timeout_ms = config.Has("timeoutMs") ? 
     config.Get("timeoutMs").As<Napi::Number>().Uint32Value() : 5000;
+  settings.flags = config.Has("flags") ?
+    config.Get("flags").As<Napi::Number>().Uint32Value() : 0;
+  settings.cpu = config.Has("cpu") ?
+    config.Get("cpu").As<Napi::Number>().Int32Value() : 0;
 
   // Handle TLS config if present
-  std::string ca_path, cert_path, key_path, verify_hostname;
-  rioc_tls_config native_tls = {};
-
-  if (config.Has("tls") && !config.Get("tls").IsNull()) {
+  if (config.Has("tls") && !config.Get("tls").IsNull() && !config.Get("tls").IsUndefined()) {
     Napi::Object tls = config.Get("tls").As<Napi::Object>();
+    settings.use_tls = true;
 
     if (tls.Has("caPath")) {
-      ca_path = tls.Get("caPath").As<Napi::String>().Utf8Value();
-      native_tls.ca_path = ca_path.c_str();
+      settings.ca_path = tls.Get("caPath").As<Napi::String>().Utf8Value();
     }
 
     if (tls.Has("certificatePath")) {
-      cert_path = tls.Get("certificatePath").As<Napi::String>().Utf8Value();
-      native_tls.cert_path = cert_path.c_str();
+      settings.cert_path = tls.Get("certificatePath").As<Napi::String>().Utf8Value();
     }
 
     if (tls.Has("keyPath")) {
-      key_path = tls.Get("keyPath").As<Napi::String>().Utf8Value();
-      native_tls.key_path = key_path.c_str();
+      settings.key_path = tls.Get("keyPath").As<Napi::String>().Utf8Value();
     }
 
     if (tls.Has("verifyHostname")) {
-      verify_hostname = tls.Get("verifyHostname").As<Napi::String>().Utf8Value();
-      native_tls.verify_hostname = verify_hostname.c_str();
+      settings.verify_hostname = tls.Get("verifyHostname").As<Napi::String>().Utf8Value();
     }
 
-    native_tls.verify_peer = tls.Has("verifyPeer") ? 
+    settings.verify_peer = tls.Has("verifyPeer") ? 
       tls.Get("verifyPeer").As<Napi::Boolean>().Value() : true;
-
-    native_config.tls = &native_tls;
   }
 
   // Connect to server
   struct rioc_client* client = nullptr;
-  int result = rioc_client_connect_with_config(&native_config, &client);
+  int result = settings.Connect(&client);
   if (result != 0) {
     Napi::Error::New(env, "Failed to connect to server").ThrowAsJavaScriptException();
     return;
@@ -100,7 +221,29 @@ RiocClient::RiocClient(const Napi::CallbackInfo& info) : Napi::ObjectWrap<RiocCl
   this->client_ptr = client;
 }
 
+int ConnectionSettings::Connect(struct rioc_client** client) const {
+  rioc_client_config native_config = {};
+  native_config.host = const_cast<char*>(host.c_str());
+  native_config.port = port;
+  native_config.timeout_ms = timeout_ms;
+  native_config.flags = flags;
+  native_config.cpu = cpu;
+
+  rioc_tls_config native_tls = {};
+  if (use_tls) {
+    native_tls.ca_path = ca_path.empty() ? nullptr : ca_path.c_str();
+    native_tls.cert_path = cert_path.empty() ? nullptr : cert_path.c_str();
+    native_tls.key_path = key_path.empty() ? nullptr : key_path.c_str();
+    native_tls.verify_hostname = verify_hostname.empty() ? nullptr : verify_hostname.c_str();
+    native_tls.verify_peer = verify_peer;
+    native_config.tls = &native_tls;
+  }
+
+  return rioc_client_connect_with_config(&native_config, client);
+}
+
 RiocClient::~RiocClient() {
+  CloseAsync();
   if (client_ptr) {
     rioc_client_disconnect_with_config(static_cast<struct rioc_client*>(client_ptr));
     client_ptr = nullptr;
@@ -120,15 +263,27 @@ Napi::Value RiocClient::Get(const Napi::CallbackInfo& info) {
   char* value_ptr = nullptr;
   size_t value_len = 0;
 
-  int result = rioc_get(
-    static_cast<struct rioc_client*>(client_ptr),
-    reinterpret_cast<const char*>(key.Data()),
-    key.Length(),
-    &value_ptr,
-    &value_len
-  );
+  int result;
+  if (client_ptr) {
+    result = rioc_get(
+      static_cast<struct rioc_client*>(client_ptr),
+      reinterpret_cast<const char*>(key.Data()),
+      key.Length(),
+      &value_ptr,
+      &value_len
+    );
+  } else {
+    SyncCall call;
+    result = CallShared(async_context, &call, [&](struct rioc_async* async) {
+      return rioc_async_get(async, reinterpret_cast<const char*>(key.Data()), key.Length(),
+                            OnSyncComplete, &call);
+    });
+    value_ptr = call.value;
+    value_len = call.value_len;
+  }
 
   if (result != 0) {
+    rioc_value_free(value_ptr);
     auto error = Napi::Error::New(env, "Get operation failed");
     error.Set("code", Napi::Number::New(env, result));
     error.ThrowAsJavaScriptException();
@@ -136,10 +291,11 @@ Napi::Value RiocClient::Get(const Napi::CallbackInfo& info) {
   }
 
   if (value_len == 0 || value_ptr == nullptr) {
+    rioc_value_free(value_ptr);
     return env.Null();
   }
 
-  return Napi::Buffer<uint8_t>::Copy(env, reinterpret_cast<uint8_t*>(value_ptr), value_len);
+  return TakeBuffer(env, value_ptr, value_len);
 }
 
 Napi::Value RiocClient::Insert(const Napi::CallbackInfo& info) {
@@ -156,14 +312,25 @@ Napi::Value RiocClient::Insert(const Napi::CallbackInfo& info) {
   bool lossless;
   uint64_t timestamp = info[2].As<Napi::BigInt>().Uint64Value(&lossless);
 
-  int result = rioc_insert(
-    static_cast<struct rioc_client*>(client_ptr),
-    reinterpret_cast<const char*>(key.Data()),
-    key.Length(),
-    reinterpret_cast<const char*>(value.Data()),
-    value.Length(),
-    timestamp
-  );
+  int result;
+  if (client_ptr) {
+    result = rioc_insert(
+      static_cast<struct rioc_client*>(client_ptr),
+      reinterpret_cast<const char*>(key.Data()),
+      key.Length(),
+      reinterpret_cast<const char*>(value.Data()),
+      value.Length(),
+      timestamp
+    );
+  } else {
+    SyncCall call;
+    result = CallShared(async_context, &call, [&](struct rioc_async* async) {
+      return rioc_async_insert(async, reinterpret_cast<const char*>(key.Data()), key.Length(),
+                               reinterpret_cast<const char*>(value.Data()), value.Length(),
+                               timestamp, OnSyncComplete, &call);
+    });
+    rioc_value_free(call.value);
+  }
 
   if (result != 0) {
     auto error = Napi::Error::New(env, "Insert operation failed");
@@ -187,12 +354,22 @@ Napi::Value RiocClient::Delete(const Napi::CallbackInfo& info) {
   bool lossless;
   uint64_t timestamp = info[1].As<Napi::BigInt>().Uint64Value(&lossless);
 
-  int result = rioc_delete(
-    static_cast<struct rioc_client*>(client_ptr),
-    reinterpret_cast<const char*>(key.Data()),
-    key.Length(),
-    timestamp
-  );
+  int result;
+  if (client_ptr) {
+    result = rioc_delete(
+      static_cast<struct rioc_client*>(client_ptr),
+      reinterpret_cast<const char*>(key.Data()),
+      key.Length(),
+      timestamp
+    );
+  } else {
+    SyncCall call;
+    result = CallShared(async_context, &call, [&](struct rioc_async* async) {
+      return rioc_async_delete(async, reinterpret_cast<const char*>(key.Data()), key.Length(),
+                               timestamp, OnSyncComplete, &call);
+    });
+    rioc_value_free(call.value);
+  }
 
   if (result != 0) {
     auto error = Napi::Error::New(env, "Delete operation failed");
@@ -204,6 +381,7 @@ Napi::Value RiocClient::Delete(const Napi::CallbackInfo& info) {
 }
 
 void RiocClient::Dispose(const Napi::CallbackInfo& info) {
+  CloseAsync();
   if (client_ptr) {
     rioc_client_disconnect_with_config(static_cast<struct rioc_client*>(client_ptr));
     client_ptr = nullptr;
@@ -214,7 +392,14 @@ Napi::Value RiocClient::CreateBatch(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
 
-  auto batch = RiocBatch::constructor.New({Napi::External<void>::New(env, client_ptr)});
+  // A batch owns its connection for a round trip, which the shared engine cannot give up
+  if (!client_ptr && async_context) {
+    Napi::Error::New(env, "Batches are not available on a shared client; use the async methods")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto batch = env.GetInstanceData<AddonData>()->batch.New({Napi::External<void>::New(env, client_ptr)});
   return batch;
 }
 
@@ -241,46 +426,34 @@ Napi::Value RiocClient::RangeQuery(const Napi::CallbackInfo& info) {
   struct rioc_range_result* results = nullptr;
   size_t result_count = 0;
 
-  int result = rioc_range_query(
-    static_cast<struct rioc_client*>(client_ptr),
-    startKeyBuffer.Data(), startKeyBuffer.Length(),
-    endKeyBuffer.Data(), endKeyBuffer.Length(),
-    &results, &result_count
-  );
+  int result;
+  if (client_ptr) {
+    result = rioc_range_query(
+      static_cast<struct rioc_client*>(client_ptr),
+      startKeyBuffer.Data(), startKeyBuffer.Length(),
+      endKeyBuffer.Data(), endKeyBuffer.Length(),
+      &results, &result_count
+    );
+  } else {
+    SyncCall call;
+    result = CallShared(async_context, &call, [&](struct rioc_async* async) {
+      return rioc_async_range_query(async, startKeyBuffer.Data(), startKeyBuffer.Length(),
+                                    endKeyBuffer.Data(), endKeyBuffer.Length(),
+                                    OnSyncComplete, &call);
+    });
+    results = reinterpret_cast<struct rioc_range_result*>(call.value);
+    result_count = call.value_len;
+    if (result != 0 && results != nullptr) {
+      rioc_free_range_results(results, result_count);
+    }
+  }
 
   if (result != 0) {
     Napi::Error::New(env, "Failed to perform range query").ThrowAsJavaScriptException();
     return env.Null();
   }
 
-  // Create array to hold results
-  Napi::Array resultArray = Napi::Array::New(env, result_count);
-
-  for (size_t i = 0; i < result_count; i++) {
-    Napi::Object pair = Napi::Object::New(env);
-    
-    // Copy key
-    Napi::Buffer<char> keyBuffer = Napi::Buffer<char>::Copy(
-      env, results[i].key, results[i].key_len
-    );
-    
-    // Copy value
-    Napi::Buffer<char> valueBuffer = Napi::Buffer<char>::Copy(
-      env, results[i].value, results[i].value_len
-    );
-    
-    pair.Set("key", keyBuffer);
-    pair.Set("value", valueBuffer);
-    
-    resultArray[i] = pair;
-  }
-
-  // Free results
-  if (results != nullptr && result_count > 0) {
-    rioc_free_range_results(results, result_count);
-  }
-
-  return resultArray;
+  return TakeRangeResults(env, results, result_count);
 }
 
 Napi::Value RiocClient::AtomicIncDec(const Napi::CallbackInfo& info) {
@@ -298,14 +471,27 @@ Napi::Value RiocClient::AtomicIncDec(const Napi::CallbackInfo& info) {
   uint64_t timestamp = info[2].As<Napi::BigInt>().Uint64Value(&lossless);
 
   int64_t result = 0;
-  int status = rioc_atomic_inc_dec(
-    static_cast<struct rioc_client*>(client_ptr),
-    reinterpret_cast<const char*>(key.Data()),
-    key.Length(),
-    value,
-    timestamp,
-    &result
-  );
+  int status;
+  if (client_ptr) {
+    status = rioc_atomic_inc_dec(
+      static_cast<struct rioc_client*>(client_ptr),
+      reinterpret_cast<const char*>(key.Data()),
+      key.Length(),
+      value,
+      timestamp,
+      &result
+    );
+  } else {
+    SyncCall call;
+    status = CallShared(async_context, &call, [&](struct rioc_async* async) {
+      return rioc_async_atomic_inc_dec(async, reinterpret_cast<const char*>(key.Data()), key.Length(),
+                                       value, timestamp, OnSyncComplete, &call);
+    });
+    if (call.value != nullptr && call.value_len >= sizeof(int64_t)) {
+      memcpy(&result, call.value, sizeof(int64_t));
+    }
+    rioc_value_free(call.value);
+  }
 
   if (status != 0) {
     auto error = Napi::Error::New(env, "Atomic increment/decrement operation failed");
@@ -317,6 +503,588 @@ Napi::Value RiocClient::AtomicIncDec(const Napi::CallbackInfo& info) {
   return Napi::BigInt::New(env, static_cast<int64_t>(result));
 }
 
+// Asynchronous operations
+//
+// Promise-based calls are queued on a rioc_async engine, whose I/O thread batches
+// everything submitted during a round trip onto a second connection, so the event
+// loop never blocks and sync calls never interleave with an in-flight batch.
+// Completions are handed back to the JS thread through a ThreadSafeFunction, which
+// only keeps the event loop alive while operations are pending.
+
+enum : uint16_t {
+  ASYNC_GET = 1,
+  ASYNC_INSERT = 2,
+  ASYNC_DELETE = 3,
+  ASYNC_RANGE_QUERY = 6,
+  ASYNC_ATOMIC_INC_DEC = 7
+};
+
+struct AsyncCompletion {
+  AsyncContext* context;
+  Napi::Promise::Deferred deferred;
+  uint16_t command;
+  int status;
+  char* value;        // Owned; range results for RANGE_QUERY
+  size_t value_len;   // Row count for RANGE_QUERY
+};
+
+static void FreeCompletionValue(AsyncCompletion* completion) {
+  if (completion->command == ASYNC_RANGE_QUERY) {
+    rioc_free_range_results(reinterpret_cast<struct rioc_range_result*>(completion->value),
+                            completion->value_len);
+  } else {
+    rioc_value_free(completion->value);
+  }
+  completion->value = nullptr;
+}
+
+static const char* AsyncErrorMessage(uint16_t command) {
+  switch (command) {
+    case ASYNC_GET: return "Get operation failed";
+    case ASYNC_INSERT: return "Insert operation failed";
+    case ASYNC_DELETE: return "Delete operation failed";
+    case ASYNC_RANGE_QUERY: return "Failed to perform range query";
+    default: return "Atomic increment/decrement operation failed";
+  }
+}
+
+// Runs on the JS thread
+static void SettleCompletion(Napi::Env env, Napi::Function, AsyncCompletion* completion) {
+  std::unique_ptr<AsyncCompletion> owned(completion);
+  if (env == nullptr) {
+    FreeCompletionValue(completion);
+    return;
+  }
+
+  Napi::HandleScope scope(env);
+  AsyncContext* context = completion->context;
+  if (--context->pending == 0) {
+    if (context->closing) {
+      context->tsfn.Release();
+    } else {
+      context->tsfn.Unref(env);
+    }
+  }
+
+  if (completion->status != 0) {
+    auto error = Napi::Error::New(env, AsyncErrorMessage(completion->command));
+    error.Set("code", Napi::Number::New(env, completion->status));
+    completion->deferred.Reject(error.Value());
+    return;
+  }
+
+  switch (completion->command) {
+    case ASYNC_GET:
+      if (completion->value == nullptr || completion->value_len == 0) {
+        FreeCompletionValue(completion);
+        completion->deferred.Resolve(env.Null());
+      } else {
+        completion->deferred.Resolve(TakeBuffer(env, completion->value, completion->value_len));
+      }
+      break;
+    case ASYNC_RANGE_QUERY:
+      completion->deferred.Resolve(TakeRangeResults(
+        env, reinterpret_cast<struct rioc_range_result*>(completion->value), completion->value_len));
+      break;
+    case ASYNC_ATOMIC_INC_DEC: {
+      int64_t result = 0;
+      if (completion->value != nullptr && completion->value_len >= sizeof(int64_t)) {
+        memcpy(&result, completion->value, sizeof(int64_t));
+      }
+      FreeCompletionValue(completion);
+      completion->deferred.Resolve(Napi::BigInt::New(env, result));
+      break;
+    }
+    default:
+      completion->deferred.Resolve(env.Undefined());
+      break;
+  }
+}
+
+// Runs on the native I/O thread, which hands over ownership of the value
+static void OnAsyncComplete(void* arg, int status, char* value, size_t value_len) {
+  AsyncCompletion* completion = static_cast<AsyncCompletion*>(arg);
+  completion->status = status;
+  completion->value = value;
+  completion->value_len = value_len;
+
+  completion->context->tsfn.BlockingCall(completion, SettleCompletion);
+}
+
+// Creates this environment's ThreadSafeFunction for completions on a shared connection
+static AsyncContext* NewAsyncContext(Napi::Env env, SharedConnection* shared) {
+  AsyncContext* context = new AsyncContext();
+  context->shared = shared;
+  context->tsfn = Napi::ThreadSafeFunction::New(
+    env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "rioc_async", 0, 1,
+    context, [](Napi::Env, AsyncContext* ctx) { delete ctx; });
+  context->tsfn.Unref(env);
+  return context;
+}
+
+AsyncContext* RiocClient::EnsureAsync(Napi::Env env) {
+  if (async_context) {
+    return async_context;
+  }
+  if (!client_ptr) {
+    Napi::Error::New(env, "Client is disposed").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+
+  std::unique_ptr<SharedConnection> shared(new SharedConnection());
+  shared->settings = settings;
+  if (settings.Connect(&shared->client) != 0) {
+    Napi::Error::New(env, "Failed to connect to server").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+
+  shared->async = rioc_async_create(shared->client);
+  if (!shared->async) {
+    rioc_client_disconnect_with_config(shared->client);
+    Napi::Error::New(env, "Failed to start asynchronous I/O").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+
+  async_context = NewAsyncContext(env, shared.release());
+  return async_context;
+}
+
+void RiocClient::CloseAsync() {
+  if (!async_context) {
+    return;
+  }
+
+  AsyncContext* context = async_context;
+  async_context = nullptr;
+  SharedConnection* shared = context->shared;
+
+  bool last;
+  {
+    std::lock_guard<std::mutex> guard(shared_lock);
+    last = --shared->refs == 0;
+    if (last && shared->id != 0) {
+      shared_connections.erase(shared->id);
+    }
+  }
+
+  if (!last) {
+    // Other threads still use the connection, so this thread's operations complete
+    // normally and the ThreadSafeFunction is released after the last of them
+    context->closing = true;
+    if (context->pending == 0) {
+      context->tsfn.Release();
+    }
+    return;
+  }
+
+  // Completes everything still queued; the settled promises are delivered once the
+  // ThreadSafeFunction drains, after which its finalizer deletes the context
+  rioc_async_free(shared->async);
+  rioc_client_disconnect_with_config(shared->client);
+  delete shared;
+  context->tsfn.Release();
+}
+
+Napi::Value RiocClient::Share(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  AsyncContext* context = EnsureAsync(env);
+  if (!context) {
+    return env.Null();
+  }
+
+  // The id is not a reference: the connection lives as long as some client holds it
+  SharedConnection* shared = context->shared;
+  std::lock_guard<std::mutex> guard(shared_lock);
+  if (shared->id == 0) {
+    shared->id = ++next_shared_id;
+    shared_connections[shared->id] = shared;
+  }
+  return Napi::Number::New(env, static_cast<double>(shared->id));
+}
+
+bool RiocClient::Attach(Napi::Env env, uint64_t id) {
+  SharedConnection* shared = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(shared_lock);
+    auto it = shared_connections.find(id);
+    if (it != shared_connections.end()) {
+      shared = it->second;
+      shared->refs++;
+    }
+  }
+
+  if (!shared) {
+    Napi::Error::New(env, "Shared client is closed").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  settings = shared->settings;
+  async_context = NewAsyncContext(env, shared);
+  return true;
+}
+
+// Submits one operation through the given rioc_async_* call and returns its promise
+template <typename Submit>
+static Napi::Value SubmitAsync(Napi::Env env, AsyncContext* context, uint16_t command, Submit submit) {
+  AsyncCompletion* completion = new AsyncCompletion{
+    context, Napi::Promise::Deferred::New(env), command, 0, nullptr, 0};
+  Napi::Promise promise = completion->deferred.Promise();
+
+  int result = submit(completion);
+  if (result != 0) {
+    auto error = Napi::Error::New(env, AsyncErrorMessage(command));
+    error.Set("code", Napi::Number::New(env, result));
+    completion->deferred.Reject(error.Value());
+    delete completion;
+    return promise;
+  }
+
+  if (context->pending++ == 0) {
+    context->tsfn.Ref(env);
+  }
+  return promise;
+}
+
+Napi::Value RiocClient::GetAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Buffer expected for key").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  AsyncContext* context = EnsureAsync(env);
+  if (!context) {
+    return env.Null();
+  }
+
+  Napi::Buffer<char> key = info[0].As<Napi::Buffer<char>>();
+  return SubmitAsync(env, context, ASYNC_GET, [&](AsyncCompletion* completion) {
+    return rioc_async_get(context->shared->async, key.Data(), key.Length(), OnAsyncComplete, completion);
+  });
+}
+
+Napi::Value RiocClient::InsertAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsBuffer() || !info[2].IsBigInt()) {
+    Napi::TypeError::New(env, "Expected (Buffer, Buffer, BigInt)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  AsyncContext* context = EnsureAsync(env);
+  if (!context) {
+    return env.Null();
+  }
+
+  Napi::Buffer<char> key = info[0].As<Napi::Buffer<char>>();
+  Napi::Buffer<char> value = info[1].As<Napi::Buffer<char>>();
+  bool lossless;
+  uint64_t timestamp = info[2].As<Napi::BigInt>().Uint64Value(&lossless);
+
+  return SubmitAsync(env, context, ASYNC_INSERT, [&](AsyncCompletion* completion) {
+    return rioc_async_insert(context->shared->async, key.Data(), key.Length(), value.Data(), value.Length(),
+                             timestamp, OnAsyncComplete, completion);
+  });
+}
+
+Napi::Value RiocClient::DeleteAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBigInt()) {
+    Napi::TypeError::New(env, "Expected (Buffer, BigInt)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  AsyncContext* context = EnsureAsync(env);
+  if (!context) {
+    return env.Null();
+  }
+
+  Napi::Buffer<char> key = info[0].As<Napi::Buffer<char>>();
+  bool lossless;
+  uint64_t timestamp = info[1].As<Napi::BigInt>().Uint64Value(&lossless);
+
+  return SubmitAsync(env, context, ASYNC_DELETE, [&](AsyncCompletion* completion) {
+    return rioc_async_delete(context->shared->async, key.Data(), key.Length(), timestamp,
+                             OnAsyncComplete, completion);
+  });
+}
+
+Napi::Value RiocClient::RangeQueryAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+    Napi::TypeError::New(env, "Start key and end key buffers expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  AsyncContext* context = EnsureAsync(env);
+  if (!context) {
+    return env.Null();
+  }
+
+  Napi::Buffer<char> startKey = info[0].As<Napi::Buffer<char>>();
+  Napi::Buffer<char> endKey = info[1].As<Napi::Buffer<char>>();
+
+  return SubmitAsync(env, context, ASYNC_RANGE_QUERY, [&](AsyncCompletion* completion) {
+    return rioc_async_range_query(context->shared->async, startKey.Data(), startKey.Length(),
+                                  endKey.Data(), endKey.Length(), OnAsyncComplete, completion);
+  });
+}
+
+Napi::Value RiocClient::AtomicIncDecAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsBigInt()) {
+    Napi::TypeError::New(env, "Expected key buffer, value number, and timestamp").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  AsyncContext* context = EnsureAsync(env);
+  if (!context) {
+    return env.Null();
+  }
+
+  Napi::Buffer<char> key = info[0].As<Napi::Buffer<char>>();
+  int64_t value = info[1].As<Napi::Number>().Int64Value();
+  bool lossless = false;
+  uint64_t timestamp = info[2].As<Napi::BigInt>().Uint64Value(&lossless);
+
+  return SubmitAsync(env, context, ASYNC_ATOMIC_INC_DEC, [&](AsyncCompletion* completion) {
+    return rioc_async_atomic_inc_dec(context->shared->async, key.Data(), key.Length(), value, timestamp,
+                                     OnAsyncComplete, completion);
+  });
+}
+
+// Streaming range queries
+//
+// A cursor reads rows on its own connection from a libuv worker, one chunk per read()
+// call, so the TypeScript stream only asks for more rows when its consumer has room
+// for them. While no read is outstanding nothing drains the socket, and TCP flow
+// control holds the server back.
+
+Napi::Object RiocRangeCursor::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "RiocRangeCursor", {
+    InstanceMethod("read", &RiocRangeCursor::Read),
+    InstanceMethod("close", &RiocRangeCursor::Close)
+  });
+
+  env.GetInstanceData<AddonData>()->range_cursor = Napi::Persistent(func);
+
+  exports.Set("RiocRangeCursor", func);
+  return exports;
+}
+
+RiocRangeCursor::RiocRangeCursor(const Napi::CallbackInfo& info) : Napi::ObjectWrap<RiocRangeCursor>(info) {
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+
+  if (info.Length() < 3 || !info[0].IsObject() || !info[1].IsBuffer() || !info[2].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected (RiocClient, Buffer, Buffer)").ThrowAsJavaScriptException();
+    return;
+  }
+
+  settings = RiocClient::Unwrap(info[0].As<Napi::Object>())->settings;
+  Napi::Buffer<char> startKey = info[1].As<Napi::Buffer<char>>();
+  Napi::Buffer<char> endKey = info[2].As<Napi::Buffer<char>>();
+  start_key.assign(startKey.Data(), startKey.Length());
+  end_key.assign(endKey.Data(), endKey.Length());
+}
+
+RiocRangeCursor::~RiocRangeCursor() {
+  Release();
+}
+
+Napi::Value RiocClient::CreateRangeCursor(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+    Napi::TypeError::New(env, "Start key and end key buffers expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return env.GetInstanceData<AddonData>()->range_cursor.New({this->Value(), info[0], info[1]});
+}
+
+// Opens the cursor on first use, then reads rows until the chunk holds max_bytes or
+// the scan ends. Rows are packed like range results in a packed batch response: a
+// uint32 key length, a uint32 value length, the key and the value.
+class RangeReadWorker : public Napi::AsyncWorker {
+public:
+  RangeReadWorker(Napi::Env env, RiocRangeCursor* cursor, size_t max_bytes)
+    : Napi::AsyncWorker(env), cursor(cursor), max_bytes(max_bytes),
+      deferred(Napi::Promise::Deferred::New(env)) {
+    // Keep the cursor alive until the read settles
+    cursor_ref = Napi::Persistent(cursor->Value());
+  }
+
+  ~RangeReadWorker() {
+    free(data);
+  }
+
+  void Execute() override {
+    if (!cursor->cursor && !Open()) {
+      return;
+    }
+
+    struct rioc_range_result row;
+    while (used < max_bytes) {
+      status = rioc_range_cursor_next(cursor->cursor, &row);
+      if (status == -6) {  // RIOC_ERR_NOENT: every row has been read
+        status = 0;
+        break;
+      }
+      if (status != 0 || !Append(row)) {
+        return;
+      }
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    cursor->reading = false;
+    if (cursor->closed) {
+      cursor->Release();
+      deferred.Resolve(env.Null());
+      return;
+    }
+    if (status != 0) {
+      auto error = Napi::Error::New(env, "Failed to read range query rows");
+      error.Set("code", Napi::Number::New(env, status));
+      deferred.Reject(error.Value());
+      return;
+    }
+
+    if (used == 0) {
+      deferred.Resolve(env.Null());
+    } else {
+      deferred.Resolve(TakeBuffer(env, data, used, free));
+      data = nullptr;
+    }
+  }
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+private:
+  bool Open() {
+    status = cursor->settings.Connect(&cursor->connection);
+    if (status != 0) {
+      cursor->connection = nullptr;
+      return false;
+    }
+
+    struct rioc_range_cursor* opened = nullptr;
+    status = rioc_range_cursor_open(cursor->connection, cursor->start_key.data(), cursor->start_key.size(),
+                                    cursor->end_key.data(), cursor->end_key.size(), &opened);
+    if (status != 0) {
+      rioc_client_disconnect_with_config(cursor->connection);
+      cursor->connection = nullptr;
+      return false;
+    }
+
+    std::lock_guard<std::mutex> guard(cursor->cancel_lock);
+    cursor->cursor = opened;
+    if (cursor->cancelled) {
+      rioc_range_cursor_cancel(opened);
+    }
+    return true;
+  }
+
+  bool Append(const struct rioc_range_result& row) {
+    size_t needed = used + 8 + row.key_len + row.value_len;
+    if (needed > capacity) {
+      size_t grown_capacity = capacity ? capacity * 2 : 4096;
+      while (grown_capacity < needed) {
+        grown_capacity *= 2;
+      }
+      char* grown = static_cast<char*>(realloc(data, grown_capacity));
+      if (!grown) {
+        status = -2;  // RIOC_ERR_MEM
+        return false;
+      }
+      data = grown;
+      capacity = grown_capacity;
+    }
+
+    // Host byte order, as in packed batch responses
+    uint32_t key_len = static_cast<uint32_t>(row.key_len);
+    uint32_t value_len = static_cast<uint32_t>(row.value_len);
+    memcpy(data + used, &key_len, sizeof(key_len));
+    memcpy(data + used + 4, &value_len, sizeof(value_len));
+    memcpy(data + used + 8, row.key, row.key_len);
+    memcpy(data + used + 8 + row.key_len, row.value, row.value_len);
+    used = needed;
+    return true;
+  }
+
+  RiocRangeCursor* cursor;
+  size_t max_bytes;
+  int status = 0;
+  char* data = nullptr;
+  size_t used = 0;
+  size_t capacity = 0;
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference cursor_ref;
+};
+
+// Resolves with the next chunk of packed rows, or null once the scan is complete
+Napi::Value RiocRangeCursor::Read(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (closed) {
+    Napi::Error::New(env, "Cursor is closed").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (reading) {
+    Napi::Error::New(env, "A read is already pending").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  size_t max_bytes = info.Length() > 0 && info[0].IsNumber() ?
+    info[0].As<Napi::Number>().Uint32Value() : 64 * 1024;
+
+  RangeReadWorker* worker = new RangeReadWorker(env, this, max_bytes > 0 ? max_bytes : 1);
+  Napi::Promise promise = worker->Promise();
+  reading = true;
+  worker->Queue();
+  return promise;
+}
+
+// Ends the scan. A scan closed before its last row is cancelled, which shuts its
+// connection down so the server stops sending; a pending read settles with null.
+void RiocRangeCursor::Close(const Napi::CallbackInfo& info) {
+  if (closed) {
+    return;
+  }
+  closed = true;
+
+  if (reading) {
+    std::lock_guard<std::mutex> guard(cancel_lock);
+    cancelled = true;
+    if (cursor) {
+      rioc_range_cursor_cancel(cursor);
+    }
+    return;
+  }
+  Release();
+}
+
+void RiocRangeCursor::Release() {
+  if (cursor) {
+    if (rioc_range_cursor_remaining(cursor) > 0) {
+      rioc_range_cursor_cancel(cursor);
+    }
+    rioc_range_cursor_close(cursor);
+    cursor = nullptr;
+  }
+  if (connection) {
+    rioc_client_disconnect_with_config(connection);
+    connection = nullptr;
+  }
+}
+
 // RiocBatch implementation
 Napi::Object RiocBatch::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
@@ -328,11 +1096,11 @@ Napi::Object RiocBatch::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("addRangeQuery", &RiocBatch::AddRangeQuery),
     InstanceMethod("executeAsync", &RiocBatch::ExecuteAsync),
     InstanceMethod("dispose", &RiocBatch::Dispose),
-    InstanceMethod("addAtomicIncDec", &RiocBatch::AddAtomicIncDec)
+    InstanceMethod("addAtomicIncDec", &RiocBatch::AddAtomicIncDec),
+    InstanceMethod("addPacked", &RiocBatch::AddPacked)
   });
 
-  constructor = Napi::Persistent(func);
-  constructor.SuppressDestruct();
+  env.GetInstanceData<AddonData>()->batch = Napi::Persistent(func);
 
   exports.Set("RiocBatch", func);
   return exports;
@@ -470,7 +1238,7 @@ Napi::Value RiocBatch::ExecuteAsync(const Napi::CallbackInfo& info) {
     return env.Null();
   }
 
-  auto tracker_obj = RiocBatchTracker::constructor.New({Napi::External<void>::New(env, tracker)});
+  auto tracker_obj = env.GetInstanceData<AddonData>()->tracker.New({Napi::External<void>::New(env, tracker)});
   return tracker_obj;
 }
 
@@ -509,20 +1277,45 @@ void RiocBatch::AddAtomicIncDec(const Napi::CallbackInfo& info) {
   }
 }
 
+// Adds every op of a packed request in one call, see rioc_batch_add_packed
+void RiocBatch::AddPacked(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Buffer expected for packed operations").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Buffer<char> packed = info[0].As<Napi::Buffer<char>>();
+  int result = rioc_batch_add_packed(
+    static_cast<struct rioc_batch*>(batch_ptr),
+    packed.Data(),
+    packed.Length()
+  );
+
+  if (result != 0) {
+    auto error = Napi::Error::New(env, "Failed to add packed operations to batch");
+    error.Set("code", Napi::Number::New(env, result));
+    error.ThrowAsJavaScriptException();
+  }
+}
+
 // RiocBatchTracker implementation
 Napi::Object RiocBatchTracker::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
 
   Napi::Function func = DefineClass(env, "RiocBatchTracker", {
     InstanceMethod("wait", &RiocBatchTracker::Wait),
+    InstanceMethod("waitAsync", &RiocBatchTracker::WaitAsync),
     InstanceMethod("getResponse", &RiocBatchTracker::GetResponse),
     InstanceMethod("getRangeQueryResponse", &RiocBatchTracker::GetRangeQueryResponse),
     InstanceMethod("dispose", &RiocBatchTracker::Dispose),
-    InstanceMethod("getAtomicResult", &RiocBatchTracker::GetAtomicResult)
+    InstanceMethod("getAtomicResult", &RiocBatchTracker::GetAtomicResult),
+    InstanceMethod("getPackedResponses", &RiocBatchTracker::GetPackedResponses)
   });
 
-  constructor = Napi::Persistent(func);
-  constructor.SuppressDestruct();
+  env.GetInstanceData<AddonData>()->tracker = Napi::Persistent(func);
 
   exports.Set("RiocBatchTracker", func);
   return exports;
@@ -560,6 +1353,76 @@ void RiocBatchTracker::Wait(const Napi::CallbackInfo& info) {
   }
 }
 
+// Waits for a batch on a libuv worker thread instead of the JS thread
+class WaitWorker : public Napi::AsyncWorker {
+public:
+  WaitWorker(Napi::Env env, RiocBatchTracker* tracker, int timeout_ms)
+    : Napi::AsyncWorker(env), tracker(tracker), timeout_ms(timeout_ms),
+      deferred(Napi::Promise::Deferred::New(env)) {
+    // Keep the tracker alive until the wait settles
+    tracker_ref = Napi::Persistent(tracker->Value());
+  }
+
+  void Execute() override {
+    result = rioc_batch_wait(static_cast<struct rioc_batch_tracker*>(tracker->tracker_ptr), timeout_ms);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    tracker->waiting = false;
+    if (result != 0) {
+      auto error = Napi::Error::New(env, "Batch execution failed");
+      error.Set("code", Napi::Number::New(env, result));
+      deferred.Reject(error.Value());
+    } else {
+      deferred.Resolve(env.Undefined());
+    }
+  }
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+private:
+  RiocBatchTracker* tracker;
+  int timeout_ms;
+  int result = 0;
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference tracker_ref;
+};
+
+Napi::Value RiocBatchTracker::WaitAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!tracker_ptr) {
+    Napi::Error::New(env, "Tracker is disposed").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  int timeout_ms = info.Length() > 0 && info[0].IsNumber() ? 
+    info[0].As<Napi::Number>().Int32Value() : -1;
+
+  WaitWorker* worker = new WaitWorker(env, this, timeout_ms);
+  Napi::Promise promise = worker->Promise();
+  waiting = true;
+  worker->Queue();
+  return promise;
+}
+
+// Responses are taken from the tracker on first read, so later reads return the same object
+Napi::Value RiocBatchTracker::CachedResponse(size_t index) {
+  if (responses.IsEmpty()) {
+    return Napi::Value();
+  }
+  Napi::Value cached = responses.Value().Get(static_cast<uint32_t>(index));
+  return cached.IsUndefined() ? Napi::Value() : cached;
+}
+
+void RiocBatchTracker::CacheResponse(Napi::Env env, size_t index, Napi::Value value) {
+  if (responses.IsEmpty()) {
+    responses = Napi::Persistent(Napi::Array::New(env).As<Napi::Object>());
+  }
+  responses.Value().Set(static_cast<uint32_t>(index), value);
+}
+
 Napi::Value RiocBatchTracker::GetResponse(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
@@ -570,10 +1433,15 @@ Napi::Value RiocBatchTracker::GetResponse(const Napi::CallbackInfo& info) {
   }
 
   size_t index = info[0].As<Napi::Number>().Uint32Value();
+  Napi::Value cached = CachedResponse(index);
+  if (!cached.IsEmpty()) {
+    return cached;
+  }
+
   char* value_ptr = nullptr;
   size_t value_len = 0;
 
-  int result = rioc_batch_get_response_async(
+  int result = rioc_batch_take_response_async(
     static_cast<struct rioc_batch_tracker*>(tracker_ptr),
     index,
     &value_ptr,
@@ -590,10 +1458,13 @@ Napi::Value RiocBatchTracker::GetResponse(const Napi::CallbackInfo& info) {
   }
 
   if (value_len == 0 || value_ptr == nullptr) {
+    rioc_value_free(value_ptr);
     return env.Null();
   }
 
-  return Napi::Buffer<uint8_t>::Copy(env, reinterpret_cast<uint8_t*>(value_ptr), value_len);
+  Napi::Buffer<char> buffer = TakeBuffer(env, value_ptr, value_len);
+  CacheResponse(env, index, buffer);
+  return buffer;
 }
 
 Napi::Value RiocBatchTracker::GetRangeQueryResponse(const Napi::CallbackInfo& info) {
@@ -606,10 +1477,15 @@ Napi::Value RiocBatchTracker::GetRangeQueryResponse(const Napi::CallbackInfo& in
   }
 
   size_t index = info[0].As<Napi::Number>().Uint32Value();
+  Napi::Value cached = CachedResponse(index);
+  if (!cached.IsEmpty()) {
+    return cached;
+  }
+
   char* value_ptr = nullptr;
   size_t value_len = 0;
 
-  int result = rioc_batch_get_response_async(
+  int result = rioc_batch_take_response_async(
     static_cast<struct rioc_batch_tracker*>(tracker_ptr),
     index, &value_ptr, &value_len
   );
@@ -625,33 +1501,9 @@ Napi::Value RiocBatchTracker::GetRangeQueryResponse(const Napi::CallbackInfo& in
 
   // For range query, value_len is the count of results
   // and value_ptr points to an array of rioc_range_result structs
-  struct rioc_range_result* results = reinterpret_cast<struct rioc_range_result*>(value_ptr);
-  
-  // Create array to hold results
-  Napi::Array resultArray = Napi::Array::New(env, value_len);
-
-  for (size_t i = 0; i < value_len; i++) {
-    Napi::Object pair = Napi::Object::New(env);
-    
-    // Copy key
-    Napi::Buffer<char> keyBuffer = Napi::Buffer<char>::Copy(
-      env, results[i].key, results[i].key_len
-    );
-    
-    // Copy value
-    Napi::Buffer<char> valueBuffer = Napi::Buffer<char>::Copy(
-      env, results[i].value, results[i].value_len
-    );
-    
-    pair.Set("key", keyBuffer);
-    pair.Set("value", valueBuffer);
-    
-    resultArray[i] = pair;
-  }
-
-  // Note: We don't free the results here as they are managed by the batch tracker
-  // and will be freed when the tracker is disposed
-
+  Napi::Array resultArray = TakeRangeResults(
+    env, reinterpret_cast<struct rioc_range_result*>(value_ptr), value_len);
+  CacheResponse(env, index, resultArray);
   return resultArray;
 }
 
@@ -692,7 +1544,39 @@ Napi::Value RiocBatchTracker::GetAtomicResult(const Napi::CallbackInfo& info) {
   return Napi::BigInt::New(env, static_cast<int64_t>(0));
 }
 
+// Returns every response of the batch as one packed buffer, sliced by the TypeScript layer
+Napi::Value RiocBatchTracker::GetPackedResponses(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+
+  if (!tracker_ptr) {
+    Napi::Error::New(env, "Tracker is disposed").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const char* packed = nullptr;
+  size_t packed_len = 0;
+  int result = rioc_batch_get_packed_responses(
+    static_cast<struct rioc_batch_tracker*>(tracker_ptr),
+    &packed,
+    &packed_len
+  );
+
+  if (result != 0) {
+    auto error = Napi::Error::New(env, "Failed to get batch responses");
+    error.Set("code", Napi::Number::New(env, result));
+    error.ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return Napi::Buffer<char>::Copy(env, packed, packed_len);
+}
+
 void RiocBatchTracker::Dispose(const Napi::CallbackInfo& info) {
+  if (waiting) {
+    Napi::Error::New(info.Env(), "Cannot dispose a tracker while waitAsync is pending").ThrowAsJavaScriptException();
+    return;
+  }
   if (tracker_ptr) {
     rioc_batch_tracker_free(static_cast<struct rioc_batch_tracker*>(tracker_ptr));
     tracker_ptr = nullptr;
@@ -701,9 +1585,11 @@ void RiocBatchTracker::Dispose(const Napi::CallbackInfo& info) {
 
 // Initialize native addon
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  env.SetInstanceData(new AddonData());
   RiocClient::Init(env, exports);
   RiocBatch::Init(env, exports);
   RiocBatchTracker::Init(env, exports);
+  RiocRangeCursor::Init(env, exports);
   return exports;
 }
 
@@ -4,12 +4,17 @@
 #include <napi.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string>
+#include <mutex>
 
 // Forward declarations
 struct rioc_client;
 struct rioc_batch;
 struct rioc_batch_tracker;
 struct rioc_range_result;
+struct rioc_async;
+struct rioc_range_cursor;
+struct AsyncContext;
 
 // TLS configuration
 struct rioc_tls_config {
@@ -26,6 +31,22 @@ struct rioc_client_config {
   uint32_t port;
   uint32_t timeout_ms;
   struct rioc_tls_config* tls;
+  uint32_t flags;               // RIOC_CLIENT_* options, 0 for none
+  int32_t cpu;                  // CPU for RIOC_CLIENT_PIN_CPU
+};
+
+// Connection settings, kept to open further connections after the first
+struct ConnectionSettings {
+  std::string host;
+  uint32_t port = 0;
+  uint32_t timeout_ms = 5000;
+  bool use_tls = false;
+  std::string ca_path, cert_path, key_path, verify_hostname;
+  bool verify_peer = true;
+  uint32_t flags = 0;
+  int32_t cpu = 0;
+
+  int Connect(struct rioc_client** client) const;
 };
 
 class RiocClient : public Napi::ObjectWrap<RiocClient> {
@@ -35,8 +56,7 @@ public:
   ~RiocClient();
 
 private:
-  static Napi::FunctionReference constructor;
-  void* client_ptr;
+  void* client_ptr = nullptr;
 
   // Core operations
   Napi::Value Get(const Napi::CallbackInfo& info);
@@ -46,9 +66,56 @@ private:
   Napi::Value AtomicIncDec(const Napi::CallbackInfo& info);
   void Dispose(const Napi::CallbackInfo& info);
 
+  // Promise-based operations, completed on a dedicated connection by the native I/O thread
+  Napi::Value GetAsync(const Napi::CallbackInfo& info);
+  Napi::Value InsertAsync(const Napi::CallbackInfo& info);
+  Napi::Value DeleteAsync(const Napi::CallbackInfo& info);
+  Napi::Value RangeQueryAsync(const Napi::CallbackInfo& info);
+  Napi::Value AtomicIncDecAsync(const Napi::CallbackInfo& info);
+  AsyncContext* EnsureAsync(Napi::Env env);
+  void CloseAsync();
+
   // Batch operations
   Napi::Value CreateBatch(const Napi::CallbackInfo& info);
   static Napi::Value GetTimestamp(const Napi::CallbackInfo& info);
+
+  // Streaming range queries, each on its own connection
+  Napi::Value CreateRangeCursor(const Napi::CallbackInfo& info);
+
+  // Sharing the asynchronous connection with other worker_threads
+  Napi::Value Share(const Napi::CallbackInfo& info);
+  bool Attach(Napi::Env env, uint64_t id);
+
+  ConnectionSettings settings;
+  AsyncContext* async_context = nullptr;
+
+  friend class RiocRangeCursor;
+};
+
+class RiocRangeCursor : public Napi::ObjectWrap<RiocRangeCursor> {
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  RiocRangeCursor(const Napi::CallbackInfo& info);
+  ~RiocRangeCursor();
+
+private:
+
+  // Cursor operations
+  Napi::Value Read(const Napi::CallbackInfo& info);
+  void Close(const Napi::CallbackInfo& info);
+  void Release();
+
+  ConnectionSettings settings;
+  std::string start_key, end_key;
+  struct rioc_client* connection = nullptr;
+  struct rioc_range_cursor* cursor = nullptr;
+  bool reading = false;              // A RangeReadWorker is using the cursor
+  bool closed = false;
+  std::mutex cancel_lock;            // Guards cursor and cancelled against a worker opening the cursor
+  bool cancelled = false;
+
+  friend class RiocClient;
+  friend class RangeReadWorker;
 };
 
 class RiocBatch : public Napi::ObjectWrap<RiocBatch> {
@@ -58,7 +125,6 @@ public:
   ~RiocBatch();
 
 private:
-  static Napi::FunctionReference constructor;
   void* batch_ptr;
 
   // Batch operations
@@ -67,6 +133,7 @@ private:
   void AddDelete(const Napi::CallbackInfo& info);
   void AddRangeQuery(const Napi::CallbackInfo& info);
   void AddAtomicIncDec(const Napi::CallbackInfo& info);
+  void AddPacked(const Napi::CallbackInfo& info);
   Napi::Value ExecuteAsync(const Napi::CallbackInfo& info);
   void Dispose(const Napi::CallbackInfo& info);
 
@@ -80,17 +147,24 @@ public:
   ~RiocBatchTracker();
 
 private:
-  static Napi::FunctionReference constructor;
   void* tracker_ptr;
 
   // Tracker operations
   void Wait(const Napi::CallbackInfo& info);
+  Napi::Value WaitAsync(const Napi::CallbackInfo& info);
   Napi::Value GetResponse(const Napi::CallbackInfo& info);
   Napi::Value GetRangeQueryResponse(const Napi::CallbackInfo& info);
   Napi::Value GetAtomicResult(const Napi::CallbackInfo& info);
+  Napi::Value GetPackedResponses(const Napi::CallbackInfo& info);
   void Dispose(const Napi::CallbackInfo& info);
+  Napi::Value CachedResponse(size_t index);
+  void CacheResponse(Napi::Env env, size_t index, Napi::Value value);
+
+  bool waiting = false;              // A WaitAsync worker is using the tracker
+  Napi::ObjectReference responses;   // Responses already taken, by index
 
   friend class RiocBatch;
+  friend class WaitWorker;
 };
 
 // Function declarations from rioc.h
@@ -112,6 +186,7 @@ extern "C" {
   struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch* batch);
   int rioc_batch_wait(struct rioc_batch_tracker* tracker, int timeout_ms);
   int rioc_batch_get_response_async(struct rioc_batch_tracker* tracker, size_t index, char** value, size_t* value_len);
+  int rioc_batch_take_response_async(struct rioc_batch_tracker* tracker, size_t index, char** value, size_t* value_len);
   void rioc_batch_tracker_free(struct rioc_batch_tracker* tracker);
   void rioc_batch_free(struct rioc_batch* batch);
   uint64_t rioc_get_timestamp_ns(void);
@@ -119,6 +194,31 @@ extern "C" {
   int rioc_atomic_inc_dec(struct rioc_client* client, const char* key, size_t key_len, int64_t value, uint64_t timestamp, int64_t* result);
   int rioc_batch_add_atomic_inc_dec(struct rioc_batch* batch, const char* key, size_t key_len, int64_t value, uint64_t timestamp);
   int rioc_batch_get_atomic_result_async(struct rioc_batch_tracker* tracker, size_t index, int64_t* result);
+  int rioc_batch_add_packed(struct rioc_batch* batch, const char* packed, size_t packed_len);
+  int rioc_batch_get_packed_responses(struct rioc_batch_tracker* tracker, const char** packed, size_t* packed_len);
+  int rioc_range_cursor_open(struct rioc_client* client, const char* start_key, size_t start_key_len,
+                             const char* end_key, size_t end_key_len, struct rioc_range_cursor** cursor);
+  int rioc_range_cursor_next(struct rioc_range_cursor* cursor, struct rioc_range_result* row);
+  size_t rioc_range_cursor_remaining(const struct rioc_range_cursor* cursor);
+  void rioc_range_cursor_cancel(struct rioc_range_cursor* cursor);
+  int rioc_range_cursor_close(struct rioc_range_cursor* cursor);
+
+  typedef void (*rioc_async_callback)(void* arg, int status, char* value, size_t value_len);
+  struct rioc_async* rioc_async_create(struct rioc_client* client);
+  void rioc_async_free(struct rioc_async* async);
+  int rioc_async_get(struct rioc_async* async, const char* key, size_t key_len,
+                     rioc_async_callback callback, void* arg);
+  int rioc_async_insert(struct rioc_async* async, const char* key, size_t key_len,
+                        const char* value, size_t value_len, uint64_t timestamp,
+                        rioc_async_callback callback, void* arg);
+  int rioc_async_delete(struct rioc_async* async, const char* key, size_t key_len,
+                        uint64_t timestamp, rioc_async_callback callback, void* arg);
+  int rioc_async_range_query(struct rioc_async* async, const char* start_key, size_t start_key_len,
+                             const char* end_key, size_t end_key_len,
+                             rioc_async_callback callback, void* arg);
+  int rioc_async_atomic_inc_dec(struct rioc_async* async, const char* key, size_t key_len,
+                                int64_t value, uint64_t timestamp,
+                                rioc_async_callback callback, void* arg);
 }
 
 #endif // RIOC_BINDING_H
\ No newline at end of file
@@ -1,6 +1,8 @@
 import { RiocClient, RiocConfig, RiocTlsConfig, RiocKeyNotFoundError, RangeQueryResult } from '../src';
 import { expect } from 'chai';
 import 'mocha';
+import * as path from 'path';
+import { Worker } from 'worker_threads';
 
 describe('RiocClient', () => {
     // Test configuration from environment variables with defaults
@@ -156,6 +158,75 @@ describe('RiocClient', () => {
         }
     });
 
+    it('should return large values and batch responses without copying them twice', () => {
+        // Arrange
+        const key = Buffer.from('large_value_key');
+        const value = Buffer.alloc(64 * 1024, 'v');
+        client.insert(key, value, RiocClient.getTimestamp());
+
+        // Act
+        const retrievedValue = client.get(key);
+        const batch = client.createBatch();
+        try {
+            batch.addGet(key);
+            const tracker = batch.executeAsync();
+            tracker.wait(1000);
+            const first = tracker.getResponse(0);
+            const second = tracker.getResponse(0);
+
+            // Assert
+            expect(Buffer.compare(retrievedValue!, value)).to.equal(0);
+            expect(Buffer.compare(first!, value)).to.equal(0);
+            expect(second).to.equal(first);
+
+            tracker.dispose();
+        } finally {
+            batch.dispose();
+            client.delete(key, RiocClient.getTimestamp());
+        }
+    });
+
+    it('should execute a full packed batch and reject one more operation', () => {
+        // Arrange
+        const batch = client.createBatch();
+        const keys = Array.from({ length: 128 }, (_, i) => Buffer.from(`packed_key${i}`));
+        try {
+            for (const key of keys) {
+                batch.addInsert(key, key, RiocClient.getTimestamp());
+            }
+
+            // Act & Assert
+            expect(() => batch.addGet(Buffer.from('packed_overflow'))).to.throw().with.property('code', -1);
+
+            const tracker = batch.executeAsync();
+            tracker.wait(1000);
+            for (let i = 0; i < keys.length; i++) {
+                expect(tracker.getResponse(i)).to.be.null;
+            }
+            tracker.dispose();
+        } finally {
+            batch.dispose();
+        }
+
+        const getBatch = client.createBatch();
+        try {
+            for (const key of keys) {
+                getBatch.addGet(key);
+            }
+            const tracker = getBatch.executeAsync();
+            tracker.wait(1000);
+            for (let i = 0; i < keys.length; i++) {
+                expect(Buffer.compare(tracker.getResponse(i)!, keys[i])).to.equal(0);
+            }
+            tracker.dispose();
+        } finally {
+            getBatch.dispose();
+            for (const key of keys) {
+                client.delete(key, RiocClient.getTimestamp());
+            }
+        }
+    });
+
     it('should return increasing timestamps', (done) => {
         // Act
         const timestamp1 = RiocClient.getTimestamp();
@@ -444,4 +515,209 @@ describe('RiocClient', () => {
             }
         });
     });
+
+    describe('Range Query Stream', () => {
+        const keys = Array.from({ length: 1000 }, (_, i) => Buffer.from(`stream_key:${String(i).padStart(4, '0')}`));
+
+        beforeEach(() => {
+            const timestamp = RiocClient.getTimestamp();
+            keys.forEach((key, i) => client.insert(key, Buffer.from(`value_${i}`), timestamp));
+        });
+
+        afterEach(() => {
+            keys.forEach(key => client.delete(key, RiocClient.getTimestamp()));
+        });
+
+        it('should stream every row in key order', async () => {
+            // Act
+            const rows: RangeQueryResult[] = [];
+            for await (const row of client.rangeQueryStream(keys[0], keys[keys.length - 1])) {
+                rows.push(row);
+            }
+
+            // Assert
+            expect(rows.map(r => r.key.toString())).to.deep.equal(keys.map(k => k.toString()));
+            rows.forEach((row, i) => {
+                expect(row.value.toString()).to.equal(`value_${i}`);
+            });
+        });
+
+        it('should abort the scan when destroyed early', async () => {
+            // Act
+            let count = 0;
+            for await (const _row of client.rangeQueryStream(keys[0], keys[keys.length - 1], { highWaterMark: 16 })) {
+                if (++count === 10) {
+                    break;
+                }
+            }
+
+            // Assert: the client's own connection is unaffected
+            expect(count).to.equal(10);
+            expect(client.get(keys[500])!.toString()).to.equal('value_500');
+        });
+    });
+
+    describe('Asynchronous Operations', () => {
+        it('should insert and get values with promises', async () => {
+            // Arrange
+            const key = Buffer.from('async_key');
+            const value = Buffer.from('async_value');
+
+            // Act
+            await client.insertAsync(key, value, RiocClient.getTimestamp());
+            const retrievedValue = await client.getAsync(key);
+
+            // Assert
+            expect(retrievedValue).to.not.be.null;
+            expect(Buffer.compare(retrievedValue!, value)).to.equal(0);
+
+            await client.deleteAsync(key, RiocClient.getTimestamp());
+        });
+
+        it('should reject with code -6 for nonexistent key', async () => {
+            try {
+                await client.getAsync(Buffer.from('async_nonexistent_key'));
+                expect.fail('Should have rejected');
+            } catch (err: any) {
+                expect(err).to.have.property('code', -6); // RIOC_ERR_NOENT
+            }
+        });
+
+        it('should keep many requests in flight', async () => {
+            // Arrange
+            const count = 2000;
+            const keys = Array.from({ length: count }, (_, i) => Buffer.from(`async_many:${i}`));
+            const timestamp = RiocClient.getTimestamp();
+
+            // Act
+            await Promise.all(keys.map((key, i) => client.insertAsync(key, Buffer.from(`value_${i}`), timestamp)));
+            const values = await Promise.all(keys.map(key => client.getAsync(key)));
+
+            // Assert
+            values.forEach((value, i) => {
+                expect(value!.toString()).to.equal(`value_${i}`);
+            });
+
+            await Promise.all(keys.map(key => client.deleteAsync(key, RiocClient.getTimestamp())));
+        });
+
+        it('should perform range queries and atomic operations with promises', async () => {
+            // Arrange
+            const timestamp = RiocClient.getTimestamp();
+            await client.insertAsync(Buffer.from('async_range:a'), Buffer.from('A'), timestamp);
+            await client.insertAsync(Buffer.from('async_range:b'), Buffer.from('B'), timestamp);
+            const counterKey = Buffer.from('async_counter');
+
+            try {
+                // Act
+                const rows = await client.rangeQueryAsync(Buffer.from('async_range:a'), Buffer.from('async_range:z'));
+                const first = await client.atomicIncDecAsync(counterKey, 5, RiocClient.getTimestamp());
+                const second = await client.atomicIncDecAsync(counterKey, -2, RiocClient.getTimestamp());
+
+                // Assert
+                expect(rows.map((r: RangeQueryResult) => r.key.toString())).to.deep.equal(['async_range:a', 'async_range:b']);
+                expect(Number(second - first)).to.equal(-2);
+            } finally {
+                client.delete(Buffer.from('async_range:a'), RiocClient.getTimestamp());
+                client.delete(Buffer.from('async_range:b'), RiocClient.getTimestamp());
+                client.delete(counterKey, RiocClient.getTimestamp());
+            }
+        });
+
+        it('should wait for a batch without blocking the event loop', async () => {
+            // Arrange
+            const key = Buffer.from('async_batch_key');
+            client.insert(key, Buffer.from('async_batch_value'), RiocClient.getTimestamp());
+            const batch = client.createBatch();
+
+            try {
+                batch.addGet(key);
+
+                // Act
+                const tracker = batch.executeAsync();
+                await tracker.waitAsync(1000);
+
+                // Assert
+                expect(tracker.getResponse(0)!.toString()).to.equal('async_batch_value');
+                tracker.dispose();
+            } finally {
+                batch.dispose();
+                client.delete(key, RiocClient.getTimestamp());
+            }
+        });
+    });
+
+    describe('Shared Connection', () => {
+        it('should serve a client created from a handle', async () => {
+            // Arrange
+            const key = Buffer.from('shared_key');
+            const counterKey = Buffer.from('shared_counter');
+            const shared = RiocClient.fromShared(client.share());
+
+            try {
+                // Act
+                shared.insert(key, Buffer.from('shared_value'), RiocClient.getTimestamp());
+                const fromOwner = await client.getAsync(key);
+                const first = await shared.atomicIncDecAsync(counterKey, 3, RiocClient.getTimestamp());
+                const second = shared.atomicIncDec(counterKey, 2, RiocClient.getTimestamp());
+
+                // Assert
+                expect(fromOwner!.toString()).to.equal('shared_value');
+                expect(shared.get(key)!.toString()).to.equal('shared_value');
+                expect(Number(second - first)).to.equal(2);
+                expect(() => shared.createBatch()).to.throw();
+            } finally {
+                shared.delete(key, RiocClient.getTimestamp());
+                shared.delete(counterKey, RiocClient.getTimestamp());
+                shared.dispose();
+            }
+        });
+
+        it('should keep the connection open until every client is disposed', async () => {
+            // Arrange
+            const key = Buffer.from('shared_survivor');
+            const shared = RiocClient.fromShared(client.share());
+            client.dispose();
+
+            try {
+                // Act
+                await shared.insertAsync(key, Buffer.from('value'), RiocClient.getTimestamp());
+                const value = await shared.getAsync(key);
+
+                // Assert
+                expect(value!.toString()).to.equal('value');
+            } finally {
+                await shared.deleteAsync(key, RiocClient.getTimestamp());
+                shared.dispose();
+            }
+        });
+
+        it('should share the connection with worker threads', async () => {
+            // Arrange
+            const handle = client.share();
+            const addon = path.resolve(__dirname, '../build/Release/rioc.node');
+            const source = `
+                const { parentPort, workerData } = require('worker_threads');
+                const native = require(workerData.addon);
+                const client = new native.RiocClient(workerData.handle.riocSharedConnection);
+                const key = Buffer.from('shared_worker:' + workerData.index);
+                client.insert(key, Buffer.from('from_worker'), native.RiocClient.getTimestamp());
+                client.getAsync(key).then(value => {
+                    client.delete(key, native.RiocClient.getTimestamp());
+                    client.dispose();
+                    parentPort.postMessage(value.toString());
+                });
+            `;
+
+            // Act
+            const results = await Promise.all([0, 1, 2, 3].map(index => new Promise<string>((resolve, reject) => {
+                const worker = new Worker(source, { eval: true, workerData: { addon, handle, index } });
+                worker.once('message', resolve);
+                worker.once('error', reject);
+            })));
+
+            // Assert
+            expect(results).to.deep.equal(['from_worker', 'from_worker', 'from_worker', 'from_worker']);
+        });
+    });
 }); 
\ No newline at end of file
@@ -0,0 +1,63 @@
+import { keys } from '../src';
+import { expect } from 'chai';
+import 'mocha';
+
+const { u32, u64, i32, i64, desc, encodeKey, decodeKey, encodeKeys, prefixSuccessor } = keys;
+
+describe('Key encoding', () => {
+    it('should match keys built by the C library', () => {
+        expect(encodeKey(u32(7), Buffer.from('a\0b'), desc(i64(-9))).toString('hex'))
+            .to.equal('000000076100ff6200018000000000000008');
+        expect(encodeKey(i32(-1), desc(u64(1)), desc('hi')).toString('hex'))
+            .to.equal('7ffffffffffffffffffffffe9796fffe');
+        expect(encodeKey(0, '').toString('hex')).to.equal('80000000000000000001');
+    });
+
+    it('should sort field by field, ascending and descending', () => {
+        const strings = ['', '\0', 'a\0b', 'a', 'ab', 'b', 'é'];
+        const fields: [number, string, number][] = [];
+        for (let i = 0; i < 300; i++) {
+            fields.push([i % 2, strings[(i * 7) % strings.length], ((i * 5) % 7) - 3]);
+        }
+        const encode = (f: [number, string, number]) => encodeKey(u32(f[0]), f[1], desc(f[2]));
+        const byKey = [...fields].sort((a, b) => Buffer.compare(encode(a), encode(b)));
+        const expected = [...fields].sort((a, b) =>
+            a[0] - b[0] || Buffer.compare(Buffer.from(a[1]), Buffer.from(b[1])) || b[2] - a[2]);
+        expect(byKey).to.deep.equal(expected);
+    });
+
+    it('should decode keys back into their fields', () => {
+        const key = encodeKey(u32(7), 'a\0b', desc(-9n), desc(Buffer.from([0])));
+        expect(decodeKey(key, 'u32', 'string', { desc: 'i64' }, { desc: 'bytes' }))
+            .to.deep.equal([7, 'a\0b', -9n, Buffer.from([0])]);
+        expect(decodeKey(encodeKey(i32(-5)), 'i32')).to.deep.equal([-5]);
+
+        expect(() => decodeKey(key, 'u32', 'string')).to.throw(RangeError);
+        expect(() => decodeKey(Buffer.from([0x61, 0x00, 0x02]), 'string')).to.throw(RangeError);
+        expect(() => decodeKey(Buffer.from([0, 0]), 'u32')).to.throw(RangeError);
+    });
+
+    it('should compute prefix successors', () => {
+        expect(prefixSuccessor(Buffer.from([0x61, 0x62, 0xff, 0xff]))).to.deep.equal(Buffer.from('ac'));
+        expect(prefixSuccessor(encodeKey(u32(7)))).to.deep.equal(encodeKey(u32(8)));
+        expect(prefixSuccessor(Buffer.from([0xff]))).to.equal(null);
+        expect(prefixSuccessor(Buffer.alloc(0))).to.equal(null);
+    });
+
+    it('should encode integer columns like encodeKey', () => {
+        const prefix = encodeKey(u32(3));
+        const cases: [keys.KeyIntKind, (number | bigint)[], (v: number | bigint) => keys.KeyInt][] = [
+            ['i64', [-(2n ** 63n), -1n, 0n, 2n ** 63n - 1n], i64],
+            ['u64', [0n, 2n ** 64n - 1n], u64],
+            ['i32', [-(2 ** 31), -5, 0, 2 ** 31 - 1], i32],
+            ['u32', [0, 9, 2 ** 32 - 1], u32],
+        ];
+        for (const [kind, values, field] of cases) {
+            for (const descending of [false, true]) {
+                const expected = values.map((v) =>
+                    Buffer.concat([prefix, encodeKey(descending ? desc(field(v)) : field(v))]));
+                expect(encodeKeys(values, kind, prefix, descending)).to.deep.equal(expected);
+            }
+        }
+    });
+});
@@ -0,0 +1,321 @@
+"""
+Workload runner for the HPKV RIOC Python SDK.
+
+Executes a workload file from bench/workloads and prints one result object in the
+shared schema (bench/README.md), so the results can be compared with
+`rioc_bench --workload` to measure the per-op cost of the ctypes binding.
+"""
+
+import argparse
+import json
+import sys
+import threading
+import time
+from typing import Dict, List, Tuple
+
+from hpkv_rioc import RiocClient, RiocConfig, RiocTlsConfig
+from hpkv_rioc.exceptions import RiocError
+
+OP_NAMES = ["get", "insert", "delete", "range_query", "atomic_inc_dec"]
+RIOC_ERR_NOENT = -6
+MAX_BATCH_SIZE = 128
+
+DEFAULTS = {
+    "name": "unnamed",
+    "threads": 1,
+    "ops_per_thread": 10000,
+    "warmup_ops": 0,
+    "batch_size": 1,
+    "key_count": 1000,
+    "key_distribution": "uniform",
+    "value_size": 100,
+    "range_rows": 10,
+    "seed": 1,
+}
+
+
+def load_workload(path: str) -> Dict:
+    """Load a workload file and apply the defaults of the shared spec."""
+    with open(path, "r", encoding="utf-8") as f:
+        spec = json.load(f)
+    unknown = set(spec) - set(DEFAULTS) - set(OP_NAMES) - {"description"}
+    if unknown:
+        raise ValueError(f"Unknown workload fields: {', '.join(sorted(unknown))}")
+    for name, value in DEFAULTS.items():
+        spec.setdefault(name, value)
+    for name in OP_NAMES:
+        spec.setdefault(name, 0)
+    if sum(spec[name] for name in OP_NAMES) <= 0:
+        raise ValueError("Workload mix must give at least one operation a positive weight")
+    if spec["key_distribution"] not in ("uniform", "sequential"):
+        raise ValueError("key_distribution must be uniform or sequential")
+    if not 1 <= spec["batch_size"] <= MAX_BATCH_SIZE:
+        raise ValueError(f"batch_size must be between 1 and {MAX_BATCH_SIZE}")
+    return spec
+
+
+def generate_ops(spec: Dict, thread_id: int) -> List[Tuple[int, int]]:
+    """Generate the (op type, key index) sequence every runner produces for a thread."""
+    state = (spec["seed"] + 0x9E3779B9 * (thread_id + 1)) & 0xFFFFFFFF
+    if state == 0:
+        state = 1
+
+    def next_random() -> int:
+        nonlocal state
+        state ^= (state << 13) & 0xFFFFFFFF
+        state ^= state >> 17
+        state ^= (state << 5) & 0xFFFFFFFF
+        return state
+
+    weights = [spec[name] for name in OP_NAMES]
+    total_weight = sum(weights)
+    count = spec["warmup_ops"] + spec["ops_per_thread"]
+    key_count = spec["key_count"]
+    ops = []
+    for i in range(count):
+        r = next_random() % total_weight
+        op_type = 0
+        while r >= weights[op_type]:
+            r -= weights[op_type]
+            op_type += 1
+        if spec["key_distribution"] == "sequential":
+            key = (thread_id * count + i) % key_count
+        else:
+            key = next_random() % key_count
+        ops.append((op_type, key))
+    return ops
+
+
+def data_key(index: int) -> bytes:
+    return b"wl:%08d" % index
+
+
+def counter_key(index: int) -> bytes:
+    return b"wl:ctr:%08d" % index
+
+
+def range_end(spec: Dict, start: int) -> int:
+    return min(start + spec["range_rows"] - 1, spec["key_count"] - 1)
+
+
+def is_error(error: RiocError) -> bool:
+    return error.code != RIOC_ERR_NOENT
+
+
+def execute_single(client: RiocClient, spec: Dict, op: Tuple[int, int], value: bytes) -> int:
+    """Execute one operation through the single-op API; returns the number of failed ops."""
+    op_type, key = op
+    try:
+        if op_type == 0:
+            client.get(data_key(key))
+        elif op_type == 1:
+            client.insert(data_key(key), value, RiocClient.get_timestamp())
+        elif op_type == 2:
+            client.delete(data_key(key), RiocClient.get_timestamp())
+        elif op_type == 3:
+            client.range_query(data_key(key), data_key(range_end(spec, key)))
+        else:
+            client.atomic_inc_dec(counter_key(key), 1, RiocClient.get_timestamp())
+    except RiocError as e:
+        return 1 if is_error(e) else 0
+    return 0
+
+
+def execute_batch(client: RiocClient, spec: Dict, ops: List[Tuple[int, int]], value: bytes) -> int:
+    """Execute ops as one batch and materialize every result; returns the number of failed ops."""
+    batch = client.create_batch()
+    tracker = None
+    try:
+        for op_type, key in ops:
+            if op_type == 0:
+                batch.add_get(data_key(key))
+            elif op_type == 1:
+                batch.add_insert(data_key(key), value, RiocClient.get_timestamp())
+            elif op_type == 2:
+                batch.add_delete(data_key(key), RiocClient.get_timestamp())
+            elif op_type == 3:
+                batch.add_range_query(data_key(key), data_key(range_end(spec, key)))
+            else:
+                batch.add_atomic_inc_dec(counter_key(key), 1, RiocClient.get_timestamp())
+        tracker = batch.execute()
+        tracker.wait()
+
+        errors = 0
+        for i, (op_type, _) in enumerate(ops):
+            try:
+                if op_type == 3:
+                    tracker.get_range_query_response(i)
+                elif op_type == 4:
+                    tracker.get_atomic_result(i)
+                else:
+                    tracker.get_response(i)
+            except RiocError as e:
+                errors += 1 if is_error(e) else 0
+        return errors
+    except RiocError:
+        return len(ops)
+    finally:
+        if tracker:
+            tracker.close()
+        batch.close()
+
+
+class WorkloadThread(threading.Thread):
+    """Runs one thread's operation sequence on its own client."""
+
+    def __init__(self, thread_id: int, spec: Dict, config: RiocConfig, value: bytes,
+                 ready: threading.Barrier):
+        super().__init__(daemon=True)
+        self.thread_id = thread_id
+        self.spec = spec
+        self.config = config
+        self.value = value
+        self.ready = ready
+        self.ops = generate_ops(spec, thread_id)
+        self.latencies: List[float] = []
+        self.op_counts = [0] * len(OP_NAMES)
+        self.errors = 0
+        self.end_time = 0.0
+        self.failed = False
+
+    def run_ops(self, client: RiocClient, ops: List[Tuple[int, int]], record: bool) -> None:
+        batch_size = self.spec["batch_size"]
+        for i in range(0, len(ops), batch_size):
+            chunk = ops[i:i + batch_size]
+            start = time.perf_counter_ns()
+            if batch_size == 1:
+                errors = execute_single(client, self.spec, chunk[0], self.value)
+            else:
+                errors = execute_batch(client, self.spec, chunk, self.value)
+            end = time.perf_counter_ns()
+            if record:
+                self.latencies.append((end - start) / 1000.0)
+                self.errors += errors
+                for op_type, _ in chunk:
+                    self.op_counts[op_type] += 1
+
+    def run(self) -> None:
+        try:
+            client = RiocClient(self.config)
+        except RiocError as e:
+            print(f"Thread {self.thread_id}: failed to connect: {e}", file=sys.stderr)
+            self.failed = True
+            self.ready.wait()
+            return
+
+        try:
+            warmup = self.spec["warmup_ops"]
+            self.run_ops(client, self.ops[:warmup], False)
+            self.ready.wait()
+            self.run_ops(client, self.ops[warmup:], True)
+            self.end_time = time.perf_counter()
+        finally:
+            client.close()
+
+
+def prepare_keys(client: RiocClient, spec: Dict, value: bytes, remove: bool) -> None:
+    """Preload the data keys, or delete them and the counters after the run."""
+    key_sets = [data_key, counter_key] if remove else [data_key]
+    for make_key in key_sets:
+        for start in range(0, spec["key_count"], MAX_BATCH_SIZE):
+            with client.batch() as batch:
+                for i in range(start, min(start + MAX_BATCH_SIZE, spec["key_count"])):
+                    if remove:
+                        batch.add_delete(make_key(i), RiocClient.get_timestamp())
+                    else:
+                        batch.add_insert(make_key(i), value, RiocClient.get_timestamp())
+                tracker = batch.execute()
+                try:
+                    tracker.wait()
+                finally:
+                    tracker.close()
+
+
+def percentile(latencies: List[float], q: float) -> float:
+    return latencies[min(int(len(latencies) * q), len(latencies) - 1)]
+
+
+def build_result(spec: Dict, workers: List[WorkloadThread], elapsed_sec: float) -> Dict:
+    latencies = sorted(l for w in workers for l in w.latencies)
+    op_counts = [sum(w.op_counts[i] for w in workers) for i in range(len(OP_NAMES))]
+    ops = sum(op_counts)
+    return {
+        "schema": "rioc-bench-result/1",
+        "runner": "python",
+        "workload": spec["name"],
+        "threads": len(workers),
+        "batch_size": spec["batch_size"],
+        "value_size": spec["value_size"],
+        "ops": ops,
+        "calls": len(latencies),
+        "errors": sum(w.errors for w in workers),
+        "ops_by_type": dict(zip(OP_NAMES, op_counts)),
+        "elapsed_sec": round(elapsed_sec, 6),
+        "ops_per_sec": round(ops / elapsed_sec, 2) if elapsed_sec > 0 else 0.0,
+        "latency_us": {
+            "min": round(latencies[0], 3),
+            "avg": round(sum(latencies) / len(latencies), 3),
+            "p50": round(percentile(latencies, 0.50), 3),
+            "p95": round(percentile(latencies, 0.95), 3),
+            "p99": round(percentile(latencies, 0.99), 3),
+            "p999": round(percentile(latencies, 0.999), 3),
+            "max": round(latencies[-1], 3),
+        },
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RIOC Workload Benchmark")
+    parser.add_argument("workload", help="Path to a workload file (see bench/README.md)")
+    parser.add_argument("--host", default="localhost", help="Server host")
+    parser.add_argument("--port", type=int, default=8000, help="Server port")
+    parser.add_argument("--timeout", type=int, default=5000, help="Operation timeout in milliseconds")
+    parser.add_argument("--tls", action="store_true", help="Enable TLS")
+    parser.add_argument("--client-cert", help="Path to client certificate")
+    parser.add_argument("--client-key", help="Path to client private key")
+    parser.add_argument("--ca-cert", help="Path to CA certificate")
+    args = parser.parse_args()
+
+    spec = load_workload(args.workload)
+    tls = None
+    if args.tls:
+        tls = RiocTlsConfig(
+            certificate_path=args.client_cert,
+            key_path=args.client_key,
+            ca_path=args.ca_cert,
+            verify_hostname=args.host,
+            verify_peer=args.ca_cert is not None,
+        )
+    config = RiocConfig(host=args.host, port=args.port, timeout_ms=args.timeout, tls=tls)
+
+    print(f"Workload {spec['name']}: {spec['threads']} threads x {spec['ops_per_thread']} ops, "
+          f"batch size {spec['batch_size']}, {spec['key_count']} keys, "
+          f"{spec['value_size']} byte values", file=sys.stderr)
+
+    value = b"x" * spec["value_size"]
+    client = RiocClient(config)
+    try:
+        prepare_keys(client, spec, value, False)
+
+        # The main thread is the last party, so its release marks the start of the run
+        ready = threading.Barrier(spec["threads"] + 1)
+        workers = [WorkloadThread(i, spec, config, value, ready) for i in range(spec["threads"])]
+        for worker in workers:
+            worker.start()
+        ready.wait()
+        start_time = time.perf_counter()
+        for worker in workers:
+            worker.join()
+
+        failed = any(w.failed for w in workers)
+        if not failed:
+            elapsed = max(w.end_time for w in workers) - start_time
+            print(json.dumps(build_result(spec, workers, elapsed), separators=(",", ":")))
+        prepare_keys(client, spec, value, True)
+    finally:
+        client.close()
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,58 @@
-from setuptools import setup, find_packages
+import os
+import platform
+import sys
+
+from setuptools import Extension, setup, find_packages
+from setuptools.command.build_ext import build_ext
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# rioc.h is taken from the repository unless RIOC_INCLUDE_DIR points elsewhere
+RIOC_INCLUDE_DIR = os.environ.get("RIOC_INCLUDE_DIR", os.path.join(HERE, "..", "..", "..", "src"))
+
+
+def _runtime_dir():
+    """Runtime directory of the bundled native library, relative to the package."""
+    system = {"win32": "win", "darwin": "osx"}.get(sys.platform, "linux")
+    arch = "arm64" if platform.machine().lower() in ("arm64", "aarch64") else "x64"
+    return f"runtimes/{system}-{arch}/native"
+
+
+def _rioc_extension():
+    """Compiled binding linked against the bundled librioc."""
+    runtime_dir = _runtime_dir()
+    link_args = []
+    rpath = []
+    if sys.platform == "darwin":
+        link_args.append(f"-Wl,-rpath,@loader_path/{runtime_dir}")
+    elif sys.platform != "win32":
+        rpath.append(f"$ORIGIN/{runtime_dir}")
+    return Extension(
+        "hpkv_rioc._rioc",
+        sources=["src/hpkv_rioc/_rioc.c"],
+        include_dirs=[RIOC_INCLUDE_DIR],
+        library_dirs=[os.path.join(HERE, "src", "hpkv_rioc", runtime_dir)],
+        libraries=["rioc"],
+        runtime_library_dirs=rpath,
+        extra_link_args=link_args,
+    )
+
+
+class OptionalBuildExt(build_ext):
+    """Build the compiled binding if possible; the package falls back to ctypes otherwise."""
+
+    def run(self):
+        try:
+            super().run()
+        except Exception as exc:  # pylint: disable=broad-except
+            print(f"warning: building hpkv_rioc._rioc failed, using the ctypes backend ({exc})")
+
+    def build_extension(self, ext):
+        try:
+            super().build_extension(ext)
+        except Exception as exc:  # pylint: disable=broad-except
+            print(f"warning: building {ext.name} failed, using the ctypes backend ({exc})")
+
 
 setup(
     name="hpkv-rioc",
@@ -16,8 +70,13 @@ setup(
             "runtimes/osx-arm64/native/librioc.dylib",
         ]
     },
+    ext_modules=[_rioc_extension()],
+    cmdclass={"build_ext": OptionalBuildExt},
     python_requires=">=3.8",
     install_requires=[],
+    extras_require={
+        "arrow": ["numpy", "pyarrow"],
+    },
     classifiers=[
         "Development Status :: 4 - Beta",
         "Intended Audience :: Developers",
@@ -3,16 +3,21 @@ HPKV RIOC Python SDK - High Performance Key-Value Store
 """
 
 from .client import RiocClient, RangeQueryResult
+from .aio import AsyncRiocClient, AsyncRiocBatch
 from .config import RiocConfig, RiocTlsConfig
 from .exceptions import RiocError, RiocTimeoutError, RiocConnectionError
+from . import keys
 
 __version__ = "0.1.0"
 __all__ = [
     "RiocClient",
+    "AsyncRiocClient",
+    "AsyncRiocBatch",
     "RiocConfig",
     "RiocTlsConfig",
     "RiocError",
     "RiocTimeoutError",
     "RiocConnectionError",
     "RangeQueryResult",
+    "keys",
 ] 
\ No newline at end of file
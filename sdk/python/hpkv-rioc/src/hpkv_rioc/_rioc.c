@@ -0,0 +1,1060 @@
+// CPython extension binding librioc for the hpkv_rioc package.
+// Exposes the same Client/Batch/Tracker/AsyncQueue interface as the ctypes backend in
+// native.py, releases the GIL for every network round trip and exports packed batch
+// responses as memoryviews over the tracker's native buffer.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#include "rioc.h"
+
+// Declared in rioc_platform.h, which also pulls in OpenSSL headers
+int rioc_platform_init(void);
+void rioc_platform_cleanup(void);
+uint64_t rioc_get_timestamp_ns(void);
+
+static PyObject *create_rioc_error;   // hpkv_rioc.exceptions.create_rioc_error
+
+// Raise the RiocError subclass for a RIOC status code
+static PyObject *raise_rioc_error(int code) {
+    PyObject *error = PyObject_CallFunction(create_rioc_error, "i", code);
+    if (error) {
+        PyErr_SetObject((PyObject *)Py_TYPE(error), error);
+        Py_DECREF(error);
+    }
+    return NULL;
+}
+
+// Client
+
+typedef struct {
+    PyObject_HEAD
+    struct rioc_client *client;
+} ClientObject;
+
+typedef struct {
+    PyObject_HEAD
+    ClientObject *client;
+    struct rioc_batch *batch;
+    Py_ssize_t trackers;      // Live trackers that still reference the batch
+    int closed;
+} BatchObject;
+
+typedef struct {
+    PyObject_HEAD
+    BatchObject *batch;
+    struct rioc_batch_tracker *tracker;
+    Py_ssize_t exports;       // Buffers exported over the packed responses
+    int closed;
+} TrackerObject;
+
+// Owns the columns of a range query result while Arrow buffers reference them
+typedef struct {
+    PyObject_HEAD
+    struct rioc_range_columns columns;
+} RangeColumnsObject;
+
+// Operation submitted through an AsyncQueue; completed on the rioc_async I/O thread
+struct async_completion {
+    struct async_completion *next;
+    struct async_queue_state *state;
+    long long id;
+    uint16_t command;
+    int status;
+    char *value;
+    size_t value_len;
+};
+
+// Shared with the I/O thread, so it is plain C and never touches Python objects
+struct async_queue_state {
+    pthread_mutex_t lock;
+    struct async_completion *head;   // Completed, not yet drained, in completion order
+    struct async_completion *tail;
+    int read_fd;                     // Readable while completions are waiting
+    int write_fd;
+};
+
+typedef struct {
+    PyObject_HEAD
+    ClientObject *client;
+    struct rioc_async *async;
+    struct async_queue_state *state;
+} AsyncQueueObject;
+
+static PyTypeObject ClientType;
+static PyTypeObject BatchType;
+static PyTypeObject TrackerType;
+static PyTypeObject RangeColumnsType;
+static PyTypeObject AsyncQueueType;
+
+static int client_init(ClientObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"host", "port", "timeout_ms", "tls", "cert_path", "key_path",
+                             "ca_path", "verify_hostname", "verify_peer", NULL};
+    const char *host;
+    unsigned int port, timeout_ms;
+    int use_tls = 0, verify_peer = 1;
+    const char *cert_path = NULL, *key_path = NULL, *ca_path = NULL, *verify_hostname = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sII|pzzzzp", kwlist, &host, &port, &timeout_ms,
+                                     &use_tls, &cert_path, &key_path, &ca_path,
+                                     &verify_hostname, &verify_peer)) {
+        return -1;
+    }
+    if (self->client) {
+        PyErr_SetString(PyExc_RuntimeError, "Client is already connected");
+        return -1;
+    }
+
+    int ret = rioc_platform_init();
+    if (ret != RIOC_SUCCESS) {
+        raise_rioc_error(ret);
+        return -1;
+    }
+
+    rioc_tls_config tls = {
+        .cert_path = cert_path,
+        .key_path = key_path,
+        .ca_path = ca_path,
+        .verify_hostname = verify_hostname,
+        .verify_peer = verify_peer != 0,
+    };
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = timeout_ms,
+        .tls = use_tls ? &tls : NULL,
+    };
+
+    struct rioc_client *client = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_client_connect_with_config(&config, &client);
+    Py_END_ALLOW_THREADS
+    if (ret != RIOC_SUCCESS) {
+        rioc_platform_cleanup();
+        raise_rioc_error(ret);
+        return -1;
+    }
+
+    self->client = client;
+    return 0;
+}
+
+static void client_disconnect(ClientObject *self) {
+    if (self->client) {
+        struct rioc_client *client = self->client;
+        self->client = NULL;
+        rioc_client_disconnect_with_config(client);
+        rioc_platform_cleanup();
+    }
+}
+
+static void client_dealloc(ClientObject *self) {
+    client_disconnect(self);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int client_check(ClientObject *self) {
+    if (!self->client) {
+        raise_rioc_error(RIOC_ERR_PARAM);
+        return -1;
+    }
+    return 0;
+}
+
+// Calls on one client must be serialized by the caller, see RiocClient._lock
+
+static PyObject *client_get(ClientObject *self, PyObject *args) {
+    Py_buffer key;
+    if (client_check(self) < 0 || !PyArg_ParseTuple(args, "y*", &key)) {
+        return NULL;
+    }
+
+    char *value = NULL;
+    size_t value_len = 0;
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_get(self->client, key.buf, key.len, &value, &value_len);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&key);
+    if (ret != RIOC_SUCCESS) {
+        rioc_value_free(value);
+        return raise_rioc_error(ret);
+    }
+
+    PyObject *result = PyBytes_FromStringAndSize(value, value ? (Py_ssize_t)value_len : 0);
+    rioc_value_free(value);
+    return result;
+}
+
+static PyObject *client_insert(ClientObject *self, PyObject *args) {
+    Py_buffer key, value;
+    unsigned long long timestamp;
+    if (client_check(self) < 0 || !PyArg_ParseTuple(args, "y*y*K", &key, &value, &timestamp)) {
+        return NULL;
+    }
+
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_insert(self->client, key.buf, key.len, value.buf, value.len, timestamp);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&key);
+    PyBuffer_Release(&value);
+    if (ret != RIOC_SUCCESS) {
+        return raise_rioc_error(ret);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *client_delete(ClientObject *self, PyObject *args) {
+    Py_buffer key;
+    unsigned long long timestamp;
+    if (client_check(self) < 0 || !PyArg_ParseTuple(args, "y*K", &key, &timestamp)) {
+        return NULL;
+    }
+
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_delete(self->client, key.buf, key.len, timestamp);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&key);
+    if (ret != RIOC_SUCCESS) {
+        return raise_rioc_error(ret);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *client_range_query(ClientObject *self, PyObject *args) {
+    Py_buffer start_key, end_key;
+    if (client_check(self) < 0 || !PyArg_ParseTuple(args, "y*y*", &start_key, &end_key)) {
+        return NULL;
+    }
+
+    struct rioc_range_result *results = NULL;
+    size_t count = 0;
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_range_query(self->client, start_key.buf, start_key.len,
+                           end_key.buf, end_key.len, &results, &count);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&start_key);
+    PyBuffer_Release(&end_key);
+    if (ret != RIOC_SUCCESS) {
+        return raise_rioc_error(ret);
+    }
+
+    PyObject *list = PyList_New((Py_ssize_t)count);
+    for (size_t i = 0; list && i < count; i++) {
+        PyObject *row = Py_BuildValue("(y#y#)", results[i].key, (Py_ssize_t)results[i].key_len,
+                                      results[i].value, (Py_ssize_t)results[i].value_len);
+        if (!row) {
+            Py_CLEAR(list);
+            break;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, row);
+    }
+    if (results) {
+        rioc_free_range_results(results, count);
+    }
+    return list;
+}
+
+static PyObject *client_atomic_inc_dec(ClientObject *self, PyObject *args) {
+    Py_buffer key;
+    long long value;
+    unsigned long long timestamp;
+    if (client_check(self) < 0 || !PyArg_ParseTuple(args, "y*LK", &key, &value, &timestamp)) {
+        return NULL;
+    }
+
+    int64_t result = 0;
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_atomic_inc_dec(self->client, key.buf, key.len, value, timestamp, &result);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&key);
+    if (ret != RIOC_SUCCESS) {
+        return raise_rioc_error(ret);
+    }
+    return PyLong_FromLongLong(result);
+}
+
+static PyObject *client_insert_bulk(ClientObject *self, PyObject *args) {
+    Py_buffer key_offsets, key_data, value_offsets, value_data;
+    unsigned long long timestamp;
+    if (client_check(self) < 0 ||
+        !PyArg_ParseTuple(args, "y*y*y*y*K", &key_offsets, &key_data, &value_offsets, &value_data,
+                          &timestamp)) {
+        return NULL;
+    }
+
+    // Offsets are int64 with count + 1 entries and lie within their data, see client.py
+    size_t count = key_offsets.len >= (Py_ssize_t)sizeof(int64_t) ?
+        (size_t)key_offsets.len / sizeof(int64_t) - 1 : 0;
+    size_t inserted = 0;
+    int ret = RIOC_ERR_PARAM;
+    if (key_offsets.len == value_offsets.len && key_offsets.len >= (Py_ssize_t)sizeof(int64_t)) {
+        Py_BEGIN_ALLOW_THREADS
+        ret = rioc_insert_bulk(self->client, count, key_offsets.buf, key_data.buf,
+                               value_offsets.buf, value_data.buf, timestamp, &inserted);
+        Py_END_ALLOW_THREADS
+    }
+    PyBuffer_Release(&key_offsets);
+    PyBuffer_Release(&key_data);
+    PyBuffer_Release(&value_offsets);
+    PyBuffer_Release(&value_data);
+
+    if (ret != RIOC_SUCCESS) {
+        // The error carries the number of leading items that were applied
+        PyObject *error = PyObject_CallFunction(create_rioc_error, "i", ret);
+        if (error) {
+            PyObject *value = PyLong_FromSize_t(inserted);
+            if (value) {
+                PyObject_SetAttrString(error, "inserted", value);
+                Py_DECREF(value);
+            }
+            PyErr_SetObject((PyObject *)Py_TYPE(error), error);
+            Py_DECREF(error);
+        }
+        return NULL;
+    }
+    return PyLong_FromSize_t(inserted);
+}
+
+static PyObject *client_range_query_columns(ClientObject *self, PyObject *args) {
+    Py_buffer start_key, end_key;
+    if (client_check(self) < 0 || !PyArg_ParseTuple(args, "y*y*", &start_key, &end_key)) {
+        return NULL;
+    }
+
+    RangeColumnsObject *columns = PyObject_New(RangeColumnsObject, &RangeColumnsType);
+    if (!columns) {
+        PyBuffer_Release(&start_key);
+        PyBuffer_Release(&end_key);
+        return NULL;
+    }
+    memset(&columns->columns, 0, sizeof(columns->columns));
+
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_range_query_columns(self->client, start_key.buf, start_key.len,
+                                   end_key.buf, end_key.len, &columns->columns);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&start_key);
+    PyBuffer_Release(&end_key);
+    if (ret != RIOC_SUCCESS) {
+        Py_DECREF(columns);
+        return raise_rioc_error(ret);
+    }
+    return (PyObject *)columns;
+}
+
+static PyObject *client_batch(ClientObject *self, PyObject *Py_UNUSED(ignored)) {
+    if (client_check(self) < 0) {
+        return NULL;
+    }
+
+    struct rioc_batch *batch = rioc_batch_create(self->client);
+    if (!batch) {
+        Py_RETURN_NONE;
+    }
+
+    BatchObject *obj = PyObject_New(BatchObject, &BatchType);
+    if (!obj) {
+        rioc_batch_free(batch);
+        return NULL;
+    }
+    Py_INCREF(self);
+    obj->client = self;
+    obj->batch = batch;
+    obj->trackers = 0;
+    obj->closed = 0;
+    return (PyObject *)obj;
+}
+
+static PyObject *client_close(ClientObject *self, PyObject *Py_UNUSED(ignored)) {
+    client_disconnect(self);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef client_methods[] = {
+    {"get", (PyCFunction)client_get, METH_VARARGS, "Get a value by key."},
+    {"insert", (PyCFunction)client_insert, METH_VARARGS, "Insert or update a key-value pair."},
+    {"delete", (PyCFunction)client_delete, METH_VARARGS, "Delete a key."},
+    {"range_query", (PyCFunction)client_range_query, METH_VARARGS,
+     "Return (key, value) tuples within a key range."},
+    {"atomic_inc_dec", (PyCFunction)client_atomic_inc_dec, METH_VARARGS,
+     "Atomically add to a counter and return its new value."},
+    {"insert_bulk", (PyCFunction)client_insert_bulk, METH_VARARGS,
+     "Insert the items of int64 offset and data columns; returns the number inserted."},
+    {"range_query_columns", (PyCFunction)client_range_query_columns, METH_VARARGS,
+     "Return the rows within a key range as RangeColumns."},
+    {"batch", (PyCFunction)client_batch, METH_NOARGS, "Create a batch, or None on failure."},
+    {"close", (PyCFunction)client_close, METH_NOARGS, "Disconnect the client."},
+    {NULL}
+};
+
+static PyTypeObject ClientType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "hpkv_rioc._rioc.Client",
+    .tp_basicsize = sizeof(ClientObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Connection to a RIOC server.",
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)client_init,
+    .tp_dealloc = (destructor)client_dealloc,
+    .tp_methods = client_methods,
+};
+
+// Batch
+
+// The native batch is freed once it is closed and no tracker references it
+static void batch_release(BatchObject *self) {
+    if (self->batch && self->closed && self->trackers == 0) {
+        rioc_batch_free(self->batch);
+        self->batch = NULL;
+    }
+}
+
+static void batch_dealloc(BatchObject *self) {
+    self->closed = 1;
+    batch_release(self);
+    Py_XDECREF(self->client);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int batch_check(BatchObject *self) {
+    if (self->closed || !self->client->client) {
+        raise_rioc_error(RIOC_ERR_PARAM);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *batch_add_packed(BatchObject *self, PyObject *args) {
+    Py_buffer packed;
+    if (batch_check(self) < 0 || !PyArg_ParseTuple(args, "y*", &packed)) {
+        return NULL;
+    }
+
+    int ret = rioc_batch_add_packed(self->batch, packed.buf, packed.len);
+    PyBuffer_Release(&packed);
+    if (ret != RIOC_SUCCESS) {
+        return raise_rioc_error(ret);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *batch_execute(BatchObject *self, PyObject *Py_UNUSED(ignored)) {
+    if (batch_check(self) < 0) {
+        return NULL;
+    }
+
+    struct rioc_batch_tracker *tracker;
+    Py_BEGIN_ALLOW_THREADS
+    tracker = rioc_batch_execute_async(self->batch);
+    Py_END_ALLOW_THREADS
+    if (!tracker) {
+        Py_RETURN_NONE;
+    }
+
+    TrackerObject *obj = PyObject_New(TrackerObject, &TrackerType);
+    if (!obj) {
+        rioc_batch_wait(tracker, -1);
+        rioc_batch_tracker_free(tracker);
+        return NULL;
+    }
+    Py_INCREF(self);
+    self->trackers++;
+    obj->batch = self;
+    obj->tracker = tracker;
+    obj->exports = 0;
+    obj->closed = 0;
+    return (PyObject *)obj;
+}
+
+static PyObject *batch_close(BatchObject *self, PyObject *Py_UNUSED(ignored)) {
+    self->closed = 1;
+    batch_release(self);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef batch_methods[] = {
+    {"add_packed", (PyCFunction)batch_add_packed, METH_VARARGS,
+     "Add the operations of a packed request, see rioc_batch_add_packed."},
+    {"execute", (PyCFunction)batch_execute, METH_NOARGS,
+     "Send the batch and return a tracker, or None on failure."},
+    {"close", (PyCFunction)batch_close, METH_NOARGS, "Free the batch."},
+    {NULL}
+};
+
+static PyTypeObject BatchType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "hpkv_rioc._rioc.Batch",
+    .tp_basicsize = sizeof(BatchObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Batch of RIOC operations.",
+    .tp_dealloc = (destructor)batch_dealloc,
+    .tp_methods = batch_methods,
+};
+
+// Tracker
+
+// The native tracker is freed once it is closed and no buffer over its responses is exported
+static void tracker_release(TrackerObject *self) {
+    if (self->tracker && self->closed && self->exports == 0) {
+        struct rioc_batch_tracker *tracker = self->tracker;
+        self->tracker = NULL;
+        Py_BEGIN_ALLOW_THREADS
+        rioc_batch_wait(tracker, -1);
+        Py_END_ALLOW_THREADS
+        rioc_batch_tracker_free(tracker);
+        self->batch->trackers--;
+        batch_release(self->batch);
+    }
+}
+
+static void tracker_dealloc(TrackerObject *self) {
+    self->closed = 1;
+    tracker_release(self);
+    Py_XDECREF(self->batch);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *tracker_wait(TrackerObject *self, PyObject *args) {
+    int timeout_ms = -1;
+    if (!PyArg_ParseTuple(args, "|i", &timeout_ms)) {
+        return NULL;
+    }
+    if (self->closed) {
+        return raise_rioc_error(RIOC_ERR_PARAM);
+    }
+
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = rioc_batch_wait(self->tracker, timeout_ms);
+    Py_END_ALLOW_THREADS
+    if (ret != RIOC_SUCCESS) {
+        return raise_rioc_error(ret);
+    }
+    Py_RETURN_NONE;
+}
+
+static int tracker_getbuffer(TrackerObject *self, Py_buffer *view, int flags) {
+    if (self->closed) {
+        raise_rioc_error(RIOC_ERR_PARAM);
+        return -1;
+    }
+
+    const char *packed = NULL;
+    size_t packed_len = 0;
+    int ret = rioc_batch_get_packed_responses(self->tracker, &packed, &packed_len);
+    if (ret != RIOC_SUCCESS) {
+        raise_rioc_error(ret);
+        return -1;
+    }
+
+    if (PyBuffer_FillInfo(view, (PyObject *)self, (void *)packed, (Py_ssize_t)packed_len, 1, flags) < 0) {
+        return -1;
+    }
+    self->exports++;
+    return 0;
+}
+
+static void tracker_releasebuffer(TrackerObject *self, Py_buffer *Py_UNUSED(view)) {
+    self->exports--;
+    tracker_release(self);
+}
+
+static PyObject *tracker_responses(TrackerObject *self, PyObject *Py_UNUSED(ignored)) {
+    return PyMemoryView_FromObject((PyObject *)self);
+}
+
+static PyObject *tracker_close(TrackerObject *self, PyObject *Py_UNUSED(ignored)) {
+    self->closed = 1;
+    tracker_release(self);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef tracker_methods[] = {
+    {"wait", (PyCFunction)tracker_wait, METH_VARARGS, "Wait for the batch to complete."},
+    {"responses", (PyCFunction)tracker_responses, METH_NOARGS,
+     "Return the packed responses as a read-only memoryview, see rioc_batch_get_packed_responses."},
+    {"close", (PyCFunction)tracker_close, METH_NOARGS, "Free the tracker once no view is exported."},
+    {NULL}
+};
+
+static PyBufferProcs tracker_as_buffer = {
+    .bf_getbuffer = (getbufferproc)tracker_getbuffer,
+    .bf_releasebuffer = (releasebufferproc)tracker_releasebuffer,
+};
+
+static PyTypeObject TrackerType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "hpkv_rioc._rioc.Tracker",
+    .tp_basicsize = sizeof(TrackerObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Tracks an executing batch.",
+    .tp_dealloc = (destructor)tracker_dealloc,
+    .tp_methods = tracker_methods,
+    .tp_as_buffer = &tracker_as_buffer,
+};
+
+// RangeColumns
+
+static void range_columns_dealloc(RangeColumnsObject *self) {
+    rioc_free_range_columns(&self->columns);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *range_columns_buffers(RangeColumnsObject *self, PyObject *Py_UNUSED(ignored)) {
+    const struct rioc_range_columns *columns = &self->columns;
+    size_t offsets_size = columns->key_offsets ? (columns->count + 1) * sizeof(int64_t) : 0;
+    size_t key_size = columns->key_offsets ? (size_t)columns->key_offsets[columns->count] : 0;
+    size_t value_size = columns->value_offsets ? (size_t)columns->value_offsets[columns->count] : 0;
+    return Py_BuildValue("[(Kn)(Kn)(Kn)(Kn)]",
+                         (unsigned long long)(uintptr_t)columns->key_offsets, (Py_ssize_t)offsets_size,
+                         (unsigned long long)(uintptr_t)columns->key_data, (Py_ssize_t)key_size,
+                         (unsigned long long)(uintptr_t)columns->value_offsets, (Py_ssize_t)offsets_size,
+                         (unsigned long long)(uintptr_t)columns->value_data, (Py_ssize_t)value_size);
+}
+
+static PyObject *range_columns_count(RangeColumnsObject *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromSize_t(self->columns.count);
+}
+
+static PyMethodDef range_columns_methods[] = {
+    {"buffers", (PyCFunction)range_columns_buffers, METH_NOARGS,
+     "Return (address, size) of the key offsets, key data, value offsets and value data."},
+    {NULL}
+};
+
+static PyGetSetDef range_columns_getset[] = {
+    {"count", (getter)range_columns_count, NULL, "Number of rows.", NULL},
+    {NULL}
+};
+
+static PyTypeObject RangeColumnsType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "hpkv_rioc._rioc.RangeColumns",
+    .tp_basicsize = sizeof(RangeColumnsObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Range query rows in columnar form; the memory lives as long as this object.",
+    .tp_dealloc = (destructor)range_columns_dealloc,
+    .tp_methods = range_columns_methods,
+    .tp_getset = range_columns_getset,
+};
+
+// AsyncQueue
+
+static void async_complete(void *arg, int status, char *value, size_t value_len) {
+    struct async_completion *completion = arg;
+    struct async_queue_state *state = completion->state;
+    completion->status = status;
+    completion->value = value;
+    completion->value_len = value_len;
+    completion->next = NULL;
+
+    pthread_mutex_lock(&state->lock);
+    int was_empty = state->head == NULL;
+    if (state->tail) {
+        state->tail->next = completion;
+    } else {
+        state->head = completion;
+    }
+    state->tail = completion;
+    pthread_mutex_unlock(&state->lock);
+
+    // Wake the event loop once per drain rather than once per completion
+    if (was_empty) {
+#ifdef __linux__
+        uint64_t one = 1;
+        ssize_t ret = write(state->write_fd, &one, sizeof(one));
+#else
+        char one = 1;
+        ssize_t ret = write(state->write_fd, &one, sizeof(one));
+#endif
+        (void)ret;
+    }
+}
+
+static void async_completion_free(struct async_completion *completion) {
+    if (completion->value) {
+        if (completion->command == RIOC_CMD_RANGE_QUERY) {
+            rioc_free_range_results((struct rioc_range_result *)completion->value, completion->value_len);
+        } else {
+            rioc_value_free(completion->value);
+        }
+    }
+    free(completion);
+}
+
+static void async_state_free(struct async_queue_state *state) {
+    struct async_completion *completion = state->head;
+    while (completion) {
+        struct async_completion *next = completion->next;
+        async_completion_free(completion);
+        completion = next;
+    }
+    if (state->write_fd != state->read_fd) {
+        close(state->write_fd);
+    }
+    close(state->read_fd);
+    pthread_mutex_destroy(&state->lock);
+    free(state);
+}
+
+static int async_queue_init(AsyncQueueObject *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    ClientObject *client;
+    if (!PyArg_ParseTuple(args, "O!", &ClientType, &client)) {
+        return -1;
+    }
+    if (self->async) {
+        PyErr_SetString(PyExc_RuntimeError, "AsyncQueue is already initialized");
+        return -1;
+    }
+    if (client_check(client) < 0) {
+        return -1;
+    }
+
+    struct async_queue_state *state = calloc(1, sizeof(*state));
+    if (!state) {
+        PyErr_NoMemory();
+        return -1;
+    }
+#ifdef __linux__
+    state->read_fd = state->write_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (state->read_fd < 0) {
+        free(state);
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        free(state);
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    state->read_fd = fds[0];
+    state->write_fd = fds[1];
+#endif
+    pthread_mutex_init(&state->lock, NULL);
+
+    self->async = rioc_async_create(client->client);
+    if (!self->async) {
+        async_state_free(state);
+        raise_rioc_error(RIOC_ERR_MEM);
+        return -1;
+    }
+    Py_INCREF(client);
+    self->client = client;
+    self->state = state;
+    return 0;
+}
+
+// Stop the I/O thread; operations already submitted complete first
+static void async_queue_stop(AsyncQueueObject *self) {
+    if (self->async) {
+        struct rioc_async *async = self->async;
+        self->async = NULL;
+        Py_BEGIN_ALLOW_THREADS
+        rioc_async_free(async);
+        Py_END_ALLOW_THREADS
+    }
+}
+
+static void async_queue_dealloc(AsyncQueueObject *self) {
+    async_queue_stop(self);
+    if (self->state) {
+        async_state_free(self->state);
+    }
+    Py_XDECREF(self->client);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static struct async_completion *async_queue_completion(AsyncQueueObject *self, long long id,
+                                                       uint16_t command) {
+    if (!self->async) {
+        raise_rioc_error(RIOC_ERR_PARAM);
+        return NULL;
+    }
+    struct async_completion *completion = calloc(1, sizeof(*completion));
+    if (!completion) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    completion->state = self->state;
+    completion->id = id;
+    completion->command = command;
+    return completion;
+}
+
+// Submissions only copy the op into the native queue, so they keep the GIL
+
+static PyObject *async_queue_submitted(struct async_completion *completion, int ret) {
+    if (ret != RIOC_SUCCESS) {
+        free(completion);
+        return raise_rioc_error(ret);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *async_queue_get(AsyncQueueObject *self, PyObject *args) {
+    long long id;
+    Py_buffer key;
+    if (!PyArg_ParseTuple(args, "Ly*", &id, &key)) {
+        return NULL;
+    }
+    struct async_completion *completion = async_queue_completion(self, id, RIOC_CMD_GET);
+    if (!completion) {
+        PyBuffer_Release(&key);
+        return NULL;
+    }
+    int ret = rioc_async_get(self->async, key.buf, key.len, async_complete, completion);
+    PyBuffer_Release(&key);
+    return async_queue_submitted(completion, ret);
+}
+
+static PyObject *async_queue_insert(AsyncQueueObject *self, PyObject *args) {
+    long long id;
+    Py_buffer key, value;
+    unsigned long long timestamp;
+    if (!PyArg_ParseTuple(args, "Ly*y*K", &id, &key, &value, &timestamp)) {
+        return NULL;
+    }
+    struct async_completion *completion = async_queue_completion(self, id, RIOC_CMD_INSERT);
+    int ret = completion ?
+        rioc_async_insert(self->async, key.buf, key.len, value.buf, value.len, timestamp,
+                          async_complete, completion) : RIOC_SUCCESS;
+    PyBuffer_Release(&key);
+    PyBuffer_Release(&value);
+    return completion ? async_queue_submitted(completion, ret) : NULL;
+}
+
+static PyObject *async_queue_delete(AsyncQueueObject *self, PyObject *args) {
+    long long id;
+    Py_buffer key;
+    unsigned long long timestamp;
+    if (!PyArg_ParseTuple(args, "Ly*K", &id, &key, &timestamp)) {
+        return NULL;
+    }
+    struct async_completion *completion = async_queue_completion(self, id, RIOC_CMD_DELETE);
+    int ret = completion ?
+        rioc_async_delete(self->async, key.buf, key.len, timestamp, async_complete, completion) :
+        RIOC_SUCCESS;
+    PyBuffer_Release(&key);
+    return completion ? async_queue_submitted(completion, ret) : NULL;
+}
+
+static PyObject *async_queue_range_query(AsyncQueueObject *self, PyObject *args) {
+    long long id;
+    Py_buffer start_key, end_key;
+    if (!PyArg_ParseTuple(args, "Ly*y*", &id, &start_key, &end_key)) {
+        return NULL;
+    }
+    struct async_completion *completion = async_queue_completion(self, id, RIOC_CMD_RANGE_QUERY);
+    int ret = completion ?
+        rioc_async_range_query(self->async, start_key.buf, start_key.len, end_key.buf, end_key.len,
+                               async_complete, completion) : RIOC_SUCCESS;
+    PyBuffer_Release(&start_key);
+    PyBuffer_Release(&end_key);
+    return completion ? async_queue_submitted(completion, ret) : NULL;
+}
+
+static PyObject *async_queue_atomic_inc_dec(AsyncQueueObject *self, PyObject *args) {
+    long long id;
+    Py_buffer key;
+    long long value;
+    unsigned long long timestamp;
+    if (!PyArg_ParseTuple(args, "Ly*LK", &id, &key, &value, &timestamp)) {
+        return NULL;
+    }
+    struct async_completion *completion = async_queue_completion(self, id, RIOC_CMD_ATOMIC_INC_DEC);
+    int ret = completion ?
+        rioc_async_atomic_inc_dec(self->async, key.buf, key.len, value, timestamp,
+                                  async_complete, completion) : RIOC_SUCCESS;
+    PyBuffer_Release(&key);
+    return completion ? async_queue_submitted(completion, ret) : NULL;
+}
+
+// Result object of a successful completion
+static PyObject *async_completion_result(struct async_completion *completion) {
+    switch (completion->command) {
+        case RIOC_CMD_GET:
+            return PyBytes_FromStringAndSize(completion->value,
+                                             completion->value ? (Py_ssize_t)completion->value_len : 0);
+        case RIOC_CMD_RANGE_QUERY: {
+            const struct rioc_range_result *rows = (const struct rioc_range_result *)completion->value;
+            size_t count = rows ? completion->value_len : 0;
+            PyObject *list = PyList_New((Py_ssize_t)count);
+            for (size_t i = 0; list && i < count; i++) {
+                PyObject *row = Py_BuildValue("(y#y#)", rows[i].key, (Py_ssize_t)rows[i].key_len,
+                                              rows[i].value, (Py_ssize_t)rows[i].value_len);
+                if (!row) {
+                    Py_CLEAR(list);
+                    break;
+                }
+                PyList_SET_ITEM(list, (Py_ssize_t)i, row);
+            }
+            return list;
+        }
+        case RIOC_CMD_ATOMIC_INC_DEC: {
+            int64_t result = 0;
+            if (completion->value && completion->value_len >= sizeof(result)) {
+                memcpy(&result, completion->value, sizeof(result));
+            }
+            return PyLong_FromLongLong(result);
+        }
+        default:
+            Py_RETURN_NONE;
+    }
+}
+
+static PyObject *async_queue_drain(AsyncQueueObject *self, PyObject *Py_UNUSED(ignored)) {
+    struct async_queue_state *state = self->state;
+    if (!state) {
+        return PyList_New(0);
+    }
+
+    // Reset the wakeup before taking the list, so a later completion signals again
+#ifdef __linux__
+    uint64_t count;
+    while (read(state->read_fd, &count, sizeof(count)) > 0) {
+    }
+#else
+    char buf[64];
+    while (read(state->read_fd, buf, sizeof(buf)) > 0) {
+    }
+#endif
+
+    pthread_mutex_lock(&state->lock);
+    struct async_completion *completion = state->head;
+    state->head = state->tail = NULL;
+    pthread_mutex_unlock(&state->lock);
+
+    PyObject *list = PyList_New(0);
+    while (completion) {
+        struct async_completion *next = completion->next;
+        if (list) {
+            PyObject *result;
+            if (completion->status == RIOC_SUCCESS) {
+                result = async_completion_result(completion);
+            } else {
+                result = Py_None;
+                Py_INCREF(result);
+            }
+            PyObject *item = result ?
+                Py_BuildValue("(LiN)", completion->id, completion->status, result) : NULL;
+            if (!item || PyList_Append(list, item) < 0) {
+                Py_CLEAR(list);
+            }
+            Py_XDECREF(item);
+        }
+        async_completion_free(completion);
+        completion = next;
+    }
+    return list;
+}
+
+static PyObject *async_queue_fileno(AsyncQueueObject *self, PyObject *Py_UNUSED(ignored)) {
+    if (!self->state) {
+        return raise_rioc_error(RIOC_ERR_PARAM);
+    }
+    return PyLong_FromLong(self->state->read_fd);
+}
+
+static PyObject *async_queue_close(AsyncQueueObject *self, PyObject *Py_UNUSED(ignored)) {
+    async_queue_stop(self);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef async_queue_methods[] = {
+    {"get", (PyCFunction)async_queue_get, METH_VARARGS, "Submit a GET."},
+    {"insert", (PyCFunction)async_queue_insert, METH_VARARGS, "Submit an INSERT."},
+    {"delete", (PyCFunction)async_queue_delete, METH_VARARGS, "Submit a DELETE."},
+    {"range_query", (PyCFunction)async_queue_range_query, METH_VARARGS, "Submit a RANGE_QUERY."},
+    {"atomic_inc_dec", (PyCFunction)async_queue_atomic_inc_dec, METH_VARARGS,
+     "Submit an ATOMIC_INC_DEC."},
+    {"drain", (PyCFunction)async_queue_drain, METH_NOARGS,
+     "Return (id, status, result) for every operation completed since the last drain."},
+    {"fileno", (PyCFunction)async_queue_fileno, METH_NOARGS,
+     "File descriptor that is readable while completions are waiting."},
+    {"close", (PyCFunction)async_queue_close, METH_NOARGS,
+     "Complete submitted operations and stop the I/O thread."},
+    {NULL}
+};
+
+static PyTypeObject AsyncQueueType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "hpkv_rioc._rioc.AsyncQueue",
+    .tp_basicsize = sizeof(AsyncQueueObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Operations sent by a native I/O thread over a dedicated client, see rioc_async.",
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)async_queue_init,
+    .tp_dealloc = (destructor)async_queue_dealloc,
+    .tp_methods = async_queue_methods,
+};
+
+// Module
+
+static PyObject *module_timestamp_ns(PyObject *Py_UNUSED(module), PyObject *Py_UNUSED(ignored)) {
+    return PyLong_FromUnsignedLongLong(rioc_get_timestamp_ns());
+}
+
+static PyMethodDef module_methods[] = {
+    {"timestamp_ns", module_timestamp_ns, METH_NOARGS, "Current timestamp in nanoseconds."},
+    {NULL}
+};
+
+static struct PyModuleDef rioc_module = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "hpkv_rioc._rioc",
+    .m_doc = "Compiled librioc binding.",
+    .m_size = -1,
+    .m_methods = module_methods,
+};
+
+PyMODINIT_FUNC PyInit__rioc(void) {
+    if (PyType_Ready(&ClientType) < 0 || PyType_Ready(&BatchType) < 0 ||
+        PyType_Ready(&TrackerType) < 0 || PyType_Ready(&RangeColumnsType) < 0 ||
+        PyType_Ready(&AsyncQueueType) < 0) {
+        return NULL;
+    }
+
+    PyObject *exceptions = PyImport_ImportModule("hpkv_rioc.exceptions");
+    if (!exceptions) {
+        return NULL;
+    }
+    create_rioc_error = PyObject_GetAttrString(exceptions, "create_rioc_error");
+    Py_DECREF(exceptions);
+    if (!create_rioc_error) {
+        return NULL;
+    }
+
+    PyObject *module = PyModule_Create(&rioc_module);
+    if (!module) {
+        return NULL;
+    }
+    Py_INCREF(&ClientType);
+    Py_INCREF(&BatchType);
+    Py_INCREF(&TrackerType);
+    Py_INCREF(&AsyncQueueType);
+    if (PyModule_AddObject(module, "Client", (PyObject *)&ClientType) < 0 ||
+        PyModule_AddObject(module, "Batch", (PyObject *)&BatchType) < 0 ||
+        PyModule_AddObject(module, "Tracker", (PyObject *)&TrackerType) < 0 ||
+        PyModule_AddObject(module, "AsyncQueue", (PyObject *)&AsyncQueueType) < 0) {
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -0,0 +1,239 @@
+"""
+asyncio RIOC client
+"""
+
+import asyncio
+import itertools
+from typing import Any, Dict, List, Optional, Tuple
+
+from .client import RangeQueryResult
+from .config import RiocConfig
+from .exceptions import RiocError, create_rioc_error
+from .native import backend
+
+_MAX_BATCH_SIZE = 128
+
+class AsyncRiocClient:
+    """asyncio client for the HPKV store.
+
+    Operations are handed to a native I/O thread that merges queued operations into
+    batches and pipelines up to four of them on the connection. Completions are
+    signalled through a file descriptor registered with the event loop, so the loop
+    thread never blocks and thousands of requests can be awaited at once; those beyond
+    the pipeline wait in the native queue.
+
+    The client must be used from a single event loop.
+    """
+    def __init__(self, config: RiocConfig):
+        """Initialize the client and connect to the server."""
+        tls = config.tls
+        self._client = backend.Client(
+            config.host,
+            config.port,
+            config.timeout_ms,
+            tls is not None,
+            tls.certificate_path if tls else None,
+            tls.key_path if tls else None,
+            tls.ca_path if tls else None,
+            tls.verify_hostname if tls else None,
+            tls.verify_peer if tls else True,
+        )
+        try:
+            self._queue = backend.AsyncQueue(self._client)
+        except BaseException:
+            self._client.close()
+            raise
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        self._pending: Dict[int, asyncio.Future] = {}
+        self._ids = itertools.count(1)
+        self._closed = False
+
+    def _submit(self, submit, *args) -> "asyncio.Future":
+        if self._closed:
+            raise RiocError(-1, "Client is closed")
+
+        loop = asyncio.get_running_loop()
+        if self._loop is None:
+            self._loop = loop
+            loop.add_reader(self._queue.fileno(), self._on_readable)
+        elif self._loop is not loop:
+            raise RiocError(-1, "Client is bound to a different event loop")
+
+        op_id = next(self._ids)
+        submit(op_id, *args)
+        future = loop.create_future()
+        self._pending[op_id] = future
+        return future
+
+    def _on_readable(self) -> None:
+        self._complete(self._queue.drain())
+
+    def _complete(self, completed: List[Tuple[int, int, Any]]) -> None:
+        for op_id, status, result in completed:
+            future = self._pending.pop(op_id, None)
+            if future is None or future.done():
+                continue
+            if status != 0:
+                future.set_exception(create_rioc_error(status))
+            else:
+                future.set_result(result)
+
+    async def get(self, key: bytes) -> bytes:
+        """Get a value by key."""
+        return await self._submit(self._queue.get, key)
+
+    async def get_string(self, key: str) -> str:
+        """Get a string value by string key."""
+        value = await self.get(key.encode("utf-8"))
+        return value.decode("utf-8")
+
+    async def insert(self, key: bytes, value: bytes, timestamp: Optional[int] = None) -> None:
+        """Insert or update a key-value pair."""
+        if timestamp is None:
+            timestamp = backend.timestamp_ns()
+        await self._submit(self._queue.insert, key, value, timestamp)
+
+    async def insert_string(self, key: str, value: str, timestamp: Optional[int] = None) -> None:
+        """Insert or update a string key-value pair."""
+        await self.insert(key.encode("utf-8"), value.encode("utf-8"), timestamp)
+
+    async def delete(self, key: bytes, timestamp: Optional[int] = None) -> None:
+        """Delete a key-value pair."""
+        if timestamp is None:
+            timestamp = backend.timestamp_ns()
+        await self._submit(self._queue.delete, key, timestamp)
+
+    async def delete_string(self, key: str, timestamp: Optional[int] = None) -> None:
+        """Delete a key-value pair using string key."""
+        await self.delete(key.encode("utf-8"), timestamp)
+
+    async def range_query(self, start_key: bytes, end_key: bytes) -> List[RangeQueryResult]:
+        """Retrieve all key-value pairs within the specified range."""
+        rows = await self._submit(self._queue.range_query, start_key, end_key)
+        return [RangeQueryResult(key, value) for key, value in rows]
+
+    async def range_query_string(self, start_key: str, end_key: str) -> List[Tuple[str, str]]:
+        """Perform a range query with string keys and return string results."""
+        results = await self.range_query(start_key.encode("utf-8"), end_key.encode("utf-8"))
+        return [(result.key.decode("utf-8"), result.value.decode("utf-8")) for result in results]
+
+    async def atomic_inc_dec(self, key: bytes, value: int, timestamp: Optional[int] = None) -> int:
+        """Atomically increment or decrement a counter and return its new value."""
+        if not isinstance(key, bytes):
+            raise TypeError("key must be bytes")
+        if not isinstance(value, int):
+            raise TypeError("value must be an integer")
+        if timestamp is None:
+            timestamp = backend.timestamp_ns()
+        return await self._submit(self._queue.atomic_inc_dec, key, value, timestamp)
+
+    async def atomic_inc_dec_string(self, key: str, value: int, timestamp: Optional[int] = None) -> int:
+        """Atomically increment or decrement a counter using string key."""
+        return await self.atomic_inc_dec(key.encode("utf-8"), value, timestamp)
+
+    def batch(self) -> "AsyncRiocBatch":
+        """Create a batch whose operations are submitted together on execute()."""
+        if self._closed:
+            raise RiocError(-1, "Client is closed")
+        return AsyncRiocBatch(self)
+
+    @staticmethod
+    def get_timestamp() -> int:
+        """Get the current timestamp in nanoseconds."""
+        return backend.timestamp_ns()
+
+    async def close(self) -> None:
+        """Complete outstanding operations, then close the connection."""
+        if self._closed:
+            return
+        self._closed = True
+
+        if self._loop is not None:
+            self._loop.remove_reader(self._queue.fileno())
+        # Stopping the I/O thread waits for submitted operations to complete
+        await asyncio.get_running_loop().run_in_executor(None, self._queue.close)
+        self._complete(self._queue.drain())
+        for future in self._pending.values():
+            if not future.done():
+                future.set_exception(RiocError(-1, "Client is closed"))
+        self._pending.clear()
+        self._client.close()
+
+    async def __aenter__(self) -> "AsyncRiocClient":
+        return self
+
+    async def __aexit__(self, *exc_info) -> None:
+        await self.close()
+
+class AsyncRiocBatchResult:
+    """Results of an executed AsyncRiocBatch, indexed in the order operations were added."""
+    def __init__(self, results: List[Any]):
+        self._results = results
+
+    def _result(self, index: int) -> Any:
+        if index < 0 or index >= len(self._results):
+            raise create_rioc_error(-1)
+        result = self._results[index]
+        if isinstance(result, BaseException):
+            raise result
+        return result
+
+    def get_response(self, index: int) -> bytes:
+        """Get the response for a GET operation at the specified index."""
+        return self._result(index)
+
+    def get_range_query_response(self, index: int) -> List[RangeQueryResult]:
+        """Get the response for a RANGE QUERY operation at the specified index."""
+        return [RangeQueryResult(key, value) for key, value in self._result(index)]
+
+    def get_atomic_result(self, index: int) -> int:
+        """Get the response for an ATOMIC_INC_DEC operation at the specified index."""
+        return self._result(index)
+
+class AsyncRiocBatch:
+    """A batch of operations for an AsyncRiocClient.
+
+    Operations are held until execute() and then submitted back to back, so the native
+    I/O thread sends them in one round trip unless other requests are already queued.
+    """
+    def __init__(self, client: AsyncRiocClient):
+        self._client = client
+        self._ops: List[Tuple[str, tuple]] = []
+
+    def _add(self, method: str, *args) -> None:
+        if len(self._ops) >= _MAX_BATCH_SIZE:
+            raise create_rioc_error(-1)
+        self._ops.append((method, args))
+
+    def add_get(self, key: bytes) -> None:
+        """Add a GET operation to the batch."""
+        self._add("get", key)
+
+    def add_insert(self, key: bytes, value: bytes, timestamp: int) -> None:
+        """Add an INSERT operation to the batch."""
+        self._add("insert", key, value, timestamp)
+
+    def add_delete(self, key: bytes, timestamp: int) -> None:
+        """Add a DELETE operation to the batch."""
+        self._add("delete", key, timestamp)
+
+    def add_range_query(self, start_key: bytes, end_key: bytes) -> None:
+        """Add a range query operation to the batch."""
+        self._add("range_query", start_key, end_key)
+
+    def add_atomic_inc_dec(self, key: bytes, value: int, timestamp: int) -> None:
+        """Add an atomic increment/decrement operation to the batch."""
+        self._add("atomic_inc_dec", key, value, timestamp)
+
+    async def execute(self) -> AsyncRiocBatchResult:
+        """Submit the operations and wait for all of them to complete.
+
+        A failed operation does not fail the batch; its error is raised when its
+        result is read.
+        """
+        queue = self._client._queue  # pylint: disable=protected-access
+        ops, self._ops = self._ops, []
+        futures = [self._client._submit(getattr(queue, method), *args)  # pylint: disable=protected-access
+                   for method, args in ops]
+        results = await asyncio.gather(*futures, return_exceptions=True)
+        return AsyncRiocBatchResult(results)
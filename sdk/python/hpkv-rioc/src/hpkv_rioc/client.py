@@ -2,19 +2,14 @@
 RIOC client implementation
 """
 
-import ctypes
+import struct
 import threading
 from contextlib import contextmanager
 from typing import Optional, List, Dict, Any, Generator, Tuple
 
 from .config import RiocConfig, RiocTlsConfig
 from .exceptions import RiocError, create_rioc_error
-from .native import (
-    rioc_native,
-    NativeClientConfig,
-    NativeTlsConfig,
-    NativeRangeResult,
-)
+from .native import backend
 
 class RangeQueryResult:
     """Represents a key-value pair returned from a range query."""
@@ -22,12 +17,77 @@ class RangeQueryResult:
         self.key = key
         self.value = value
 
+# Wire layout shared with rioc_batch_add_packed and rioc_batch_get_packed_responses,
+# in native byte order without padding
+_OP_HEADER = struct.Struct("=HHIQ")      # command, key_len, value_len, timestamp
+_RESULT_HEADER = struct.Struct("=iIQ")   # status, count, data_len
+_ROW_HEADER = struct.Struct("=II")       # key_len, value_len
+_INT64 = struct.Struct("=q")
+
+_CMD_GET = 1
+_CMD_INSERT = 2
+_CMD_DELETE = 3
+_CMD_RANGE_QUERY = 6
+_CMD_ATOMIC_INC_DEC = 7
+
+_MAX_BATCH_SIZE = 128
+_MAX_KEY_SIZE = 512
+_MAX_VALUE_SIZE = 100 * 1024
+
+def _bulk_column(column: Any) -> Tuple[Any, Any]:
+    """Return (int64 offsets, uint8 data) NumPy arrays for a column of binary items.
+
+    column is a pyarrow binary or string array (chunked or not, large or not), or an
+    (offsets, data) pair of NumPy arrays or buffers in the same layout. Arrow buffers
+    are used in place; only int32 offsets are widened.
+    """
+    import numpy as np  # pylint: disable=import-outside-toplevel
+
+    if isinstance(column, tuple):
+        offsets, data = column
+        offsets = np.ascontiguousarray(offsets, dtype=np.int64)
+        data = np.frombuffer(data, dtype=np.uint8) if not isinstance(data, np.ndarray) else data
+        data = np.ascontiguousarray(data).reshape(-1).view(np.uint8)
+    else:
+        import pyarrow as pa  # pylint: disable=import-outside-toplevel
+
+        if isinstance(column, pa.ChunkedArray):
+            column = column.combine_chunks()
+        if not isinstance(column, pa.Array):
+            column = pa.array(column, type=pa.binary())
+        if column.null_count:
+            raise ValueError("bulk keys and values must not contain nulls")
+        if pa.types.is_large_binary(column.type) or pa.types.is_large_string(column.type):
+            offset_type = np.int64
+        elif pa.types.is_binary(column.type) or pa.types.is_string(column.type):
+            offset_type = np.int32
+        else:
+            raise TypeError(f"unsupported column type {column.type}")
+        _, offsets_buffer, data_buffer = column.buffers()
+        offsets = np.frombuffer(offsets_buffer, dtype=offset_type, count=len(column) + 1,
+                                offset=column.offset * np.dtype(offset_type).itemsize)
+        offsets = offsets.astype(np.int64, copy=False)
+        data = (np.frombuffer(data_buffer, dtype=np.uint8) if data_buffer is not None
+                else np.zeros(0, dtype=np.uint8))
+
+    if (len(offsets) == 0 or offsets[0] < 0 or offsets[-1] > len(data) or
+            np.any(offsets[1:] < offsets[:-1])):
+        raise ValueError("bulk offsets must be non-decreasing and within the data")
+    return offsets, data
+
 class RiocBatchTracker:
-    """Tracks the execution of a batch operation."""
-    def __init__(self, handle: ctypes.c_void_p):
-        self._handle = handle
+    """Tracks the execution of a batch operation.
+
+    All responses are fetched from the native tracker in one call on first access
+    and sliced per operation on demand. With the compiled extension they are a view
+    over the native buffer rather than a copy.
+    """
+    def __init__(self, tracker: Any):
+        self._tracker = tracker
         self._completed = False
         self._closed = False
+        self._packed: Optional[memoryview] = None
+        self._offsets: List[int] = []
 
     def wait(self, timeout_ms: int = -1) -> None:
         """Wait for the batch operation to complete."""
@@ -36,92 +96,65 @@ class RiocBatchTracker:
         if self._completed:
             return
 
-        result = rioc_native.lib.rioc_batch_wait(self._handle, timeout_ms)
-        if result != 0:
-            raise create_rioc_error(result)
+        self._tracker.wait(timeout_ms)
         self._completed = True
 
-    def get_response(self, index: int) -> bytes:
-        """Get the response for a GET operation at the specified index."""
+    def _result(self, index: int) -> Tuple[int, int, int, int]:
+        """Return (status, count, data offset, data length) of the operation at index."""
         if self._closed:
             raise RiocError(-1, "Batch tracker is closed")
         if not self._completed:
             raise RiocError(-1, "Batch operation not completed")
 
-        value_ptr = ctypes.POINTER(ctypes.c_char)()
-        value_len = ctypes.c_size_t()
+        if self._packed is None:
+            packed = memoryview(self._tracker.responses())
+            offset = 0
+            while offset < len(packed):
+                self._offsets.append(offset)
+                offset += _RESULT_HEADER.size + _RESULT_HEADER.unpack_from(packed, offset)[2]
+            self._packed = packed
 
-        result = rioc_native.lib.rioc_batch_get_response_async(
-            self._handle, index, ctypes.byref(value_ptr), ctypes.byref(value_len)
-        )
-        if result != 0:
-            raise create_rioc_error(result)
+        if index < 0 or index >= len(self._offsets):
+            raise create_rioc_error(-1)
 
-        if not value_ptr or value_len.value == 0:
-            return b""
+        offset = self._offsets[index]
+        status, count, data_len = _RESULT_HEADER.unpack_from(self._packed, offset)
+        if status != 0:
+            raise create_rioc_error(status)
+        return status, count, offset + _RESULT_HEADER.size, data_len
 
-        return ctypes.string_at(value_ptr, value_len.value)
+    def get_response(self, index: int) -> bytes:
+        """Get the response for a GET operation at the specified index."""
+        _, _, offset, data_len = self._result(index)
+        return bytes(self._packed[offset:offset + data_len])
 
     def get_range_query_response(self, index: int) -> List[RangeQueryResult]:
         """Get the response for a RANGE QUERY operation at the specified index."""
-        if self._closed:
-            raise RiocError(-1, "Batch tracker is closed")
-        if not self._completed:
-            raise RiocError(-1, "Batch operation not completed")
-
-        value_ptr = ctypes.POINTER(ctypes.c_char)()
-        value_len = ctypes.c_size_t()
-
-        result = rioc_native.lib.rioc_batch_get_response_async(
-            self._handle, index, ctypes.byref(value_ptr), ctypes.byref(value_len)
-        )
-        if result != 0:
-            raise create_rioc_error(result)
-
-        if not value_ptr or value_len.value == 0:
-            return []
+        _, count, offset, _ = self._result(index)
 
-        # For range query, value_ptr points to an array of NativeRangeResult structs
-        # and value_len is the count of results
-        results_ptr = ctypes.cast(value_ptr, ctypes.POINTER(NativeRangeResult))
-        results_count = value_len.value
-
-        # Convert native results to Python objects
         results = []
-        for i in range(results_count):
-            result = results_ptr[i]
-            key = ctypes.string_at(result.key, result.key_len)
-            value = ctypes.string_at(result.value, result.value_len)
+        packed = self._packed
+        for _ in range(count):
+            key_len, value_len = _ROW_HEADER.unpack_from(packed, offset)
+            offset += _ROW_HEADER.size
+            key = bytes(packed[offset:offset + key_len])
+            offset += key_len
+            value = bytes(packed[offset:offset + value_len])
+            offset += value_len
             results.append(RangeQueryResult(key, value))
 
         return results
 
     def get_atomic_result(self, index: int) -> int:
         """Get the response for an ATOMIC_INC_DEC operation at the specified index."""
-        if self._closed:
-            raise RiocError(-1, "Batch tracker is closed")
-        if not self._completed:
-            raise RiocError(-1, "Batch operation not completed")
-
-        value_ptr = ctypes.POINTER(ctypes.c_char)()
-        value_len = ctypes.c_size_t()
-
-        result = rioc_native.lib.rioc_batch_get_response_async(
-            self._handle, index, ctypes.byref(value_ptr), ctypes.byref(value_len)
-        )
-        if result != 0:
-            raise create_rioc_error(result)
-
-        if not value_ptr or value_len.value < ctypes.sizeof(ctypes.c_int64):
+        _, _, offset, data_len = self._result(index)
+        if data_len < _INT64.size:
             return 0
-
-        # For atomic operations, value_ptr points to an int64_t
-        result_value = ctypes.cast(value_ptr, ctypes.POINTER(ctypes.c_int64))[0]
-        return result_value
+        return _INT64.unpack_from(self._packed, offset)[0]
 
     def close(self) -> None:
         """Clean up the native resources."""
-        if not self._closed and hasattr(self, "_handle") and self._handle:
+        if not self._closed and hasattr(self, "_tracker") and self._tracker:
             try:
                 if not self._completed:
                     # Try to wait with a short timeout to ensure completion
@@ -129,9 +162,12 @@ class RiocBatchTracker:
                         self.wait(timeout_ms=100)
                     except:  # pylint: disable=bare-except
                         pass
-                rioc_native.lib.rioc_batch_tracker_free(self._handle)
+                if self._packed is not None:
+                    self._packed.release()
+                    self._packed = None
+                self._tracker.close()
             finally:
-                self._handle = None
+                self._tracker = None
                 self._closed = True
 
     def __del__(self):
@@ -142,89 +178,52 @@ class RiocBatchTracker:
             pass
 
 class RiocBatch:
-    """A batch of RIOC operations."""
-    def __init__(self, handle: ctypes.c_void_p):
-        self._handle = handle
-        self._operations: List[Dict[str, Any]] = []
+    """A batch of RIOC operations.
+
+    Operations are packed in Python and handed to the native batch in one call
+    when the batch is executed.
+    """
+    def __init__(self, batch: Any):
+        self._batch = batch
+        self._packed = bytearray()
+        self._count = 0
         self._closed = False
 
-    def add_get(self, key: bytes) -> None:
-        """Add a GET operation to the batch."""
+    def _add(self, command: int, key: bytes, value: bytes, timestamp: int) -> None:
         if self._closed:
             raise RiocError(-1, "Batch is closed")
-        result = rioc_native.lib.rioc_batch_add_get(
-            self._handle,
-            key,
-            len(key)
-        )
-        if result != 0:
-            raise create_rioc_error(result)
-        self._operations.append({"type": "get", "key": key})
+        if (self._count >= _MAX_BATCH_SIZE or len(key) > _MAX_KEY_SIZE or
+                len(value) > _MAX_VALUE_SIZE):
+            raise create_rioc_error(-1)
+
+        self._packed += _OP_HEADER.pack(command, len(key), len(value), timestamp)
+        self._packed += key
+        self._packed += value
+        self._count += 1
+
+    def add_get(self, key: bytes) -> None:
+        """Add a GET operation to the batch."""
+        self._add(_CMD_GET, key, b"", 0)
 
     def add_insert(self, key: bytes, value: bytes, timestamp: int) -> None:
         """Add an INSERT operation to the batch."""
-        if self._closed:
-            raise RiocError(-1, "Batch is closed")
-        result = rioc_native.lib.rioc_batch_add_insert(
-            self._handle,
-            key,
-            len(key),
-            value,
-            len(value),
-            timestamp
-        )
-        if result != 0:
-            raise create_rioc_error(result)
-        self._operations.append({
-            "type": "insert",
-            "key": key,
-            "value": value,
-            "timestamp": timestamp
-        })
+        self._add(_CMD_INSERT, key, value, timestamp)
 
     def add_delete(self, key: bytes, timestamp: int) -> None:
         """Add a DELETE operation to the batch."""
-        if self._closed:
-            raise RiocError(-1, "Batch is closed")
-        result = rioc_native.lib.rioc_batch_add_delete(
-            self._handle,
-            key,
-            len(key),
-            timestamp
-        )
-        if result != 0:
-            raise create_rioc_error(result)
-        self._operations.append({
-            "type": "delete",
-            "key": key,
-            "timestamp": timestamp
-        })
+        self._add(_CMD_DELETE, key, b"", timestamp)
 
     def add_range_query(self, start_key: bytes, end_key: bytes) -> None:
         """Add a range query operation to the batch."""
-        if self._closed:
-            raise RiocError(-1, "Batch is closed")
-
         # Input validation
         if not isinstance(start_key, bytes):
             raise TypeError("start_key must be bytes")
         if not isinstance(end_key, bytes):
             raise TypeError("end_key must be bytes")
-        
-        # Call native method
-        result = rioc_native.lib.rioc_batch_add_range_query(
-            self._handle,
-            start_key, len(start_key),
-            end_key, len(end_key)
-        )
-        
-        if result != 0:
-            raise create_rioc_error(result)
-        self._operations.append({
-            "type": "range_query",
-            "start_key": start_key,
-            "end_key": end_key
-        })
+        if len(end_key) > _MAX_KEY_SIZE:
+            raise create_rioc_error(-1)
+
+        self._add(_CMD_RANGE_QUERY, start_key, end_key, 0)
 
     def add_atomic_inc_dec(self, key: bytes, value: int, timestamp: int) -> None:
         """Add an atomic increment/decrement operation to the batch.
@@ -234,9 +233,6 @@ class RiocBatch:
             value: The amount to increment (positive) or decrement (negative).
             timestamp: The timestamp for this operation.
         """
-        if self._closed:
-            raise RiocError(-1, "Batch is closed")
-
         # Input validation
         if not isinstance(key, bytes):
             raise TypeError("key must be bytes")
@@ -245,39 +241,30 @@ class RiocBatch:
         if not isinstance(timestamp, int):
             raise TypeError("timestamp must be int")
 
-        # Call native method
-        result = rioc_native.lib.rioc_batch_add_atomic_inc_dec(
-            self._handle,
-            key, len(key),
-            value,
-            timestamp
-        )
-
-        if result != 0:
-            raise create_rioc_error(result)
-        self._operations.append({
-            "type": "atomic_inc_dec",
-            "key": key,
-            "value": value,
-            "timestamp": timestamp
-        })
+        self._add(_CMD_ATOMIC_INC_DEC, key, _INT64.pack(value), timestamp)
 
     def execute(self) -> RiocBatchTracker:
         """Execute the batch operations."""
         if self._closed:
             raise RiocError(-1, "Batch is closed")
-        tracker_handle = rioc_native.lib.rioc_batch_execute_async(self._handle)
-        if not tracker_handle:
+
+        # Hand every operation added since the last execute to the native batch at once
+        if self._packed:
+            self._batch.add_packed(bytes(self._packed))
+            self._packed = bytearray()
+
+        tracker = self._batch.execute()
+        if tracker is None:
             raise RiocError(-1, "Failed to execute batch")
-        return RiocBatchTracker(tracker_handle)
+        return RiocBatchTracker(tracker)
 
     def close(self) -> None:
         """Clean up the native resources."""
-        if not self._closed and hasattr(self, "_handle") and self._handle:
+        if not self._closed and hasattr(self, "_batch") and self._batch:
             try:
-                rioc_native.lib.rioc_batch_free(self._handle)
+                self._batch.close()
             finally:
-                self._handle = None
+                self._batch = None
                 self._closed = True
 
     def __del__(self):
@@ -291,46 +278,18 @@ class RiocClient:
     """RIOC client for interacting with the HPKV store."""
     def __init__(self, config: RiocConfig):
         """Initialize the RIOC client."""
-        # Initialize platform
-        result = rioc_native.lib.rioc_platform_init()
-        if result != 0:
-            raise RiocError(result, "Failed to initialize platform")
-
-        # Convert config to native config
-        native_config = NativeClientConfig()
-        native_config.host = config.host.encode("utf-8")
-        native_config.port = config.port
-        native_config.timeout_ms = config.timeout_ms
-
-        # Handle TLS config
-        native_tls_config = None
-        if config.tls:
-            native_tls_config = NativeTlsConfig()
-            if config.tls.certificate_path:
-                native_tls_config.cert_path = config.tls.certificate_path.encode("utf-8")
-            if config.tls.key_path:
-                native_tls_config.key_path = config.tls.key_path.encode("utf-8")
-            if config.tls.ca_path:
-                native_tls_config.ca_path = config.tls.ca_path.encode("utf-8")
-            if config.tls.verify_hostname:
-                native_tls_config.verify_hostname = config.tls.verify_hostname.encode("utf-8")
-            native_tls_config.verify_peer = config.tls.verify_peer
-            self._tls_config = native_tls_config  # Keep reference to prevent GC
-            native_config.tls = ctypes.pointer(native_tls_config)
-        else:
-            native_config.tls = None
-            self._tls_config = None
-
-        # Connect to server
-        client_handle = ctypes.c_void_p()
-        result = rioc_native.lib.rioc_client_connect_with_config(
-            ctypes.byref(native_config),
-            ctypes.byref(client_handle)
+        tls = config.tls
+        self._client = backend.Client(
+            config.host,
+            config.port,
+            config.timeout_ms,
+            tls is not None,
+            tls.certificate_path if tls else None,
+            tls.key_path if tls else None,
+            tls.ca_path if tls else None,
+            tls.verify_hostname if tls else None,
+            tls.verify_peer if tls else True,
         )
-        if result != 0:
-            raise create_rioc_error(result)
-
-        self._handle = client_handle
         self._closed = False
         self._lock = threading.RLock()
 
@@ -340,23 +299,7 @@ class RiocClient:
             raise RiocError(-1, "Client is closed")
 
         with self._lock:
-            value_ptr = ctypes.POINTER(ctypes.c_char)()
-            value_len = ctypes.c_size_t()
-
-            result = rioc_native.lib.rioc_get(
-                self._handle,
-                key,
-                len(key),
-                ctypes.byref(value_ptr),
-                ctypes.byref(value_len)
-            )
-            if result != 0:
-                raise create_rioc_error(result)
-
-            if not value_ptr or value_len.value == 0:
-                return b""
-
-            return ctypes.string_at(value_ptr, value_len.value)
+            return self._client.get(key)
 
     def get_string(self, key: str) -> str:
         """Get a string value by string key."""
@@ -373,16 +316,7 @@ class RiocClient:
             timestamp = self.get_timestamp()
 
         with self._lock:
-            result = rioc_native.lib.rioc_insert(
-                self._handle,
-                key,
-                len(key),
-                value,
-                len(value),
-                timestamp
-            )
-            if result != 0:
-                raise create_rioc_error(result)
+            self._client.insert(key, value, timestamp)
 
     def insert_string(self, key: str, value: str, timestamp: Optional[int] = None) -> None:
         """Insert or update a string key-value pair."""
@@ -398,14 +332,7 @@ class RiocClient:
             timestamp = self.get_timestamp()
 
         with self._lock:
-            result = rioc_native.lib.rioc_delete(
-                self._handle,
-                key,
-                len(key),
-                timestamp
-            )
-            if result != 0:
-                raise create_rioc_error(result)
+            self._client.delete(key, timestamp)
 
     def delete_string(self, key: str, timestamp: Optional[int] = None) -> None:
         """Delete a key-value pair using string key."""
@@ -417,50 +344,67 @@ class RiocClient:
             raise RiocError(-1, "Client is closed")
 
         with self._lock:
-            results_ptr = ctypes.POINTER(NativeRangeResult)()
-            results_count = ctypes.c_size_t()
-
-            result = rioc_native.lib.rioc_range_query(
-                self._handle,
-                start_key,
-                len(start_key),
-                end_key,
-                len(end_key),
-                ctypes.byref(results_ptr),
-                ctypes.byref(results_count)
-            )
-            if result != 0:
-                raise create_rioc_error(result)
-
-            # Convert native results to Python objects
-            results = []
-            if results_ptr and results_count.value > 0:
-                for i in range(results_count.value):
-                    native_result = results_ptr[i]
-                    key = ctypes.string_at(native_result.key, native_result.key_len)
-                    value = ctypes.string_at(native_result.value, native_result.value_len)
-                    results.append(RangeQueryResult(key, value))
-
-                # Free native results
-                rioc_native.lib.rioc_free_range_results(results_ptr, results_count.value)
-
-            return results
+            rows = self._client.range_query(start_key, end_key)
+        return [RangeQueryResult(key, value) for key, value in rows]
 
     def range_query_string(self, start_key: str, end_key: str) -> List[Tuple[str, str]]:
         """Perform a range query with string keys and return string results."""
         results = self.range_query(start_key.encode("utf-8"), end_key.encode("utf-8"))
         return [(result.key.decode("utf-8"), result.value.decode("utf-8")) for result in results]
 
+    def insert_bulk(self, keys: Any, values: Any, timestamp: Optional[int] = None) -> int:
+        """Insert many key-value pairs given as columns.
+
+        keys and values are pyarrow binary or string arrays, or (offsets, data) pairs of
+        NumPy arrays where item i is data[offsets[i]:offsets[i + 1]]. Items are sent in
+        pipelined batches by the native library without per-item Python calls. Returns
+        the number of items inserted; on failure the raised RiocError has an `inserted`
+        attribute with the number of leading items that were applied.
+        """
+        if self._closed:
+            raise RiocError(-1, "Client is closed")
+
+        key_offsets, key_data = _bulk_column(keys)
+        value_offsets, value_data = _bulk_column(values)
+        if len(key_offsets) != len(value_offsets):
+            raise ValueError("keys and values must have the same length")
+        if timestamp is None:
+            timestamp = self.get_timestamp()
+
+        with self._lock:
+            return self._client.insert_bulk(key_offsets, key_data, value_offsets, value_data, timestamp)
+
+    def range_query_arrow(self, start_key: bytes, end_key: bytes) -> Any:
+        """Perform a range query and return a pyarrow.RecordBatch with large_binary
+        "key" and "value" columns.
+
+        The columns are read from the connection straight into native buffers that
+        the record batch references without a copy or per-row Python objects.
+        """
+        import pyarrow as pa  # pylint: disable=import-outside-toplevel
+
+        if self._closed:
+            raise RiocError(-1, "Client is closed")
+
+        with self._lock:
+            columns = self._client.range_query_columns(start_key, end_key)
+
+        buffers = [pa.foreign_buffer(address, size, base=columns) if address else pa.py_buffer(b"")
+                   for address, size in columns.buffers()]
+        keys = pa.Array.from_buffers(pa.large_binary(), columns.count, [None, buffers[0], buffers[1]])
+        values = pa.Array.from_buffers(pa.large_binary(), columns.count, [None, buffers[2], buffers[3]])
+        return pa.RecordBatch.from_arrays([keys, values], names=["key", "value"])
+
     def create_batch(self) -> RiocBatch:
         """Create a new batch operation."""
         if self._closed:
             raise RiocError(-1, "Client is closed")
 
         with self._lock:
-            batch_handle = rioc_native.lib.rioc_batch_create(self._handle)
-            if not batch_handle:
+            batch = self._client.batch()
+            if batch is None:
                 raise RiocError(-1, "Failed to create batch")
-            return RiocBatch(batch_handle)
+            return RiocBatch(batch)
 
     @contextmanager
     def batch(self) -> Generator[RiocBatch, None, None]:
@@ -477,23 +421,17 @@ class RiocClient:
     @staticmethod
     def get_timestamp() -> int:
         """Get the current timestamp in nanoseconds."""
-        return rioc_native.lib.rioc_get_timestamp_ns()
+        return backend.timestamp_ns()
 
     def close(self) -> None:
         """Close the client and release resources."""
         if not self._closed:
             with self._lock:
-                if not self._closed and hasattr(self, "_handle") and self._handle:
+                if not self._closed and hasattr(self, "_client"):
                     try:
-                        rioc_native.lib.rioc_client_disconnect_with_config(self._handle)
+                        self._client.close()
                     finally:
-                        self._handle = None
                         self._closed = True
-                        # Clean up platform
-                        try:
-                            rioc_native.lib.rioc_platform_cleanup()
-                        except:  # pylint: disable=bare-except
-                            pass
 
     def __del__(self):
         """Clean up the native resources."""
@@ -521,19 +459,11 @@ class RiocClient:
         if timestamp is None:
             timestamp = self.get_timestamp()
 
-        result_value = ctypes.c_int64()
-        result = rioc_native.lib.rioc_atomic_inc_dec(
-            self._handle,
-            key, len(key),
-            value,
-            timestamp,
-            ctypes.byref(result_value)
-        )
-
-        if result != 0:
-            raise create_rioc_error(result)
+        if self._closed:
+            raise RiocError(-1, "Client is closed")
 
-        return result_value.value
+        with self._lock:
+            return self._client.atomic_inc_dec(key, value, timestamp)
 
     def atomic_inc_dec_string(self, key: str, value: int, timestamp: Optional[int] = None) -> int:
         """Atomically increment or decrement a counter value using string key.
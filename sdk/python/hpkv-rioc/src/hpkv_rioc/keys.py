@@ -0,0 +1,206 @@
+"""
+Order-preserving key encoding
+
+Range queries compare keys as raw bytes. Keys built here compare field by field in
+the fields' own order, and are byte for byte the keys the rioc_key_* C functions build:
+
+- Integers are big-endian with the sign bit flipped for signed types.
+- Strings (UTF-8) and bytes escape 0x00 as 0x00 0xFF and end with 0x00 0x01, so a
+  string sorts before any longer string it is a prefix of.
+- Fields wrapped in Desc are complemented, so they sort in reverse.
+"""
+
+import struct
+from typing import Any, List, Optional, Sequence, Tuple
+
+class _Int:
+    """An integer field of fixed width. Plain ints encode as I64."""
+    __slots__ = ("value",)
+    _format = struct.Struct(">Q")
+    _signed = True
+
+    def __init__(self, value: int):
+        self.value = int(value)
+
+    def __eq__(self, other: Any) -> bool:
+        return type(other) is type(self) and other.value == self.value
+
+    def __hash__(self) -> int:
+        return hash((type(self), self.value))
+
+    def __repr__(self) -> str:
+        return f"{type(self).__name__}({self.value})"
+
+    @classmethod
+    def _encode(cls, value: int) -> bytes:
+        if cls._signed:
+            value += 1 << (cls._format.size * 8 - 1)
+        return cls._format.pack(value)
+
+    @classmethod
+    def _decode(cls, key: bytes, pos: int) -> Tuple[int, int]:
+        if len(key) - pos < cls._format.size:
+            raise ValueError("key ends inside an integer field")
+        (value,) = cls._format.unpack_from(key, pos)
+        if cls._signed:
+            value -= 1 << (cls._format.size * 8 - 1)
+        return value, pos + cls._format.size
+
+class U32(_Int):
+    """Unsigned 32-bit key field."""
+    __slots__ = ()
+    _format = struct.Struct(">I")
+    _signed = False
+
+class U64(_Int):
+    """Unsigned 64-bit key field."""
+    __slots__ = ()
+    _format = struct.Struct(">Q")
+    _signed = False
+
+class I32(_Int):
+    """Signed 32-bit key field."""
+    __slots__ = ()
+    _format = struct.Struct(">I")
+    _signed = True
+
+class I64(_Int):
+    """Signed 64-bit key field."""
+    __slots__ = ()
+    _format = struct.Struct(">Q")
+    _signed = True
+
+class Desc:
+    """Wraps a field, or a field type for decode_key, to sort it in reverse."""
+    __slots__ = ("field",)
+
+    def __init__(self, field: Any):
+        self.field = field
+
+    def __repr__(self) -> str:
+        return f"Desc({self.field!r})"
+
+_FLIP = bytes(range(255, -1, -1))
+
+def _complement(data: bytes) -> bytes:
+    return data.translate(_FLIP)
+
+def _encode_field(field: Any) -> bytes:
+    if isinstance(field, Desc):
+        return _complement(_encode_field(field.field))
+    if isinstance(field, _Int):
+        return field._encode(field.value)  # pylint: disable=protected-access
+    if isinstance(field, bool):
+        raise TypeError("bool key fields are not supported; use U32")
+    if isinstance(field, int):
+        return I64._encode(field)  # pylint: disable=protected-access
+    if isinstance(field, str):
+        field = field.encode("utf-8")
+    if isinstance(field, (bytes, bytearray, memoryview)):
+        return bytes(field).replace(b"\x00", b"\x00\xff") + b"\x00\x01"
+    raise TypeError(f"unsupported key field type {type(field).__name__}")
+
+def encode_key(*fields: Any) -> bytes:
+    """Encode fields into one key.
+
+    Fields are ints (encoded as I64), U32, U64, I32, I64, str, bytes, or any of these
+    wrapped in Desc.
+    """
+    return b"".join(_encode_field(field) for field in fields)
+
+def _decode_string(key: bytes, pos: int) -> Tuple[bytes, int]:
+    out = bytearray()
+    while True:
+        end = key.find(b"\x00", pos)
+        if end < 0 or end + 1 >= len(key):
+            raise ValueError("key ends inside a string field")
+        out += key[pos:end]
+        marker = key[end + 1]
+        if marker == 0x01:
+            return bytes(out), end + 2
+        if marker != 0xFF:
+            raise ValueError("invalid escape in a string field")
+        out.append(0)
+        pos = end + 2
+
+def _decode_field(kind: Any, key: bytes, pos: int) -> Tuple[Any, int]:
+    if isinstance(kind, Desc):
+        # The field's length is only known once decoded, so complement the rest
+        rest = _complement(key[pos:])
+        value, used = _decode_field(kind.field, rest, 0)
+        return value, pos + used
+    if isinstance(kind, type) and issubclass(kind, _Int):
+        return kind._decode(key, pos)  # pylint: disable=protected-access
+    if kind is int:
+        return I64._decode(key, pos)  # pylint: disable=protected-access
+    if kind is bytes:
+        return _decode_string(key, pos)
+    if kind is str:
+        value, pos = _decode_string(key, pos)
+        return value.decode("utf-8"), pos
+    raise TypeError(f"unsupported key field type {kind!r}")
+
+def decode_key(key: bytes, *kinds: Any) -> Tuple[Any, ...]:
+    """Decode a key built from fields of the given types, such as a range query row's key.
+
+    Types are int, U32, U64, I32, I64, str or bytes, or any of them wrapped in Desc.
+    Integer fields decode to int. Raises ValueError if the key does not match.
+    """
+    key = bytes(key)
+    pos = 0
+    values = []
+    for kind in kinds:
+        value, pos = _decode_field(kind, key, pos)
+        values.append(value)
+    if pos != len(key):
+        raise ValueError("key has bytes after its last field")
+    return tuple(values)
+
+def prefix_successor(prefix: bytes) -> Optional[bytes]:
+    """Return the smallest key above every key that starts with prefix.
+
+    Use it as the end key of a scan over the prefix. Range ends are inclusive, but
+    keys built from the same fields as the prefix are always longer than the
+    successor. Returns None if the prefix is empty or all 0xFF bytes, when no key
+    bounds the scan.
+    """
+    trimmed = bytes(prefix).rstrip(b"\xff")
+    if not trimmed:
+        return None
+    return trimmed[:-1] + bytes([trimmed[-1] + 1])
+
+_COLUMN_KINDS = {       # width, signed
+    U32: (4, False),
+    U64: (8, False),
+    I32: (4, True),
+    I64: (8, True),
+    int: (8, True),
+}
+
+def encode_keys(values: Sequence[int], kind: Any = I64, prefix: bytes = b"",
+                desc: bool = False) -> List[bytes]:
+    """Encode many keys of the form prefix + one integer field.
+
+    With NumPy installed the field is encoded for the whole column at once, so
+    building keys for a batch or a set of scan bounds costs little per key.
+    """
+    if kind not in _COLUMN_KINDS:
+        raise TypeError(f"unsupported column kind {kind!r}")
+    prefix = bytes(prefix)
+    try:
+        import numpy as np  # pylint: disable=import-outside-toplevel
+    except ImportError:
+        return [prefix + encode_key(Desc(kind(value)) if desc else kind(value)) for value in values]
+
+    width, signed = _COLUMN_KINDS[kind]
+    unsigned = np.dtype(f"u{width}")
+    column = np.asarray(values, dtype=np.dtype(f"{'i' if signed else 'u'}{width}")).view(unsigned)
+    mask = (1 << (width * 8 - 1) if signed else 0) ^ ((1 << (width * 8)) - 1 if desc else 0)
+    if mask:
+        column = column ^ unsigned.type(mask)
+    step = len(prefix) + width
+    keys = np.empty((len(column), step), dtype=np.uint8)
+    keys[:, :len(prefix)] = np.frombuffer(prefix, dtype=np.uint8)
+    keys[:, len(prefix):] = column.astype(unsigned.newbyteorder(">")).view(np.uint8).reshape(-1, width)
+    data = keys.tobytes()
+    return [data[i:i + step] for i in range(0, len(data), step)]
@@ -6,12 +6,16 @@ import ctypes
 import os
 import platform
 import sys
+import threading
 from ctypes import (
     c_int, c_uint, c_uint64, c_size_t, c_char_p, c_void_p, c_bool,
-    POINTER, Structure, CDLL, c_char
+    POINTER, Structure, CDLL, c_char, CFUNCTYPE
 )
 from pathlib import Path
-from typing import Optional
+from types import ModuleType
+from typing import Any, Dict, List, Optional, Tuple
+
+from .exceptions import create_rioc_error
 
 # Platform-specific library names
 _WINDOWS_LIB = "rioc.dll"
@@ -75,18 +79,35 @@ class NativeClientConfig(Structure):
         ("port", c_uint),
         ("timeout_ms", c_uint),
         ("tls", POINTER(NativeTlsConfig)),
+        ("flags", c_uint),
+        ("cpu", c_int),
     ]
 
 # Define the range result structure
 class NativeRangeResult(Structure):
     """Native range query result structure."""
+    # c_void_p rather than c_char_p: ctypes would convert a c_char_p field into bytes
+    # cut at the first NUL, and keys and values are binary
     _fields_ = [
-        ("key", c_char_p),
+        ("key", c_void_p),
         ("key_len", c_size_t),
-        ("value", c_char_p),
+        ("value", c_void_p),
         ("value_len", c_size_t),
     ]
 
+class NativeRangeColumns(Structure):
+    """Native columnar range query result structure."""
+    _fields_ = [
+        ("count", c_size_t),
+        ("key_offsets", POINTER(ctypes.c_int64)),
+        ("key_data", c_void_p),
+        ("value_offsets", POINTER(ctypes.c_int64)),
+        ("value_data", c_void_p),
+    ]
+
+# void (*rioc_async_callback)(void *arg, int status, char *value, size_t value_len)
+ASYNC_CALLBACK = CFUNCTYPE(None, c_void_p, c_int, POINTER(c_char), c_size_t)
+
 class RiocNative:
     """RIOC native library interface."""
     _instance: Optional["RiocNative"] = None
@@ -134,10 +155,26 @@ class RiocNative:
                                               POINTER(POINTER(NativeRangeResult)), POINTER(c_size_t)]
         self._lib.rioc_range_query.restype = c_int
 
+        # Values returned by the client are released with rioc_value_free
+        self._lib.rioc_value_free.argtypes = [c_void_p]
+        self._lib.rioc_value_free.restype = None
+
         # Free range results function
         self._lib.rioc_free_range_results.argtypes = [POINTER(NativeRangeResult), c_size_t]
         self._lib.rioc_free_range_results.restype = None
 
+        # Bulk operations
+        self._lib.rioc_insert_bulk.argtypes = [c_void_p, c_size_t, c_void_p, c_void_p, c_void_p, c_void_p,
+                                               c_uint64, POINTER(c_size_t)]
+        self._lib.rioc_insert_bulk.restype = c_int
+
+        self._lib.rioc_range_query_columns.argtypes = [c_void_p, c_char_p, c_size_t, c_char_p, c_size_t,
+                                                       POINTER(NativeRangeColumns)]
+        self._lib.rioc_range_query_columns.restype = c_int
+
+        self._lib.rioc_free_range_columns.argtypes = [POINTER(NativeRangeColumns)]
+        self._lib.rioc_free_range_columns.restype = None
+
         # Atomic operations
         self._lib.rioc_atomic_inc_dec.argtypes = [c_void_p, c_char_p, c_size_t, ctypes.c_int64, c_uint64, POINTER(ctypes.c_int64)]
         self._lib.rioc_atomic_inc_dec.restype = c_int
@@ -163,6 +200,13 @@ class RiocNative:
         self._lib.rioc_batch_add_range_query.argtypes = [c_void_p, c_char_p, c_size_t, c_char_p, c_size_t]
         self._lib.rioc_batch_add_range_query.restype = c_int
 
+        # Packed batch functions
+        self._lib.rioc_batch_add_packed.argtypes = [c_void_p, c_char_p, c_size_t]
+        self._lib.rioc_batch_add_packed.restype = c_int
+
+        self._lib.rioc_batch_get_packed_responses.argtypes = [c_void_p, POINTER(POINTER(c_char)), POINTER(c_size_t)]
+        self._lib.rioc_batch_get_packed_responses.restype = c_int
+
         self._lib.rioc_batch_execute_async.argtypes = [c_void_p]
         self._lib.rioc_batch_execute_async.restype = c_void_p
 
@@ -188,6 +232,31 @@ class RiocNative:
         self._lib.rioc_platform_cleanup.argtypes = []
         self._lib.rioc_platform_cleanup.restype = None
 
+        # Asynchronous operations
+        self._lib.rioc_async_create.argtypes = [c_void_p]
+        self._lib.rioc_async_create.restype = c_void_p
+
+        self._lib.rioc_async_free.argtypes = [c_void_p]
+        self._lib.rioc_async_free.restype = None
+
+        self._lib.rioc_async_get.argtypes = [c_void_p, c_char_p, c_size_t, ASYNC_CALLBACK, c_void_p]
+        self._lib.rioc_async_get.restype = c_int
+
+        self._lib.rioc_async_insert.argtypes = [c_void_p, c_char_p, c_size_t, c_char_p, c_size_t, c_uint64,
+                                                ASYNC_CALLBACK, c_void_p]
+        self._lib.rioc_async_insert.restype = c_int
+
+        self._lib.rioc_async_delete.argtypes = [c_void_p, c_char_p, c_size_t, c_uint64, ASYNC_CALLBACK, c_void_p]
+        self._lib.rioc_async_delete.restype = c_int
+
+        self._lib.rioc_async_range_query.argtypes = [c_void_p, c_char_p, c_size_t, c_char_p, c_size_t,
+                                                     ASYNC_CALLBACK, c_void_p]
+        self._lib.rioc_async_range_query.restype = c_int
+
+        self._lib.rioc_async_atomic_inc_dec.argtypes = [c_void_p, c_char_p, c_size_t, ctypes.c_int64, c_uint64,
+                                                        ASYNC_CALLBACK, c_void_p]
+        self._lib.rioc_async_atomic_inc_dec.restype = c_int
+
     @property
     def lib(self) -> CDLL:
         """Get the native library instance."""
@@ -196,4 +265,358 @@ class RiocNative:
         return self._lib
 
 # Global instance
-rioc_native = RiocNative() 
\ No newline at end of file
+rioc_native = RiocNative()
+
+# ctypes backend, used when the compiled _rioc extension is unavailable.
+# Client, Batch, Tracker, RangeColumns and AsyncQueue mirror the types of the extension.
+
+def _raise_error(code: int) -> None:
+    raise create_rioc_error(code)
+
+class Client:
+    """Connection to a RIOC server."""
+    def __init__(self, host: str, port: int, timeout_ms: int, tls: bool = False,
+                 cert_path: Optional[str] = None, key_path: Optional[str] = None,
+                 ca_path: Optional[str] = None, verify_hostname: Optional[str] = None,
+                 verify_peer: bool = True):
+        lib = rioc_native.lib
+        result = lib.rioc_platform_init()
+        if result != 0:
+            _raise_error(result)
+
+        native_config = NativeClientConfig()
+        native_config.host = host.encode("utf-8")
+        native_config.port = port
+        native_config.timeout_ms = timeout_ms
+
+        if tls:
+            native_tls_config = NativeTlsConfig()
+            if cert_path:
+                native_tls_config.cert_path = cert_path.encode("utf-8")
+            if key_path:
+                native_tls_config.key_path = key_path.encode("utf-8")
+            if ca_path:
+                native_tls_config.ca_path = ca_path.encode("utf-8")
+            if verify_hostname:
+                native_tls_config.verify_hostname = verify_hostname.encode("utf-8")
+            native_tls_config.verify_peer = verify_peer
+            native_config.tls = ctypes.pointer(native_tls_config)
+        else:
+            native_config.tls = None
+
+        handle = c_void_p()
+        result = lib.rioc_client_connect_with_config(ctypes.byref(native_config), ctypes.byref(handle))
+        if result != 0:
+            lib.rioc_platform_cleanup()
+            _raise_error(result)
+        self._handle = handle
+
+    def _check(self) -> None:
+        if not self._handle:
+            _raise_error(-1)
+
+    def get(self, key: bytes) -> bytes:
+        self._check()
+        value_ptr = POINTER(c_char)()
+        value_len = c_size_t()
+        result = rioc_native.lib.rioc_get(self._handle, key, len(key),
+                                          ctypes.byref(value_ptr), ctypes.byref(value_len))
+        if result != 0:
+            _raise_error(result)
+        try:
+            if not value_ptr or value_len.value == 0:
+                return b""
+            return ctypes.string_at(value_ptr, value_len.value)
+        finally:
+            rioc_native.lib.rioc_value_free(ctypes.cast(value_ptr, c_void_p))
+
+    def insert(self, key: bytes, value: bytes, timestamp: int) -> None:
+        self._check()
+        result = rioc_native.lib.rioc_insert(self._handle, key, len(key), value, len(value), timestamp)
+        if result != 0:
+            _raise_error(result)
+
+    def delete(self, key: bytes, timestamp: int) -> None:
+        self._check()
+        result = rioc_native.lib.rioc_delete(self._handle, key, len(key), timestamp)
+        if result != 0:
+            _raise_error(result)
+
+    def range_query(self, start_key: bytes, end_key: bytes) -> List[Tuple[bytes, bytes]]:
+        self._check()
+        results_ptr = POINTER(NativeRangeResult)()
+        results_count = c_size_t()
+        result = rioc_native.lib.rioc_range_query(self._handle, start_key, len(start_key),
+                                                  end_key, len(end_key),
+                                                  ctypes.byref(results_ptr), ctypes.byref(results_count))
+        if result != 0:
+            _raise_error(result)
+
+        rows = []
+        if results_ptr and results_count.value > 0:
+            for i in range(results_count.value):
+                native_result = results_ptr[i]
+                rows.append((ctypes.string_at(native_result.key, native_result.key_len),
+                             ctypes.string_at(native_result.value, native_result.value_len)))
+            rioc_native.lib.rioc_free_range_results(results_ptr, results_count.value)
+        return rows
+
+    def atomic_inc_dec(self, key: bytes, value: int, timestamp: int) -> int:
+        self._check()
+        result_value = ctypes.c_int64()
+        result = rioc_native.lib.rioc_atomic_inc_dec(self._handle, key, len(key), value, timestamp,
+                                                     ctypes.byref(result_value))
+        if result != 0:
+            _raise_error(result)
+        return result_value.value
+
+    def insert_bulk(self, key_offsets, key_data, value_offsets, value_data, timestamp: int) -> int:
+        # Offsets are int64 with count + 1 entries and lie within their data, see client.py
+        self._check()
+        key_offsets, value_offsets = memoryview(key_offsets), memoryview(value_offsets)
+        if key_offsets.nbytes != value_offsets.nbytes or key_offsets.nbytes < 8:
+            _raise_error(-1)
+        inserted = c_size_t()
+        result = rioc_native.lib.rioc_insert_bulk(self._handle, key_offsets.nbytes // 8 - 1,
+                                                  _buffer_arg(key_offsets), _buffer_arg(key_data),
+                                                  _buffer_arg(value_offsets), _buffer_arg(value_data),
+                                                  timestamp, ctypes.byref(inserted))
+        if result != 0:
+            error = create_rioc_error(result)
+            error.inserted = inserted.value
+            raise error
+        return inserted.value
+
+    def range_query_columns(self, start_key: bytes, end_key: bytes) -> "RangeColumns":
+        self._check()
+        columns = RangeColumns()
+        result = rioc_native.lib.rioc_range_query_columns(self._handle, start_key, len(start_key),
+                                                          end_key, len(end_key), ctypes.byref(columns._native))
+        if result != 0:
+            _raise_error(result)
+        return columns
+
+    def batch(self) -> Optional["Batch"]:
+        self._check()
+        handle = rioc_native.lib.rioc_batch_create(self._handle)
+        return Batch(handle) if handle else None
+
+    def close(self) -> None:
+        if self._handle:
+            handle, self._handle = self._handle, None
+            rioc_native.lib.rioc_client_disconnect_with_config(handle)
+            rioc_native.lib.rioc_platform_cleanup()
+
+def _buffer_arg(buffer):
+    """Pass a contiguous buffer to a void * parameter, keeping it alive for the call."""
+    view = memoryview(buffer).cast("B")
+    if isinstance(buffer, bytes) or view.nbytes == 0:
+        return bytes(view) if not isinstance(buffer, bytes) else buffer
+    if view.readonly:
+        # ctypes only maps writable buffers without a copy
+        return view.tobytes()
+    return (c_char * view.nbytes).from_buffer(view)
+
+class RangeColumns:
+    """Range query rows in columnar form; the memory lives as long as this object."""
+    def __init__(self):
+        self._native = NativeRangeColumns()
+
+    @property
+    def count(self) -> int:
+        return self._native.count
+
+    def buffers(self) -> List[Tuple[int, int]]:
+        native = self._native
+        if not native.key_offsets:
+            return [(0, 0)] * 4
+        offsets_size = (native.count + 1) * 8
+        return [
+            (ctypes.cast(native.key_offsets, c_void_p).value or 0, offsets_size),
+            (native.key_data or 0, native.key_offsets[native.count]),
+            (ctypes.cast(native.value_offsets, c_void_p).value or 0, offsets_size),
+            (native.value_data or 0, native.value_offsets[native.count]),
+        ]
+
+    def __del__(self):
+        rioc_native.lib.rioc_free_range_columns(ctypes.byref(self._native))
+
+class Batch:
+    """Batch of RIOC operations."""
+    def __init__(self, handle: int):
+        self._handle = handle
+
+    def add_packed(self, packed: bytes) -> None:
+        if not self._handle:
+            _raise_error(-1)
+        result = rioc_native.lib.rioc_batch_add_packed(self._handle, packed, len(packed))
+        if result != 0:
+            _raise_error(result)
+
+    def execute(self) -> Optional["Tracker"]:
+        if not self._handle:
+            _raise_error(-1)
+        handle = rioc_native.lib.rioc_batch_execute_async(self._handle)
+        return Tracker(handle) if handle else None
+
+    def close(self) -> None:
+        if self._handle:
+            handle, self._handle = self._handle, None
+            rioc_native.lib.rioc_batch_free(handle)
+
+class Tracker:
+    """Tracks an executing batch."""
+    def __init__(self, handle: int):
+        self._handle = handle
+
+    def wait(self, timeout_ms: int = -1) -> None:
+        if not self._handle:
+            _raise_error(-1)
+        result = rioc_native.lib.rioc_batch_wait(self._handle, timeout_ms)
+        if result != 0:
+            _raise_error(result)
+
+    def responses(self) -> bytes:
+        if not self._handle:
+            _raise_error(-1)
+        packed_ptr = POINTER(c_char)()
+        packed_len = c_size_t()
+        result = rioc_native.lib.rioc_batch_get_packed_responses(
+            self._handle, ctypes.byref(packed_ptr), ctypes.byref(packed_len)
+        )
+        if result != 0:
+            _raise_error(result)
+        return ctypes.string_at(packed_ptr, packed_len.value)
+
+    def close(self) -> None:
+        if self._handle:
+            handle, self._handle = self._handle, None
+            rioc_native.lib.rioc_batch_tracker_free(handle)
+
+_CMD_GET = 1
+_CMD_INSERT = 2
+_CMD_DELETE = 3
+_CMD_RANGE_QUERY = 6
+_CMD_ATOMIC_INC_DEC = 7
+
+class AsyncQueue:
+    """Operations sent by a native I/O thread over a dedicated client.
+
+    Completions are collected by drain(); fileno() becomes readable while any are waiting.
+    """
+    def __init__(self, client: Client):
+        client._check()
+        self._client = client
+        self._lock = threading.Lock()
+        self._completed: List[Tuple[int, int, Any]] = []
+        self._commands: Dict[int, int] = {}
+        self._read_fd, self._write_fd = os.pipe()
+        os.set_blocking(self._read_fd, False)
+        self._callback = ASYNC_CALLBACK(self._on_complete)
+        handle = rioc_native.lib.rioc_async_create(client._handle)
+        if not handle:
+            os.close(self._read_fd)
+            os.close(self._write_fd)
+            _raise_error(-2)
+        self._handle = handle
+
+    def _on_complete(self, arg: Optional[int], status: int, value, value_len: int) -> None:
+        # Runs on the I/O thread
+        op_id = arg or 0
+        with self._lock:
+            command = self._commands.pop(op_id, 0)
+        result = None
+        if value:
+            if status == 0:
+                if command == _CMD_RANGE_QUERY:
+                    rows = ctypes.cast(value, POINTER(NativeRangeResult))
+                    result = [(ctypes.string_at(rows[i].key, rows[i].key_len),
+                               ctypes.string_at(rows[i].value, rows[i].value_len))
+                              for i in range(value_len)]
+                elif command == _CMD_ATOMIC_INC_DEC:
+                    result = ctypes.cast(value, POINTER(ctypes.c_int64))[0]
+                else:
+                    result = ctypes.string_at(value, value_len)
+            if command == _CMD_RANGE_QUERY:
+                rioc_native.lib.rioc_free_range_results(ctypes.cast(value, POINTER(NativeRangeResult)),
+                                                        value_len)
+            else:
+                rioc_native.lib.rioc_value_free(ctypes.cast(value, c_void_p))
+        elif status == 0:
+            result = {_CMD_GET: b"", _CMD_RANGE_QUERY: [], _CMD_ATOMIC_INC_DEC: 0}.get(command)
+        with self._lock:
+            wake = not self._completed
+            self._completed.append((op_id, status, result))
+        if wake:
+            os.write(self._write_fd, b"\x01")
+
+    def _submit(self, op_id: int, command: int, submit, *args) -> None:
+        if not self._handle:
+            _raise_error(-1)
+        with self._lock:
+            self._commands[op_id] = command
+        result = submit(self._handle, *args, self._callback, op_id)
+        if result != 0:
+            with self._lock:
+                self._commands.pop(op_id, None)
+            _raise_error(result)
+
+    def get(self, op_id: int, key: bytes) -> None:
+        self._submit(op_id, _CMD_GET, rioc_native.lib.rioc_async_get, key, len(key))
+
+    def insert(self, op_id: int, key: bytes, value: bytes, timestamp: int) -> None:
+        self._submit(op_id, _CMD_INSERT, rioc_native.lib.rioc_async_insert, key, len(key), value, len(value), timestamp)
+
+    def delete(self, op_id: int, key: bytes, timestamp: int) -> None:
+        self._submit(op_id, _CMD_DELETE, rioc_native.lib.rioc_async_delete, key, len(key), timestamp)
+
+    def range_query(self, op_id: int, start_key: bytes, end_key: bytes) -> None:
+        self._submit(op_id, _CMD_RANGE_QUERY, rioc_native.lib.rioc_async_range_query,
+                     start_key, len(start_key), end_key, len(end_key))
+
+    def atomic_inc_dec(self, op_id: int, key: bytes, value: int, timestamp: int) -> None:
+        self._submit(op_id, _CMD_ATOMIC_INC_DEC, rioc_native.lib.rioc_async_atomic_inc_dec,
+                     key, len(key), value, timestamp)
+
+    def drain(self) -> List[Tuple[int, int, Any]]:
+        try:
+            while os.read(self._read_fd, 4096):
+                pass
+        except (BlockingIOError, OSError):
+            pass
+        with self._lock:
+            completed, self._completed = self._completed, []
+        return completed
+
+    def fileno(self) -> int:
+        return self._read_fd
+
+    def close(self) -> None:
+        if self._handle:
+            handle, self._handle = self._handle, None
+            rioc_native.lib.rioc_async_free(handle)
+
+    def __del__(self):
+        self.close()
+        for fd in (getattr(self, "_read_fd", -1), getattr(self, "_write_fd", -1)):
+            if fd >= 0:
+                os.close(fd)
+
+def timestamp_ns() -> int:
+    """Current timestamp in nanoseconds."""
+    return rioc_native.lib.rioc_get_timestamp_ns()
+
+def _load_backend() -> ModuleType:
+    """Return the compiled _rioc extension, or this module if it is unavailable.
+
+    Set HPKV_RIOC_BACKEND=ctypes to force the ctypes backend.
+    """
+    if os.environ.get("HPKV_RIOC_BACKEND") != "ctypes":
+        try:
+            from . import _rioc
+            return _rioc
+        except ImportError:
+            pass
+    return sys.modules[__name__]
+
+backend = _load_backend() 
\ No newline at end of file
@@ -0,0 +1,102 @@
+"""
+Tests for the asyncio RIOC client.
+"""
+
+import asyncio
+import os
+import pytest
+
+from hpkv_rioc import AsyncRiocClient, RiocConfig, RiocError
+
+def make_config(tls_config):
+    """Create the client configuration."""
+    return RiocConfig(
+        host=os.getenv("RIOC_TEST_HOST", "localhost"),
+        port=int(os.getenv("RIOC_TEST_PORT", "8000")),
+        timeout_ms=int(os.getenv("RIOC_TEST_TIMEOUT", "5000")),
+        tls=tls_config
+    )
+
+def test_async_insert_get_delete(tls_config):
+    """Test basic operations through the asyncio client."""
+    async def run():
+        async with AsyncRiocClient(make_config(tls_config)) as client:
+            await client.insert_string("async_key", "async_value")
+            assert await client.get_string("async_key") == "async_value"
+
+            await client.delete_string("async_key")
+            with pytest.raises(RiocError):
+                await client.get_string("async_key")
+
+    asyncio.run(run())
+
+def test_async_concurrent_gets(tls_config):
+    """Test many concurrent requests from one event loop."""
+    async def run():
+        async with AsyncRiocClient(make_config(tls_config)) as client:
+            await asyncio.gather(*(client.insert(f"async_concurrent_{i}".encode(), str(i).encode())
+                                   for i in range(1000)))
+            values = await asyncio.gather(*(client.get(f"async_concurrent_{i}".encode())
+                                            for i in range(1000)))
+            assert values == [str(i).encode() for i in range(1000)]
+
+            await asyncio.gather(*(client.delete(f"async_concurrent_{i}".encode())
+                                   for i in range(1000)))
+
+    asyncio.run(run())
+
+def test_async_range_query_and_atomic(tls_config):
+    """Test range queries and atomic operations through the asyncio client."""
+    async def run():
+        async with AsyncRiocClient(make_config(tls_config)) as client:
+            for i in range(3):
+                await client.insert(f"async_range_{i}".encode(), f"value_{i}".encode())
+            results = await client.range_query(b"async_range_0", b"async_range_2")
+            assert [r.key for r in results] == [f"async_range_{i}".encode() for i in range(3)]
+
+            counter = f"async_counter_{client.get_timestamp()}".encode()
+            assert await client.atomic_inc_dec(counter, 10) == 10
+            assert await client.atomic_inc_dec(counter, -3) == 7
+            await client.delete(counter)
+
+    asyncio.run(run())
+
+def test_async_empty_range_and_failed_atomic(tls_config):
+    """Test operations that complete without a value through the asyncio client."""
+    async def run():
+        async with AsyncRiocClient(make_config(tls_config)) as client:
+            assert await client.range_query(b"async_empty_range_a", b"async_empty_range_b") == []
+
+            key = f"async_not_a_counter_{client.get_timestamp()}".encode()
+            await client.insert(key, b"not a counter")
+            with pytest.raises(RiocError):
+                await client.atomic_inc_dec(key, 1)
+            assert await client.get(key) == b"not a counter"
+            await client.delete(key)
+
+    asyncio.run(run())
+
+def test_async_batch(tls_config):
+    """Test batch execution through the asyncio client."""
+    async def run():
+        async with AsyncRiocClient(make_config(tls_config)) as client:
+            timestamp = client.get_timestamp()
+            batch = client.batch()
+            batch.add_insert(b"async_batch_key", b"async_batch_value", timestamp)
+            batch.add_get(b"async_batch_missing")
+            await batch.execute()
+
+            batch = client.batch()
+            batch.add_get(b"async_batch_key")
+            batch.add_get(b"async_batch_missing")
+            results = await batch.execute()
+            assert results.get_response(0) == b"async_batch_value"
+            with pytest.raises(RiocError):
+                results.get_response(1)
+
+            for _ in range(128):
+                batch.add_get(b"async_batch_key")
+            with pytest.raises(RiocError):
+                batch.add_get(b"async_batch_key")
+
+    asyncio.run(run())
@@ -227,4 +227,31 @@ def test_batch_with_empty_values(client):
     # Delete in batch
     with client.batch() as batch:
         for key in keys:
-            batch.add_delete(key, client.get_timestamp()) 
\ No newline at end of file
+            batch.add_delete(key, client.get_timestamp())
+
+def test_batch_full_packed(client):
+    """Test a full batch of 128 operations and the batch size limit."""
+    keys = [f"test_batch_packed_{i}".encode() for i in range(128)]
+
+    batch = client.create_batch()
+    for key in keys:
+        batch.add_insert(key, key, client.get_timestamp())
+    with pytest.raises(RiocError) as exc_info:
+        batch.add_get(b"test_batch_packed_overflow")
+    assert exc_info.value.code == -1  # RIOC_ERR_PARAM
+    tracker = batch.execute()
+    tracker.wait()
+
+    batch = client.create_batch()
+    for key in keys:
+        batch.add_get(key)
+    tracker = batch.execute()
+    tracker.wait()
+
+    for i, key in enumerate(keys):
+        assert tracker.get_response(i) == key
+
+    # Cleanup
+    with client.batch() as batch:
+        for key in keys:
+            batch.add_delete(key, client.get_timestamp())
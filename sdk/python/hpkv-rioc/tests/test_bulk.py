@@ -0,0 +1,57 @@
+"""
+Tests for the NumPy/Arrow bulk operations.
+"""
+
+import pytest
+
+from hpkv_rioc import RiocError
+
+np = pytest.importorskip("numpy")
+pa = pytest.importorskip("pyarrow")
+
+def test_insert_bulk_arrow(client):
+    """Test bulk inserts from Arrow arrays across several batches."""
+    count = 1000
+    keys = pa.array([f"bulk_arrow_{i:04d}" for i in range(count)])
+    values = pa.array([f"value_{i}".encode() for i in range(count)], type=pa.large_binary())
+
+    assert client.insert_bulk(keys, values) == count
+    assert client.get(b"bulk_arrow_0000") == b"value_0"
+    assert client.get(b"bulk_arrow_0999") == b"value_999"
+
+    # Sliced and chunked arrays
+    client.insert_bulk(pa.chunked_array([keys.slice(10, 2)]), pa.array([b"a", b"bb"]))
+    assert client.get(b"bulk_arrow_0011") == b"bb"
+
+def test_insert_bulk_numpy(client):
+    """Test bulk inserts from NumPy offsets and data."""
+    key_data = np.frombuffer(b"bulk_np_1bulk_np_2", dtype=np.uint8)
+    key_offsets = np.array([0, 9, 18])
+    value_offsets = np.array([0, 1, 3], dtype=np.int32)
+
+    assert client.insert_bulk((key_offsets, key_data), (value_offsets, b"xyz")) == 2
+    assert client.get(b"bulk_np_2") == b"yz"
+
+    with pytest.raises(ValueError):
+        client.insert_bulk((np.array([0, 9, 5]), key_data), (value_offsets, b"xyz"))
+
+def test_insert_bulk_error(client):
+    """Test that a failed bulk insert reports the items applied."""
+    keys = pa.array([b"bulk_error_1", b"k" * 1000])
+    with pytest.raises(RiocError) as error:
+        client.insert_bulk(keys, pa.array([b"a", b"b"]))
+    assert error.value.inserted == 0
+
+def test_range_query_arrow(client):
+    """Test range query results as an Arrow record batch."""
+    keys = pa.array([f"bulk_range_{i}" for i in range(5)])
+    client.insert_bulk(keys, keys)
+
+    batch = client.range_query_arrow(b"bulk_range_0", b"bulk_range_4")
+    assert batch.schema.names == ["key", "value"]
+    assert batch.column("key").type == pa.large_binary()
+    assert batch.column("key").to_pylist() == [f"bulk_range_{i}".encode() for i in range(5)]
+    assert batch.column("value").to_pylist() == batch.column("key").to_pylist()
+
+    empty = client.range_query_arrow(b"bulk_range_none_0", b"bulk_range_none_1")
+    assert empty.num_rows == 0
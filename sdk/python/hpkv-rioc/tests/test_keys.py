@@ -0,0 +1,73 @@
+"""
+Tests for the order-preserving key encoding.
+"""
+
+import random
+
+import pytest
+
+from hpkv_rioc.keys import (Desc, I32, I64, U32, U64, decode_key, encode_key, encode_keys,
+                            prefix_successor)
+
+def test_matches_c_encoding():
+    """Test keys byte for byte against keys built with the rioc_key_* C functions."""
+    assert encode_key(U32(7), b"a\x00b", Desc(I64(-9))).hex() == "000000076100ff6200018000000000000008"
+    assert encode_key(I32(-1), Desc(U64(1)), Desc("hi")).hex() == "7ffffffffffffffffffffffe9796fffe"
+    assert encode_key(0, "").hex() == "80000000000000000001"
+
+def test_order():
+    """Test that byte order matches field order, ascending and descending."""
+    rng = random.Random(7)
+    strings = ["", "\x00", "a\x00b", "a", "ab", "b", "é"]
+    fields = [(rng.randrange(2), rng.choice(strings), rng.randrange(-3, 4)) for _ in range(300)]
+
+    by_key = sorted(fields, key=lambda f: encode_key(U32(f[0]), f[1], f[2]))
+    assert by_key == sorted(fields, key=lambda f: (f[0], f[1].encode(), f[2]))
+
+    by_key = sorted(fields, key=lambda f: encode_key(U32(f[0]), f[1], Desc(f[2])))
+    assert by_key == sorted(fields, key=lambda f: (f[0], f[1].encode(), -f[2]))
+
+def test_decode():
+    """Test decoding keys back into their fields."""
+    key = encode_key(U32(7), "a\x00b", Desc(I64(-9)), Desc(b"\x00"))
+    assert decode_key(key, U32, str, Desc(I64), Desc(bytes)) == (7, "a\x00b", -9, b"\x00")
+
+    with pytest.raises(ValueError):
+        decode_key(key, U32, str)                   # Bytes left over
+    with pytest.raises(ValueError):
+        decode_key(b"ab\x00\x02", str)              # Invalid escape
+    with pytest.raises(ValueError):
+        decode_key(b"\x00\x00", U32)                # Too short
+
+def test_prefix_successor():
+    """Test end keys for prefix scans."""
+    assert prefix_successor(b"ab\xff\xff") == b"ac"
+    assert prefix_successor(encode_key(U32(7))) == encode_key(U32(8))
+    assert prefix_successor(b"\xff") is None
+    assert prefix_successor(b"") is None
+
+@pytest.mark.parametrize("kind,values", [
+    (I64, [-(1 << 63), -1, 0, 1, (1 << 63) - 1]),
+    (U64, [0, 1, (1 << 64) - 1]),
+    (I32, [-(1 << 31), -5, 0, (1 << 31) - 1]),
+    (U32, [0, 9, (1 << 32) - 1]),
+])
+@pytest.mark.parametrize("desc", [False, True])
+def test_encode_keys(kind, values, desc):
+    """Test that column encoding matches encode_key, with and without a prefix."""
+    prefix = encode_key(U32(3))
+    expected = [prefix + encode_key(Desc(kind(v)) if desc else kind(v)) for v in values]
+    assert encode_keys(values, kind, prefix, desc) == expected
+    assert encode_keys(values, kind, desc=desc) == [k[len(prefix):] for k in expected]
+
+def test_range_query(client):
+    """Test that a typed range scan returns keys in field order."""
+    prefix = encode_key("keys_test", U32(1))
+    for ts in (-2, -1, 0, 1, 2):
+        client.insert(prefix + encode_key(Desc(ts)), b"v")
+    try:
+        rows = client.range_query(prefix, prefix_successor(prefix))
+        assert [decode_key(r.key, str, U32, Desc(int))[2] for r in rows] == [2, 1, 0, -1, -2]
+    finally:
+        for ts in (-2, -1, 0, 1, 2):
+            client.delete(prefix + encode_key(Desc(ts)))
@@ -20,10 +20,20 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <pthread.h>
-#include <stdatomic.h>
 #include <sys/uio.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+// C++ sees the tracker's C11 atomics as the std::atomic types, which have the same
+// size and representation on every supported compiler
+#include <atomic>
+using std::atomic_int;
+using std::atomic_size_t;
+extern "C" {
+#else
+#include <stdatomic.h>
+#endif
+
 // Forward declarations
 struct rioc_tls_context;
 
@@ -96,12 +106,30 @@ typedef struct rioc_server_config {
     rioc_tls_config* tls;       // Optional TLS config, NULL for no TLS
 } rioc_server_config;
 
+// Client options (rioc_client_config.flags)
+// HUGE_PAGES backs batch value buffers, the client's largest allocations, with 2MB
+// pages: from the reserved hugetlbfs pool if it has room, as transparent huge pages
+// otherwise. PIN_CPU pins the threads the client starts (batch response threads and
+// the rioc_async I/O thread) to cpu, and places batch value buffers and range cursor
+// buffers on cpu's NUMA node. Both are Linux-only and fall back to ordinary memory
+// and scheduling where the system does not support them.
+// BUSY_POLL trades CPU time for latency: receives spin on a non-blocking socket
+// instead of sleeping in recv, rioc_batch_wait spins instead of sleeping between
+// checks, and the kernel is asked to busy poll the NIC queue (SO_BUSY_POLL and
+// SO_PREFER_BUSY_POLL, which need CAP_NET_ADMIN or a raised net.core.busy_read; the
+// user-space spin applies either way). Combine it with PIN_CPU on a dedicated core.
+#define RIOC_CLIENT_HUGE_PAGES  0x1
+#define RIOC_CLIENT_PIN_CPU     0x2
+#define RIOC_CLIENT_BUSY_POLL   0x4
+
 // Client configuration
 typedef struct rioc_client_config {
-    const char* host;           // Server hostname
-    uint32_t port;             // Server port
+    const char* host;           // Server hostname, or a Unix socket path starting with '/'
+    uint32_t port;             // Server port, unused for a Unix socket
     uint32_t timeout_ms;       // Operation timeout in milliseconds
     rioc_tls_config* tls;      // Optional TLS config, NULL for no TLS
+    uint32_t flags;            // RIOC_CLIENT_* options, 0 for none
+    int32_t cpu;               // CPU for RIOC_CLIENT_PIN_CPU
 } rioc_client_config;
 
 // Optimized operation header
@@ -131,6 +159,8 @@ struct rioc_client {
     int fd;             // Socket file descriptor
     uint64_t sequence;  // Operation sequence number
     struct rioc_tls_context *tls; // TLS context, NULL if not using TLS
+    uint32_t flags;     // RIOC_CLIENT_* options from the config
+    int32_t cpu;        // CPU for RIOC_CLIENT_PIN_CPU
 };
 
 // Server context
@@ -174,6 +204,7 @@ struct rioc_batch {
     struct rioc_batch_op ops[RIOC_MAX_BATCH_SIZE];
     char *value_buffer;     // Single buffer for all values
     size_t value_buffer_size;
+    uint32_t value_buffer_flags; // RIOC_CLIENT_* placement of value_buffer
     size_t value_buffer_used;
     size_t count;
     size_t iov_count;
@@ -187,6 +218,8 @@ struct rioc_batch_tracker {
     atomic_int completed;
     atomic_int error;
     atomic_size_t responses_received;
+    char *packed;            // Packed responses, built on first request
+    size_t packed_len;
     char pad[RIOC_CACHE_LINE_SIZE];  // Padding to prevent false sharing
 } __attribute__((aligned(RIOC_CACHE_LINE_SIZE)));
 
@@ -207,6 +240,31 @@ struct rioc_range_result {
     size_t value_len;
 };
 
+// Range query rows in columnar form, see rioc_range_query_columns(). Row i's key is
+// key_data[key_offsets[i], key_offsets[i + 1]) and likewise for its value, which is the
+// layout of an Arrow large_binary array.
+struct rioc_range_columns {
+    size_t count;
+    int64_t *key_offsets;       // count + 1 entries
+    char *key_data;
+    int64_t *value_offsets;     // count + 1 entries
+    char *value_data;
+};
+
+// Per-op header of a packed batch response, see rioc_batch_get_packed_responses()
+struct rioc_packed_result {
+    int32_t status;      // Op status (RIOC_SUCCESS, RIOC_ERR_NOENT, ...)
+    uint32_t count;      // Row count for RANGE_QUERY, 0 otherwise
+    uint64_t data_len;   // Bytes of data following this header
+};
+
+// Memory held by a RIOC object, see rioc_*_memory_usage()
+typedef struct rioc_memory_usage {
+    size_t allocated;    // Bytes allocated for the object and the buffers it owns
+    size_t in_use;       // Bytes of those allocations currently holding data
+    size_t allocations;  // Number of live heap blocks
+} rioc_memory_usage;
+
 // Forward declare TLS context for internal use
 struct rioc_tls_context;
 
@@ -230,6 +288,17 @@ void rioc_server_stop_with_config(void);
 int rioc_client_connect_with_config(rioc_client_config* config, struct rioc_client** client);
 void rioc_client_disconnect_with_config(struct rioc_client* client);
 
+// TLS session resumption
+// A session is captured from a connected client after its first completed operation
+// (TLS 1.3 session tickets arrive after the handshake) and may be offered on later
+// connects to skip certificate exchange. Sessions are owned by the caller.
+typedef struct rioc_tls_session rioc_tls_session;
+int rioc_client_connect_with_session(rioc_client_config* config, rioc_tls_session* session,
+                                     struct rioc_client** client);
+rioc_tls_session* rioc_client_get_tls_session(struct rioc_client* client);
+bool rioc_client_tls_session_reused(struct rioc_client* client);
+void rioc_tls_session_free(rioc_tls_session* session);
+
 // Basic operations
 int rioc_get(struct rioc_client *client, const char *key, size_t key_len, 
              char **value, size_t *value_len);
@@ -263,8 +332,291 @@ int rioc_batch_wait(struct rioc_batch_tracker *tracker, int timeout_ms);
 int rioc_batch_get_response_async(struct rioc_batch_tracker *tracker, size_t index, 
                                 char **value, size_t *value_len);
 void rioc_batch_tracker_free(struct rioc_batch_tracker *tracker);
+// Like rioc_batch_get_response_async, but the caller takes ownership of the value:
+// release GET and ATOMIC_INC_DEC values with rioc_value_free() and RANGE_QUERY results
+// (value_len is the row count) with rioc_free_range_results(). The value is NULL when
+// none was received (INSERT, DELETE, an empty range or a failed op) and on a second take.
+int rioc_batch_take_response_async(struct rioc_batch_tracker *tracker, size_t index,
+                                   char **value, size_t *value_len);
+// Pipelining on one thread: rioc_batch_send sends a batch without starting a response
+// thread, and rioc_batch_receive reads its responses in the calling thread, returning
+// what rioc_batch_wait would. Responses arrive in send order, so receive batches in the
+// order they were sent; each needs its own struct rioc_batch until its tracker is freed.
+struct rioc_batch_tracker* rioc_batch_send(struct rioc_batch *batch);
+int rioc_batch_receive(struct rioc_batch_tracker *tracker);
 int rioc_batch_add_range_query(struct rioc_batch *batch, 
                               const char *start_key, size_t start_key_len,
                               const char *end_key, size_t end_key_len);
 
+// Packed batches
+// Bindings can fill and read a whole batch with one call each. A packed request is a
+// sequence of records in the wire layout: a struct rioc_op_header followed by key_len
+// key bytes and value_len value bytes (the INSERT value, the int64_t ATOMIC_INC_DEC
+// increment or the RANGE_QUERY end key). A packed response holds, for each op in order,
+// a struct rioc_packed_result followed by data_len bytes: the GET value, the int64_t
+// ATOMIC_INC_DEC result, or `count` RANGE_QUERY rows, each a uint32_t key length, a
+// uint32_t value length, the key and the value. Integers are in host byte order and
+// records are not padded. The response buffer is owned by the tracker; values already
+// taken with rioc_batch_take_response_async have no data.
+int rioc_batch_add_packed(struct rioc_batch *batch, const char *packed, size_t packed_len);
+int rioc_batch_get_packed_responses(struct rioc_batch_tracker *tracker,
+                                    const char **packed, size_t *packed_len);
+
+// Bulk operations
+// Keys and values are passed in columnar form: item i is data[offsets[i], offsets[i + 1])
+// of the key and value columns, as in an Arrow binary array with int64 offsets. Inserts
+// go out in batches of RIOC_MAX_BATCH_SIZE with the next batch sent before the previous
+// one's responses are read. On failure *inserted is the number of leading items that
+// were acknowledged; later items may also have been applied.
+int rioc_insert_bulk(struct rioc_client *client, size_t count,
+                     const int64_t *key_offsets, const char *key_data,
+                     const int64_t *value_offsets, const char *value_data,
+                     uint64_t timestamp, size_t *inserted);
+// Like rioc_range_query, but rows are read from the connection straight into columns
+int rioc_range_query_columns(struct rioc_client *client,
+                             const char *start_key, size_t start_key_len,
+                             const char *end_key, size_t end_key_len,
+                             struct rioc_range_columns *columns);
+void rioc_free_range_columns(struct rioc_range_columns *columns);
+
+// Streaming range queries
+// A cursor reads rows from the connection one at a time into a buffer it reuses, so a
+// scan of any size runs in memory bounded by the largest row. The client must not be
+// used for anything else until the cursor is closed.
+struct rioc_range_cursor;
+int rioc_range_cursor_open(struct rioc_client *client,
+                           const char *start_key, size_t start_key_len,
+                           const char *end_key, size_t end_key_len,
+                           struct rioc_range_cursor **cursor);
+// Read the next row. Its key and value point into the cursor and are valid until the
+// next call or close. Returns RIOC_ERR_NOENT once every row has been read.
+int rioc_range_cursor_next(struct rioc_range_cursor *cursor, struct rioc_range_result *row);
+// Number of rows not yet read
+size_t rioc_range_cursor_remaining(const struct rioc_range_cursor *cursor);
+// Abort the scan; safe to call from another thread while rioc_range_cursor_next is
+// blocked. The connection is shut down, so the server stops sending and the client
+// must be reconnected.
+void rioc_range_cursor_cancel(struct rioc_range_cursor *cursor);
+// Free the cursor after reading and discarding any unread rows. Returns RIOC_ERR_IO if
+// the scan was cancelled or the connection failed, in which case the client is unusable.
+int rioc_range_cursor_close(struct rioc_range_cursor *cursor);
+
+// Order-preserving keys
+// Range queries compare keys as raw bytes. A key built here from fields compares
+// field by field in the fields' own order:
+// - Integers are big-endian, with the sign bit flipped for signed types.
+// - Strings escape 0x00 as 0x00 0xFF and end with 0x00 0x01, so a string sorts
+//   before any longer string it is a prefix of.
+// - A field added with RIOC_KEY_DESC is complemented, so it sorts in reverse.
+// Appends return RIOC_ERR_OVERFLOW and leave the key unchanged if the buffer is full.
+// Reads return RIOC_ERR_PROTO for a field that is not encoded as expected.
+#define RIOC_KEY_DESC 0x1
+
+struct rioc_key_builder {
+    char *buf;
+    size_t cap;
+    size_t len;                 // Bytes written so far
+};
+
+struct rioc_key_reader {
+    const char *data;
+    size_t len;
+    size_t pos;                 // Bytes consumed so far
+};
+
+void rioc_key_init(struct rioc_key_builder *key, char *buf, size_t cap);
+int rioc_key_add_u32(struct rioc_key_builder *key, uint32_t value, int flags);
+int rioc_key_add_u64(struct rioc_key_builder *key, uint64_t value, int flags);
+int rioc_key_add_i32(struct rioc_key_builder *key, int32_t value, int flags);
+int rioc_key_add_i64(struct rioc_key_builder *key, int64_t value, int flags);
+int rioc_key_add_string(struct rioc_key_builder *key, const char *value, size_t len, int flags);
+// Appends bytes unescaped, such as a fixed prefix. Only safe as the last field or
+// when every key has the same bytes here.
+int rioc_key_add_raw(struct rioc_key_builder *key, const char *value, size_t len);
+
+void rioc_key_reader_init(struct rioc_key_reader *reader, const char *key, size_t len);
+int rioc_key_read_u32(struct rioc_key_reader *reader, uint32_t *value, int flags);
+int rioc_key_read_u64(struct rioc_key_reader *reader, uint64_t *value, int flags);
+int rioc_key_read_i32(struct rioc_key_reader *reader, int32_t *value, int flags);
+int rioc_key_read_i64(struct rioc_key_reader *reader, int64_t *value, int flags);
+// *len is set to the decoded length; RIOC_ERR_OVERFLOW if it exceeds cap
+int rioc_key_read_string(struct rioc_key_reader *reader, char *out, size_t cap, size_t *len,
+                         int flags);
+
+// Smallest key above every key that starts with prefix: trailing 0xFF bytes are
+// dropped and the last remaining byte incremented. out needs prefix_len bytes and may
+// be prefix itself. Returns RIOC_ERR_NOENT if the prefix is empty or all 0xFF, when no
+// key bounds the scan. Range ends are inclusive, so a key equal to the successor would
+// be returned too. Keys built from the same fields as the prefix are always longer.
+int rioc_key_prefix_successor(const char *prefix, size_t prefix_len, char *out, size_t *out_len);
+
+// Batch encoding
+// Keys for a batch are laid out every stride bytes. rioc_key_fill_prefix copies a
+// shared prefix to the start of each key, and the column encoders write field i at
+// out + i * stride, where out points at the field's offset in the first key. The loops
+// have no branches, and with stride equal to the field width they vectorize.
+int rioc_key_fill_prefix(const char *prefix, size_t prefix_len, size_t count, char *out, size_t stride);
+int rioc_key_encode_u32s(const uint32_t *values, size_t count, int flags, char *out, size_t stride);
+int rioc_key_encode_u64s(const uint64_t *values, size_t count, int flags, char *out, size_t stride);
+int rioc_key_encode_i32s(const int32_t *values, size_t count, int flags, char *out, size_t stride);
+int rioc_key_encode_i64s(const int64_t *values, size_t count, int flags, char *out, size_t stride);
+
+// Memory accounting
+// Client figures exclude OpenSSL's internal SSL/SSL_CTX state. Tracker figures include
+// every response value the tracker owns.
+int rioc_client_memory_usage(const struct rioc_client *client, rioc_memory_usage *usage);
+int rioc_batch_memory_usage(const struct rioc_batch *batch, rioc_memory_usage *usage);
+int rioc_batch_tracker_memory_usage(struct rioc_batch_tracker *tracker, rioc_memory_usage *usage);
+
+// Value allocation
+// Every buffer handed to the caller (GET and ATOMIC_INC_DEC values from rioc_get, batch
+// responses and async callbacks, range query rows and columns) is allocated through
+// these hooks. Release values with rioc_value_free(), range results with
+// rioc_free_range_results() and columns with rioc_free_range_columns(). The default
+// hooks are libc's, so code that releases values with free() keeps working until
+// another allocator is installed. Install one before the first RIOC call, and do not
+// change it while any value it allocated is alive. The hooks are called from the
+// caller's threads and from the library's response and I/O threads.
+typedef struct rioc_allocator {
+    void *(*malloc_fn)(void *ctx, size_t size);
+    void *(*realloc_fn)(void *ctx, void *ptr, size_t size);
+    void (*free_fn)(void *ctx, void *ptr);
+    void *ctx;                  // Passed to every hook, such as an arena handle
+} rioc_allocator;
+
+// Install hooks, copied from *allocator; NULL restores libc's
+int rioc_set_allocator(const rioc_allocator *allocator);
+void rioc_value_free(void *value);
+
+// Built-in thread-caching allocator for rioc_set_allocator(). Values are rounded up to
+// size classes (32 bytes to 128KB, spaced by factors of 1.5 and 2) and freed blocks are
+// kept on per-thread lists, so allocating a value usually takes no lock and no libc
+// call. Blocks of 4KB and less are carved from 64KB chunks that are kept for reuse;
+// larger ones are cached up to 4MB per class. Larger values go to libc directly.
+const rioc_allocator *rioc_size_class_allocator(void);
+// Figures for the built-in allocator: allocated is the memory it holds from libc,
+// in_use the bytes requested by live values and allocations their count, so
+// allocated - in_use is what rounding, headers and cached blocks cost. Returns
+// RIOC_ERR_NOENT if another allocator is installed.
+int rioc_value_memory_usage(rioc_memory_usage *usage);
+
+// Asynchronous operations
+// A rioc_async owns an I/O thread that sends queued operations over the client's
+// connection and reads the responses itself. Queued ops are merged into batches (up to
+// RIOC_MAX_BATCH_SIZE ops, or the adaptive flush target below), and up to four
+// batches are pipelined on the connection while their requests total under 64KB.
+// After an I/O or protocol error the engine stops: ops in flight and queued complete
+// with that status, new submits return it, and rioc_async_get_stats() reports it; the
+// client is then unusable and must be reconnected with a new rioc_async.
+// The client must not be used for anything else until rioc_async_free() returns;
+// free completes queued ops first. Callbacks run on the I/O thread with the op's
+// status and take ownership of the value: GET passes the value bytes and
+// ATOMIC_INC_DEC an int64_t result, both to be released with rioc_value_free();
+// RANGE_QUERY passes a struct rioc_range_result array with value_len as its count,
+// to be released with rioc_free_range_results().
+struct rioc_async;
+typedef void (*rioc_async_callback)(void *arg, int status, char *value, size_t value_len);
+
+// Adaptive batching (rioc_async_create_adaptive) sizes each flush from what the
+// connection is doing: the flush target grows by one op while batches fill up and the
+// smoothed round trip time stays under latency_target_us, and halves once it does
+// not. When fewer ops than the target are queued the I/O thread lingers for more, up
+// to max_linger_us and no longer than the RTT headroom left under the target; the
+// linger is tuned by hill climbing on the completion rate and drifts back to zero
+// when waiting does not raise it. rioc_async_create() always flushes everything
+// queued and never lingers.
+typedef struct rioc_async_config {
+    uint32_t latency_target_us; // Round trip time to stay under, 0 for 1000
+    uint32_t max_batch;         // Largest flush target, 0 for RIOC_MAX_BATCH_SIZE
+    uint32_t max_linger_us;     // Longest wait for a batch to fill, 0 to never wait
+} rioc_async_config;
+
+typedef struct rioc_async_stats {
+    uint32_t target_batch;      // Ops sent per round trip when enough are queued
+    uint32_t linger_us;         // Current wait for a batch to fill
+    uint64_t rtt_us;            // Smoothed round trip time
+    uint64_t ops_per_sec;       // Completion rate over the last few round trips
+    uint64_t batches;
+    uint64_t ops;
+    uint32_t in_flight;         // Ops sent and not yet answered
+    uint32_t max_in_flight;     // Most ops that were on the connection at once
+    int32_t error;              // RIOC_SUCCESS, or the status that stopped the engine
+} rioc_async_stats;
+
+struct rioc_async *rioc_async_create(struct rioc_client *client);
+struct rioc_async *rioc_async_create_adaptive(struct rioc_client *client,
+                                              const rioc_async_config *config);
+void rioc_async_free(struct rioc_async *async);
+int rioc_async_get_stats(struct rioc_async *async, rioc_async_stats *stats);
+int rioc_async_get(struct rioc_async *async, const char *key, size_t key_len,
+                   rioc_async_callback callback, void *arg);
+int rioc_async_insert(struct rioc_async *async, const char *key, size_t key_len,
+                      const char *value, size_t value_len, uint64_t timestamp,
+                      rioc_async_callback callback, void *arg);
+int rioc_async_delete(struct rioc_async *async, const char *key, size_t key_len,
+                      uint64_t timestamp, rioc_async_callback callback, void *arg);
+int rioc_async_range_query(struct rioc_async *async,
+                           const char *start_key, size_t start_key_len,
+                           const char *end_key, size_t end_key_len,
+                           rioc_async_callback callback, void *arg);
+int rioc_async_atomic_inc_dec(struct rioc_async *async, const char *key, size_t key_len,
+                              int64_t increment, uint64_t timestamp,
+                              rioc_async_callback callback, void *arg);
+
+// Connection pool
+// A pool spreads ops from many threads over several connections to one server. Each
+// key hashes to one connection, so ops on a key stay in order; an op whose connection
+// is down runs on the next healthy one instead. A background thread reconnects
+// connections that failed, probes idle ones every health_check_ms, adds a connection
+// (up to max_connections) when more than 5% of ops waited for theirs to be free, and
+// drops back toward connections after ten checks with no waiting. The pool copies the
+// client config, so it need not outlive rioc_pool_create().
+typedef struct rioc_pool_config {
+    const rioc_client_config *client;   // Settings for every connection
+    uint32_t connections;       // Opened up front, and the fewest kept open
+    uint32_t max_connections;   // Most to grow to, 0 for a fixed-size pool
+    uint32_t health_check_ms;   // Check interval, 0 for 1000
+} rioc_pool_config;
+
+typedef struct rioc_pool_stats {
+    uint32_t connections;       // Connections ops are spread over
+    uint32_t healthy;           // Of those, the ones currently connected
+    uint64_t ops;
+    uint64_t waits;             // Ops that waited for their connection to be free
+    uint64_t failovers;         // Ops run on another connection because theirs was down
+    uint64_t reconnects;
+    uint64_t grows;
+    uint64_t shrinks;
+} rioc_pool_stats;
+
+struct rioc_pool;
+
+// Fails only if no connection could be opened; the others are retried in the background
+int rioc_pool_create(const rioc_pool_config *config, struct rioc_pool **pool);
+void rioc_pool_free(struct rioc_pool *pool);
+// Same as the rioc_* operations; RIOC_ERR_IO if every connection is down. Range
+// queries are routed by start_key.
+int rioc_pool_get(struct rioc_pool *pool, const char *key, size_t key_len,
+                  char **value, size_t *value_len);
+int rioc_pool_insert(struct rioc_pool *pool, const char *key, size_t key_len,
+                     const char *value, size_t value_len, uint64_t timestamp);
+int rioc_pool_delete(struct rioc_pool *pool, const char *key, size_t key_len,
+                     uint64_t timestamp);
+int rioc_pool_range_query(struct rioc_pool *pool, const char *start_key, size_t start_key_len,
+                          const char *end_key, size_t end_key_len,
+                          struct rioc_range_result **results, size_t *result_count);
+int rioc_pool_atomic_inc_dec(struct rioc_pool *pool, const char *key, size_t key_len,
+                             int64_t increment, uint64_t timestamp, int64_t *result);
+// Borrow key's connection for exclusive use, such as a batch or a range cursor. Other
+// ops on the connection wait until it is released. Pass the last status seen on it to
+// rioc_pool_release(): after RIOC_ERR_IO or RIOC_ERR_PROTO the pool closes the client.
+int rioc_pool_acquire(struct rioc_pool *pool, const char *key, size_t key_len,
+                      struct rioc_client **client);
+void rioc_pool_release(struct rioc_pool *pool, struct rioc_client *client, int status);
+int rioc_pool_get_stats(struct rioc_pool *pool, rioc_pool_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // RIOC_H 
\ No newline at end of file
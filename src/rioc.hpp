@@ -0,0 +1,1679 @@
+/*
+ * Copyright 2025 HPKV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RIOC_HPP
+#define RIOC_HPP
+
+// Header-only C++20 API over rioc.h
+//
+// Clients, batches and trackers are move-only owners of their native objects, and
+// values come back in handles that own the buffers the C library allocated, so nothing
+// is copied and nothing has to be freed by hand. Calls do not throw: they return a
+// status or a result holding either a value or the RIOC_ERR_* code of the failure.
+// Keys and values can be typed through codec<T> and key_codec<T>, and async_client
+// offers the same operations as coroutine awaitables.
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <semaphore>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rioc.h"
+
+extern "C" uint64_t rioc_get_timestamp_ns(void);  // From rioc_platform.h
+
+namespace rioc {
+
+// Keys and values are passed as byte spans
+using bytes = std::span<const std::byte>;
+
+inline bytes bytes_of(std::string_view s) noexcept {
+    return {reinterpret_cast<const std::byte *>(s.data()), s.size()};
+}
+
+// Nanosecond timestamp for inserts, deletes and atomic updates
+inline uint64_t timestamp() noexcept {
+    return rioc_get_timestamp_ns();
+}
+
+enum class errc : int {
+    success = RIOC_SUCCESS,
+    param = RIOC_ERR_PARAM,
+    mem = RIOC_ERR_MEM,
+    io = RIOC_ERR_IO,
+    proto = RIOC_ERR_PROTO,
+    device = RIOC_ERR_DEVICE,
+    noent = RIOC_ERR_NOENT,
+    busy = RIOC_ERR_BUSY,
+    overflow = RIOC_ERR_OVERFLOW
+};
+
+inline const char *message(errc code) noexcept {
+    switch (code) {
+        case errc::success: return "success";
+        case errc::param: return "invalid parameter";
+        case errc::mem: return "out of memory";
+        case errc::io: return "I/O error";
+        case errc::proto: return "protocol error";
+        case errc::device: return "device error";
+        case errc::noent: return "key not found";
+        case errc::busy: return "busy";
+        case errc::overflow: return "overflow";
+    }
+    return "unknown error";
+}
+
+// Outcome of a call that returns no value
+class [[nodiscard]] status {
+public:
+    constexpr status() noexcept = default;
+    constexpr explicit status(int code) noexcept : code_(code) {}
+
+    constexpr bool ok() const noexcept { return code_ == RIOC_SUCCESS; }
+    constexpr explicit operator bool() const noexcept { return ok(); }
+    constexpr errc error() const noexcept { return static_cast<errc>(code_); }
+    constexpr int code() const noexcept { return code_; }
+    const char *message() const noexcept { return rioc::message(error()); }
+
+private:
+    int code_ = RIOC_SUCCESS;
+};
+
+// A value, or the status of the call that failed to produce it
+template <typename T>
+class [[nodiscard]] result {
+public:
+    result(T value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(value)) {}
+    result(rioc::status failure) noexcept : code_(failure.code()) {
+        assert(!failure.ok());
+    }
+
+    bool ok() const noexcept { return code_ == RIOC_SUCCESS; }
+    explicit operator bool() const noexcept { return ok(); }
+    errc error() const noexcept { return static_cast<errc>(code_); }
+    int code() const noexcept { return code_; }
+    rioc::status status() const noexcept { return rioc::status(code_); }
+    const char *message() const noexcept { return rioc::message(error()); }
+
+    // The value must be present
+    T &value() & noexcept { assert(ok()); return *value_; }
+    const T &value() const & noexcept { assert(ok()); return *value_; }
+    T &&value() && noexcept { assert(ok()); return std::move(*value_); }
+    T &operator*() & noexcept { return value(); }
+    const T &operator*() const & noexcept { return value(); }
+    T &&operator*() && noexcept { return std::move(*this).value(); }
+    T *operator->() noexcept { return &value(); }
+    const T *operator->() const noexcept { return &value(); }
+
+    template <typename U>
+    T value_or(U &&fallback) && {
+        return ok() ? std::move(*value_) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+private:
+    std::optional<T> value_;
+    int code_ = RIOC_SUCCESS;
+};
+
+// A value owned by the C library's allocation, released with rioc_value_free()
+class buffer {
+public:
+    buffer() noexcept = default;
+    buffer(buffer &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    buffer &operator=(buffer &&other) noexcept {
+        if (this != &other) {
+            rioc_value_free(data_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+    buffer(const buffer &) = delete;
+    buffer &operator=(const buffer &) = delete;
+    ~buffer() { rioc_value_free(data_); }
+
+    // Takes ownership of a value the C library returned
+    static buffer adopt(char *data, size_t size) noexcept {
+        buffer b;
+        b.data_ = data;
+        b.size_ = data ? size : 0;
+        return b;
+    }
+
+    const std::byte *data() const noexcept { return reinterpret_cast<const std::byte *>(data_); }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bytes view() const noexcept { return {data(), size_}; }
+    std::string_view str() const noexcept { return {data_ ? data_ : "", size_}; }
+
+    // Gives up ownership; the caller frees the value
+    char *release() noexcept {
+        size_ = 0;
+        return std::exchange(data_, nullptr);
+    }
+
+private:
+    char *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// A row of range query results, viewing memory owned by its range_rows
+struct row {
+    bytes key;
+    bytes value;
+};
+
+// Range query results owned by the C library, released with rioc_free_range_results()
+class range_rows {
+public:
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = row;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+        explicit iterator(const rioc_range_result *pos) noexcept : pos_(pos) {}
+
+        row operator*() const noexcept { return range_rows::to_row(*pos_); }
+        iterator &operator++() noexcept { ++pos_; return *this; }
+        iterator operator++(int) noexcept { iterator prev = *this; ++pos_; return prev; }
+        bool operator==(const iterator &) const noexcept = default;
+
+    private:
+        const rioc_range_result *pos_ = nullptr;
+    };
+
+    range_rows() noexcept = default;
+    range_rows(range_rows &&other) noexcept
+        : rows_(std::exchange(other.rows_, nullptr)), count_(std::exchange(other.count_, 0)) {}
+    range_rows &operator=(range_rows &&other) noexcept {
+        if (this != &other) {
+            reset();
+            rows_ = std::exchange(other.rows_, nullptr);
+            count_ = std::exchange(other.count_, 0);
+        }
+        return *this;
+    }
+    range_rows(const range_rows &) = delete;
+    range_rows &operator=(const range_rows &) = delete;
+    ~range_rows() { reset(); }
+
+    // Takes ownership of results from rioc_range_query() or a batch range query
+    static range_rows adopt(rioc_range_result *rows, size_t count) noexcept {
+        range_rows r;
+        r.rows_ = rows;
+        r.count_ = rows ? count : 0;
+        return r;
+    }
+
+    size_t size() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+    row operator[](size_t index) const noexcept {
+        assert(index < count_);
+        return to_row(rows_[index]);
+    }
+    iterator begin() const noexcept { return iterator(rows_); }
+    iterator end() const noexcept { return iterator(rows_ + count_); }
+
+private:
+    static row to_row(const rioc_range_result &r) noexcept {
+        return {{reinterpret_cast<const std::byte *>(r.key), r.key_len},
+                {reinterpret_cast<const std::byte *>(r.value), r.value_len}};
+    }
+
+    void reset() noexcept {
+        if (rows_) {
+            rioc_free_range_results(rows_, count_);
+            rows_ = nullptr;
+            count_ = 0;
+        }
+    }
+
+    rioc_range_result *rows_ = nullptr;
+    size_t count_ = 0;
+};
+
+namespace detail {
+
+inline const char *chars(bytes b) noexcept {
+    return reinterpret_cast<const char *>(b.data());
+}
+
+} // namespace detail
+
+// Typed keys and values
+//
+// codec<T> converts values to bytes and back. Trivially copyable types are stored as
+// their object representation: put() sends the object's own bytes, and get_ref() reads
+// the object in place from the buffer it was received into. Other types specialize
+// codec<T> with view() if they already hold their bytes contiguously, or with size()
+// and encode() if they must be written out, plus decode() to read them back.
+//
+// key_codec<T> encodes keys so that byte order matches value order, which is the order
+// range queries compare in. Integers are big-endian with the sign bit flipped, and
+// tuples concatenate their fields. Strings inside a tuple are escaped and terminated,
+// so a string sorts before any longer string it is a prefix of, and descending<T>
+// fields are complemented. This is the encoding of the rioc_key_* C functions. A key
+// that is itself a string or a byte span is sent unchanged.
+
+// Primary templates are empty; a type is usable once it has a matching specialization
+template <typename T>
+struct codec {};
+
+template <typename T>
+struct key_codec {};
+
+template <typename T>
+concept value_viewable = requires(const T &value) {
+    { codec<T>::view(value) } -> std::same_as<bytes>;
+};
+
+template <typename T>
+concept value_encodable = value_viewable<T> || requires(const T &value, std::byte *out) {
+    { codec<T>::size(value) } -> std::convertible_to<size_t>;
+    { codec<T>::encode(value, out) } -> std::same_as<std::byte *>;
+};
+
+template <typename T>
+concept value_decodable = requires(bytes in) {
+    { codec<T>::decode(in) } -> std::same_as<std::optional<T>>;
+};
+
+// Keys that are sent as they are
+template <typename K>
+concept raw_key = std::convertible_to<const K &, bytes> || std::convertible_to<const K &, std::string_view>;
+
+template <typename K>
+concept key_encodable = requires(const K &key, std::byte *out) {
+    { key_codec<K>::size(key) } -> std::convertible_to<size_t>;
+    { key_codec<K>::encode(key, out) } -> std::same_as<std::byte *>;
+};
+
+// decode() consumes the key's bytes from the front of its argument
+template <typename K>
+concept key_decodable = requires(bytes &in) {
+    { key_codec<K>::decode(in) } -> std::same_as<std::optional<K>>;
+};
+
+template <typename K>
+concept key_type = raw_key<K> || key_encodable<K>;
+
+// Trivially copyable values are their own bytes. Types holding pointers are trivially
+// copyable too, but storing them is meaningless; give those a codec of their own.
+template <typename T>
+    requires std::is_trivially_copyable_v<T> && (!std::is_pointer_v<T>) && (!std::is_member_pointer_v<T>)
+struct codec<T> {
+    static constexpr bool in_place = true;
+
+    static bytes view(const T &value) noexcept {
+        return std::as_bytes(std::span<const T, 1>(&value, 1));
+    }
+
+    static std::optional<T> decode(bytes in) noexcept {
+        if (in.size() != sizeof(T)) {
+            return std::nullopt;
+        }
+        std::array<std::byte, sizeof(T)> raw;
+        std::memcpy(raw.data(), in.data(), sizeof(T));
+        return std::bit_cast<T>(raw);
+    }
+};
+
+// Views are stored as the bytes they refer to, and cannot be decoded into
+template <>
+struct codec<bytes> {
+    static bytes view(bytes value) noexcept { return value; }
+};
+
+template <>
+struct codec<std::string_view> {
+    static bytes view(std::string_view value) noexcept { return bytes_of(value); }
+};
+
+template <>
+struct codec<std::string> {
+    static bytes view(const std::string &value) noexcept { return bytes_of(value); }
+    static std::optional<std::string> decode(bytes in) {
+        return std::string(reinterpret_cast<const char *>(in.data()), in.size());
+    }
+};
+
+// Arrays of trivially copyable elements, stored back to back
+template <typename T>
+    requires std::is_trivially_copyable_v<T> && (!std::is_pointer_v<T>)
+struct codec<std::vector<T>> {
+    static bytes view(const std::vector<T> &value) noexcept {
+        return std::as_bytes(std::span<const T>(value));
+    }
+    static std::optional<std::vector<T>> decode(bytes in) {
+        if (in.size() % sizeof(T) != 0) {
+            return std::nullopt;
+        }
+        std::vector<T> value(in.size() / sizeof(T));
+        std::memcpy(value.data(), in.data(), in.size());
+        return value;
+    }
+};
+
+namespace detail {
+
+// Byte swap on little-endian hosts; the swap is its own inverse
+template <std::unsigned_integral U>
+constexpr U to_big_endian(U value) noexcept {
+    if constexpr (std::endian::native == std::endian::big || sizeof(U) == 1) {
+        return value;
+    } else {
+#if defined(__GNUC__) || defined(__clang__)
+        if constexpr (sizeof(U) == 2) return __builtin_bswap16(value);
+        if constexpr (sizeof(U) == 4) return __builtin_bswap32(value);
+        if constexpr (sizeof(U) == 8) return __builtin_bswap64(value);
+#endif
+        U swapped = 0;
+        for (size_t i = 0; i < sizeof(U); i++) {
+            swapped = static_cast<U>((swapped << 8) | ((value >> (8 * i)) & 0xFF));
+        }
+        return swapped;
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+    requires std::integral<T> && (!std::same_as<T, bool>)
+struct key_codec<T> {
+    using unsigned_type = std::make_unsigned_t<T>;
+    static constexpr unsigned_type sign_bit = unsigned_type(unsigned_type(1) << (sizeof(T) * 8 - 1));
+
+    static constexpr size_t size(T) noexcept { return sizeof(T); }
+
+    static std::byte *encode(T key, std::byte *out) noexcept {
+        unsigned_type bits = static_cast<unsigned_type>(key);
+        if constexpr (std::is_signed_v<T>) {
+            bits ^= sign_bit;
+        }
+        bits = detail::to_big_endian(bits);
+        std::memcpy(out, &bits, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    static std::optional<T> decode(bytes &in) noexcept {
+        if (in.size() < sizeof(T)) {
+            return std::nullopt;
+        }
+        unsigned_type bits;
+        std::memcpy(&bits, in.data(), sizeof(T));
+        bits = detail::to_big_endian(bits);
+        in = in.subspan(sizeof(T));
+        if constexpr (std::is_signed_v<T>) {
+            bits ^= sign_bit;
+        }
+        return static_cast<T>(bits);
+    }
+};
+
+template <>
+struct key_codec<bool> {
+    static constexpr size_t size(bool) noexcept { return 1; }
+    static std::byte *encode(bool key, std::byte *out) noexcept {
+        *out = std::byte(key ? 1 : 0);
+        return out + 1;
+    }
+    static std::optional<bool> decode(bytes &in) noexcept {
+        if (in.empty() || in[0] > std::byte(1)) {
+            return std::nullopt;
+        }
+        bool key = in[0] == std::byte(1);
+        in = in.subspan(1);
+        return key;
+    }
+};
+
+template <typename T>
+    requires std::is_enum_v<T>
+struct key_codec<T> {
+    using underlying = key_codec<std::underlying_type_t<T>>;
+
+    static constexpr size_t size(T) noexcept { return sizeof(T); }
+    static std::byte *encode(T key, std::byte *out) noexcept {
+        return underlying::encode(static_cast<std::underlying_type_t<T>>(key), out);
+    }
+    static std::optional<T> decode(bytes &in) noexcept {
+        auto raw = underlying::decode(in);
+        return raw ? std::optional<T>(static_cast<T>(*raw)) : std::nullopt;
+    }
+};
+
+namespace detail {
+
+// Strings in keys: every 0x00 becomes 0x00 0xFF, then 0x00 0x01 ends the string
+struct escaped_key {
+    static size_t size(bytes key) noexcept {
+        size_t zeros = 0;
+        for (std::byte b : key) {
+            zeros += b == std::byte(0);
+        }
+        return key.size() + zeros + 2;
+    }
+
+    static std::byte *encode(bytes key, std::byte *out) noexcept {
+        for (std::byte b : key) {
+            *out++ = b;
+            if (b == std::byte(0)) {
+                *out++ = std::byte(0xFF);
+            }
+        }
+        *out++ = std::byte(0);
+        *out++ = std::byte(1);
+        return out;
+    }
+
+    static std::optional<std::string> decode(bytes &in) {
+        std::string key;
+        for (size_t i = 0; i + 1 < in.size(); i++) {
+            if (in[i] != std::byte(0)) {
+                key.push_back(static_cast<char>(in[i]));
+            } else if (in[i + 1] == std::byte(0xFF)) {
+                key.push_back('\0');
+                i++;
+            } else if (in[i + 1] == std::byte(1)) {
+                in = in.subspan(i + 2);
+                return key;
+            } else {
+                return std::nullopt;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+template <typename T>
+concept tuple_like = requires { std::tuple_size<T>::value; };
+
+} // namespace detail
+
+template <>
+struct key_codec<bytes> : detail::escaped_key {};
+
+template <>
+struct key_codec<std::string_view> {
+    static size_t size(std::string_view key) noexcept { return detail::escaped_key::size(bytes_of(key)); }
+    static std::byte *encode(std::string_view key, std::byte *out) noexcept {
+        return detail::escaped_key::encode(bytes_of(key), out);
+    }
+};
+
+template <>
+struct key_codec<const char *> : key_codec<std::string_view> {};
+
+template <>
+struct key_codec<std::string> : key_codec<std::string_view> {
+    static std::optional<std::string> decode(bytes &in) { return detail::escaped_key::decode(in); }
+};
+
+// Tuples, pairs and arrays: the fields in order, so keys sort field by field
+template <detail::tuple_like T>
+    requires (!raw_key<T>)
+struct key_codec<T> {
+    template <size_t I>
+    using field = std::remove_cvref_t<std::tuple_element_t<I, T>>;
+
+    static size_t size(const T &key) noexcept {
+        return fields(key, [](const auto &...f) {
+            return (size_t(0) + ... + key_codec<std::remove_cvref_t<decltype(f)>>::size(f));
+        });
+    }
+
+    static std::byte *encode(const T &key, std::byte *out) noexcept {
+        fields(key, [&out](const auto &...f) {
+            ((out = key_codec<std::remove_cvref_t<decltype(f)>>::encode(f, out)), ...);
+        });
+        return out;
+    }
+
+    static constexpr bool decodable = []<size_t... I>(std::index_sequence<I...>) {
+        return (key_decodable<field<I>> && ...);
+    }(std::make_index_sequence<std::tuple_size_v<T>>());
+
+    static std::optional<T> decode(bytes &in)
+        requires decodable
+    {
+        return decode_fields(in, std::make_index_sequence<std::tuple_size_v<T>>());
+    }
+
+private:
+    template <typename F>
+    static auto fields(const T &key, F &&visit) noexcept {
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return visit(std::get<I>(key)...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>());
+    }
+
+    template <size_t... I>
+    static std::optional<T> decode_fields(bytes &in, std::index_sequence<I...>) {
+        std::tuple<std::optional<field<I>>...> decoded;
+        bool ok = ((std::get<I>(decoded) = key_codec<field<I>>::decode(in)).has_value() && ...);
+        if (!ok) {
+            return std::nullopt;
+        }
+        return T{std::move(*std::get<I>(decoded))...};
+    }
+};
+
+// Sorts a key field in reverse, like RIOC_KEY_DESC in the C API
+template <typename T>
+struct descending {
+    T value;
+};
+
+template <key_encodable T>
+struct key_codec<descending<T>> {
+    static size_t size(const descending<T> &key) noexcept { return key_codec<T>::size(key.value); }
+
+    static std::byte *encode(const descending<T> &key, std::byte *out) noexcept {
+        std::byte *end = key_codec<T>::encode(key.value, out);
+        for (std::byte *p = out; p != end; p++) {
+            *p = ~*p;
+        }
+        return end;
+    }
+
+    // The field's length is only known once decoded, so the rest of the key is
+    // complemented into a copy first
+    static std::optional<descending<T>> decode(bytes &in)
+        requires key_decodable<T>
+    {
+        if (in.size() > RIOC_MAX_KEY_SIZE) {
+            return std::nullopt;
+        }
+        std::array<std::byte, RIOC_MAX_KEY_SIZE> flipped;
+        for (size_t i = 0; i < in.size(); i++) {
+            flipped[i] = ~in[i];
+        }
+        bytes rest(flipped.data(), in.size());
+        std::optional<T> value = key_codec<T>::decode(rest);
+        if (!value) {
+            return std::nullopt;
+        }
+        in = in.subspan(in.size() - rest.size());
+        return descending<T>{std::move(*value)};
+    }
+};
+
+// A key encoded with key_codec, held inline. It converts to bytes, so it can be passed
+// wherever a key is taken, including to async_client calls that outlive the encoding.
+class encoded_key {
+public:
+    bytes view() const noexcept { return {data_.data(), size_}; }
+    operator bytes() const noexcept { return view(); }
+    size_t size() const noexcept { return size_; }
+
+private:
+    template <key_encodable K>
+    friend result<encoded_key> encode_key(const K &key) noexcept;
+    friend result<encoded_key> prefix_successor(bytes prefix) noexcept;
+
+    std::array<std::byte, RIOC_MAX_KEY_SIZE> data_;
+    size_t size_ = 0;
+};
+
+// Fails with errc::param if the encoding exceeds RIOC_MAX_KEY_SIZE
+template <key_encodable K>
+result<encoded_key> encode_key(const K &key) noexcept {
+    size_t size = key_codec<K>::size(key);
+    if (size > RIOC_MAX_KEY_SIZE) {
+        return status(RIOC_ERR_PARAM);
+    }
+    encoded_key encoded;
+    encoded.size_ = static_cast<size_t>(key_codec<K>::encode(key, encoded.data_.data()) - encoded.data_.data());
+    return encoded;
+}
+
+// Smallest key above every key that starts with prefix, as an end key for scanning it.
+// Fails with errc::noent if the prefix is empty or all 0xFF bytes.
+inline result<encoded_key> prefix_successor(bytes prefix) noexcept {
+    if (prefix.size() > RIOC_MAX_KEY_SIZE) {
+        return status(RIOC_ERR_PARAM);
+    }
+    encoded_key successor;
+    int ret = rioc_key_prefix_successor(detail::chars(prefix), prefix.size(),
+                                        reinterpret_cast<char *>(successor.data_.data()), &successor.size_);
+    if (ret != RIOC_SUCCESS) {
+        return status(ret);
+    }
+    return successor;
+}
+
+// Reads a key_codec key, such as a range query row's key; the whole key must be used
+template <key_decodable K>
+std::optional<K> decode_key(bytes in) {
+    std::optional<K> key = key_codec<K>::decode(in);
+    if (!in.empty()) {
+        return std::nullopt;
+    }
+    return key;
+}
+
+template <value_decodable T>
+std::optional<T> decode_value(bytes in) {
+    return codec<T>::decode(in);
+}
+
+// A trivially copyable value read in place, owning the buffer it was received into.
+// The C library allocates each value with malloc, so the buffer is suitably aligned.
+template <typename T>
+concept in_place_value = requires { requires codec<T>::in_place; } && alignof(T) <= alignof(std::max_align_t);
+
+template <in_place_value T>
+class value_ref {
+public:
+    static result<value_ref> adopt(buffer value) noexcept {
+        if (value.size() != sizeof(T)) {
+            return status(RIOC_ERR_PROTO);
+        }
+        return value_ref(std::move(value));
+    }
+
+    const T &operator*() const noexcept { return *get(); }
+    const T *operator->() const noexcept { return get(); }
+    const T *get() const noexcept { return std::launder(reinterpret_cast<const T *>(value_.data())); }
+
+private:
+    explicit value_ref(buffer value) noexcept : value_(std::move(value)) {}
+
+    buffer value_;
+};
+
+namespace detail {
+
+// Calls use() with the key's bytes, encoding it on the stack if it is not a raw key
+template <typename K, typename F>
+auto with_key(const K &key, F &&use) {
+    if constexpr (std::convertible_to<const K &, bytes>) {
+        return use(bytes(key));
+    } else if constexpr (std::convertible_to<const K &, std::string_view>) {
+        return use(bytes_of(std::string_view(key)));
+    } else {
+        using R = decltype(use(bytes()));
+        size_t size = key_codec<K>::size(key);
+        if (size > RIOC_MAX_KEY_SIZE) {
+            return R(status(RIOC_ERR_PARAM));
+        }
+        std::array<std::byte, RIOC_MAX_KEY_SIZE> encoded;
+        std::byte *end = key_codec<K>::encode(key, encoded.data());
+        return use(bytes(encoded.data(), static_cast<size_t>(end - encoded.data())));
+    }
+}
+
+// Calls use() with the value's bytes. Encoded values up to 256 bytes are written on
+// the stack, larger ones into a temporary allocation.
+template <typename T, typename F>
+status with_value(const T &value, F &&use) {
+    if constexpr (value_viewable<T>) {
+        return use(codec<T>::view(value));
+    } else {
+        size_t size = codec<T>::size(value);
+        if (size > RIOC_MAX_VALUE_SIZE) {
+            return status(RIOC_ERR_PARAM);
+        }
+        std::array<std::byte, 256> local;
+        std::byte *out = size <= local.size() ? local.data() : static_cast<std::byte *>(std::malloc(size));
+        if (!out) {
+            return status(RIOC_ERR_MEM);
+        }
+        std::byte *end = codec<T>::encode(value, out);
+        status ret = use(bytes(out, static_cast<size_t>(end - out)));
+        if (out != local.data()) {
+            std::free(out);
+        }
+        return ret;
+    }
+}
+
+// Decodes a GET result, failing with errc::proto if the stored value does not decode
+template <typename T>
+result<T> decode_result(result<buffer> value) {
+    if (!value) {
+        return value.status();
+    }
+    std::optional<T> decoded = codec<T>::decode(value->view());
+    if (!decoded) {
+        return status(RIOC_ERR_PROTO);
+    }
+    return std::move(*decoded);
+}
+
+} // namespace detail
+
+class batch;
+
+// Responses of an executing batch. The tracker owns the batch it was executed from and
+// frees both, after waiting for the response thread.
+class tracker {
+public:
+    tracker(tracker &&other) noexcept
+        : tracker_(std::exchange(other.tracker_, nullptr)), batch_(std::exchange(other.batch_, nullptr)) {}
+    tracker &operator=(tracker &&other) noexcept {
+        if (this != &other) {
+            reset();
+            tracker_ = std::exchange(other.tracker_, nullptr);
+            batch_ = std::exchange(other.batch_, nullptr);
+        }
+        return *this;
+    }
+    tracker(const tracker &) = delete;
+    tracker &operator=(const tracker &) = delete;
+    ~tracker() { reset(); }
+
+    // Waits for every response; a timeout of 0 waits indefinitely
+    status wait(int timeout_ms = 0) noexcept {
+        return status(rioc_batch_wait(tracker_, timeout_ms));
+    }
+
+    size_t size() const noexcept { return batch_ ? batch_->count : 0; }
+
+    // Status of the op at index, for INSERT and DELETE
+    status op_status(size_t index) noexcept {
+        char *value = nullptr;
+        size_t value_len = 0;
+        return status(rioc_batch_get_response_async(tracker_, index, &value, &value_len));
+    }
+
+    // GET value at index, taken from the tracker without a copy
+    result<buffer> take(size_t index) noexcept {
+        char *value = nullptr;
+        size_t value_len = 0;
+        int ret = rioc_batch_take_response_async(tracker_, index, &value, &value_len);
+        buffer owned = buffer::adopt(value, value_len);
+        if (ret != RIOC_SUCCESS) {
+            return status(ret);
+        }
+        return owned;
+    }
+
+    // RANGE_QUERY rows at index, taken from the tracker without a copy
+    result<range_rows> take_range(size_t index) noexcept {
+        char *value = nullptr;
+        size_t count = 0;
+        int ret = rioc_batch_take_response_async(tracker_, index, &value, &count);
+        range_rows owned = range_rows::adopt(reinterpret_cast<rioc_range_result *>(value), count);
+        if (ret != RIOC_SUCCESS) {
+            return status(ret);
+        }
+        return owned;
+    }
+
+    // GET value at index decoded as T; errc::proto if it does not decode
+    template <value_decodable T>
+    result<T> take(size_t index) {
+        return detail::decode_result<T>(take(index));
+    }
+
+    // GET value at index read in place, without a copy
+    template <in_place_value T>
+    result<value_ref<T>> take_ref(size_t index) noexcept {
+        result<buffer> value = take(index);
+        if (!value) {
+            return value.status();
+        }
+        return value_ref<T>::adopt(std::move(value).value());
+    }
+
+    // ATOMIC_INC_DEC result at index
+    result<int64_t> atomic_result(size_t index) noexcept {
+        result<buffer> value = take(index);
+        if (!value) {
+            return value.status();
+        }
+        if (value->size() < sizeof(int64_t)) {
+            return status(RIOC_ERR_PROTO);
+        }
+        int64_t counter;
+        std::memcpy(&counter, value->data(), sizeof(counter));
+        return counter;
+    }
+
+    rioc_batch_tracker *native_handle() const noexcept { return tracker_; }
+
+private:
+    friend class batch;
+
+    tracker(rioc_batch_tracker *native, rioc_batch *owner) noexcept : tracker_(native), batch_(owner) {}
+
+    void reset() noexcept {
+        if (tracker_) {
+            rioc_batch_tracker_free(tracker_);
+            tracker_ = nullptr;
+        }
+        if (batch_) {
+            rioc_batch_free(batch_);
+            batch_ = nullptr;
+        }
+    }
+
+    rioc_batch_tracker *tracker_ = nullptr;
+    rioc_batch *batch_ = nullptr;
+};
+
+// Up to RIOC_MAX_BATCH_SIZE operations sent in one round trip. Executing consumes the
+// batch, since the tracker reads responses into it.
+class batch {
+public:
+    batch(batch &&other) noexcept : batch_(std::exchange(other.batch_, nullptr)) {}
+    batch &operator=(batch &&other) noexcept {
+        if (this != &other) {
+            rioc_batch_free(batch_);
+            batch_ = std::exchange(other.batch_, nullptr);
+        }
+        return *this;
+    }
+    batch(const batch &) = delete;
+    batch &operator=(const batch &) = delete;
+    ~batch() { rioc_batch_free(batch_); }
+
+    status get(bytes key) noexcept {
+        return status(rioc_batch_add_get(batch_, detail::chars(key), key.size()));
+    }
+
+    status insert(bytes key, bytes value, uint64_t ts = timestamp()) noexcept {
+        return status(rioc_batch_add_insert(batch_, detail::chars(key), key.size(),
+                                            detail::chars(value), value.size(), ts));
+    }
+
+    status remove(bytes key, uint64_t ts = timestamp()) noexcept {
+        return status(rioc_batch_add_delete(batch_, detail::chars(key), key.size(), ts));
+    }
+
+    status range(bytes start_key, bytes end_key) noexcept {
+        return status(rioc_batch_add_range_query(batch_, detail::chars(start_key), start_key.size(),
+                                                 detail::chars(end_key), end_key.size()));
+    }
+
+    status atomic_inc_dec(bytes key, int64_t increment, uint64_t ts = timestamp()) noexcept {
+        return status(rioc_batch_add_atomic_inc_dec(batch_, detail::chars(key), key.size(),
+                                                    increment, ts));
+    }
+
+    // Typed keys and values. The batch copies them when they are added.
+    template <key_type K>
+    status get(const K &key) {
+        return detail::with_key(key, [this](bytes k) { return this->get(k); });
+    }
+
+    template <key_type K, value_encodable V>
+    status put(const K &key, const V &value, uint64_t ts = timestamp()) {
+        return detail::with_key(key, [&](bytes k) {
+            return detail::with_value(value, [&](bytes v) { return insert(k, v, ts); });
+        });
+    }
+
+    template <key_type K>
+    status remove(const K &key, uint64_t ts = timestamp()) {
+        return detail::with_key(key, [&](bytes k) { return this->remove(k, ts); });
+    }
+
+    template <key_type S, key_type E>
+    status range(const S &start_key, const E &end_key) {
+        return detail::with_key(start_key, [&](bytes start) {
+            return detail::with_key(end_key, [&](bytes end) { return this->range(start, end); });
+        });
+    }
+
+    size_t size() const noexcept { return batch_ ? batch_->count : 0; }
+
+    // Sends the batch; responses are read by a background thread
+    result<tracker> execute() && noexcept {
+        if (!batch_ || batch_->count == 0) {
+            return status(RIOC_ERR_PARAM);
+        }
+        rioc_batch_tracker *native = rioc_batch_execute_async(batch_);
+        if (!native) {
+            return status(RIOC_ERR_IO);
+        }
+        return tracker(native, std::exchange(batch_, nullptr));
+    }
+
+    rioc_batch *native_handle() const noexcept { return batch_; }
+
+private:
+    friend class client;
+
+    explicit batch(rioc_batch *native) noexcept : batch_(native) {}
+
+    rioc_batch *batch_ = nullptr;
+};
+
+// A connection to a RIOC server. Like the C client, it is used by one thread at a time.
+class client {
+public:
+    // Takes ownership of a connected native client
+    explicit client(rioc_client *native) noexcept : client_(native) {}
+    client(client &&other) noexcept : client_(std::exchange(other.client_, nullptr)) {}
+    client &operator=(client &&other) noexcept {
+        if (this != &other) {
+            reset();
+            client_ = std::exchange(other.client_, nullptr);
+        }
+        return *this;
+    }
+    client(const client &) = delete;
+    client &operator=(const client &) = delete;
+    ~client() { reset(); }
+
+    static result<client> connect(const rioc_client_config &config) noexcept {
+        rioc_client_config native_config = config;
+        rioc_client *native = nullptr;
+        int ret = rioc_client_connect_with_config(&native_config, &native);
+        if (ret != RIOC_SUCCESS) {
+            return status(ret);
+        }
+        return client(native);
+    }
+
+    // flags takes RIOC_CLIENT_* options; cpu is used with RIOC_CLIENT_PIN_CPU
+    static result<client> connect(const char *host, uint32_t port, uint32_t timeout_ms = 5000,
+                                  rioc_tls_config *tls = nullptr, uint32_t flags = 0,
+                                  int32_t cpu = 0) noexcept {
+        rioc_client_config config = {.host = host, .port = port, .timeout_ms = timeout_ms,
+                                     .tls = tls, .flags = flags, .cpu = cpu};
+        return connect(config);
+    }
+
+    // Fails with errc::noent for a missing key
+    result<buffer> get(bytes key) noexcept {
+        char *value = nullptr;
+        size_t value_len = 0;
+        int ret = rioc_get(client_, detail::chars(key), key.size(), &value, &value_len);
+        buffer owned = buffer::adopt(value, value_len);
+        if (ret != RIOC_SUCCESS) {
+            return status(ret);
+        }
+        return owned;
+    }
+
+    status insert(bytes key, bytes value, uint64_t ts = timestamp()) noexcept {
+        return status(rioc_insert(client_, detail::chars(key), key.size(),
+                                  detail::chars(value), value.size(), ts));
+    }
+
+    status remove(bytes key, uint64_t ts = timestamp()) noexcept {
+        return status(rioc_delete(client_, detail::chars(key), key.size(), ts));
+    }
+
+    result<range_rows> range(bytes start_key, bytes end_key) noexcept {
+        rioc_range_result *rows = nullptr;
+        size_t count = 0;
+        int ret = rioc_range_query(client_, detail::chars(start_key), start_key.size(),
+                                   detail::chars(end_key), end_key.size(), &rows, &count);
+        range_rows owned = range_rows::adopt(rows, count);
+        if (ret != RIOC_SUCCESS) {
+            return status(ret);
+        }
+        return owned;
+    }
+
+    result<int64_t> atomic_inc_dec(bytes key, int64_t increment, uint64_t ts = timestamp()) noexcept {
+        int64_t counter = 0;
+        int ret = rioc_atomic_inc_dec(client_, detail::chars(key), key.size(), increment, ts, &counter);
+        if (ret != RIOC_SUCCESS) {
+            return status(ret);
+        }
+        return counter;
+    }
+
+    // Typed keys and values. get<T>() fails with errc::proto if the stored value does
+    // not decode as T.
+    template <value_decodable T, key_type K>
+    result<T> get(const K &key) {
+        return detail::with_key(key, [this](bytes k) { return detail::decode_result<T>(this->get(k)); });
+    }
+
+    // Reads a trivially copyable value in place, without a copy
+    template <in_place_value T, key_type K>
+    result<value_ref<T>> get_ref(const K &key) noexcept {
+        return detail::with_key(key, [this](bytes k) -> result<value_ref<T>> {
+            result<buffer> value = this->get(k);
+            if (!value) {
+                return value.status();
+            }
+            return value_ref<T>::adopt(std::move(value).value());
+        });
+    }
+
+    template <key_type K, value_encodable V>
+    status put(const K &key, const V &value, uint64_t ts = timestamp()) {
+        return detail::with_key(key, [&](bytes k) {
+            return detail::with_value(value, [&](bytes v) { return insert(k, v, ts); });
+        });
+    }
+
+    template <key_type K>
+    status remove(const K &key, uint64_t ts = timestamp()) {
+        return detail::with_key(key, [&](bytes k) { return this->remove(k, ts); });
+    }
+
+    template <key_type S, key_type E>
+    result<range_rows> range(const S &start_key, const E &end_key) {
+        return detail::with_key(start_key, [&](bytes start) {
+            return detail::with_key(end_key, [&](bytes end) { return this->range(start, end); });
+        });
+    }
+
+    // A batch sends over this client's connection, so the client must outlive it
+    result<batch> make_batch() noexcept {
+        rioc_batch *native = rioc_batch_create(client_);
+        if (!native) {
+            return status(client_ ? RIOC_ERR_MEM : RIOC_ERR_PARAM);
+        }
+        return batch(native);
+    }
+
+    rioc_client *native_handle() const noexcept { return client_; }
+
+    // Gives up ownership; the caller disconnects the client
+    rioc_client *release() noexcept { return std::exchange(client_, nullptr); }
+
+private:
+    void reset() noexcept {
+        if (client_) {
+            rioc_client_disconnect_with_config(client_);
+            client_ = nullptr;
+        }
+    }
+
+    rioc_client *client_ = nullptr;
+};
+
+// Coroutines
+//
+// An async_client queues operations on a rioc_async engine, and co_await suspends the
+// calling coroutine until the engine's I/O thread completes the operation. The
+// coroutine is then resumed on the I/O thread, or posted to an executor. Nothing
+// blocks a thread while operations are outstanding, so one thread can keep as many
+// in flight as it has coroutines.
+
+// Where completed operations resume their coroutines. By default they resume inline on
+// the I/O thread, which sends nothing more until the coroutine suspends again, so
+// coroutines resumed there must not block.
+class executor {
+public:
+    using post_function = void (*)(void *context, std::coroutine_handle<> handle) noexcept;
+
+    constexpr executor() noexcept = default;
+    constexpr executor(post_function post, void *context) noexcept : post_(post), context_(context) {}
+
+    // Adapts an object with post(std::coroutine_handle<>), which must outlive its use
+    template <typename E>
+        requires requires(E &e, std::coroutine_handle<> h) { e.post(h); }
+    static executor from(E &e) noexcept {
+        return executor([](void *context, std::coroutine_handle<> h) noexcept {
+            static_cast<E *>(context)->post(h);
+        }, &e);
+    }
+
+    void resume(std::coroutine_handle<> h) const noexcept {
+        if (post_) {
+            post_(context_, h);
+        } else {
+            h.resume();
+        }
+    }
+
+private:
+    post_function post_ = nullptr;
+    void *context_ = nullptr;
+};
+
+namespace detail {
+
+// An operation as queued on the engine
+struct async_request {
+    uint16_t command;
+    bytes key;
+    bytes value;            // INSERT value or RANGE_QUERY end key
+    int64_t increment;
+    uint64_t timestamp;
+};
+
+inline int submit(rioc_async *async, const async_request &req, rioc_async_callback callback,
+                  void *arg) noexcept {
+    switch (req.command) {
+        case RIOC_CMD_GET:
+            return rioc_async_get(async, chars(req.key), req.key.size(), callback, arg);
+        case RIOC_CMD_INSERT:
+            return rioc_async_insert(async, chars(req.key), req.key.size(), chars(req.value),
+                                     req.value.size(), req.timestamp, callback, arg);
+        case RIOC_CMD_DELETE:
+            return rioc_async_delete(async, chars(req.key), req.key.size(), req.timestamp,
+                                     callback, arg);
+        case RIOC_CMD_RANGE_QUERY:
+            return rioc_async_range_query(async, chars(req.key), req.key.size(), chars(req.value),
+                                          req.value.size(), callback, arg);
+        case RIOC_CMD_ATOMIC_INC_DEC:
+            return rioc_async_atomic_inc_dec(async, chars(req.key), req.key.size(), req.increment,
+                                             req.timestamp, callback, arg);
+    }
+    return RIOC_ERR_PARAM;
+}
+
+// Frees a completion value that nobody took
+inline void release_value(uint16_t command, char *value, size_t value_len) noexcept {
+    if (command == RIOC_CMD_RANGE_QUERY) {
+        if (value) {
+            rioc_free_range_results(reinterpret_cast<rioc_range_result *>(value), value_len);
+        }
+    } else {
+        rioc_value_free(value);
+    }
+}
+
+// Takes ownership of a completion value in the form its command returns
+template <uint16_t Command>
+auto take_value(int ret, char *value, size_t value_len) noexcept {
+    if constexpr (Command == RIOC_CMD_GET) {
+        buffer owned = buffer::adopt(value, value_len);
+        return ret == RIOC_SUCCESS ? result<buffer>(std::move(owned)) : result<buffer>(status(ret));
+    } else if constexpr (Command == RIOC_CMD_RANGE_QUERY) {
+        range_rows owned = range_rows::adopt(reinterpret_cast<rioc_range_result *>(value), value_len);
+        return ret == RIOC_SUCCESS ? result<range_rows>(std::move(owned)) : result<range_rows>(status(ret));
+    } else if constexpr (Command == RIOC_CMD_ATOMIC_INC_DEC) {
+        buffer owned = buffer::adopt(value, value_len);
+        if (ret != RIOC_SUCCESS) {
+            return result<int64_t>(status(ret));
+        }
+        if (owned.size() < sizeof(int64_t)) {
+            return result<int64_t>(status(RIOC_ERR_PROTO));
+        }
+        int64_t counter;
+        std::memcpy(&counter, owned.data(), sizeof(counter));
+        return result<int64_t>(counter);
+    } else {
+        rioc_value_free(value);
+        return status(ret);
+    }
+}
+
+} // namespace detail
+
+// Awaitable for one queued operation. The key and value are copied when the operation
+// is queued, at co_await. co_await yields the same type as the matching client call.
+template <uint16_t Command>
+class [[nodiscard]] async_operation {
+public:
+    async_operation(const async_operation &) = delete;
+    async_operation &operator=(const async_operation &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        handle_ = h;
+        int ret = detail::submit(async_, request_, &async_operation::complete, this);
+        if (ret != RIOC_SUCCESS) {
+            // Not queued, so resume at once with the error
+            status_ = ret;
+            return false;
+        }
+        // The operation may already have completed and resumed the coroutine on the I/O
+        // thread, so this must not be touched again
+        return true;
+    }
+
+    auto await_resume() noexcept {
+        return detail::take_value<Command>(status_, std::exchange(value_, nullptr), value_len_);
+    }
+
+    ~async_operation() {
+        detail::release_value(Command, value_, value_len_);
+    }
+
+private:
+    friend class async_client;
+
+    async_operation(rioc_async *async, executor exec, detail::async_request request) noexcept
+        : async_(async), exec_(exec), request_(request) {}
+
+    static void complete(void *arg, int status, char *value, size_t value_len) noexcept {
+        auto *self = static_cast<async_operation *>(arg);
+        self->status_ = status;
+        self->value_ = value;
+        self->value_len_ = value_len;
+        self->exec_.resume(self->handle_);
+    }
+
+    rioc_async *async_;
+    executor exec_;
+    detail::async_request request_;
+    std::coroutine_handle<> handle_;
+    int status_ = RIOC_SUCCESS;
+    char *value_ = nullptr;
+    size_t value_len_ = 0;
+};
+
+// Results of an executed async_batch, by the index each op was added at
+class async_batch_results {
+public:
+    async_batch_results(async_batch_results &&) noexcept = default;
+    async_batch_results &operator=(async_batch_results &&other) noexcept {
+        if (this != &other) {
+            reset();
+            slots_ = std::move(other.slots_);
+        }
+        return *this;
+    }
+    ~async_batch_results() { reset(); }
+
+    size_t size() const noexcept { return slots_.size(); }
+
+    // Status of the op at index, for INSERT and DELETE
+    status op_status(size_t index) const noexcept {
+        return index < slots_.size() ? status(slots_[index].status) : status(RIOC_ERR_PARAM);
+    }
+
+    result<buffer> take(size_t index) noexcept { return take_as<RIOC_CMD_GET>(index); }
+    result<range_rows> take_range(size_t index) noexcept { return take_as<RIOC_CMD_RANGE_QUERY>(index); }
+    result<int64_t> atomic_result(size_t index) noexcept { return take_as<RIOC_CMD_ATOMIC_INC_DEC>(index); }
+
+private:
+    friend class async_batch_operation;
+
+    struct slot {
+        void *owner;
+        uint16_t command;
+        int status;
+        char *value;
+        size_t value_len;
+    };
+
+    explicit async_batch_results(std::vector<slot> slots) noexcept : slots_(std::move(slots)) {}
+
+    template <uint16_t Command>
+    decltype(detail::take_value<Command>(0, nullptr, 0)) take_as(size_t index) noexcept {
+        if (index >= slots_.size() || slots_[index].command != Command) {
+            return detail::take_value<Command>(RIOC_ERR_PARAM, nullptr, 0);
+        }
+        slot &s = slots_[index];
+        return detail::take_value<Command>(s.status, std::exchange(s.value, nullptr), s.value_len);
+    }
+
+    void reset() noexcept {
+        for (slot &s : slots_) {
+            detail::release_value(s.command, std::exchange(s.value, nullptr), s.value_len);
+        }
+        slots_.clear();
+    }
+
+    std::vector<slot> slots_;
+};
+
+// Awaitable for the ops of an async_batch, which resumes once after the last completes
+class [[nodiscard]] async_batch_operation {
+public:
+    async_batch_operation(const async_batch_operation &) = delete;
+    async_batch_operation &operator=(const async_batch_operation &) = delete;
+
+    bool await_ready() const noexcept { return requests_.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        handle_ = h;
+        // One extra count keeps completions from resuming the coroutine before every op
+        // has been queued
+        remaining_.store(requests_.size() + 1, std::memory_order_relaxed);
+        size_t settled = 1;
+        for (size_t i = 0; i < requests_.size(); i++) {
+            int ret = detail::submit(async_, requests_[i], &async_batch_operation::complete, &slots_[i]);
+            if (ret != RIOC_SUCCESS) {
+                slots_[i].status = ret;
+                settled++;
+            }
+        }
+        return remaining_.fetch_sub(settled, std::memory_order_acq_rel) != settled;
+    }
+
+    async_batch_results await_resume() noexcept {
+        return async_batch_results(std::move(slots_));
+    }
+
+private:
+    friend class async_batch;
+
+    async_batch_operation(rioc_async *async, executor exec,
+                          std::vector<detail::async_request> requests) noexcept
+        : async_(async), exec_(exec), requests_(std::move(requests)) {
+        slots_.reserve(requests_.size());
+        for (const detail::async_request &req : requests_) {
+            slots_.push_back({this, req.command, RIOC_SUCCESS, nullptr, 0});
+        }
+    }
+
+    static void complete(void *arg, int status, char *value, size_t value_len) noexcept {
+        auto *s = static_cast<async_batch_results::slot *>(arg);
+        s->status = status;
+        s->value = value;
+        s->value_len = value_len;
+        auto *self = static_cast<async_batch_operation *>(s->owner);
+        if (self->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            self->exec_.resume(self->handle_);
+        }
+    }
+
+    rioc_async *async_;
+    executor exec_;
+    std::vector<detail::async_request> requests_;
+    std::vector<async_batch_results::slot> slots_;
+    std::atomic<size_t> remaining_{0};
+    std::coroutine_handle<> handle_;
+};
+
+// Ops queued back to back on the engine, so they share round trips, and awaited together.
+// Keys and values are referenced until execute() is awaited.
+class async_batch {
+public:
+    status get(bytes key) {
+        return add({RIOC_CMD_GET, key, {}, 0, 0});
+    }
+
+    status insert(bytes key, bytes value, uint64_t ts = timestamp()) {
+        return add({RIOC_CMD_INSERT, key, value, 0, ts});
+    }
+
+    status remove(bytes key, uint64_t ts = timestamp()) {
+        return add({RIOC_CMD_DELETE, key, {}, 0, ts});
+    }
+
+    status range(bytes start_key, bytes end_key) {
+        return add({RIOC_CMD_RANGE_QUERY, start_key, end_key, 0, 0});
+    }
+
+    status atomic_inc_dec(bytes key, int64_t increment, uint64_t ts = timestamp()) {
+        return add({RIOC_CMD_ATOMIC_INC_DEC, key, {}, increment, ts});
+    }
+
+    size_t size() const noexcept { return requests_.size(); }
+
+    // Hands the ops to the returned awaitable, leaving the batch empty for reuse
+    async_batch_operation execute() noexcept {
+        return async_batch_operation(async_, exec_, std::move(requests_));
+    }
+
+private:
+    friend class async_client;
+
+    async_batch(rioc_async *async, executor exec) noexcept : async_(async), exec_(exec) {}
+
+    status add(const detail::async_request &req) {
+        if (req.key.size() > RIOC_MAX_KEY_SIZE || req.value.size() > RIOC_MAX_VALUE_SIZE) {
+            return status(RIOC_ERR_PARAM);
+        }
+        requests_.push_back(req);
+        return status();
+    }
+
+    rioc_async *async_;
+    executor exec_;
+    std::vector<detail::async_request> requests_;
+};
+
+// A client whose operations are awaited. It takes over a connected client, which its
+// I/O thread uses until the async_client is destroyed. Destruction completes queued
+// operations first, so it must not happen on the I/O thread itself.
+class async_client {
+public:
+    async_client(async_client &&other) noexcept
+        : client_(std::move(other.client_)), async_(std::exchange(other.async_, nullptr)),
+          exec_(other.exec_) {}
+    async_client &operator=(async_client &&other) noexcept {
+        if (this != &other) {
+            rioc_async_free(async_);
+            client_ = std::move(other.client_);
+            async_ = std::exchange(other.async_, nullptr);
+            exec_ = other.exec_;
+        }
+        return *this;
+    }
+    async_client(const async_client &) = delete;
+    async_client &operator=(const async_client &) = delete;
+    ~async_client() { rioc_async_free(async_); }
+
+    static result<async_client> create(client &&connection, executor exec = {}) noexcept {
+        rioc_async *async = rioc_async_create(connection.native_handle());
+        if (!async) {
+            return status(connection.native_handle() ? RIOC_ERR_MEM : RIOC_ERR_PARAM);
+        }
+        return async_client(std::move(connection), async, exec);
+    }
+
+    async_operation<RIOC_CMD_GET> get(bytes key) noexcept {
+        return {async_, exec_, {RIOC_CMD_GET, key, {}, 0, 0}};
+    }
+
+    async_operation<RIOC_CMD_INSERT> insert(bytes key, bytes value, uint64_t ts = timestamp()) noexcept {
+        return {async_, exec_, {RIOC_CMD_INSERT, key, value, 0, ts}};
+    }
+
+    async_operation<RIOC_CMD_DELETE> remove(bytes key, uint64_t ts = timestamp()) noexcept {
+        return {async_, exec_, {RIOC_CMD_DELETE, key, {}, 0, ts}};
+    }
+
+    async_operation<RIOC_CMD_RANGE_QUERY> range(bytes start_key, bytes end_key) noexcept {
+        return {async_, exec_, {RIOC_CMD_RANGE_QUERY, start_key, end_key, 0, 0}};
+    }
+
+    async_operation<RIOC_CMD_ATOMIC_INC_DEC> atomic_inc_dec(bytes key, int64_t increment,
+                                                            uint64_t ts = timestamp()) noexcept {
+        return {async_, exec_, {RIOC_CMD_ATOMIC_INC_DEC, key, {}, increment, ts}};
+    }
+
+    async_batch make_batch() noexcept { return async_batch(async_, exec_); }
+
+    rioc_async *native_handle() const noexcept { return async_; }
+
+private:
+    async_client(client &&connection, rioc_async *async, executor exec) noexcept
+        : client_(std::move(connection)), async_(async), exec_(exec) {}
+
+    client client_;
+    rioc_async *async_ = nullptr;
+    executor exec_;
+};
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+struct task_promise_base {
+    // Resumes whoever awaited the task by symmetric transfer, so a chain of tasks that
+    // complete one after another does not grow the stack
+    struct final_awaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    void rethrow_if_failed() const {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception;
+};
+
+template <typename T>
+struct task_promise : task_promise_base {
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U &&v) { value.emplace(std::forward<U>(v)); }
+
+    T result() {
+        rethrow_if_failed();
+        return std::move(*value);
+    }
+
+    std::optional<T> value;
+};
+
+template <>
+struct task_promise<void> : task_promise_base {
+    task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void result() const { rethrow_if_failed(); }
+};
+
+} // namespace detail
+
+// A lazily started coroutine. Awaiting it starts it by symmetric transfer and resumes
+// the awaiter the same way when it finishes.
+template <typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::task_promise<T>;
+
+    task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    task &operator=(task &&other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+    ~task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    auto operator co_await() const noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().result(); }
+        };
+        return awaiter{handle_};
+    }
+
+private:
+    friend promise_type;
+
+    explicit task(std::coroutine_handle<promise_type> h) noexcept : handle_(h) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T>
+task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+// Runs a task to completion for sync_wait, then wakes the waiting thread
+struct sync_wait_task {
+    struct promise_type {
+        sync_wait_task get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        auto final_suspend() const noexcept {
+            struct notifier {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+                    h.promise().done.release();
+                }
+                void await_resume() const noexcept {}
+            };
+            return notifier{};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept {}  // The task keeps its own exception
+
+        std::binary_semaphore done{0};
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+sync_wait_task run_for_sync_wait(const task<T> &t) {
+    struct ready {
+        decltype(t.operator co_await()) inner;
+        bool await_ready() const noexcept { return inner.await_ready(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) noexcept {
+            return inner.await_suspend(h);
+        }
+        void await_resume() const noexcept {}
+    };
+    co_await ready{t.operator co_await()};
+}
+
+} // namespace detail
+
+// Blocks the calling thread until a task finishes and returns its result. The calling
+// thread runs the task up to its first suspension.
+template <typename T>
+T sync_wait(task<T> t) {
+    detail::sync_wait_task runner = detail::run_for_sync_wait(t);
+    runner.handle.resume();
+    runner.handle.promise().done.acquire();
+    runner.handle.destroy();
+    return t.operator co_await().await_resume();
+}
+
+} // namespace rioc
+
+#endif // RIOC_HPP
@@ -0,0 +1,437 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "rioc.h"
+#include "rioc_alloc.h"
+
+// Value allocation hooks. Every buffer handed to the caller goes through the installed
+// allocator, which defaults to libc.
+
+static void *libc_malloc(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void *libc_realloc(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    return realloc(ptr, size);
+}
+
+static void libc_free(void *ctx, void *ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+static rioc_allocator value_allocator = {libc_malloc, libc_realloc, libc_free, NULL};
+
+int rioc_set_allocator(const rioc_allocator *allocator) {
+    if (!allocator) {
+        value_allocator = (rioc_allocator){libc_malloc, libc_realloc, libc_free, NULL};
+        return RIOC_SUCCESS;
+    }
+    if (!allocator->malloc_fn || !allocator->realloc_fn || !allocator->free_fn) {
+        return RIOC_ERR_PARAM;
+    }
+    value_allocator = *allocator;
+    return RIOC_SUCCESS;
+}
+
+void *rioc_value_alloc(size_t size) {
+    return value_allocator.malloc_fn(value_allocator.ctx, size);
+}
+
+void *rioc_value_realloc(void *ptr, size_t size) {
+    return value_allocator.realloc_fn(value_allocator.ctx, ptr, size);
+}
+
+void rioc_value_free(void *value) {
+    if (value) {
+        value_allocator.free_fn(value_allocator.ctx, value);
+    }
+}
+
+// Size-class allocator
+// Blocks carry a 16-byte header with their class and requested size, and are rounded
+// up to classes spaced by factors of 1.5 and 2 (32, 48, 64, 96, ... 128KB), so rounding
+// wastes at most a third of a block. Each thread keeps a free list per class and
+// allocates and frees without locks; lists beyond their limit spill half their blocks
+// to a locked global list, where threads that only allocate (like a batch's response
+// thread) refill in bulk. Classes up to SC_SPAN_MAX_BLOCK are carved from 64KB spans
+// that are kept for reuse. Larger classes are allocated one block at a time, and blocks
+// beyond SC_GLOBAL_MAX_BYTES of cache per class go back to libc. Requests above the
+// largest class go straight to libc.
+
+#define SC_HEADER           16
+#define SC_MIN_BLOCK        32
+#define SC_CLASSES          25                      // 32 << 12 = 128KB is the largest
+#define SC_MAX_BLOCK        ((size_t)SC_MIN_BLOCK << 12)
+#define SC_LARGE            UINT32_MAX
+#define SC_SPAN_SIZE        (64 * 1024)
+#define SC_SPAN_MAX_BLOCK   4096
+#define SC_THREAD_MAX_BYTES (64 * 1024)             // Per class, before spilling
+#define SC_GLOBAL_MAX_BYTES (4 * 1024 * 1024)       // Per class, for blocks not in spans
+
+struct sc_header {
+    uint32_t cls;
+    uint32_t reserved;
+    uint64_t size;                  // Requested bytes
+};
+
+struct sc_block {
+    struct sc_block *next;
+};
+
+// Spans are chained from their first bytes, so leak checkers see them as reachable
+struct sc_span {
+    struct sc_span *next;
+    char pad[SC_HEADER - sizeof(struct sc_span *)];
+};
+
+struct sc_list {
+    struct sc_block *head;
+    size_t count;
+};
+
+struct sc_global {
+    pthread_mutex_t lock;
+    struct sc_list list;
+} __attribute__((aligned(RIOC_CACHE_LINE_SIZE)));
+
+// Owner-written counters, summed by rioc_value_memory_usage(). A block freed on another
+// thread is subtracted there, so a single thread's figures can be negative.
+struct sc_thread_cache {
+    struct sc_list lists[SC_CLASSES];
+    _Atomic int64_t in_use;
+    _Atomic int64_t allocations;
+    struct sc_thread_cache *prev, *next;
+    bool registered;
+};
+
+static struct sc_global sc_globals[SC_CLASSES];
+static pthread_once_t sc_once = PTHREAD_ONCE_INIT;
+static pthread_key_t sc_key;
+static pthread_mutex_t sc_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct sc_thread_cache *sc_registry;
+static int64_t sc_retired_in_use;       // Counters of exited threads, under sc_registry_lock
+static int64_t sc_retired_allocations;
+static pthread_mutex_t sc_span_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct sc_span *sc_spans;        // Under sc_span_lock
+static atomic_size_t sc_system_bytes;   // Held from libc: spans and standalone blocks
+
+static inline size_t sc_class_size(unsigned cls) {
+    return (size_t)((cls & 1) ? SC_MIN_BLOCK + SC_MIN_BLOCK / 2 : SC_MIN_BLOCK) << (cls / 2);
+}
+
+// Smallest class holding block bytes, for SC_MIN_BLOCK < block <= SC_MAX_BLOCK
+static inline unsigned sc_class_of(size_t block) {
+    if (block <= SC_MIN_BLOCK) {
+        return 0;
+    }
+    unsigned log = 63 - (unsigned)__builtin_clzll((unsigned long long)(block - 1));  // 2^log < block
+    return block <= ((size_t)3 << (log - 1)) ? 2 * (log - 5) + 1 : 2 * (log - 4);
+}
+
+static inline size_t sc_thread_limit(unsigned cls) {
+    size_t limit = SC_THREAD_MAX_BYTES / sc_class_size(cls);
+    return limit < 2 ? 2 : limit;
+}
+
+static void sc_thread_exit(void *arg);
+
+static void sc_init(void) {
+    for (unsigned i = 0; i < SC_CLASSES; i++) {
+        pthread_mutex_init(&sc_globals[i].lock, NULL);
+    }
+    pthread_key_create(&sc_key, sc_thread_exit);
+}
+
+static inline void sc_count(struct sc_thread_cache *tc, int64_t bytes, int64_t blocks) {
+    atomic_store_explicit(&tc->in_use, atomic_load_explicit(&tc->in_use, memory_order_relaxed) + bytes,
+                          memory_order_relaxed);
+    atomic_store_explicit(&tc->allocations,
+                          atomic_load_explicit(&tc->allocations, memory_order_relaxed) + blocks,
+                          memory_order_relaxed);
+}
+
+static struct sc_thread_cache *sc_thread_cache(void) {
+    static __thread struct sc_thread_cache cache;
+    if (RIOC_UNLIKELY(!cache.registered)) {
+        pthread_once(&sc_once, sc_init);
+        pthread_mutex_lock(&sc_registry_lock);
+        cache.prev = NULL;
+        cache.next = sc_registry;
+        if (sc_registry) {
+            sc_registry->prev = &cache;
+        }
+        sc_registry = &cache;
+        cache.registered = true;
+        pthread_mutex_unlock(&sc_registry_lock);
+        pthread_setspecific(sc_key, &cache);
+    }
+    return &cache;
+}
+
+// Move the first n blocks of a thread list to the global list. Standalone blocks beyond
+// the global cache limit are returned to libc instead.
+static void sc_spill(struct sc_list *local, unsigned cls, size_t n) {
+    struct sc_block *first = local->head;
+    struct sc_block *last = first;
+    for (size_t i = 1; i < n; i++) {
+        last = last->next;
+    }
+    local->head = last->next;
+    local->count -= n;
+    last->next = NULL;
+
+    struct sc_global *global = &sc_globals[cls];
+    size_t block = sc_class_size(cls);
+    struct sc_block *release = NULL;
+    pthread_mutex_lock(&global->lock);
+    if (block > SC_SPAN_MAX_BLOCK) {
+        size_t cap = SC_GLOBAL_MAX_BYTES / block;
+        size_t keep = global->list.count >= cap ? 0 : cap - global->list.count;
+        if (keep == 0) {
+            release = first;
+            first = NULL;
+        } else if (keep < n) {
+            last = first;
+            for (size_t i = 1; i < keep; i++) {
+                last = last->next;
+            }
+            release = last->next;
+            last->next = NULL;
+            n = keep;
+        }
+    }
+    if (first) {
+        last->next = global->list.head;
+        global->list.head = first;
+        global->list.count += n;
+    }
+    pthread_mutex_unlock(&global->lock);
+
+    while (release) {
+        struct sc_block *next = release->next;
+        free(release);
+        atomic_fetch_sub_explicit(&sc_system_bytes, block, memory_order_relaxed);
+        release = next;
+    }
+}
+
+// Fill an empty thread list from the global list, or from libc when that is empty too
+static bool sc_refill(struct sc_list *local, unsigned cls) {
+    struct sc_global *global = &sc_globals[cls];
+    size_t want = sc_thread_limit(cls) / 2 + 1;
+
+    pthread_mutex_lock(&global->lock);
+    if (global->list.head) {
+        struct sc_block *first = global->list.head;
+        struct sc_block *last = first;
+        size_t n = 1;
+        while (n < want && last->next) {
+            last = last->next;
+            n++;
+        }
+        global->list.head = last->next;
+        global->list.count -= n;
+        pthread_mutex_unlock(&global->lock);
+        last->next = NULL;
+        local->head = first;
+        local->count = n;
+        return true;
+    }
+    pthread_mutex_unlock(&global->lock);
+
+    size_t block = sc_class_size(cls);
+    if (block > SC_SPAN_MAX_BLOCK) {
+        struct sc_block *b = malloc(block);
+        if (!b) {
+            return false;
+        }
+        atomic_fetch_add_explicit(&sc_system_bytes, block, memory_order_relaxed);
+        b->next = NULL;
+        local->head = b;
+        local->count = 1;
+        return true;
+    }
+
+    struct sc_span *span = malloc(SC_SPAN_SIZE);
+    if (!span) {
+        return false;
+    }
+    atomic_fetch_add_explicit(&sc_system_bytes, SC_SPAN_SIZE, memory_order_relaxed);
+    pthread_mutex_lock(&sc_span_lock);
+    span->next = sc_spans;
+    sc_spans = span;
+    pthread_mutex_unlock(&sc_span_lock);
+
+    // Carve the span into a chain of blocks
+    char *start = (char *)span + sizeof(*span);
+    size_t n = (SC_SPAN_SIZE - sizeof(*span)) / block;
+    for (size_t i = 0; i < n; i++) {
+        ((struct sc_block *)(start + i * block))->next =
+            i + 1 < n ? (struct sc_block *)(start + (i + 1) * block) : NULL;
+    }
+    local->head = (struct sc_block *)start;
+    local->count = n;
+    return true;
+}
+
+static void sc_thread_exit(void *arg) {
+    struct sc_thread_cache *tc = arg;
+    for (unsigned cls = 0; cls < SC_CLASSES; cls++) {
+        if (tc->lists[cls].count > 0) {
+            sc_spill(&tc->lists[cls], cls, tc->lists[cls].count);
+        }
+    }
+
+    pthread_mutex_lock(&sc_registry_lock);
+    sc_retired_in_use += atomic_load_explicit(&tc->in_use, memory_order_relaxed);
+    sc_retired_allocations += atomic_load_explicit(&tc->allocations, memory_order_relaxed);
+    atomic_store_explicit(&tc->in_use, 0, memory_order_relaxed);
+    atomic_store_explicit(&tc->allocations, 0, memory_order_relaxed);
+    if (tc->prev) {
+        tc->prev->next = tc->next;
+    } else {
+        sc_registry = tc->next;
+    }
+    if (tc->next) {
+        tc->next->prev = tc->prev;
+    }
+    // A later free on this thread, from another key's destructor, registers it again
+    tc->registered = false;
+    pthread_mutex_unlock(&sc_registry_lock);
+}
+
+static void *sc_malloc(void *ctx, size_t size) {
+    (void)ctx;
+    if (size > SC_MAX_BLOCK - SC_HEADER) {
+        if (size > SIZE_MAX - SC_HEADER) {
+            return NULL;
+        }
+        struct sc_header *h = malloc(size + SC_HEADER);
+        if (!h) {
+            return NULL;
+        }
+        h->cls = SC_LARGE;
+        h->size = size;
+        atomic_fetch_add_explicit(&sc_system_bytes, size + SC_HEADER, memory_order_relaxed);
+        sc_count(sc_thread_cache(), (int64_t)size, 1);
+        return (char *)h + SC_HEADER;
+    }
+
+    unsigned cls = sc_class_of(size + SC_HEADER);
+    struct sc_thread_cache *tc = sc_thread_cache();
+    struct sc_list *list = &tc->lists[cls];
+    if (RIOC_UNLIKELY(!list->head) && !sc_refill(list, cls)) {
+        return NULL;
+    }
+    struct sc_block *b = list->head;
+    list->head = b->next;
+    list->count--;
+
+    struct sc_header *h = (struct sc_header *)b;
+    h->cls = cls;
+    h->size = size;
+    sc_count(tc, (int64_t)size, 1);
+    return (char *)h + SC_HEADER;
+}
+
+static void sc_free(void *ctx, void *ptr) {
+    (void)ctx;
+    if (!ptr) {
+        return;
+    }
+    struct sc_header *h = (struct sc_header *)((char *)ptr - SC_HEADER);
+    struct sc_thread_cache *tc = sc_thread_cache();
+    sc_count(tc, -(int64_t)h->size, -1);
+
+    if (h->cls == SC_LARGE) {
+        atomic_fetch_sub_explicit(&sc_system_bytes, h->size + SC_HEADER, memory_order_relaxed);
+        free(h);
+        return;
+    }
+
+    unsigned cls = h->cls;
+    struct sc_list *list = &tc->lists[cls];
+    struct sc_block *b = (struct sc_block *)h;
+    b->next = list->head;
+    list->head = b;
+    if (RIOC_UNLIKELY(++list->count > sc_thread_limit(cls))) {
+        sc_spill(list, cls, list->count / 2);
+    }
+}
+
+static void *sc_realloc(void *ctx, void *ptr, size_t size) {
+    if (!ptr) {
+        return sc_malloc(ctx, size);
+    }
+    struct sc_header *h = (struct sc_header *)((char *)ptr - SC_HEADER);
+
+    // Large blocks stay with libc, which can resize them without copying
+    if (h->cls == SC_LARGE && size > SC_MAX_BLOCK - SC_HEADER) {
+        if (size > SIZE_MAX - SC_HEADER) {
+            return NULL;
+        }
+        uint64_t old_size = h->size;
+        struct sc_header *grown = realloc(h, size + SC_HEADER);
+        if (!grown) {
+            return NULL;
+        }
+        grown->size = size;
+        if (size >= old_size) {
+            atomic_fetch_add_explicit(&sc_system_bytes, size - old_size, memory_order_relaxed);
+        } else {
+            atomic_fetch_sub_explicit(&sc_system_bytes, old_size - size, memory_order_relaxed);
+        }
+        sc_count(sc_thread_cache(), (int64_t)size - (int64_t)old_size, 0);
+        return (char *)grown + SC_HEADER;
+    }
+
+    // Grow or shrink in place while the block's class still fits
+    if (h->cls != SC_LARGE && size <= sc_class_size(h->cls) - SC_HEADER &&
+        (h->cls == 0 || size > sc_class_size(h->cls - 1) - SC_HEADER)) {
+        sc_count(sc_thread_cache(), (int64_t)size - (int64_t)h->size, 0);
+        h->size = size;
+        return ptr;
+    }
+
+    void *grown = sc_malloc(ctx, size);
+    if (!grown) {
+        return NULL;
+    }
+    memcpy(grown, ptr, h->size < size ? h->size : size);
+    sc_free(ctx, ptr);
+    return grown;
+}
+
+static const rioc_allocator size_class_allocator = {sc_malloc, sc_realloc, sc_free, NULL};
+
+const rioc_allocator *rioc_size_class_allocator(void) {
+    return &size_class_allocator;
+}
+
+int rioc_value_memory_usage(rioc_memory_usage *usage) {
+    if (!usage) {
+        return RIOC_ERR_PARAM;
+    }
+    if (value_allocator.malloc_fn != sc_malloc) {
+        return RIOC_ERR_NOENT;
+    }
+
+    pthread_mutex_lock(&sc_registry_lock);
+    int64_t in_use = sc_retired_in_use;
+    int64_t allocations = sc_retired_allocations;
+    for (struct sc_thread_cache *tc = sc_registry; tc; tc = tc->next) {
+        in_use += atomic_load_explicit(&tc->in_use, memory_order_relaxed);
+        allocations += atomic_load_explicit(&tc->allocations, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&sc_registry_lock);
+
+    // Threads update their counters without synchronizing with this read
+    usage->allocated = atomic_load_explicit(&sc_system_bytes, memory_order_relaxed);
+    usage->in_use = in_use > 0 ? (size_t)in_use : 0;
+    usage->allocations = allocations > 0 ? (size_t)allocations : 0;
+    return RIOC_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#ifndef RIOC_ALLOC_H
+#define RIOC_ALLOC_H
+
+#include <stddef.h>
+#include "rioc.h"
+
+// Allocation through the hooks installed with rioc_set_allocator(), for every buffer
+// handed to the caller. Release with rioc_value_free().
+void *rioc_value_alloc(size_t size);
+void *rioc_value_realloc(void *ptr, size_t size);
+
+#endif // RIOC_ALLOC_H
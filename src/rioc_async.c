@@ -0,0 +1,617 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+
+// Queued operation; the key is stored first in data, followed by the value
+// (INSERT), the increment (ATOMIC_INC_DEC) or the end key (RANGE_QUERY)
+struct rioc_async_op {
+    struct rioc_async_op *next;
+    rioc_async_callback callback;
+    void *arg;
+    uint64_t timestamp;
+    size_t key_len;
+    size_t value_len;
+    uint16_t command;
+    char data[];
+};
+
+// Controller steps are taken every ASYNC_ADAPT_WINDOW round trips so that one slow
+// response does not move the target; the RTT is smoothed with weight 1/8 as in TCP
+#define ASYNC_ADAPT_WINDOW 8
+#define ASYNC_RTT_SHIFT 3
+#define ASYNC_DEFAULT_LATENCY_TARGET_US 1000
+#define ASYNC_LINGER_STEPS 16           // Linger moves by max_linger / 16 per step
+
+// Flush sizing. The I/O thread owns the controller and updates it with lock held,
+// so rioc_async_get_stats() can read it under the same lock.
+struct async_adapt {
+    bool adaptive;
+    uint32_t max_batch;
+    uint64_t latency_target_ns;
+    uint64_t max_linger_ns;
+    uint32_t target_batch;
+    uint64_t linger_ns;
+    int linger_dir;                 // Hill climbing direction, +1 or -1
+    uint64_t srtt_ns;
+    uint64_t window_start_ns;
+    uint32_t window_trips;
+    uint32_t window_full;           // Round trips that sent target_batch ops
+    uint64_t window_ops;
+    uint64_t rate;                  // Ops/sec over the last window
+    uint64_t batches;
+    uint64_t ops;
+};
+
+// Batches on the connection at once. A batch beyond the first is only sent if it and
+// the requests of those in flight fit in ASYNC_PIPELINE_BYTES: the I/O thread reads no
+// responses while it writes, so requests must fit in the socket buffers even if the
+// server is blocked sending responses.
+#define ASYNC_PIPELINE_DEPTH 4
+#define ASYNC_PIPELINE_BYTES (64 * 1024)
+
+// A batch sent and not yet answered. ops[i] is the op at index i of the batch.
+struct async_flight {
+    struct rioc_batch *batch;       // Created on first use, reused afterwards
+    struct rioc_batch_tracker *tracker;
+    struct rioc_async_op *ops[RIOC_MAX_BATCH_SIZE];
+    size_t count;
+    size_t bytes;                   // Request size
+    uint64_t sent_ns;
+};
+
+struct rioc_async {
+    struct rioc_client *client;
+    pthread_t io_thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct rioc_async_op *head;     // Submission queue, protected by lock
+    struct rioc_async_op *tail;
+    size_t queued;
+    bool stopping;
+    int error;                      // Status that stopped the engine, protected by lock
+    // Pipeline, owned by the I/O thread; in_flight_ops is also read under lock
+    struct async_flight flights[ASYNC_PIPELINE_DEPTH];
+    size_t first_flight;
+    size_t flights_sent;
+    size_t flight_bytes;
+    size_t in_flight_ops;
+    size_t max_in_flight_ops;
+    struct async_adapt adapt;
+};
+
+static void *async_io_thread(void *arg);
+
+static struct rioc_async *async_create(struct rioc_client *client,
+                                       const rioc_async_config *config) {
+    if (!client) {
+        return NULL;
+    }
+
+    struct rioc_async *async = calloc(1, sizeof(*async));
+    if (!async) {
+        return NULL;
+    }
+
+    struct async_adapt *adapt = &async->adapt;
+    adapt->max_batch = RIOC_MAX_BATCH_SIZE;
+    if (config) {
+        adapt->adaptive = true;
+        if (config->max_batch > 0 && config->max_batch < RIOC_MAX_BATCH_SIZE) {
+            adapt->max_batch = config->max_batch;
+        }
+        adapt->latency_target_ns = (uint64_t)(config->latency_target_us ?
+            config->latency_target_us : ASYNC_DEFAULT_LATENCY_TARGET_US) * 1000ULL;
+        adapt->max_linger_ns = (uint64_t)config->max_linger_us * 1000ULL;
+        // Start small and let the controller find the size the connection sustains
+        adapt->target_batch = 1;
+    } else {
+        adapt->target_batch = adapt->max_batch;
+    }
+    adapt->linger_dir = 1;
+
+    // Further batches are created when the pipeline first gets that deep
+    async->client = client;
+    async->flights[0].batch = rioc_batch_create(client);
+    if (!async->flights[0].batch) {
+        free(async);
+        return NULL;
+    }
+
+    pthread_mutex_init(&async->lock, NULL);
+    pthread_cond_init(&async->cond, NULL);
+
+    if (pthread_create(&async->io_thread, NULL, async_io_thread, async) != 0) {
+        pthread_cond_destroy(&async->cond);
+        pthread_mutex_destroy(&async->lock);
+        rioc_batch_free(async->flights[0].batch);
+        free(async);
+        return NULL;
+    }
+
+    return async;
+}
+
+struct rioc_async *rioc_async_create(struct rioc_client *client) {
+    return async_create(client, NULL);
+}
+
+struct rioc_async *rioc_async_create_adaptive(struct rioc_client *client,
+                                              const rioc_async_config *config) {
+    if (!config) {
+        return NULL;
+    }
+    return async_create(client, config);
+}
+
+int rioc_async_get_stats(struct rioc_async *async, rioc_async_stats *stats) {
+    if (!async || !stats) {
+        return RIOC_ERR_PARAM;
+    }
+
+    pthread_mutex_lock(&async->lock);
+    const struct async_adapt *adapt = &async->adapt;
+    stats->target_batch = adapt->target_batch;
+    stats->linger_us = (uint32_t)(adapt->linger_ns / 1000);
+    stats->rtt_us = adapt->srtt_ns / 1000;
+    stats->ops_per_sec = adapt->rate;
+    stats->batches = adapt->batches;
+    stats->ops = adapt->ops;
+    stats->in_flight = (uint32_t)async->in_flight_ops;
+    stats->max_in_flight = (uint32_t)async->max_in_flight_ops;
+    stats->error = async->error;
+    pthread_mutex_unlock(&async->lock);
+    return RIOC_SUCCESS;
+}
+
+void rioc_async_free(struct rioc_async *async) {
+    if (!async) {
+        return;
+    }
+
+    // The I/O thread completes everything already queued before it exits
+    pthread_mutex_lock(&async->lock);
+    async->stopping = true;
+    pthread_cond_signal(&async->cond);
+    pthread_mutex_unlock(&async->lock);
+    pthread_join(async->io_thread, NULL);
+
+    pthread_cond_destroy(&async->cond);
+    pthread_mutex_destroy(&async->lock);
+    for (size_t i = 0; i < ASYNC_PIPELINE_DEPTH; i++) {
+        rioc_batch_free(async->flights[i].batch);
+    }
+    free(async);
+}
+
+// Copy an operation and append it to the submission queue
+static int async_submit(struct rioc_async *async, uint16_t command,
+                        const char *key, size_t key_len,
+                        const char *value, size_t value_len, uint64_t timestamp,
+                        rioc_async_callback callback, void *arg) {
+    if (!async || !key || !callback || key_len > RIOC_MAX_KEY_SIZE ||
+        (value_len > 0 && !value) || value_len > RIOC_MAX_VALUE_SIZE) {
+        return RIOC_ERR_PARAM;
+    }
+
+    struct rioc_async_op *op = malloc(sizeof(*op) + key_len + value_len);
+    if (!op) {
+        return RIOC_ERR_MEM;
+    }
+
+    op->next = NULL;
+    op->callback = callback;
+    op->arg = arg;
+    op->timestamp = timestamp;
+    op->key_len = key_len;
+    op->value_len = value_len;
+    op->command = command;
+    memcpy(op->data, key, key_len);
+    if (value_len > 0) {
+        memcpy(op->data + key_len, value, value_len);
+    }
+
+    pthread_mutex_lock(&async->lock);
+    if (async->stopping || async->error != RIOC_SUCCESS) {
+        int ret = async->stopping ? RIOC_ERR_PARAM : async->error;
+        pthread_mutex_unlock(&async->lock);
+        free(op);
+        return ret;
+    }
+    if (async->tail) {
+        async->tail->next = op;
+    } else {
+        async->head = op;
+    }
+    async->tail = op;
+    async->queued++;
+    pthread_cond_signal(&async->cond);
+    pthread_mutex_unlock(&async->lock);
+
+    return RIOC_SUCCESS;
+}
+
+int rioc_async_get(struct rioc_async *async, const char *key, size_t key_len,
+                   rioc_async_callback callback, void *arg) {
+    return async_submit(async, RIOC_CMD_GET, key, key_len, NULL, 0, 0, callback, arg);
+}
+
+int rioc_async_insert(struct rioc_async *async, const char *key, size_t key_len,
+                      const char *value, size_t value_len, uint64_t timestamp,
+                      rioc_async_callback callback, void *arg) {
+    return async_submit(async, RIOC_CMD_INSERT, key, key_len, value, value_len,
+                        timestamp, callback, arg);
+}
+
+int rioc_async_delete(struct rioc_async *async, const char *key, size_t key_len,
+                      uint64_t timestamp, rioc_async_callback callback, void *arg) {
+    return async_submit(async, RIOC_CMD_DELETE, key, key_len, NULL, 0, timestamp, callback, arg);
+}
+
+int rioc_async_range_query(struct rioc_async *async,
+                           const char *start_key, size_t start_key_len,
+                           const char *end_key, size_t end_key_len,
+                           rioc_async_callback callback, void *arg) {
+    if (end_key_len > RIOC_MAX_KEY_SIZE) {
+        return RIOC_ERR_PARAM;
+    }
+    return async_submit(async, RIOC_CMD_RANGE_QUERY, start_key, start_key_len,
+                        end_key, end_key_len, 0, callback, arg);
+}
+
+int rioc_async_atomic_inc_dec(struct rioc_async *async, const char *key, size_t key_len,
+                              int64_t increment, uint64_t timestamp,
+                              rioc_async_callback callback, void *arg) {
+    return async_submit(async, RIOC_CMD_ATOMIC_INC_DEC, key, key_len,
+                        (const char*)&increment, sizeof(increment), timestamp, callback, arg);
+}
+
+static int async_add_to_batch(struct rioc_batch *batch, const struct rioc_async_op *op) {
+    const char *value = op->data + op->key_len;
+
+    switch (op->command) {
+        case RIOC_CMD_GET:
+            return rioc_batch_add_get(batch, op->data, op->key_len);
+        case RIOC_CMD_INSERT:
+            return rioc_batch_add_insert(batch, op->data, op->key_len, value, op->value_len,
+                                         op->timestamp);
+        case RIOC_CMD_DELETE:
+            return rioc_batch_add_delete(batch, op->data, op->key_len, op->timestamp);
+        case RIOC_CMD_RANGE_QUERY:
+            return rioc_batch_add_range_query(batch, op->data, op->key_len, value, op->value_len);
+        case RIOC_CMD_ATOMIC_INC_DEC: {
+            int64_t increment;
+            memcpy(&increment, value, sizeof(increment));
+            return rioc_batch_add_atomic_inc_dec(batch, op->data, op->key_len, increment,
+                                                 op->timestamp);
+        }
+        default:
+            return RIOC_ERR_PARAM;
+    }
+}
+
+// Complete an op and release it
+static void async_complete(struct rioc_async_op *op, int status, char *value, size_t value_len) {
+    op->callback(op->arg, status, value, value_len);
+    free(op);
+}
+
+static size_t async_request_bytes(const struct rioc_async_op *op) {
+    return sizeof(struct rioc_op_header) + op->key_len + op->value_len;
+}
+
+// Put ops into the flight's batch and send it. An op the batch rejects completes
+// with that status, so every op keeps its own response. Returns RIOC_ERR_IO if the
+// batch could not be sent; its ops are completed with that status.
+static int async_flight_send(struct async_flight *flight, struct rioc_async_op **ops,
+                             size_t count) {
+    struct rioc_batch *batch = flight->batch;
+    batch->count = 0;
+    flight->count = 0;
+    flight->bytes = sizeof(struct rioc_batch_header);
+    for (size_t i = 0; i < count; i++) {
+        int ret = async_add_to_batch(batch, ops[i]);
+        if (ret != RIOC_SUCCESS) {
+            async_complete(ops[i], ret, NULL, 0);
+            continue;
+        }
+        flight->ops[flight->count++] = ops[i];
+        flight->bytes += async_request_bytes(ops[i]);
+    }
+    if (flight->count == 0) {
+        return RIOC_SUCCESS;
+    }
+
+    flight->sent_ns = rioc_get_timestamp_ns();
+    flight->tracker = rioc_batch_send(batch);
+    if (!flight->tracker) {
+        for (size_t i = 0; i < flight->count; i++) {
+            async_complete(flight->ops[i], RIOC_ERR_IO, NULL, 0);
+        }
+        flight->count = 0;
+        return RIOC_ERR_IO;
+    }
+    return RIOC_SUCCESS;
+}
+
+// Read the responses of the oldest batch and complete its ops. Ops whose responses
+// never arrived complete with the batch's error and no value. Once the engine has
+// failed the responses are out of step with the requests, so nothing is read and
+// every op gets the engine's error. Returns the batch's status and sets *rtt_ns.
+static int async_flight_receive(struct async_flight *flight, int engine_error,
+                                uint64_t *rtt_ns) {
+    int error = engine_error;
+    size_t received = 0;
+    if (engine_error == RIOC_SUCCESS) {
+        error = rioc_batch_receive(flight->tracker);
+        received = atomic_load_explicit(&flight->tracker->responses_received,
+                                        memory_order_acquire);
+    }
+    *rtt_ns = rioc_get_timestamp_ns() - flight->sent_ns;
+    if (*rtt_ns == 0) {
+        *rtt_ns = 1;
+    }
+
+    for (size_t i = 0; i < flight->count; i++) {
+        struct rioc_async_op *op = flight->ops[i];
+        if (i >= received) {
+            async_complete(op, error, NULL, 0);
+            continue;
+        }
+
+        // Only values the response allocated are taken; free those of failed ops
+        char *value = NULL;
+        size_t value_len = 0;
+        int status = rioc_batch_take_response_async(flight->tracker, i, &value, &value_len);
+        if (status != RIOC_SUCCESS && value) {
+            if (op->command == RIOC_CMD_RANGE_QUERY) {
+                rioc_free_range_results((struct rioc_range_result *)value, value_len);
+            } else {
+                rioc_value_free(value);
+            }
+            value = NULL;
+            value_len = 0;
+        }
+        async_complete(op, status, value, value_len);
+    }
+
+    rioc_batch_tracker_free(flight->tracker);
+    flight->tracker = NULL;
+    flight->count = 0;
+    return error;
+}
+
+// Feed one round trip of count ops to the controller; called with lock held
+static void async_adapt_step(struct async_adapt *adapt, size_t count, uint64_t rtt_ns) {
+    uint64_t now_ns = rioc_get_timestamp_ns();
+    adapt->batches++;
+    adapt->ops += count;
+    if (rtt_ns == 0) {
+        return;
+    }
+
+    adapt->srtt_ns = adapt->srtt_ns ?
+        adapt->srtt_ns - (adapt->srtt_ns >> ASYNC_RTT_SHIFT) + (rtt_ns >> ASYNC_RTT_SHIFT) :
+        rtt_ns;
+    if (adapt->window_trips == 0) {
+        adapt->window_start_ns = now_ns - rtt_ns;
+    }
+    adapt->window_trips++;
+    adapt->window_ops += count;
+    if (count >= adapt->target_batch) {
+        adapt->window_full++;
+    }
+    if (adapt->window_trips < ASYNC_ADAPT_WINDOW) {
+        return;
+    }
+
+    uint64_t elapsed_ns = now_ns - adapt->window_start_ns;
+    uint64_t rate = elapsed_ns ? adapt->window_ops * 1000000000ULL / elapsed_ns : 0;
+    bool full = adapt->window_full * 2 >= adapt->window_trips;
+
+    if (adapt->adaptive) {
+        if (adapt->srtt_ns > adapt->latency_target_ns) {
+            // Multiplicative decrease: smaller batches come back sooner
+            adapt->target_batch = adapt->target_batch > 1 ? adapt->target_batch / 2 : 1;
+            adapt->linger_ns /= 2;
+        } else {
+            // Additive increase while the queue keeps up with the target
+            if (full && adapt->target_batch < adapt->max_batch) {
+                adapt->target_batch++;
+            }
+
+            // Linger climbs while it raises the completion rate by more than noise,
+            // turns back when the rate falls and shrinks when waiting changes nothing
+            uint64_t step = adapt->max_linger_ns / ASYNC_LINGER_STEPS;
+            uint64_t noise = adapt->rate / 50;
+            if (rate + noise < adapt->rate) {
+                adapt->linger_dir = -adapt->linger_dir;
+            } else if (rate <= adapt->rate + noise) {
+                adapt->linger_dir = -1;
+            }
+            if (adapt->linger_dir > 0) {
+                adapt->linger_ns += step;
+            } else {
+                adapt->linger_ns = adapt->linger_ns > step ? adapt->linger_ns - step : 0;
+            }
+            if (adapt->linger_ns == 0) {
+                adapt->linger_dir = 1;
+            }
+
+            uint64_t headroom = adapt->latency_target_ns - adapt->srtt_ns;
+            uint64_t cap = adapt->max_linger_ns < headroom ? adapt->max_linger_ns : headroom;
+            if (adapt->linger_ns > cap) {
+                adapt->linger_ns = cap;
+            }
+        }
+    }
+
+    adapt->rate = rate;
+    adapt->window_trips = 0;
+    adapt->window_full = 0;
+    adapt->window_ops = 0;
+}
+
+// Wait up to the linger time for target_batch ops to be queued; called with lock held
+static void async_linger(struct rioc_async *async) {
+    struct async_adapt *adapt = &async->adapt;
+    if (adapt->linger_ns == 0 || async->queued >= adapt->target_batch) {
+        return;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    uint64_t nsec = (uint64_t)deadline.tv_nsec + adapt->linger_ns;
+    deadline.tv_sec += (time_t)(nsec / 1000000000ULL);
+    deadline.tv_nsec = (long)(nsec % 1000000000ULL);
+
+    while (async->queued < adapt->target_batch && !async->stopping) {
+        if (pthread_cond_timedwait(&async->cond, &async->lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+}
+
+// Fail every queued op with the engine's error; called with lock held, returns with it held
+static void async_fail_queued(struct rioc_async *async) {
+    struct rioc_async_op *op = async->head;
+    async->head = NULL;
+    async->tail = NULL;
+    async->queued = 0;
+    int error = async->error;
+    pthread_mutex_unlock(&async->lock);
+
+    while (op) {
+        struct rioc_async_op *next = op->next;
+        async_complete(op, error, NULL, 0);
+        op = next;
+    }
+    pthread_mutex_lock(&async->lock);
+}
+
+// Whether another batch may be sent now; called with lock held
+static bool async_can_send(struct rioc_async *async) {
+    if (!async->head || async->error != RIOC_SUCCESS) {
+        return false;
+    }
+    if (async->flights_sent == 0) {
+        // An empty pipeline restarts at the batch created up front
+        async->first_flight = 0;
+        return true;
+    }
+    if (async->flights_sent == ASYNC_PIPELINE_DEPTH) {
+        return false;
+    }
+
+    // The next batch must fit beside those in flight; a larger one waits for them
+    size_t bytes = sizeof(struct rioc_batch_header);
+    size_t count = 0;
+    for (const struct rioc_async_op *op = async->head;
+         op && count < async->adapt.target_batch; op = op->next, count++) {
+        bytes += async_request_bytes(op);
+    }
+    if (async->flight_bytes + bytes > ASYNC_PIPELINE_BYTES) {
+        return false;
+    }
+
+    struct async_flight *flight =
+        &async->flights[(async->first_flight + async->flights_sent) % ASYNC_PIPELINE_DEPTH];
+    if (!flight->batch) {
+        // Without another batch the pipeline stays as deep as it is
+        flight->batch = rioc_batch_create(async->client);
+    }
+    return flight->batch != NULL;
+}
+
+// The I/O thread sends batches while the pipeline has room and ops are queued, then
+// reads the oldest batch's responses, as rioc_insert_bulk does. Ops queued while it
+// reads go out as soon as that batch completes, while later batches are still in flight.
+static void *async_io_thread(void *arg) {
+    struct rioc_async *async = (struct rioc_async *)arg;
+    struct rioc_async_op *ops[RIOC_MAX_BATCH_SIZE];
+
+    // Best effort, as for batch response threads
+    if (async->client->flags & RIOC_CLIENT_PIN_CPU) {
+        rioc_pin_thread_to_cpu(async->client->cpu);
+    }
+
+    pthread_mutex_lock(&async->lock);
+    for (;;) {
+        if (async->error != RIOC_SUCCESS && async->head) {
+            async_fail_queued(async);
+        }
+        if (async->flights_sent == 0) {
+            while (!async->head && !async->stopping) {
+                pthread_cond_wait(&async->cond, &async->lock);
+            }
+            if (!async->head) {
+                break;
+            }
+            if (async->error != RIOC_SUCCESS) {
+                continue;
+            }
+            // Linger only while the connection is idle; otherwise responses are waiting
+            async_linger(async);
+        }
+
+        while (async_can_send(async)) {
+            // Queued ops go out together, up to the target
+            size_t count = 0;
+            while (async->head && count < async->adapt.target_batch) {
+                ops[count++] = async->head;
+                async->head = async->head->next;
+            }
+            if (!async->head) {
+                async->tail = NULL;
+            }
+            async->queued -= count;
+            size_t index = (async->first_flight + async->flights_sent) % ASYNC_PIPELINE_DEPTH;
+            struct async_flight *flight = &async->flights[index];
+            pthread_mutex_unlock(&async->lock);
+
+            int ret = async_flight_send(flight, ops, count);
+
+            pthread_mutex_lock(&async->lock);
+            if (ret != RIOC_SUCCESS) {
+                async->error = ret;
+            } else if (flight->count > 0) {
+                async->flights_sent++;
+                async->flight_bytes += flight->bytes;
+                async->in_flight_ops += flight->count;
+                if (async->in_flight_ops > async->max_in_flight_ops) {
+                    async->max_in_flight_ops = async->in_flight_ops;
+                }
+            }
+        }
+        if (async->flights_sent == 0) {
+            continue;
+        }
+
+        struct async_flight *flight = &async->flights[async->first_flight];
+        size_t count = flight->count;
+        size_t bytes = flight->bytes;
+        int engine_error = async->error;
+        pthread_mutex_unlock(&async->lock);
+
+        uint64_t rtt_ns;
+        int ret = async_flight_receive(flight, engine_error, &rtt_ns);
+
+        pthread_mutex_lock(&async->lock);
+        if (ret != RIOC_SUCCESS && async->error == RIOC_SUCCESS) {
+            async->error = ret;
+        }
+        async->first_flight = (async->first_flight + 1) % ASYNC_PIPELINE_DEPTH;
+        async->flights_sent--;
+        async->flight_bytes -= bytes;
+        async->in_flight_ops -= count;
+        async_adapt_step(&async->adapt, count, ret == RIOC_SUCCESS ? rtt_ns : 0);
+    }
+    pthread_mutex_unlock(&async->lock);
+
+    return NULL;
+}
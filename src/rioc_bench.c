@@ -13,6 +13,7 @@
 #include <inttypes.h>
 #include "rioc.h"
 #include "rioc_platform.h"
+#include "rioc_bench.h"
 
 #define MAX_THREADS 64
 #define MAX_SAMPLES 1000000
@@ -57,17 +58,6 @@ struct thread_context {
     const char *tls_verify_hostname; // Hostname to verify in server certificate
 } RIOC_ALIGNED;  // Align thread context for better cache performance
 
-struct thread_result {
-    double min_latency;
-    double max_latency;
-    double avg_latency;
-    double p50_latency;
-    double p95_latency;
-    double p99_latency;
-    uint64_t op_count;
-    uint64_t error_count;
-};
-
 static inline uint64_t get_timestamp_ns(void) {
     return rioc_get_timestamp_ns();
 }
@@ -78,7 +68,7 @@ static int compare_doubles(const void *a, const void *b) {
     return (da > db) - (da < db);
 }
 
-static void calculate_stats(double *latencies, int count, struct thread_result *result) {
+void calculate_stats(double *latencies, int count, struct thread_result *result) {
     qsort(latencies, count, sizeof(double), compare_doubles);
     
     result->min_latency = latencies[0];
@@ -93,6 +83,29 @@ static void calculate_stats(double *latencies, int count, struct thread_result *
     result->p50_latency = latencies[count * 50 / 100];
     result->p95_latency = latencies[count * 95 / 100];
     result->p99_latency = latencies[count * 99 / 100];
+    result->p999_latency = latencies[(int)((int64_t)count * 999 / 1000)];
+}
+
+void gate_wait(struct start_gate *gate) {
+    pthread_mutex_lock(&gate->lock);
+    gate->waiting++;
+    pthread_cond_broadcast(&gate->cond);
+    while (!gate->released) {
+        pthread_cond_wait(&gate->cond, &gate->lock);
+    }
+    pthread_mutex_unlock(&gate->lock);
+}
+
+uint64_t gate_release(struct start_gate *gate, int num_threads) {
+    pthread_mutex_lock(&gate->lock);
+    while (gate->waiting < num_threads) {
+        pthread_cond_wait(&gate->cond, &gate->lock);
+    }
+    uint64_t start = rioc_get_timestamp_ns();
+    gate->released = 1;
+    pthread_cond_broadcast(&gate->cond);
+    pthread_mutex_unlock(&gate->lock);
+    return start;
 }
 
 // Helper function to pin thread to CPU
@@ -628,9 +641,41 @@ static void *worker_thread(void *arg) {
 }
 
 int main(int argc, char *argv[]) {
+    // Alternative benchmark modes
+    if (argc > 1 && strcmp(argv[1], "--connect") == 0) {
+        return rioc_bench_connect_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--scan") == 0) {
+        return rioc_bench_scan_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--tail") == 0) {
+        return rioc_bench_tail_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--workload") == 0) {
+        return rioc_bench_workload_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--pool") == 0) {
+        return rioc_bench_pool_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--async") == 0) {
+        return rioc_bench_async_main(argc - 1, argv + 1);
+    }
+
     if (argc < 4) {
         fprintf(stderr, "Usage: %s <host> <port> <num_threads> [value_size] [num_ops] [verify] "
                 "[tls_cert_path] [tls_key_path] [tls_ca_path]\n", argv[0]);
+        fprintf(stderr, "       %s --connect <host> <port> <concurrency> [conns_per_thread] "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n", argv[0]);
+        fprintf(stderr, "       %s --scan <host> <port> [max_rows] [value_sizes] "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n", argv[0]);
+        fprintf(stderr, "       %s --tail <host> <port> [num_ops] [timeout_ms] [hedge_delay_us] "
+                "[value_size]\n", argv[0]);
+        fprintf(stderr, "       %s --workload <file> <host> <port> "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n", argv[0]);
+        fprintf(stderr, "       %s --pool <host> <port> [num_threads] [max_connections] "
+                "[ops_per_thread]\n", argv[0]);
+        fprintf(stderr, "       %s --async <host> <port> [num_threads] [ops_per_thread] "
+                "[latency_target_us] [max_linger_us]\n", argv[0]);
         return 1;
     }
 
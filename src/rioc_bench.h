@@ -0,0 +1,45 @@
+#ifndef RIOC_BENCH_H
+#define RIOC_BENCH_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "rioc.h"
+
+// Latency summary for one sample set (microseconds)
+struct thread_result {
+    double min_latency;
+    double max_latency;
+    double avg_latency;
+    double p50_latency;
+    double p95_latency;
+    double p99_latency;
+    double p999_latency;
+    uint64_t op_count;
+    uint64_t error_count;
+};
+
+// Sorts latencies in place and fills in the summary
+void calculate_stats(double *latencies, int count, struct thread_result *result);
+
+// Start gate so that every thread begins its measured phase at the same time
+struct start_gate {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int waiting;
+    int released;
+};
+
+void gate_wait(struct start_gate *gate);
+
+// Waits for num_threads threads to reach the gate, then releases them; returns the release time
+uint64_t gate_release(struct start_gate *gate, int num_threads);
+
+// Benchmark modes, selected by the first argument of rioc_bench
+int rioc_bench_connect_main(int argc, char *argv[]);
+int rioc_bench_scan_main(int argc, char *argv[]);
+int rioc_bench_tail_main(int argc, char *argv[]);
+int rioc_bench_workload_main(int argc, char *argv[]);
+int rioc_bench_pool_main(int argc, char *argv[]);
+int rioc_bench_async_main(int argc, char *argv[]);
+
+#endif // RIOC_BENCH_H
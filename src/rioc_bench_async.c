@@ -0,0 +1,264 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <inttypes.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+#include "rioc_bench.h"
+
+// Async batching benchmark: threads share one rioc_async and keep a few GETs and
+// INSERTs each in flight over a small key space. The same load runs with the default
+// flush-everything batching and with the adaptive controller, which sizes flushes and
+// lingers to stay under the latency target. The controller's final state is printed
+// so the batch size it settled on can be used where sizes are still picked by hand.
+
+#define ASYNC_MAX_THREADS 256
+#define ASYNC_KEYS 1024
+#define ASYNC_VALUE_SIZE 100
+#define ASYNC_DEPTH 8           // Ops each thread keeps in flight
+
+struct async_context;
+
+struct async_slot {
+    struct async_context *ctx;
+    uint64_t start_ns;
+};
+
+struct async_context {
+    struct rioc_async *async;
+    int thread_id;
+    int num_ops;
+    struct start_gate *gate;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int in_flight;
+    struct async_slot slots[ASYNC_DEPTH];
+    double *latencies;
+    uint64_t ok_count;
+    uint64_t error_count;
+    uint64_t end_time;
+};
+
+static void async_done(void *arg, int status, char *value, size_t value_len) {
+    (void)value_len;
+    struct async_slot *slot = arg;
+    struct async_context *ctx = slot->ctx;
+    uint64_t end_ns = rioc_get_timestamp_ns();
+    rioc_value_free(value);
+
+    pthread_mutex_lock(&ctx->lock);
+    if (status == RIOC_SUCCESS || status == RIOC_ERR_NOENT) {
+        ctx->latencies[ctx->ok_count++] = (double)(end_ns - slot->start_ns) / 1000.0;
+    } else {
+        ctx->error_count++;
+    }
+    ctx->in_flight--;
+    pthread_cond_signal(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static void *async_thread(void *arg) {
+    struct async_context *ctx = arg;
+    char key[32];
+    char value[ASYNC_VALUE_SIZE];
+    memset(value, 'a', sizeof(value));
+    unsigned int seed = (unsigned int)ctx->thread_id + 1;
+
+    gate_wait(ctx->gate);
+
+    // Each wave fills every slot, then waits for all of them to complete
+    for (int i = 0; i < ctx->num_ops; i += ASYNC_DEPTH) {
+        int n = ctx->num_ops - i < ASYNC_DEPTH ? ctx->num_ops - i : ASYNC_DEPTH;
+        pthread_mutex_lock(&ctx->lock);
+        ctx->in_flight = n;
+        pthread_mutex_unlock(&ctx->lock);
+
+        for (int j = 0; j < n; j++) {
+            struct async_slot *slot = &ctx->slots[j];
+            int key_len = snprintf(key, sizeof(key), "async_key_%d", rand_r(&seed) % ASYNC_KEYS);
+            slot->start_ns = rioc_get_timestamp_ns();
+            int ret = ((i + j) & 1) ?
+                rioc_async_get(ctx->async, key, key_len, async_done, slot) :
+                rioc_async_insert(ctx->async, key, key_len, value, sizeof(value),
+                                  rioc_get_timestamp_ns(), async_done, slot);
+            if (ret != RIOC_SUCCESS) {
+                pthread_mutex_lock(&ctx->lock);
+                ctx->error_count++;
+                ctx->in_flight--;
+                pthread_mutex_unlock(&ctx->lock);
+            }
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->in_flight > 0) {
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+        }
+        pthread_mutex_unlock(&ctx->lock);
+    }
+
+    ctx->end_time = rioc_get_timestamp_ns();
+    return NULL;
+}
+
+static int run_async(const char *label, rioc_client_config *config,
+                     const rioc_async_config *async_config, int num_threads, int num_ops) {
+    struct rioc_client *client = NULL;
+    int ret = rioc_client_connect_with_config(config, &client);
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to connect: %d\n", ret);
+        return 1;
+    }
+    struct rioc_async *async = async_config ? rioc_async_create_adaptive(client, async_config)
+                                            : rioc_async_create(client);
+    if (!async) {
+        fprintf(stderr, "Failed to create async client\n");
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+
+    struct async_context *contexts = calloc(num_threads, sizeof(struct async_context));
+    pthread_t *threads = calloc(num_threads, sizeof(pthread_t));
+    if (!contexts || !threads) {
+        fprintf(stderr, "Failed to allocate thread contexts\n");
+        free(contexts);
+        free(threads);
+        rioc_async_free(async);
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+
+    struct start_gate gate = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .cond = PTHREAD_COND_INITIALIZER,
+        .waiting = 0,
+        .released = 0
+    };
+
+    int threads_started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        struct async_context *ctx = &contexts[i];
+        ctx->async = async;
+        ctx->thread_id = i;
+        ctx->num_ops = num_ops;
+        ctx->gate = &gate;
+        pthread_mutex_init(&ctx->lock, NULL);
+        pthread_cond_init(&ctx->cond, NULL);
+        for (int j = 0; j < ASYNC_DEPTH; j++) {
+            ctx->slots[j].ctx = ctx;
+        }
+        ctx->latencies = malloc(sizeof(double) * num_ops);
+        if (!ctx->latencies) {
+            fprintf(stderr, "Failed to allocate sample arrays for thread %d\n", i);
+            break;
+        }
+        if (pthread_create(&threads[i], NULL, async_thread, ctx) != 0) {
+            fprintf(stderr, "Failed to create thread %d\n", i);
+            break;
+        }
+        threads_started++;
+    }
+
+    uint64_t start_time = gate_release(&gate, threads_started);
+
+    uint64_t end_time = start_time;
+    uint64_t total_ok = 0, total_errors = 0;
+    for (int i = 0; i < threads_started; i++) {
+        pthread_join(threads[i], NULL);
+        if (contexts[i].end_time > end_time) end_time = contexts[i].end_time;
+        total_ok += contexts[i].ok_count;
+        total_errors += contexts[i].error_count;
+    }
+
+    rioc_async_stats stats;
+    rioc_async_get_stats(async, &stats);
+
+    // Merge samples so percentiles are taken over every op, not per thread
+    double *all = malloc(sizeof(double) * (total_ok ? total_ok : 1));
+    size_t merged = 0;
+    for (int i = 0; i < threads_started && all; i++) {
+        memcpy(all + merged, contexts[i].latencies, contexts[i].ok_count * sizeof(double));
+        merged += contexts[i].ok_count;
+    }
+
+    double elapsed_ms = (double)(end_time - start_time) / 1000000.0;
+    printf("\nASYNC (%s) Performance:\n", label);
+    printf("  Operations:       %"PRIu64"\n", total_ok);
+    printf("  Errors:           %"PRIu64"\n", total_errors);
+    printf("  Throughput:       %.2f ops/sec\n",
+           elapsed_ms > 0 ? (double)total_ok * 1000.0 / elapsed_ms : 0.0);
+    printf("  Round trips:      %"PRIu64" (%.1f ops each)\n", stats.batches,
+           stats.batches ? (double)stats.ops / (double)stats.batches : 0.0);
+    printf("  Final target:     %"PRIu32" ops, %"PRIu32" us linger, %"PRIu64" us RTT\n",
+           stats.target_batch, stats.linger_us, stats.rtt_us);
+    printf("  Most in flight:   %"PRIu32" ops\n", stats.max_in_flight);
+    if (all && merged > 0) {
+        struct thread_result result;
+        calculate_stats(all, (int)merged, &result);
+        printf("  Latency (microseconds):\n");
+        printf("    Average:         %.3f\n", result.avg_latency);
+        printf("    P50 (median):    %.3f\n", result.p50_latency);
+        printf("    P99:             %.3f\n", result.p99_latency);
+        printf("    P99.9:           %.3f\n", result.p999_latency);
+    }
+
+    free(all);
+    for (int i = 0; i < num_threads; i++) {
+        free(contexts[i].latencies);
+        if (contexts[i].async) {
+            pthread_cond_destroy(&contexts[i].cond);
+            pthread_mutex_destroy(&contexts[i].lock);
+        }
+    }
+    free(contexts);
+    free(threads);
+    rioc_async_free(async);
+    rioc_client_disconnect_with_config(client);
+    return (threads_started == num_threads && total_errors == 0) ? 0 : 1;
+}
+
+int rioc_bench_async_main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: rioc_bench --async <host> <port> [num_threads] "
+                "[ops_per_thread] [latency_target_us] [max_linger_us]\n");
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    int num_threads = (argc > 3) ? atoi(argv[3]) : 16;
+    int num_ops = (argc > 4) ? atoi(argv[4]) : 20000;
+    int latency_target_us = (argc > 5) ? atoi(argv[5]) : 1000;
+    int max_linger_us = (argc > 6) ? atoi(argv[6]) : 200;
+
+    if (num_threads < 1 || num_threads > ASYNC_MAX_THREADS || num_ops < 1 ||
+        latency_target_us < 1 || max_linger_us < 0) {
+        fprintf(stderr, "Invalid parameters\n");
+        return 1;
+    }
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = 5000,
+        .tls = NULL
+    };
+    rioc_async_config async_config = {
+        .latency_target_us = (uint32_t)latency_target_us,
+        .max_batch = 0,
+        .max_linger_us = (uint32_t)max_linger_us
+    };
+
+    printf("\nAsync Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Threads:         %d (%d ops in flight each)\n", num_threads, ASYNC_DEPTH);
+    printf("  Ops/thread:      %d (50%% GET, 50%% INSERT over %d keys)\n", num_ops, ASYNC_KEYS);
+    printf("  Latency target:  %d us, linger up to %d us\n", latency_target_us, max_linger_us);
+
+    int failed = 0;
+    failed |= run_async("flush all queued", &config, NULL, num_threads, num_ops);
+    failed |= run_async("adaptive", &config, &async_config, num_threads, num_ops);
+    return failed;
+}
@@ -0,0 +1,319 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/resource.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+#include "rioc_bench.h"
+
+// Connection-storm benchmark: many threads are released at the same instant and each
+// opens conns_per_thread connections back to back, keeping them open until the phase
+// ends, the way a fleet of clients reconnects after a server restart or deploy.
+
+#define CONNECT_MAX_THREADS 4096
+#define CONNECT_THREAD_STACK (256 * 1024)
+#define CONNECT_PROBE_KEY "connect_bench_probe"
+
+enum connect_phase {
+    PHASE_PLAIN = 0,
+    PHASE_TLS_FULL = 1,
+    PHASE_TLS_RESUMED = 2
+};
+
+static const char *phase_names[] = {
+    "CONNECT (plain TCP)",
+    "CONNECT (TLS full handshake)",
+    "CONNECT (TLS resumed)"
+};
+
+struct connect_context {
+    int thread_id;
+    rioc_client_config *config;
+    int conns;
+    enum connect_phase phase;
+    struct start_gate *gate;
+    double *connect_latencies;   // Connect call duration (TCP + TLS handshake)
+    double *first_op_latencies;  // Connect start until the first GET completes
+    struct rioc_client **clients;
+    uint64_t ok_count;
+    uint64_t error_count;
+    uint64_t resumed_count;
+    uint64_t end_time;
+};
+
+// Opens one connection outside the measured window to obtain a resumable session
+static rioc_tls_session *prime_session(rioc_client_config *config) {
+    struct rioc_client *client = NULL;
+    if (rioc_client_connect_with_config(config, &client) != RIOC_SUCCESS) {
+        return NULL;
+    }
+
+    char *value = NULL;
+    size_t value_len = 0;
+    int ret = rioc_get(client, CONNECT_PROBE_KEY, strlen(CONNECT_PROBE_KEY), &value, &value_len);
+    if (ret == RIOC_SUCCESS) {
+        rioc_value_free(value);
+    }
+
+    rioc_tls_session *session = rioc_client_get_tls_session(client);
+    rioc_client_disconnect_with_config(client);
+    return session;
+}
+
+static void *connect_thread(void *arg) {
+    struct connect_context *ctx = (struct connect_context *)arg;
+    rioc_tls_session *session = NULL;
+
+    if (ctx->phase == PHASE_TLS_RESUMED) {
+        session = prime_session(ctx->config);
+        if (!session) {
+            fprintf(stderr, "Thread %d: No resumable TLS session, connects will do full handshakes\n",
+                    ctx->thread_id);
+        }
+    }
+
+    gate_wait(ctx->gate);
+
+    for (int i = 0; i < ctx->conns; i++) {
+        struct rioc_client *client = NULL;
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        int ret = rioc_client_connect_with_session(ctx->config, session, &client);
+        uint64_t connected_ns = rioc_get_timestamp_ns();
+        if (ret != RIOC_SUCCESS) {
+            ctx->error_count++;
+            continue;
+        }
+
+        // First op: a GET of an absent key is a full round trip, NOENT counts as success
+        char *value = NULL;
+        size_t value_len = 0;
+        ret = rioc_get(client, CONNECT_PROBE_KEY, strlen(CONNECT_PROBE_KEY), &value, &value_len);
+        uint64_t first_op_ns = rioc_get_timestamp_ns();
+        if (ret == RIOC_SUCCESS) {
+            rioc_value_free(value);
+        } else if (ret != RIOC_ERR_NOENT) {
+            ctx->error_count++;
+            rioc_client_disconnect_with_config(client);
+            continue;
+        }
+
+        ctx->connect_latencies[ctx->ok_count] = (double)(connected_ns - start_ns) / 1000.0;
+        ctx->first_op_latencies[ctx->ok_count] = (double)(first_op_ns - start_ns) / 1000.0;
+        ctx->clients[ctx->ok_count] = client;
+        ctx->ok_count++;
+
+        if (ctx->phase == PHASE_TLS_RESUMED) {
+            if (rioc_client_tls_session_reused(client)) {
+                ctx->resumed_count++;
+            }
+            // Chain to the newest ticket, as a reconnecting client would
+            rioc_tls_session *next = rioc_client_get_tls_session(client);
+            if (next) {
+                rioc_tls_session_free(session);
+                session = next;
+            }
+        }
+    }
+
+    ctx->end_time = rioc_get_timestamp_ns();
+    rioc_tls_session_free(session);
+    return NULL;
+}
+
+static void print_latency(const char *label, double *latencies, int count) {
+    struct thread_result result;
+    calculate_stats(latencies, count, &result);
+    printf("  %s (microseconds):\n", label);
+    printf("    Min:             %.3f\n", result.min_latency);
+    printf("    Max:             %.3f\n", result.max_latency);
+    printf("    Average:         %.3f\n", result.avg_latency);
+    printf("    P50 (median):    %.3f\n", result.p50_latency);
+    printf("    P95:             %.3f\n", result.p95_latency);
+    printf("    P99:             %.3f\n", result.p99_latency);
+}
+
+static int run_phase(enum connect_phase phase, rioc_client_config *config,
+                     int num_threads, int conns_per_thread) {
+    struct connect_context *contexts = calloc(num_threads, sizeof(struct connect_context));
+    pthread_t *threads = calloc(num_threads, sizeof(pthread_t));
+    if (!contexts || !threads) {
+        fprintf(stderr, "Failed to allocate thread contexts\n");
+        free(contexts);
+        free(threads);
+        return 1;
+    }
+
+    struct start_gate gate = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .cond = PTHREAD_COND_INITIALIZER,
+        .waiting = 0,
+        .released = 0
+    };
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, CONNECT_THREAD_STACK);
+
+    int threads_started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        struct connect_context *ctx = &contexts[i];
+        ctx->thread_id = i;
+        ctx->config = config;
+        ctx->conns = conns_per_thread;
+        ctx->phase = phase;
+        ctx->gate = &gate;
+        ctx->connect_latencies = malloc(sizeof(double) * conns_per_thread);
+        ctx->first_op_latencies = malloc(sizeof(double) * conns_per_thread);
+        ctx->clients = calloc(conns_per_thread, sizeof(struct rioc_client *));
+        if (!ctx->connect_latencies || !ctx->first_op_latencies || !ctx->clients) {
+            fprintf(stderr, "Failed to allocate sample arrays for thread %d\n", i);
+            break;
+        }
+        if (pthread_create(&threads[i], &attr, connect_thread, ctx) != 0) {
+            fprintf(stderr, "Failed to create thread %d\n", i);
+            break;
+        }
+        threads_started++;
+    }
+    pthread_attr_destroy(&attr);
+
+    uint64_t start_time = gate_release(&gate, threads_started);
+
+    uint64_t end_time = start_time;
+    uint64_t total_ok = 0, total_errors = 0, total_resumed = 0;
+    for (int i = 0; i < threads_started; i++) {
+        pthread_join(threads[i], NULL);
+        if (contexts[i].end_time > end_time) end_time = contexts[i].end_time;
+        total_ok += contexts[i].ok_count;
+        total_errors += contexts[i].error_count;
+        total_resumed += contexts[i].resumed_count;
+    }
+
+    // Merge samples so percentiles are taken over every connection, not per thread
+    double *connect_all = malloc(sizeof(double) * (total_ok ? total_ok : 1));
+    double *first_op_all = malloc(sizeof(double) * (total_ok ? total_ok : 1));
+    size_t merged = 0;
+    for (int i = 0; i < threads_started && connect_all && first_op_all; i++) {
+        memcpy(connect_all + merged, contexts[i].connect_latencies,
+               contexts[i].ok_count * sizeof(double));
+        memcpy(first_op_all + merged, contexts[i].first_op_latencies,
+               contexts[i].ok_count * sizeof(double));
+        merged += contexts[i].ok_count;
+    }
+
+    double elapsed_ms = (double)(end_time - start_time) / 1000000.0;
+    printf("\n%s Performance:\n", phase_names[phase]);
+    printf("  Connections:      %"PRIu64"\n", total_ok);
+    printf("  Failures:         %"PRIu64"\n", total_errors);
+    if (phase == PHASE_TLS_RESUMED) {
+        printf("  Resumed:          %"PRIu64"\n", total_resumed);
+    }
+    printf("  Storm duration:   %.3f ms\n", elapsed_ms);
+    printf("  Connections/sec:  %.2f\n", elapsed_ms > 0 ? (double)total_ok * 1000.0 / elapsed_ms : 0.0);
+    if (merged > 0) {
+        print_latency("Connect latency", connect_all, (int)merged);
+        print_latency("Time to first op", first_op_all, (int)merged);
+    }
+
+    // Connections were held open for the whole storm; release them now
+    for (int i = 0; i < num_threads; i++) {
+        for (uint64_t j = 0; contexts[i].clients && j < contexts[i].ok_count; j++) {
+            rioc_client_disconnect_with_config(contexts[i].clients[j]);
+        }
+        free(contexts[i].connect_latencies);
+        free(contexts[i].first_op_latencies);
+        free(contexts[i].clients);
+    }
+    free(connect_all);
+    free(first_op_all);
+    free(contexts);
+    free(threads);
+    return threads_started == num_threads ? 0 : 1;
+}
+
+// Every held connection needs a descriptor; lift the soft limit as far as allowed
+static void raise_fd_limit(uint64_t needed) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0 || rl.rlim_cur >= needed) {
+        return;
+    }
+    rl.rlim_cur = (rl.rlim_max == RLIM_INFINITY || rl.rlim_max >= needed) ? needed : rl.rlim_max;
+    if (setrlimit(RLIMIT_NOFILE, &rl) != 0 || rl.rlim_cur < needed) {
+        fprintf(stderr, "Warning: open file limit %llu is below %"PRIu64" connections\n",
+                (unsigned long long)rl.rlim_cur, needed);
+    }
+}
+
+int rioc_bench_connect_main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: rioc_bench --connect <host> <port> <concurrency> [conns_per_thread] "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n");
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    int num_threads = atoi(argv[3]);
+    int conns_per_thread = (argc > 4) ? atoi(argv[4]) : 1;
+    const char *tls_cert_path = (argc > 5) ? argv[5] : NULL;
+    const char *tls_key_path = (argc > 6) ? argv[6] : NULL;
+    const char *tls_ca_path = (argc > 7) ? argv[7] : NULL;
+
+    if (num_threads < 1 || num_threads > CONNECT_MAX_THREADS) {
+        fprintf(stderr, "Concurrency must be between 1 and %d\n", CONNECT_MAX_THREADS);
+        return 1;
+    }
+    if (conns_per_thread < 1) {
+        fprintf(stderr, "Connections per thread must be at least 1\n");
+        return 1;
+    }
+    if ((tls_cert_path && !tls_key_path) || (!tls_cert_path && tls_key_path)) {
+        fprintf(stderr, "Both TLS certificate and key paths must be provided for TLS mode\n");
+        return 1;
+    }
+
+    rioc_tls_config tls_config;
+    memset(&tls_config, 0, sizeof(tls_config));
+    tls_config.cert_path = tls_cert_path;
+    tls_config.key_path = tls_key_path;
+    tls_config.ca_path = tls_ca_path;
+    tls_config.verify_hostname = host;
+    tls_config.verify_peer = tls_ca_path != NULL;
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = 5000,
+        .tls = tls_cert_path ? &tls_config : NULL
+    };
+
+    uint64_t total_conns = (uint64_t)num_threads * conns_per_thread;
+    raise_fd_limit(total_conns + 64);
+
+    printf("\nConnection Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Concurrency:     %d threads\n", num_threads);
+    printf("  Conns/thread:    %d (held open until phase end)\n", conns_per_thread);
+    printf("  TLS:             %s\n", config.tls ? "enabled" : "disabled");
+    if (config.tls) {
+        printf("  Client cert:     %s\n", tls_cert_path);
+        printf("  CA cert:         %s\n", tls_ca_path ? tls_ca_path : "none");
+        printf("  Peer verify:     %s\n", tls_config.verify_peer ? "enabled" : "disabled");
+    }
+
+    if (!config.tls) {
+        return run_phase(PHASE_PLAIN, &config, num_threads, conns_per_thread);
+    }
+
+    int ret = run_phase(PHASE_TLS_FULL, &config, num_threads, conns_per_thread);
+    // Let the server reap the previous storm before the resumption pass
+    usleep(500000);
+    ret |= run_phase(PHASE_TLS_RESUMED, &config, num_threads, conns_per_thread);
+    return ret;
+}
@@ -0,0 +1,569 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+
+// Memory benchmark: creates clients, batches, trackers and range results in bulk and
+// reports the RSS, heap and allocation-count growth per object next to the figures the
+// library reports through rioc_*_memory_usage(). It is built as its own executable,
+// rioc_bench_memory, because it replaces the process's allocator; rioc_bench keeps the
+// plain one so its timings carry no counting.
+
+#define MEMORY_DEFAULT_OBJECTS 16
+#define MEMORY_MAX_OBJECTS 1024
+#define MEMORY_DEFAULT_VALUE_SIZE 1024
+#define MEMORY_DEFAULT_RANGE_ROWS 10000
+#define MEMORY_KEY_SIZE 64
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define MEMORY_TRACK_HEAP 1
+
+// glibc exports its allocator under these names, so the bench can wrap malloc and friends
+// for the whole process, OpenSSL included. Counting stays off until main() has parsed
+// its arguments.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static atomic_int heap_tracking;
+static atomic_llong heap_live;
+static atomic_llong heap_peak;
+static atomic_ullong heap_allocs;
+
+static void heap_track_alloc(void *ptr) {
+    if (!ptr || !atomic_load_explicit(&heap_tracking, memory_order_relaxed)) {
+        return;
+    }
+    long long size = (long long)malloc_usable_size(ptr);
+    long long live = atomic_fetch_add_explicit(&heap_live, size, memory_order_relaxed) + size;
+    atomic_fetch_add_explicit(&heap_allocs, 1, memory_order_relaxed);
+    long long peak = atomic_load_explicit(&heap_peak, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&heap_peak, &peak, live,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void heap_track_free(void *ptr) {
+    if (!ptr || !atomic_load_explicit(&heap_tracking, memory_order_relaxed)) {
+        return;
+    }
+    atomic_fetch_sub_explicit(&heap_live, (long long)malloc_usable_size(ptr), memory_order_relaxed);
+}
+
+void *malloc(size_t size) {
+    void *ptr = __libc_malloc(size);
+    heap_track_alloc(ptr);
+    return ptr;
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    void *ptr = __libc_calloc(nmemb, size);
+    heap_track_alloc(ptr);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+    size_t old_size = ptr ? malloc_usable_size(ptr) : 0;
+    void *new_ptr = __libc_realloc(ptr, size);
+    if (!new_ptr && size != 0) {
+        return NULL;  // Original block is untouched
+    }
+    if (ptr && atomic_load_explicit(&heap_tracking, memory_order_relaxed)) {
+        atomic_fetch_sub_explicit(&heap_live, (long long)old_size, memory_order_relaxed);
+    }
+    heap_track_alloc(new_ptr);
+    return new_ptr;
+}
+
+void free(void *ptr) {
+    heap_track_free(ptr);
+    __libc_free(ptr);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    void *ptr = __libc_memalign(alignment, size);
+    heap_track_alloc(ptr);
+    return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *ptr = memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *memptr = ptr;
+    return 0;
+}
+#else
+#define MEMORY_TRACK_HEAP 0
+#endif
+
+struct memory_snapshot {
+    long rss_kb;
+    long long heap_bytes;
+    uint64_t allocs;
+};
+
+static long read_rss_kb(void) {
+#ifdef __linux__
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f) {
+        long size = 0, resident = -1;
+        int n = fscanf(f, "%ld %ld", &size, &resident);
+        fclose(f);
+        if (n == 2) {
+            return resident * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+    }
+#endif
+    // Peak rather than current RSS; deltas are only meaningful while memory grows
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+// Takes a snapshot and restarts the peak heap watermark from the current level
+static void memory_snapshot(struct memory_snapshot *snap) {
+#if MEMORY_TRACK_HEAP
+    snap->heap_bytes = atomic_load(&heap_live);
+    snap->allocs = atomic_load(&heap_allocs);
+    atomic_store(&heap_peak, snap->heap_bytes);
+#else
+    snap->heap_bytes = 0;
+    snap->allocs = 0;
+#endif
+    snap->rss_kb = read_rss_kb();
+}
+
+static long long peak_heap_bytes(void) {
+#if MEMORY_TRACK_HEAP
+    return atomic_load(&heap_peak);
+#else
+    return 0;
+#endif
+}
+
+static void print_header(void) {
+    printf("  %-22s %7s %12s %12s %14s %10s %14s %14s\n", "Object", "Count", "RSS (KB)",
+           "Heap (KB)", "Peak heap (KB)", "Allocs", "Lib alloc (KB)", "Lib in use (KB)");
+}
+
+// Prints per-object growth between two snapshots; lib is NULL when the library has no figure
+static void print_row(const char *name, int count, const struct memory_snapshot *before,
+                      const struct memory_snapshot *after, long long peak,
+                      const rioc_memory_usage *lib) {
+    double n = count > 0 ? count : 1;
+    printf("  %-22s %7d %12.1f", name, count, (double)(after->rss_kb - before->rss_kb) / n);
+    if (MEMORY_TRACK_HEAP) {
+        printf(" %12.1f %14.1f %10.1f",
+               (double)(after->heap_bytes - before->heap_bytes) / 1024.0 / n,
+               (double)(peak - before->heap_bytes) / 1024.0 / n,
+               (double)(after->allocs - before->allocs) / n);
+    } else {
+        printf(" %12s %14s %10s", "n/a", "n/a", "n/a");
+    }
+    if (lib) {
+        printf(" %14.1f %14.1f\n", (double)lib->allocated / 1024.0 / n,
+               (double)lib->in_use / 1024.0 / n);
+    } else {
+        printf(" %14s %14s\n", "n/a", "n/a");
+    }
+}
+
+static void add_usage(rioc_memory_usage *total, const rioc_memory_usage *usage) {
+    total->allocated += usage->allocated;
+    total->in_use += usage->in_use;
+    total->allocations += usage->allocations;
+}
+
+// Runs one batch to completion and frees it
+static int run_batch(struct rioc_batch *batch) {
+    struct rioc_batch_tracker *tracker = rioc_batch_execute_async(batch);
+    if (!tracker) {
+        rioc_batch_free(batch);
+        return RIOC_ERR_IO;
+    }
+    int ret = rioc_batch_wait(tracker, 0);
+    rioc_batch_tracker_free(tracker);
+    rioc_batch_free(batch);
+    return ret;
+}
+
+// Inserts or deletes keys prefix:00000000 .. prefix:count-1
+static int load_keys(struct rioc_client *client, const char *prefix, const char *value,
+                     int value_size, int count, int remove) {
+    char key[MEMORY_KEY_SIZE];
+    uint64_t base_timestamp = rioc_get_timestamp_ns();
+    struct rioc_batch *batch = NULL;
+    int ret = RIOC_SUCCESS;
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        if (!batch && !(batch = rioc_batch_create(client))) {
+            return RIOC_ERR_MEM;
+        }
+        snprintf(key, sizeof(key), "%s:%08d", prefix, i);
+        if (remove) {
+            ret = rioc_batch_add_delete(batch, key, strlen(key), base_timestamp + i);
+        } else {
+            ret = rioc_batch_add_insert(batch, key, strlen(key), value, value_size, base_timestamp + i);
+        }
+        if (ret == RIOC_SUCCESS && (batch->count == RIOC_MAX_BATCH_SIZE || i == count - 1)) {
+            ret = run_batch(batch);
+            batch = NULL;
+            // Deleting keys left behind by an interrupted run is not an error
+            if (remove && ret == RIOC_ERR_NOENT) ret = RIOC_SUCCESS;
+        }
+    }
+    if (batch) {
+        rioc_batch_free(batch);
+    }
+    return ret;
+}
+
+static int measure_clients(rioc_client_config *config, int count, const char *name) {
+    struct rioc_client **clients = calloc(count, sizeof(*clients));
+    if (!clients) {
+        return RIOC_ERR_MEM;
+    }
+
+    struct memory_snapshot before, after;
+    rioc_memory_usage lib = {0};
+    int ret = RIOC_SUCCESS;
+    memory_snapshot(&before);
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        ret = rioc_client_connect_with_config(config, &clients[i]);
+    }
+    memory_snapshot(&after);
+
+    for (int i = 0; i < count; i++) {
+        rioc_memory_usage usage;
+        if (clients[i] && rioc_client_memory_usage(clients[i], &usage) == RIOC_SUCCESS) {
+            add_usage(&lib, &usage);
+        }
+    }
+    if (ret == RIOC_SUCCESS) {
+        print_row(name, count, &before, &after, peak_heap_bytes(), &lib);
+    } else {
+        fprintf(stderr, "Failed to connect %s (error code: %d)\n", name, ret);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (clients[i]) {
+            rioc_client_disconnect_with_config(clients[i]);
+        }
+    }
+    free(clients);
+    return ret;
+}
+
+static int measure_batches(struct rioc_client *client, int count, const char *value, int value_size) {
+    struct rioc_batch **batches = calloc(count, sizeof(*batches));
+    if (!batches) {
+        return RIOC_ERR_MEM;
+    }
+
+    struct memory_snapshot before, created, filled;
+    rioc_memory_usage lib = {0};
+    int ret = RIOC_SUCCESS;
+    memory_snapshot(&before);
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        if (!(batches[i] = rioc_batch_create(client))) {
+            ret = RIOC_ERR_MEM;
+        }
+    }
+    memory_snapshot(&created);
+    long long created_peak = peak_heap_bytes();
+
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        rioc_memory_usage usage;
+        rioc_batch_memory_usage(batches[i], &usage);
+        add_usage(&lib, &usage);
+    }
+    if (ret == RIOC_SUCCESS) {
+        print_row("batch (empty)", count, &before, &created, created_peak, &lib);
+    }
+
+    char key[MEMORY_KEY_SIZE];
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        for (int j = 0; j < RIOC_MAX_BATCH_SIZE && ret == RIOC_SUCCESS; j++) {
+            snprintf(key, sizeof(key), "mem:%08d", j);
+            ret = rioc_batch_add_insert(batches[i], key, strlen(key), value, value_size, 0);
+        }
+    }
+    memory_snapshot(&filled);
+
+    memset(&lib, 0, sizeof(lib));
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        rioc_memory_usage usage;
+        rioc_batch_memory_usage(batches[i], &usage);
+        add_usage(&lib, &usage);
+    }
+    if (ret == RIOC_SUCCESS) {
+        print_row("batch (128 inserts)", count, &before, &filled, peak_heap_bytes(), &lib);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (batches[i]) {
+            rioc_batch_free(batches[i]);
+        }
+    }
+    free(batches);
+    return ret;
+}
+
+// Executes count batches of 128 GETs (or one range each) and holds every tracker with its results
+static int measure_trackers(struct rioc_client *client, int count, int range_rows, const char *name) {
+    struct rioc_batch **batches = calloc(count, sizeof(*batches));
+    struct rioc_batch_tracker **trackers = calloc(count, sizeof(*trackers));
+    if (!batches || !trackers) {
+        free(batches);
+        free(trackers);
+        return RIOC_ERR_MEM;
+    }
+
+    char key[MEMORY_KEY_SIZE], end_key[MEMORY_KEY_SIZE];
+    int ret = RIOC_SUCCESS;
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        if (!(batches[i] = rioc_batch_create(client))) {
+            ret = RIOC_ERR_MEM;
+            break;
+        }
+        if (range_rows > 0) {
+            snprintf(key, sizeof(key), "mem:range:%08d", 0);
+            snprintf(end_key, sizeof(end_key), "mem:range:%08d", range_rows - 1);
+            ret = rioc_batch_add_range_query(batches[i], key, strlen(key), end_key, strlen(end_key));
+        } else {
+            for (int j = 0; j < RIOC_MAX_BATCH_SIZE && ret == RIOC_SUCCESS; j++) {
+                snprintf(key, sizeof(key), "mem:%08d", j);
+                ret = rioc_batch_add_get(batches[i], key, strlen(key));
+            }
+        }
+    }
+
+    struct memory_snapshot before, after;
+    rioc_memory_usage lib = {0};
+    memory_snapshot(&before);
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        trackers[i] = rioc_batch_execute_async(batches[i]);
+        if (!trackers[i]) {
+            ret = RIOC_ERR_IO;
+            break;
+        }
+        ret = rioc_batch_wait(trackers[i], 0);
+    }
+    memory_snapshot(&after);
+
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        rioc_memory_usage usage;
+        rioc_batch_tracker_memory_usage(trackers[i], &usage);
+        add_usage(&lib, &usage);
+    }
+    if (ret == RIOC_SUCCESS) {
+        print_row(name, count, &before, &after, peak_heap_bytes(), &lib);
+    } else {
+        fprintf(stderr, "Failed to measure %s (error code: %d)\n", name, ret);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (trackers[i]) rioc_batch_tracker_free(trackers[i]);
+        if (batches[i]) rioc_batch_free(batches[i]);
+    }
+    free(trackers);
+    free(batches);
+    return ret;
+}
+
+static int measure_range_query(struct rioc_client *client, int range_rows) {
+    char start_key[MEMORY_KEY_SIZE], end_key[MEMORY_KEY_SIZE];
+    snprintf(start_key, sizeof(start_key), "mem:range:%08d", 0);
+    snprintf(end_key, sizeof(end_key), "mem:range:%08d", range_rows - 1);
+
+    struct memory_snapshot before, after;
+    struct rioc_range_result *results = NULL;
+    size_t result_count = 0;
+    memory_snapshot(&before);
+    int ret = rioc_range_query(client, start_key, strlen(start_key), end_key, strlen(end_key),
+                               &results, &result_count);
+    memory_snapshot(&after);
+
+    if (ret == RIOC_SUCCESS) {
+        // Caller-owned, so the library has no figure for it
+        print_row("range_query results", 1, &before, &after, peak_heap_bytes(), NULL);
+        rioc_free_range_results(results, result_count);
+    } else {
+        fprintf(stderr, "Failed to measure range_query results (error code: %d)\n", ret);
+    }
+    return ret;
+}
+
+// Repeats the range query with the built-in size-class allocator installed. The library
+// figures show what size classes cost over the requested bytes while the rows are held,
+// and what the allocator keeps cached for reuse once they are freed.
+static int measure_size_class_values(struct rioc_client *client, int range_rows) {
+    char start_key[MEMORY_KEY_SIZE], end_key[MEMORY_KEY_SIZE];
+    snprintf(start_key, sizeof(start_key), "mem:range:%08d", 0);
+    snprintf(end_key, sizeof(end_key), "mem:range:%08d", range_rows - 1);
+
+    // Every value from the earlier workloads has been freed, so the allocator can change
+    int ret = rioc_set_allocator(rioc_size_class_allocator());
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+
+    struct memory_snapshot before, after;
+    struct rioc_range_result *results = NULL;
+    size_t result_count = 0;
+    rioc_memory_usage held = {0}, kept = {0};
+    memory_snapshot(&before);
+    ret = rioc_range_query(client, start_key, strlen(start_key), end_key, strlen(end_key),
+                           &results, &result_count);
+    memory_snapshot(&after);
+
+    if (ret == RIOC_SUCCESS) {
+        rioc_value_memory_usage(&held);
+        print_row("range rows, size-class", 1, &before, &after, peak_heap_bytes(), &held);
+        rioc_free_range_results(results, result_count);
+        rioc_value_memory_usage(&kept);
+        printf("  %-22s %7zu values, %.1f%% of allocated KB not requested; %.1f KB cached after free\n",
+               "", held.allocations,
+               held.allocated ? 100.0 * (double)(held.allocated - held.in_use) / (double)held.allocated : 0.0,
+               (double)kept.allocated / 1024.0);
+    } else {
+        fprintf(stderr, "Failed to measure size-class range rows (error code: %d)\n", ret);
+    }
+
+    rioc_set_allocator(NULL);
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <host> <port> [objects] [value_size] [range_rows] "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n", argv[0]);
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    int objects = (argc > 3) ? atoi(argv[3]) : MEMORY_DEFAULT_OBJECTS;
+    int value_size = (argc > 4) ? atoi(argv[4]) : MEMORY_DEFAULT_VALUE_SIZE;
+    int range_rows = (argc > 5) ? atoi(argv[5]) : MEMORY_DEFAULT_RANGE_ROWS;
+    const char *tls_cert_path = (argc > 6) ? argv[6] : NULL;
+    const char *tls_key_path = (argc > 7) ? argv[7] : NULL;
+    const char *tls_ca_path = (argc > 8) ? argv[8] : NULL;
+
+    if (objects <= 0 || objects > MEMORY_MAX_OBJECTS) {
+        fprintf(stderr, "objects must be between 1 and %d\n", MEMORY_MAX_OBJECTS);
+        return 1;
+    }
+    if (value_size <= 0 || value_size > RIOC_MAX_VALUE_SIZE) {
+        fprintf(stderr, "value_size must be between 1 and %d\n", RIOC_MAX_VALUE_SIZE);
+        return 1;
+    }
+    if (range_rows <= 0) {
+        fprintf(stderr, "range_rows must be positive\n");
+        return 1;
+    }
+    if ((tls_cert_path && !tls_key_path) || (!tls_cert_path && tls_key_path)) {
+        fprintf(stderr, "Both TLS certificate and key paths must be provided for TLS mode\n");
+        return 1;
+    }
+
+    rioc_tls_config tls_config;
+    memset(&tls_config, 0, sizeof(tls_config));
+    tls_config.cert_path = tls_cert_path;
+    tls_config.key_path = tls_key_path;
+    tls_config.ca_path = tls_ca_path;
+    tls_config.verify_hostname = host;
+    tls_config.verify_peer = tls_ca_path != NULL;
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = 5000,
+        .tls = tls_cert_path ? &tls_config : NULL
+    };
+
+#if MEMORY_TRACK_HEAP
+    atomic_store(&heap_tracking, 1);
+#endif
+
+    struct rioc_client *client = NULL;
+    int ret = rioc_client_connect_with_config(&config, &client);
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to connect to %s:%d (error code: %d)\n", host, port, ret);
+        return 1;
+    }
+
+    char *value = malloc(value_size);
+    if (!value) {
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+    memset(value, 'M', value_size);
+
+    printf("\nMemory Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Objects:         %d per workload\n", objects);
+    printf("  Value size:      %d bytes\n", value_size);
+    printf("  Range rows:      %d\n", range_rows);
+    printf("  TLS:             %s\n", config.tls ? "enabled" : "disabled");
+    printf("  Heap tracking:   %s\n", MEMORY_TRACK_HEAP ? "enabled" : "unavailable (requires glibc)");
+
+    printf("\nLoading keys...\n");
+    int failed = 0;
+    ret = load_keys(client, "mem", value, value_size, RIOC_MAX_BATCH_SIZE, 0);
+    if (ret == RIOC_SUCCESS) {
+        ret = load_keys(client, "mem:range", value, value_size, range_rows, 0);
+    }
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to load keys (error code: %d)\n", ret);
+        failed = 1;
+    }
+
+    if (!failed) {
+        printf("\nMemory Per Object (growth while the objects are held):\n");
+        print_header();
+        // Failures are reported per row; the remaining workloads still run
+        failed |= measure_clients(&config, objects, config.tls ? "client (TLS)" : "client") != RIOC_SUCCESS;
+        failed |= measure_batches(client, objects, value, value_size) != RIOC_SUCCESS;
+        failed |= measure_trackers(client, objects, 0, "tracker (128 GETs)") != RIOC_SUCCESS;
+        failed |= measure_trackers(client, 1, range_rows, "tracker (range)") != RIOC_SUCCESS;
+        failed |= measure_range_query(client, range_rows) != RIOC_SUCCESS;
+        failed |= measure_size_class_values(client, range_rows) != RIOC_SUCCESS;
+
+        printf("\n  RSS counts touched pages only; a batch reserves room for %d values of %d bytes\n",
+               RIOC_MAX_BATCH_SIZE, RIOC_MAX_VALUE_SIZE);
+        printf("  but faults in only what it stores. Heap and allocation counts cover every\n");
+        printf("  allocator call in the process, OpenSSL included; library figures do not.\n");
+    }
+
+    load_keys(client, "mem", NULL, 0, RIOC_MAX_BATCH_SIZE, 1);
+    load_keys(client, "mem:range", NULL, 0, range_rows, 1);
+
+    free(value);
+    rioc_client_disconnect_with_config(client);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,211 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <inttypes.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+#include "rioc_bench.h"
+
+// Connection pool benchmark: threads share one pool and run a 50/50 GET/INSERT mix
+// over a small key space. The same load runs on a one-connection pool, where every
+// thread queues behind the others, a fixed pool of max_connections, and a pool that
+// starts at one connection and grows with the measured contention.
+
+#define POOL_MAX_THREADS 256
+#define POOL_KEYS 1024
+#define POOL_VALUE_SIZE 100
+#define POOL_HEALTH_MS 50
+
+struct pool_context {
+    struct rioc_pool *pool;
+    int thread_id;
+    int num_ops;
+    struct start_gate *gate;
+    double *latencies;
+    uint64_t ok_count;
+    uint64_t error_count;
+    uint64_t end_time;
+};
+
+static void *pool_thread(void *arg) {
+    struct pool_context *ctx = arg;
+    char key[32];
+    char value[POOL_VALUE_SIZE];
+    memset(value, 'p', sizeof(value));
+    unsigned int seed = (unsigned int)ctx->thread_id + 1;
+
+    gate_wait(ctx->gate);
+
+    for (int i = 0; i < ctx->num_ops; i++) {
+        int key_len = snprintf(key, sizeof(key), "pool_key_%d", rand_r(&seed) % POOL_KEYS);
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        int ret;
+        if (i & 1) {
+            char *out = NULL;
+            size_t out_len = 0;
+            ret = rioc_pool_get(ctx->pool, key, key_len, &out, &out_len);
+            if (ret == RIOC_SUCCESS) {
+                rioc_value_free(out);
+            } else if (ret == RIOC_ERR_NOENT) {
+                ret = RIOC_SUCCESS;
+            }
+        } else {
+            ret = rioc_pool_insert(ctx->pool, key, key_len, value, sizeof(value),
+                                   rioc_get_timestamp_ns());
+        }
+        uint64_t end_ns = rioc_get_timestamp_ns();
+        if (ret != RIOC_SUCCESS) {
+            ctx->error_count++;
+            continue;
+        }
+        ctx->latencies[ctx->ok_count++] = (double)(end_ns - start_ns) / 1000.0;
+    }
+
+    ctx->end_time = rioc_get_timestamp_ns();
+    return NULL;
+}
+
+static int run_pool(const char *label, rioc_client_config *config, uint32_t connections,
+                    uint32_t max_connections, int num_threads, int num_ops) {
+    rioc_pool_config pool_config = {
+        .client = config,
+        .connections = connections,
+        .max_connections = max_connections,
+        .health_check_ms = POOL_HEALTH_MS
+    };
+    struct rioc_pool *pool = NULL;
+    int ret = rioc_pool_create(&pool_config, &pool);
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to create pool: %d\n", ret);
+        return 1;
+    }
+
+    struct pool_context *contexts = calloc(num_threads, sizeof(struct pool_context));
+    pthread_t *threads = calloc(num_threads, sizeof(pthread_t));
+    if (!contexts || !threads) {
+        fprintf(stderr, "Failed to allocate thread contexts\n");
+        free(contexts);
+        free(threads);
+        rioc_pool_free(pool);
+        return 1;
+    }
+
+    struct start_gate gate = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .cond = PTHREAD_COND_INITIALIZER,
+        .waiting = 0,
+        .released = 0
+    };
+
+    int threads_started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        struct pool_context *ctx = &contexts[i];
+        ctx->pool = pool;
+        ctx->thread_id = i;
+        ctx->num_ops = num_ops;
+        ctx->gate = &gate;
+        ctx->latencies = malloc(sizeof(double) * num_ops);
+        if (!ctx->latencies) {
+            fprintf(stderr, "Failed to allocate sample arrays for thread %d\n", i);
+            break;
+        }
+        if (pthread_create(&threads[i], NULL, pool_thread, ctx) != 0) {
+            fprintf(stderr, "Failed to create thread %d\n", i);
+            break;
+        }
+        threads_started++;
+    }
+
+    uint64_t start_time = gate_release(&gate, threads_started);
+
+    uint64_t end_time = start_time;
+    uint64_t total_ok = 0, total_errors = 0;
+    for (int i = 0; i < threads_started; i++) {
+        pthread_join(threads[i], NULL);
+        if (contexts[i].end_time > end_time) end_time = contexts[i].end_time;
+        total_ok += contexts[i].ok_count;
+        total_errors += contexts[i].error_count;
+    }
+
+    rioc_pool_stats stats;
+    rioc_pool_get_stats(pool, &stats);
+
+    // Merge samples so percentiles are taken over every op, not per thread
+    double *all = malloc(sizeof(double) * (total_ok ? total_ok : 1));
+    size_t merged = 0;
+    for (int i = 0; i < threads_started && all; i++) {
+        memcpy(all + merged, contexts[i].latencies, contexts[i].ok_count * sizeof(double));
+        merged += contexts[i].ok_count;
+    }
+
+    double elapsed_ms = (double)(end_time - start_time) / 1000000.0;
+    printf("\nPOOL (%s) Performance:\n", label);
+    printf("  Operations:       %"PRIu64"\n", total_ok);
+    printf("  Errors:           %"PRIu64"\n", total_errors);
+    printf("  Throughput:       %.2f ops/sec\n",
+           elapsed_ms > 0 ? (double)total_ok * 1000.0 / elapsed_ms : 0.0);
+    printf("  Connections:      %"PRIu32" at end (%"PRIu64" grows, %"PRIu64" shrinks)\n",
+           stats.connections, stats.grows, stats.shrinks);
+    printf("  Waited:           %.2f%% of ops\n",
+           stats.ops ? 100.0 * (double)stats.waits / (double)stats.ops : 0.0);
+    if (all && merged > 0) {
+        struct thread_result result;
+        calculate_stats(all, (int)merged, &result);
+        printf("  Latency (microseconds):\n");
+        printf("    Average:         %.3f\n", result.avg_latency);
+        printf("    P50 (median):    %.3f\n", result.p50_latency);
+        printf("    P99:             %.3f\n", result.p99_latency);
+        printf("    P99.9:           %.3f\n", result.p999_latency);
+    }
+
+    free(all);
+    for (int i = 0; i < num_threads; i++) {
+        free(contexts[i].latencies);
+    }
+    free(contexts);
+    free(threads);
+    rioc_pool_free(pool);
+    return (threads_started == num_threads && total_errors == 0) ? 0 : 1;
+}
+
+int rioc_bench_pool_main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: rioc_bench --pool <host> <port> [num_threads] "
+                "[max_connections] [ops_per_thread]\n");
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    int num_threads = (argc > 3) ? atoi(argv[3]) : 16;
+    int max_connections = (argc > 4) ? atoi(argv[4]) : 8;
+    int num_ops = (argc > 5) ? atoi(argv[5]) : 20000;
+
+    if (num_threads < 1 || num_threads > POOL_MAX_THREADS ||
+        max_connections < 1 || num_ops < 1) {
+        fprintf(stderr, "Invalid parameters\n");
+        return 1;
+    }
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = 5000,
+        .tls = NULL
+    };
+
+    printf("\nPool Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Threads:         %d\n", num_threads);
+    printf("  Max connections: %d\n", max_connections);
+    printf("  Ops/thread:      %d (50%% GET, 50%% INSERT over %d keys)\n", num_ops, POOL_KEYS);
+
+    int failed = 0;
+    failed |= run_pool("1 connection", &config, 1, 0, num_threads, num_ops);
+    failed |= run_pool("fixed", &config, (uint32_t)max_connections, 0, num_threads, num_ops);
+    failed |= run_pool("autosized", &config, 1, (uint32_t)max_connections, num_threads, num_ops);
+    return failed;
+}
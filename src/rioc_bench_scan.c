@@ -0,0 +1,360 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/resource.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+#include "rioc_bench.h"
+
+// Scan benchmark: loads max_rows keys per value size, then times range queries whose
+// result size sweeps by powers of ten, through rioc_range_query, the batch range path
+// and a streaming range cursor.
+
+#define SCAN_DEFAULT_MAX_ROWS 1000000
+#define SCAN_MIN_ROWS 10
+#define SCAN_MAX_VALUE_SIZES 16
+#define SCAN_KEY_SIZE 64
+
+enum scan_api {
+    SCAN_API_RANGE_QUERY = 0,
+    SCAN_API_BATCH = 1,
+    SCAN_API_CURSOR = 2,
+    SCAN_API_COUNT = 3
+};
+
+static const char *scan_api_names[] = {"range_query", "batch_range", "cursor"};
+
+struct scan_sample {
+    uint64_t rows;
+    uint64_t bytes;
+    uint64_t elapsed_ns;
+    uint64_t first_row_ns;
+    long peak_rss_kb;
+    int errors;
+};
+
+static void scan_key(char *buf, size_t size, int value_size, uint64_t index) {
+    snprintf(buf, size, "scan:%d:%08"PRIu64, value_size, index);
+}
+
+// Resets the kernel's peak RSS watermark so the next reading covers only one query
+static int reset_peak_rss(void) {
+#ifdef __linux__
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (f) {
+        int ok = fputs("5", f) >= 0;
+        ok &= fclose(f) == 0;
+        return ok;
+    }
+#endif
+    return 0;
+}
+
+// Peak RSS in KB: VmHWM when it can be reset per query, otherwise the process maximum
+static long read_peak_rss_kb(void) {
+#ifdef __linux__
+    FILE *f = fopen("/proc/self/status", "r");
+    if (f) {
+        char line[256];
+        long kb = -1;
+        while (fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) {
+                break;
+            }
+        }
+        fclose(f);
+        if (kb >= 0) {
+            return kb;
+        }
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+// Runs a batch of operations and waits for completion; the batch is reset for reuse
+static int execute_batch(struct rioc_client *client, struct rioc_batch **batch) {
+    struct rioc_batch_tracker *tracker = rioc_batch_execute_async(*batch);
+    if (!tracker) {
+        return RIOC_ERR_IO;
+    }
+    int ret = rioc_batch_wait(tracker, 0);
+    rioc_batch_tracker_free(tracker);
+    rioc_batch_free(*batch);
+    *batch = rioc_batch_create(client);
+    if (!*batch) {
+        return RIOC_ERR_MEM;
+    }
+    return ret;
+}
+
+static int load_keys(struct rioc_client *client, int value_size, uint64_t count, int remove) {
+    char *value = malloc(value_size);
+    struct rioc_batch *batch = rioc_batch_create(client);
+    if (!value || !batch) {
+        free(value);
+        if (batch) rioc_batch_free(batch);
+        return RIOC_ERR_MEM;
+    }
+    memset(value, 'S', value_size);
+
+    char key[SCAN_KEY_SIZE];
+    uint64_t base_timestamp = rioc_get_timestamp_ns();
+    int ret = RIOC_SUCCESS;
+    for (uint64_t i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        scan_key(key, sizeof(key), value_size, i);
+        if (remove) {
+            ret = rioc_batch_add_delete(batch, key, strlen(key), base_timestamp + i);
+        } else {
+            ret = rioc_batch_add_insert(batch, key, strlen(key), value, value_size, base_timestamp + i);
+        }
+        if (ret == RIOC_SUCCESS && (batch->count == RIOC_MAX_BATCH_SIZE || i == count - 1)) {
+            ret = execute_batch(client, &batch);
+        }
+        if (!remove && i > 0 && i % 100000 == 0) {
+            printf("  Loaded %"PRIu64" rows\n", i);
+        }
+    }
+
+    if (batch) rioc_batch_free(batch);
+    free(value);
+    return ret;
+}
+
+static void sum_results(struct rioc_range_result *results, size_t count, struct scan_sample *sample) {
+    sample->rows = count;
+    sample->bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        sample->bytes += results[i].key_len + results[i].value_len;
+    }
+}
+
+static int scan_once(struct rioc_client *client, enum scan_api api, const char *start_key,
+                     const char *end_key, struct scan_sample *sample) {
+    struct rioc_range_result *results = NULL;
+    size_t count = 0;
+    int ret;
+
+    memset(sample, 0, sizeof(*sample));
+    int hwm_reset = reset_peak_rss();
+    long rss_before = read_peak_rss_kb();
+
+    if (api == SCAN_API_RANGE_QUERY) {
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        ret = rioc_range_query(client, start_key, strlen(start_key), end_key, strlen(end_key),
+                               &results, &count);
+        sample->elapsed_ns = rioc_get_timestamp_ns() - start_ns;
+        if (ret == RIOC_SUCCESS) {
+            sum_results(results, count, sample);
+            rioc_free_range_results(results, count);
+        }
+        // Every row is materialized before the call returns, so the first row is
+        // only observable to the caller when the whole result is
+        sample->first_row_ns = sample->elapsed_ns;
+    } else if (api == SCAN_API_CURSOR) {
+        struct rioc_range_cursor *cursor = NULL;
+        struct rioc_range_result row;
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        ret = rioc_range_cursor_open(client, start_key, strlen(start_key), end_key, strlen(end_key),
+                                     &cursor);
+        while (ret == RIOC_SUCCESS && (ret = rioc_range_cursor_next(cursor, &row)) == RIOC_SUCCESS) {
+            if (sample->rows++ == 0) {
+                sample->first_row_ns = rioc_get_timestamp_ns() - start_ns;
+            }
+            sample->bytes += row.key_len + row.value_len;
+        }
+        if (ret == RIOC_ERR_NOENT) {
+            ret = RIOC_SUCCESS;
+        }
+        if (cursor) {
+            int close_ret = rioc_range_cursor_close(cursor);
+            if (ret == RIOC_SUCCESS) ret = close_ret;
+        }
+        sample->elapsed_ns = rioc_get_timestamp_ns() - start_ns;
+    } else {
+        struct rioc_batch *batch = rioc_batch_create(client);
+        if (!batch) {
+            return RIOC_ERR_MEM;
+        }
+        ret = rioc_batch_add_range_query(batch, start_key, strlen(start_key), end_key, strlen(end_key));
+        if (ret != RIOC_SUCCESS) {
+            rioc_batch_free(batch);
+            return ret;
+        }
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        struct rioc_batch_tracker *tracker = rioc_batch_execute_async(batch);
+        ret = tracker ? rioc_batch_wait(tracker, 0) : RIOC_ERR_IO;
+        sample->elapsed_ns = rioc_get_timestamp_ns() - start_ns;
+        if (ret == RIOC_SUCCESS) {
+            struct rioc_batch_op *op = &batch->ops[0];
+            ret = op->response.status;
+            if (ret == RIOC_SUCCESS && op->value_ptr) {
+                sum_results((struct rioc_range_result *)op->value_ptr, op->response.value_len, sample);
+            }
+        }
+        if (tracker) rioc_batch_tracker_free(tracker);
+        rioc_batch_free(batch);
+        sample->first_row_ns = sample->elapsed_ns;
+    }
+
+    long rss_after = read_peak_rss_kb();
+    sample->peak_rss_kb = hwm_reset ? rss_after : (rss_after > rss_before ? rss_after : rss_before);
+    return ret;
+}
+
+static int parse_value_sizes(const char *arg, int *sizes) {
+    int count = 0;
+    char *copy = strdup(arg);
+    char *saveptr = NULL;
+    for (char *tok = strtok_r(copy, ",", &saveptr); tok && count < SCAN_MAX_VALUE_SIZES;
+         tok = strtok_r(NULL, ",", &saveptr)) {
+        int size = atoi(tok);
+        if (size < 1 || size > RIOC_MAX_VALUE_SIZE) {
+            fprintf(stderr, "Value size %s out of range (1..%d)\n", tok, RIOC_MAX_VALUE_SIZE);
+            free(copy);
+            return -1;
+        }
+        sizes[count++] = size;
+    }
+    free(copy);
+    return count;
+}
+
+int rioc_bench_scan_main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: rioc_bench --scan <host> <port> [max_rows] [value_sizes] "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n");
+        fprintf(stderr, "  value_sizes is a comma-separated list, e.g. 16,1024,16384\n");
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    uint64_t max_rows = (argc > 3) ? strtoull(argv[3], NULL, 10) : SCAN_DEFAULT_MAX_ROWS;
+    const char *value_sizes_arg = (argc > 4) ? argv[4] : "100,4096";
+    const char *tls_cert_path = (argc > 5) ? argv[5] : NULL;
+    const char *tls_key_path = (argc > 6) ? argv[6] : NULL;
+    const char *tls_ca_path = (argc > 7) ? argv[7] : NULL;
+
+    if (max_rows < SCAN_MIN_ROWS || max_rows > UINT32_MAX) {
+        fprintf(stderr, "max_rows must be between %d and %u\n", SCAN_MIN_ROWS, UINT32_MAX);
+        return 1;
+    }
+    int value_sizes[SCAN_MAX_VALUE_SIZES];
+    int num_value_sizes = parse_value_sizes(value_sizes_arg, value_sizes);
+    if (num_value_sizes <= 0) {
+        return 1;
+    }
+    if ((tls_cert_path && !tls_key_path) || (!tls_cert_path && tls_key_path)) {
+        fprintf(stderr, "Both TLS certificate and key paths must be provided for TLS mode\n");
+        return 1;
+    }
+
+    rioc_tls_config tls_config;
+    memset(&tls_config, 0, sizeof(tls_config));
+    tls_config.cert_path = tls_cert_path;
+    tls_config.key_path = tls_key_path;
+    tls_config.ca_path = tls_ca_path;
+    tls_config.verify_hostname = host;
+    tls_config.verify_peer = tls_ca_path != NULL;
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = 5000,
+        .tls = tls_cert_path ? &tls_config : NULL
+    };
+
+    struct rioc_client *client = NULL;
+    int ret = rioc_client_connect_with_config(&config, &client);
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to connect to %s:%d (error code: %d)\n", host, port, ret);
+        return 1;
+    }
+
+    printf("\nScan Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Max rows:        %"PRIu64"\n", max_rows);
+    printf("  Value sizes:     %s bytes\n", value_sizes_arg);
+    printf("  TLS:             %s\n", config.tls ? "enabled" : "disabled");
+    printf("  TTFR:            time to first row; equals total time except for the cursor\n");
+
+    int failed = 0;
+    for (int v = 0; v < num_value_sizes; v++) {
+        int value_size = value_sizes[v];
+        printf("\nLoading %"PRIu64" rows of %d bytes...\n", max_rows, value_size);
+        ret = load_keys(client, value_size, max_rows, 0);
+        if (ret != RIOC_SUCCESS && ret != -EEXIST) {
+            fprintf(stderr, "Failed to load scan keys (error code: %d)\n", ret);
+            failed = 1;
+            break;
+        }
+
+        printf("\nSCAN Performance (value size %d bytes):\n", value_size);
+        printf("  %-12s %10s %12s %14s %10s %12s %14s %7s\n", "API", "Rows", "Time (ms)",
+               "Rows/sec", "MB/sec", "TTFR (ms)", "Peak RSS (MB)", "Errors");
+
+        char start_key[SCAN_KEY_SIZE], end_key[SCAN_KEY_SIZE];
+        scan_key(start_key, sizeof(start_key), value_size, 0);
+        for (uint64_t rows = SCAN_MIN_ROWS; rows <= max_rows; rows *= 10) {
+            scan_key(end_key, sizeof(end_key), value_size, rows - 1);
+            // Repeat small scans so each data point covers a measurable interval
+            int iterations = rows <= 1000 ? 20 : (rows <= 100000 ? 3 : 1);
+
+            for (int api = 0; api < SCAN_API_COUNT; api++) {
+                uint64_t total_rows = 0, total_bytes = 0, total_ns = 0, first_row_ns = 0;
+                long peak_rss_kb = 0;
+                int errors = 0, samples = 0;
+                for (int it = 0; it < iterations; it++) {
+                    struct scan_sample sample;
+                    ret = scan_once(client, api, start_key, end_key, &sample);
+                    if (ret != RIOC_SUCCESS || sample.rows != rows) {
+                        errors++;
+                        if (ret == RIOC_ERR_IO) break;  // Connection state is unknown
+                        continue;
+                    }
+                    total_rows += sample.rows;
+                    total_bytes += sample.bytes;
+                    total_ns += sample.elapsed_ns;
+                    first_row_ns += sample.first_row_ns;
+                    if (sample.peak_rss_kb > peak_rss_kb) peak_rss_kb = sample.peak_rss_kb;
+                    samples++;
+                }
+
+                double seconds = (double)total_ns / 1000000000.0;
+                printf("  %-12s %10"PRIu64" %12.3f %14.2f %10.2f %12.3f %14.2f %7d\n",
+                       scan_api_names[api], rows,
+                       samples > 0 ? (double)total_ns / samples / 1000000.0 : 0.0,
+                       seconds > 0 ? (double)total_rows / seconds : 0.0,
+                       seconds > 0 ? (double)total_bytes / (1024.0 * 1024.0) / seconds : 0.0,
+                       samples > 0 ? (double)first_row_ns / samples / 1000000.0 : 0.0,
+                       (double)peak_rss_kb / 1024.0, errors);
+                if (ret == RIOC_ERR_IO) {
+                    fprintf(stderr, "Connection failed during scan, stopping\n");
+                    failed = 1;
+                    break;
+                }
+            }
+            if (failed) break;
+        }
+        if (failed) break;
+
+        ret = load_keys(client, value_size, max_rows, 1);
+        if (ret != RIOC_SUCCESS) {
+            fprintf(stderr, "Warning: failed to remove scan keys (error code: %d)\n", ret);
+        }
+    }
+
+    rioc_client_disconnect_with_config(client);
+    return failed;
+}
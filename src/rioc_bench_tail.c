@@ -0,0 +1,466 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/socket.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+#include "rioc_bench.h"
+
+// Tail-latency scenarios, meant to run through rioc_netem so that latency, jitter,
+// head-of-line blocking and resets are present. Each scenario issues num_ops GETs
+// against a preloaded key set and reports the latency each caller observed.
+
+#define TAIL_KEYS 1024
+#define TAIL_HEDGE_CONNS 4
+#define TAIL_POLL_NS 20000  // Completion polling interval for hedged requests
+
+struct tail_report {
+    const char *name;
+    double *latencies;   // Per-op latency seen by the caller (microseconds)
+    int count;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t reconnects;
+    uint64_t hedges;
+    uint64_t hedge_wins;
+    uint64_t elapsed_ns;
+};
+
+// One connection with at most one request in flight
+struct tail_conn {
+    struct rioc_client *client;
+    struct rioc_batch *batch;
+    struct rioc_batch_tracker *tracker;
+};
+
+static rioc_client_config *tail_config;
+
+static void tail_key(char *buf, size_t size, int index) {
+    snprintf(buf, size, "tail_key_%d", index);
+}
+
+static int tail_reconnect(struct rioc_client **client, struct tail_report *report) {
+    if (*client) {
+        rioc_client_disconnect_with_config(*client);
+        *client = NULL;
+    }
+    report->reconnects++;
+    // The impairment may reset the handshake too; back off briefly and retry
+    for (int attempt = 0; attempt < 50; attempt++) {
+        if (rioc_client_connect_with_config(tail_config, client) == RIOC_SUCCESS) {
+            return RIOC_SUCCESS;
+        }
+        usleep(10000);
+    }
+    return RIOC_ERR_IO;
+}
+
+// Abandons an in-flight request. The protocol has no cancel, so the only way to
+// stop the response thread is to shut the socket down and drop the connection.
+static void tail_abort(struct tail_conn *conn) {
+    shutdown(conn->client->fd, SHUT_RDWR);
+    rioc_batch_tracker_free(conn->tracker);
+    rioc_batch_free(conn->batch);
+    conn->tracker = NULL;
+    conn->batch = NULL;
+}
+
+static int tail_start_get(struct tail_conn *conn, const char *key) {
+    conn->batch = rioc_batch_create(conn->client);
+    if (!conn->batch) {
+        return RIOC_ERR_MEM;
+    }
+    int ret = rioc_batch_add_get(conn->batch, key, strlen(key));
+    if (ret == RIOC_SUCCESS) {
+        conn->tracker = rioc_batch_execute_async(conn->batch);
+        ret = conn->tracker ? RIOC_SUCCESS : RIOC_ERR_IO;
+    }
+    if (ret != RIOC_SUCCESS) {
+        rioc_batch_free(conn->batch);
+        conn->batch = NULL;
+    }
+    return ret;
+}
+
+static bool tail_completed(struct tail_conn *conn) {
+    return conn->tracker && atomic_load_explicit(&conn->tracker->completed, memory_order_acquire);
+}
+
+// Releases a completed request; returns its status (NOENT counts as success)
+static int tail_finish(struct tail_conn *conn) {
+    int ret = rioc_batch_wait(conn->tracker, 0);
+    for (size_t i = 0; ret == RIOC_SUCCESS && i < conn->batch->count; i++) {
+        int status = conn->batch->ops[i].response.status;
+        if (status != RIOC_SUCCESS && status != RIOC_ERR_NOENT) {
+            ret = status;
+        }
+    }
+    rioc_batch_tracker_free(conn->tracker);
+    rioc_batch_free(conn->batch);
+    conn->tracker = NULL;
+    conn->batch = NULL;
+    return ret;
+}
+
+static void sleep_ns(long ns) {
+    struct timespec ts = {.tv_sec = 0, .tv_nsec = ns};
+    nanosleep(&ts, NULL);
+}
+
+// Pipelining: batch_size GETs share one round trip, so each op sees the batch latency
+static void run_pipelined(int batch_size, int num_ops, struct tail_report *report) {
+    struct tail_conn conn = {0};
+    if (tail_reconnect(&conn.client, report) != RIOC_SUCCESS) {
+        report->errors = num_ops;
+        return;
+    }
+    report->reconnects = 0;
+
+    char key[64];
+    uint64_t bench_start = rioc_get_timestamp_ns();
+    for (int done = 0; done < num_ops; ) {
+        int n = (num_ops - done < batch_size) ? num_ops - done : batch_size;
+        conn.batch = rioc_batch_create(conn.client);
+        if (!conn.batch) {
+            report->errors += n;
+            done += n;
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            tail_key(key, sizeof(key), rand() % TAIL_KEYS);
+            rioc_batch_add_get(conn.batch, key, strlen(key));
+        }
+
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        conn.tracker = rioc_batch_execute_async(conn.batch);
+        int ret = conn.tracker ? tail_finish(&conn) : RIOC_ERR_IO;
+        uint64_t end_ns = rioc_get_timestamp_ns();
+        if (!conn.tracker && conn.batch) {
+            rioc_batch_free(conn.batch);
+            conn.batch = NULL;
+        }
+
+        if (ret == RIOC_SUCCESS) {
+            for (int i = 0; i < n; i++) {
+                report->latencies[report->count++] = (double)(end_ns - start_ns) / 1000.0;
+            }
+        } else {
+            report->errors += n;
+            if (tail_reconnect(&conn.client, report) != RIOC_SUCCESS) {
+                break;
+            }
+        }
+        done += n;
+    }
+    report->elapsed_ns = rioc_get_timestamp_ns() - bench_start;
+    if (conn.client) {
+        rioc_client_disconnect_with_config(conn.client);
+    }
+}
+
+// Returns an idle connection other than exclude, reaping finished stragglers first.
+// With wait set, polls until a straggler finishes when every connection is busy.
+static struct tail_conn *tail_pick_idle(struct tail_conn *conns, struct tail_conn *exclude,
+                                        bool wait, struct tail_report *report) {
+    for (;;) {
+        for (int i = 0; i < TAIL_HEDGE_CONNS; i++) {
+            struct tail_conn *conn = &conns[i];
+            if (conn->tracker && tail_completed(conn)) {
+                if (tail_finish(conn) == RIOC_ERR_IO) {
+                    tail_reconnect(&conn->client, report);
+                }
+            }
+        }
+        for (int i = 0; i < TAIL_HEDGE_CONNS; i++) {
+            if (&conns[i] != exclude && !conns[i].tracker && conns[i].client) {
+                return &conns[i];
+            }
+        }
+        bool pending = false;
+        for (int i = 0; i < TAIL_HEDGE_CONNS; i++) {
+            pending |= conns[i].tracker != NULL;
+        }
+        if (!wait || !pending) {
+            return NULL;  // Nothing idle, or every connection is lost
+        }
+        sleep_ns(TAIL_POLL_NS);
+    }
+}
+
+// Hedging: if the first request has not completed after hedge_delay_us, the same GET
+// is sent on a second connection and whichever answers first wins. The loser is left
+// to finish in the background and its connection is reused once it has.
+static void run_hedged(int num_ops, int hedge_delay_us, struct tail_report *report) {
+    struct tail_conn conns[TAIL_HEDGE_CONNS];
+    memset(conns, 0, sizeof(conns));
+    for (int i = 0; i < TAIL_HEDGE_CONNS; i++) {
+        tail_reconnect(&conns[i].client, report);
+    }
+    report->reconnects = 0;
+
+    char key[64];
+    uint64_t bench_start = rioc_get_timestamp_ns();
+    for (int op = 0; op < num_ops; op++) {
+        tail_key(key, sizeof(key), rand() % TAIL_KEYS);
+        struct tail_conn *primary = tail_pick_idle(conns, NULL, true, report);
+        if (!primary) {
+            report->errors += num_ops - op;
+            break;
+        }
+        struct tail_conn *hedge = NULL;
+        struct tail_conn *winner = NULL;
+        bool hedge_tried = false;
+
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        if (tail_start_get(primary, key) != RIOC_SUCCESS) {
+            report->errors++;
+            tail_reconnect(&primary->client, report);
+            continue;
+        }
+        while (!winner) {
+            if (tail_completed(primary)) {
+                winner = primary;
+            } else if (hedge && tail_completed(hedge)) {
+                winner = hedge;
+            } else {
+                if (!hedge_tried && rioc_get_timestamp_ns() - start_ns >= (uint64_t)hedge_delay_us * 1000) {
+                    hedge_tried = true;
+                    hedge = tail_pick_idle(conns, primary, false, report);
+                    if (hedge && tail_start_get(hedge, key) == RIOC_SUCCESS) {
+                        report->hedges++;
+                    } else {
+                        hedge = NULL;
+                    }
+                }
+                sleep_ns(TAIL_POLL_NS);
+            }
+        }
+        uint64_t end_ns = rioc_get_timestamp_ns();
+
+        int ret = tail_finish(winner);
+        if (ret == RIOC_SUCCESS) {
+            report->latencies[report->count++] = (double)(end_ns - start_ns) / 1000.0;
+            if (winner == hedge) {
+                report->hedge_wins++;
+            }
+        } else {
+            // The other copy may still succeed, but the caller saw the first answer
+            report->errors++;
+            if (ret == RIOC_ERR_IO) {
+                tail_reconnect(&winner->client, report);
+            }
+        }
+    }
+    report->elapsed_ns = rioc_get_timestamp_ns() - bench_start;
+
+    for (int i = 0; i < TAIL_HEDGE_CONNS; i++) {
+        if (conns[i].tracker) {
+            tail_finish(&conns[i]);
+        }
+        if (conns[i].client) {
+            rioc_client_disconnect_with_config(conns[i].client);
+        }
+    }
+}
+
+// Timeouts: each GET gets timeout_ms; on expiry the connection is torn down, rebuilt
+// and the GET retried once. Latency includes the timeout, reconnect and retry.
+static void run_timeouts(int num_ops, int timeout_ms, struct tail_report *report) {
+    struct tail_conn conn = {0};
+    if (tail_reconnect(&conn.client, report) != RIOC_SUCCESS) {
+        report->errors = num_ops;
+        return;
+    }
+    report->reconnects = 0;
+
+    char key[64];
+    uint64_t bench_start = rioc_get_timestamp_ns();
+    for (int op = 0; op < num_ops; op++) {
+        tail_key(key, sizeof(key), rand() % TAIL_KEYS);
+        uint64_t start_ns = rioc_get_timestamp_ns();
+        bool ok = false;
+
+        for (int attempt = 0; attempt < 2 && !ok && conn.client; attempt++) {
+            if (tail_start_get(&conn, key) != RIOC_SUCCESS) {
+                tail_reconnect(&conn.client, report);
+                continue;
+            }
+            rioc_batch_wait(conn.tracker, timeout_ms);
+            if (!tail_completed(&conn)) {
+                report->timeouts++;
+                tail_abort(&conn);
+                tail_reconnect(&conn.client, report);
+                continue;
+            }
+            int ret = tail_finish(&conn);
+            if (ret == RIOC_SUCCESS) {
+                ok = true;
+            } else if (ret == RIOC_ERR_IO) {
+                tail_reconnect(&conn.client, report);
+            }
+        }
+
+        uint64_t end_ns = rioc_get_timestamp_ns();
+        if (ok) {
+            report->latencies[report->count++] = (double)(end_ns - start_ns) / 1000.0;
+        } else {
+            report->errors++;
+        }
+        if (!conn.client) {
+            break;
+        }
+    }
+    report->elapsed_ns = rioc_get_timestamp_ns() - bench_start;
+    if (conn.client) {
+        rioc_client_disconnect_with_config(conn.client);
+    }
+}
+
+static void print_report(struct tail_report *report) {
+    printf("\n%s:\n", report->name);
+    printf("  Completed ops:    %d\n", report->count);
+    printf("  Errors:           %"PRIu64"\n", report->errors);
+    printf("  Reconnects:       %"PRIu64"\n", report->reconnects);
+    if (report->timeouts) {
+        printf("  Timeouts:         %"PRIu64"\n", report->timeouts);
+    }
+    if (report->hedges) {
+        printf("  Hedges sent:      %"PRIu64" (%.2f%%), won %"PRIu64"\n", report->hedges,
+               report->count ? 100.0 * report->hedges / report->count : 0.0, report->hedge_wins);
+    }
+    if (report->count == 0) {
+        return;
+    }
+    double seconds = (double)report->elapsed_ns / 1000000000.0;
+    printf("  Operations/sec:   %.2f\n", seconds > 0 ? report->count / seconds : 0.0);
+
+    struct thread_result result;
+    calculate_stats(report->latencies, report->count, &result);
+    printf("  Latency (microseconds):\n");
+    printf("    P50 (median):    %.3f\n", result.p50_latency);
+    printf("    P95:             %.3f\n", result.p95_latency);
+    printf("    P99:             %.3f\n", result.p99_latency);
+    printf("    P99.9:           %.3f\n", result.p999_latency);
+    printf("    Max:             %.3f\n", result.max_latency);
+}
+
+static int preload_keys(struct rioc_client *client, int value_size) {
+    char *value = malloc(value_size);
+    struct rioc_batch *batch = rioc_batch_create(client);
+    if (!value || !batch) {
+        free(value);
+        if (batch) rioc_batch_free(batch);
+        return RIOC_ERR_MEM;
+    }
+    memset(value, 'T', value_size);
+
+    char key[64];
+    int ret = RIOC_SUCCESS;
+    uint64_t base_timestamp = rioc_get_timestamp_ns();
+    for (int i = 0; i < TAIL_KEYS && ret == RIOC_SUCCESS; i++) {
+        tail_key(key, sizeof(key), i);
+        rioc_batch_add_insert(batch, key, strlen(key), value, value_size, base_timestamp + i);
+        if (batch->count == RIOC_MAX_BATCH_SIZE || i == TAIL_KEYS - 1) {
+            struct rioc_batch_tracker *tracker = rioc_batch_execute_async(batch);
+            ret = tracker ? rioc_batch_wait(tracker, 0) : RIOC_ERR_IO;
+            rioc_batch_tracker_free(tracker);
+            rioc_batch_free(batch);
+            batch = rioc_batch_create(client);
+            if (!batch) {
+                ret = RIOC_ERR_MEM;
+            }
+        }
+    }
+    if (batch) rioc_batch_free(batch);
+    free(value);
+    return ret;
+}
+
+int rioc_bench_tail_main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: rioc_bench --tail <host> <port> [num_ops] [timeout_ms] "
+                "[hedge_delay_us] [value_size]\n");
+        fprintf(stderr, "  Point host:port at rioc_netem to exercise impaired networks\n");
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    int num_ops = (argc > 3) ? atoi(argv[3]) : 10000;
+    int timeout_ms = (argc > 4) ? atoi(argv[4]) : 50;
+    int hedge_delay_us = (argc > 5) ? atoi(argv[5]) : 2000;
+    int value_size = (argc > 6) ? atoi(argv[6]) : 100;
+
+    if (num_ops < 1 || timeout_ms < 1 || hedge_delay_us < 0 ||
+        value_size < 1 || value_size > RIOC_MAX_VALUE_SIZE) {
+        fprintf(stderr, "Invalid parameters\n");
+        return 1;
+    }
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = (uint32_t)timeout_ms,
+        .tls = NULL
+    };
+    tail_config = &config;
+
+    struct rioc_client *client = NULL;
+    if (rioc_client_connect_with_config(&config, &client) != RIOC_SUCCESS ||
+        preload_keys(client, value_size) != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to preload keys through %s:%d\n", host, port);
+        if (client) rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+    rioc_client_disconnect_with_config(client);
+
+    printf("\nTail Latency Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Operations:      %d per scenario\n", num_ops);
+    printf("  Op timeout:      %d ms\n", timeout_ms);
+    printf("  Hedge delay:     %d us\n", hedge_delay_us);
+    printf("  Value size:      %d bytes\n", value_size);
+
+    srand(1);
+    const int batch_sizes[] = {1, 16, RIOC_MAX_BATCH_SIZE};
+    char names[3][64];
+    struct tail_report reports[5];
+    memset(reports, 0, sizeof(reports));
+    int num_reports = 0;
+
+    for (int i = 0; i < 5; i++) {
+        reports[i].latencies = malloc(sizeof(double) * num_ops);
+        if (!reports[i].latencies) {
+            fprintf(stderr, "Failed to allocate latency arrays\n");
+            for (int j = 0; j < i; j++) free(reports[j].latencies);
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        snprintf(names[i], sizeof(names[i]), "Pipelined GET (batch size %d)", batch_sizes[i]);
+        reports[num_reports].name = names[i];
+        run_pipelined(batch_sizes[i], num_ops, &reports[num_reports]);
+        num_reports++;
+    }
+
+    reports[num_reports].name = "Hedged GET";
+    run_hedged(num_ops, hedge_delay_us, &reports[num_reports]);
+    num_reports++;
+
+    reports[num_reports].name = "GET with timeout and one retry";
+    run_timeouts(num_ops, timeout_ms, &reports[num_reports]);
+    num_reports++;
+
+    for (int i = 0; i < num_reports; i++) {
+        print_report(&reports[i]);
+        free(reports[i].latencies);
+    }
+    return 0;
+}
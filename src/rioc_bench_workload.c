@@ -0,0 +1,584 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <inttypes.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+#include "rioc_bench.h"
+
+// Workload runner: executes a workload file from bench/workloads and prints one result
+// object in the shared schema (bench/README.md) on stdout. The SDK runners implement the
+// same spec, so their results can be compared with this one to isolate binding overhead.
+
+#define WL_MAX_THREADS 256
+#define WL_KEY_SIZE 32
+#define WL_NAME_SIZE 64
+#define WL_MAX_FILE_SIZE (64 * 1024)
+
+enum wl_op {
+    WL_GET = 0,
+    WL_INSERT = 1,
+    WL_DELETE = 2,
+    WL_RANGE = 3,
+    WL_ATOMIC = 4,
+    WL_OP_COUNT = 5
+};
+
+static const char *wl_op_names[] = {"get", "insert", "delete", "range_query", "atomic_inc_dec"};
+
+struct workload_spec {
+    char name[WL_NAME_SIZE];
+    int threads;
+    int ops_per_thread;
+    int warmup_ops;
+    int batch_size;
+    int key_count;
+    int sequential;
+    int value_size;
+    int range_rows;
+    int seed;
+    int mix[WL_OP_COUNT];
+};
+
+struct workload_op {
+    uint32_t type;
+    uint32_t key;
+};
+
+struct workload_context {
+    int thread_id;
+    const struct workload_spec *spec;
+    rioc_client_config *config;
+    struct start_gate *gate;
+    const char *value;
+    struct workload_op *ops;   // warmup_ops followed by ops_per_thread
+    double *latencies;         // One sample per call, microseconds
+    size_t latency_count;
+    uint64_t op_counts[WL_OP_COUNT];
+    uint64_t error_count;
+    uint64_t end_time;
+    int failed;
+};
+
+static void data_key(char *buf, uint32_t index) {
+    snprintf(buf, WL_KEY_SIZE, "wl:%08" PRIu32, index);
+}
+
+static void counter_key(char *buf, uint32_t index) {
+    snprintf(buf, WL_KEY_SIZE, "wl:ctr:%08" PRIu32, index);
+}
+
+// Flat JSON object of string and integer members; enough for workload files
+static const char *skip_ws(const char *p) {
+    while (*p && isspace((unsigned char)*p)) p++;
+    return p;
+}
+
+static const char *parse_string(const char *p, char *out, size_t size) {
+    if (*p != '"') return NULL;
+    p++;
+    size_t len = 0;
+    while (*p && *p != '"') {
+        if (*p == '\\' && p[1]) p++;
+        if (len + 1 < size) out[len++] = *p;
+        p++;
+    }
+    if (*p != '"') return NULL;
+    out[len] = '\0';
+    return p + 1;
+}
+
+static int set_field(struct workload_spec *spec, const char *name, const char *str, long num, int is_str) {
+    struct { const char *name; int *value; } ints[] = {
+        {"threads", &spec->threads},
+        {"ops_per_thread", &spec->ops_per_thread},
+        {"warmup_ops", &spec->warmup_ops},
+        {"batch_size", &spec->batch_size},
+        {"key_count", &spec->key_count},
+        {"value_size", &spec->value_size},
+        {"range_rows", &spec->range_rows},
+        {"seed", &spec->seed},
+        {"get", &spec->mix[WL_GET]},
+        {"insert", &spec->mix[WL_INSERT]},
+        {"delete", &spec->mix[WL_DELETE]},
+        {"range_query", &spec->mix[WL_RANGE]},
+        {"atomic_inc_dec", &spec->mix[WL_ATOMIC]},
+    };
+
+    if (strcmp(name, "description") == 0) {
+        return is_str ? 0 : -1;
+    }
+    if (strcmp(name, "name") == 0 && is_str) {
+        snprintf(spec->name, sizeof(spec->name), "%s", str);
+        return 0;
+    }
+    if (strcmp(name, "key_distribution") == 0 && is_str) {
+        if (strcmp(str, "uniform") == 0) spec->sequential = 0;
+        else if (strcmp(str, "sequential") == 0) spec->sequential = 1;
+        else return -1;
+        return 0;
+    }
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++) {
+        if (strcmp(name, ints[i].name) == 0 && !is_str) {
+            *ints[i].value = (int)num;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int validate_spec(const struct workload_spec *spec) {
+    int total = 0;
+    for (int i = 0; i < WL_OP_COUNT; i++) {
+        if (spec->mix[i] < 0) return -1;
+        total += spec->mix[i];
+    }
+    if (total <= 0) {
+        fprintf(stderr, "Workload mix must give at least one operation a positive weight\n");
+        return -1;
+    }
+    if (spec->threads <= 0 || spec->threads > WL_MAX_THREADS || spec->ops_per_thread <= 0 ||
+        spec->warmup_ops < 0 || spec->batch_size <= 0 || spec->batch_size > RIOC_MAX_BATCH_SIZE ||
+        spec->key_count <= 0 || spec->value_size <= 0 || spec->value_size > RIOC_MAX_VALUE_SIZE ||
+        spec->range_rows <= 0) {
+        fprintf(stderr, "Workload parameter out of range\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int load_workload(const char *path, struct workload_spec *spec) {
+    memset(spec, 0, sizeof(*spec));
+    snprintf(spec->name, sizeof(spec->name), "unnamed");
+    spec->threads = 1;
+    spec->ops_per_thread = 10000;
+    spec->batch_size = 1;
+    spec->key_count = 1000;
+    spec->value_size = 100;
+    spec->range_rows = 10;
+    spec->seed = 1;
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open workload %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    char *text = malloc(WL_MAX_FILE_SIZE + 1);
+    if (!text) {
+        fclose(f);
+        return -1;
+    }
+    size_t len = fread(text, 1, WL_MAX_FILE_SIZE, f);
+    fclose(f);
+    text[len] = '\0';
+
+    const char *p = skip_ws(text);
+    int ret = *p == '{' ? 0 : -1;
+    if (ret == 0) p = skip_ws(p + 1);
+    while (ret == 0 && *p != '}') {
+        char name[WL_NAME_SIZE], str[WL_NAME_SIZE * 4];
+        p = parse_string(p, name, sizeof(name));
+        if (!p || *(p = skip_ws(p)) != ':') {
+            ret = -1;
+            break;
+        }
+        p = skip_ws(p + 1);
+        if (*p == '"') {
+            p = parse_string(p, str, sizeof(str));
+            ret = p ? set_field(spec, name, str, 0, 1) : -1;
+        } else {
+            char *end;
+            long num = strtol(p, &end, 10);
+            ret = end != p ? set_field(spec, name, NULL, num, 0) : -1;
+            p = end;
+        }
+        if (ret != 0) {
+            fprintf(stderr, "Invalid or unknown workload field \"%s\"\n", name);
+            break;
+        }
+        p = skip_ws(p);
+        if (*p == ',') p = skip_ws(p + 1);
+        else if (*p != '}') ret = -1;
+    }
+    free(text);
+    if (ret != 0) {
+        fprintf(stderr, "Failed to parse workload %s\n", path);
+        return -1;
+    }
+    return validate_spec(spec);
+}
+
+// Operation sequence shared by every runner: xorshift32 seeded per thread
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void generate_ops(const struct workload_spec *spec, int thread_id, struct workload_op *ops) {
+    uint32_t state = (uint32_t)spec->seed + 0x9E3779B9u * (uint32_t)(thread_id + 1);
+    if (state == 0) state = 1;
+    uint32_t total_weight = 0;
+    for (int i = 0; i < WL_OP_COUNT; i++) total_weight += spec->mix[i];
+
+    uint32_t count = (uint32_t)(spec->warmup_ops + spec->ops_per_thread);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t r = xorshift32(&state) % total_weight;
+        uint32_t type = 0;
+        while (r >= (uint32_t)spec->mix[type]) {
+            r -= spec->mix[type];
+            type++;
+        }
+        ops[i].type = type;
+        ops[i].key = spec->sequential ? (uint32_t)(((uint64_t)thread_id * count + i) % (uint64_t)spec->key_count)
+                                      : xorshift32(&state) % (uint32_t)spec->key_count;
+    }
+}
+
+static int is_error(int status) {
+    return status != RIOC_SUCCESS && status != RIOC_ERR_NOENT;
+}
+
+static uint32_t range_end(const struct workload_spec *spec, uint32_t start) {
+    uint32_t end = start + (uint32_t)spec->range_rows - 1;
+    return end < (uint32_t)spec->key_count ? end : (uint32_t)spec->key_count - 1;
+}
+
+// Executes one operation through the single-op API; returns the number of failed ops
+static int execute_single(struct rioc_client *client, const struct workload_spec *spec,
+                          const struct workload_op *op, const char *value) {
+    char key[WL_KEY_SIZE], end_key[WL_KEY_SIZE];
+    int ret;
+    switch (op->type) {
+        case WL_GET: {
+            char *result = NULL;
+            size_t result_len = 0;
+            data_key(key, op->key);
+            ret = rioc_get(client, key, strlen(key), &result, &result_len);
+            rioc_value_free(result);
+            break;
+        }
+        case WL_INSERT:
+            data_key(key, op->key);
+            ret = rioc_insert(client, key, strlen(key), value, spec->value_size, rioc_get_timestamp_ns());
+            break;
+        case WL_DELETE:
+            data_key(key, op->key);
+            ret = rioc_delete(client, key, strlen(key), rioc_get_timestamp_ns());
+            break;
+        case WL_RANGE: {
+            struct rioc_range_result *results = NULL;
+            size_t result_count = 0;
+            data_key(key, op->key);
+            data_key(end_key, range_end(spec, op->key));
+            ret = rioc_range_query(client, key, strlen(key), end_key, strlen(end_key),
+                                   &results, &result_count);
+            if (ret == RIOC_SUCCESS) rioc_free_range_results(results, result_count);
+            break;
+        }
+        default: {
+            int64_t counter = 0;
+            counter_key(key, op->key);
+            ret = rioc_atomic_inc_dec(client, key, strlen(key), 1, rioc_get_timestamp_ns(), &counter);
+            break;
+        }
+    }
+    return is_error(ret);
+}
+
+// Executes count operations as one batch; returns the number of failed ops
+static int execute_batch(struct rioc_client *client, const struct workload_spec *spec,
+                         const struct workload_op *ops, int count, const char *value) {
+    struct rioc_batch *batch = rioc_batch_create(client);
+    if (!batch) {
+        return count;
+    }
+
+    char key[WL_KEY_SIZE], end_key[WL_KEY_SIZE];
+    int ret = RIOC_SUCCESS;
+    for (int i = 0; i < count && ret == RIOC_SUCCESS; i++) {
+        const struct workload_op *op = &ops[i];
+        switch (op->type) {
+            case WL_GET:
+                data_key(key, op->key);
+                ret = rioc_batch_add_get(batch, key, strlen(key));
+                break;
+            case WL_INSERT:
+                data_key(key, op->key);
+                ret = rioc_batch_add_insert(batch, key, strlen(key), value, spec->value_size,
+                                            rioc_get_timestamp_ns());
+                break;
+            case WL_DELETE:
+                data_key(key, op->key);
+                ret = rioc_batch_add_delete(batch, key, strlen(key), rioc_get_timestamp_ns());
+                break;
+            case WL_RANGE:
+                data_key(key, op->key);
+                data_key(end_key, range_end(spec, op->key));
+                ret = rioc_batch_add_range_query(batch, key, strlen(key), end_key, strlen(end_key));
+                break;
+            default:
+                counter_key(key, op->key);
+                ret = rioc_batch_add_atomic_inc_dec(batch, key, strlen(key), 1, rioc_get_timestamp_ns());
+                break;
+        }
+    }
+
+    struct rioc_batch_tracker *tracker = ret == RIOC_SUCCESS ? rioc_batch_execute_async(batch) : NULL;
+    if (!tracker || rioc_batch_wait(tracker, 0) != RIOC_SUCCESS) {
+        rioc_batch_tracker_free(tracker);
+        rioc_batch_free(batch);
+        return count;
+    }
+
+    int errors = 0;
+    for (int i = 0; i < count; i++) {
+        char *result = NULL;
+        size_t result_len = 0;
+        errors += is_error(rioc_batch_get_response_async(tracker, i, &result, &result_len));
+    }
+    rioc_batch_tracker_free(tracker);
+    rioc_batch_free(batch);
+    return errors;
+}
+
+static void run_ops(struct rioc_client *client, struct workload_context *ctx,
+                    const struct workload_op *ops, int count, int record) {
+    const struct workload_spec *spec = ctx->spec;
+    for (int i = 0; i < count; i += spec->batch_size) {
+        int n = count - i < spec->batch_size ? count - i : spec->batch_size;
+        uint64_t start = rioc_get_timestamp_ns();
+        int errors = spec->batch_size == 1 ? execute_single(client, spec, &ops[i], ctx->value)
+                                           : execute_batch(client, spec, &ops[i], n, ctx->value);
+        uint64_t end = rioc_get_timestamp_ns();
+        if (record) {
+            ctx->latencies[ctx->latency_count++] = (double)(end - start) / 1000.0;
+            ctx->error_count += errors;
+            for (int j = 0; j < n; j++) ctx->op_counts[ops[i + j].type]++;
+        }
+    }
+}
+
+static void *workload_thread(void *arg) {
+    struct workload_context *ctx = (struct workload_context *)arg;
+    struct rioc_client *client = NULL;
+
+    if (rioc_client_connect_with_config(ctx->config, &client) != RIOC_SUCCESS) {
+        fprintf(stderr, "Thread %d: failed to connect\n", ctx->thread_id);
+        ctx->failed = 1;
+        gate_wait(ctx->gate);  // The main thread waits for every started thread
+        return NULL;
+    }
+
+    run_ops(client, ctx, ctx->ops, ctx->spec->warmup_ops, 0);
+    gate_wait(ctx->gate);
+    run_ops(client, ctx, ctx->ops + ctx->spec->warmup_ops, ctx->spec->ops_per_thread, 1);
+    ctx->end_time = rioc_get_timestamp_ns();
+
+    rioc_client_disconnect_with_config(client);
+    return NULL;
+}
+
+// Inserts (or deletes) the data keys and, on delete, the counters too
+static int prepare_keys(struct rioc_client *client, const struct workload_spec *spec,
+                        const char *value, int remove) {
+    char key[WL_KEY_SIZE];
+    int passes = remove ? 2 : 1;
+    for (int pass = 0; pass < passes; pass++) {
+        struct rioc_batch *batch = NULL;
+        for (int i = 0; i < spec->key_count; i++) {
+            if (!batch && !(batch = rioc_batch_create(client))) {
+                return RIOC_ERR_MEM;
+            }
+            if (pass == 0) data_key(key, i);
+            else counter_key(key, i);
+            int ret = remove ? rioc_batch_add_delete(batch, key, strlen(key), rioc_get_timestamp_ns())
+                             : rioc_batch_add_insert(batch, key, strlen(key), value, spec->value_size,
+                                                     rioc_get_timestamp_ns());
+            if (ret != RIOC_SUCCESS) {
+                rioc_batch_free(batch);
+                return ret;
+            }
+            if (batch->count == RIOC_MAX_BATCH_SIZE || i == spec->key_count - 1) {
+                struct rioc_batch_tracker *tracker = rioc_batch_execute_async(batch);
+                ret = tracker ? rioc_batch_wait(tracker, 0) : RIOC_ERR_IO;
+                rioc_batch_tracker_free(tracker);
+                rioc_batch_free(batch);
+                batch = NULL;
+                if (ret != RIOC_SUCCESS) {
+                    return ret;
+                }
+            }
+        }
+    }
+    return RIOC_SUCCESS;
+}
+
+static void print_result(const struct workload_spec *spec, struct workload_context *contexts,
+                         int threads, double elapsed_sec) {
+    size_t calls = 0;
+    uint64_t ops = 0, errors = 0, op_counts[WL_OP_COUNT] = {0};
+    for (int t = 0; t < threads; t++) {
+        calls += contexts[t].latency_count;
+        errors += contexts[t].error_count;
+        for (int i = 0; i < WL_OP_COUNT; i++) {
+            op_counts[i] += contexts[t].op_counts[i];
+            ops += contexts[t].op_counts[i];
+        }
+    }
+
+    double *all = malloc(sizeof(double) * (calls ? calls : 1));
+    struct thread_result stats;
+    memset(&stats, 0, sizeof(stats));
+    if (all && calls > 0) {
+        size_t merged = 0;
+        for (int t = 0; t < threads; t++) {
+            memcpy(all + merged, contexts[t].latencies, sizeof(double) * contexts[t].latency_count);
+            merged += contexts[t].latency_count;
+        }
+        calculate_stats(all, (int)calls, &stats);
+    }
+    free(all);
+
+    printf("{\"schema\":\"rioc-bench-result/1\",\"runner\":\"c\",\"workload\":\"%s\","
+           "\"threads\":%d,\"batch_size\":%d,\"value_size\":%d,"
+           "\"ops\":%"PRIu64",\"calls\":%zu,\"errors\":%"PRIu64",\"ops_by_type\":{",
+           spec->name, threads, spec->batch_size, spec->value_size, ops, calls, errors);
+    for (int i = 0; i < WL_OP_COUNT; i++) {
+        printf("%s\"%s\":%"PRIu64, i ? "," : "", wl_op_names[i], op_counts[i]);
+    }
+    printf("},\"elapsed_sec\":%.6f,\"ops_per_sec\":%.2f,\"latency_us\":{"
+           "\"min\":%.3f,\"avg\":%.3f,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f}}\n",
+           elapsed_sec, elapsed_sec > 0 ? (double)ops / elapsed_sec : 0.0,
+           stats.min_latency, stats.avg_latency, stats.p50_latency, stats.p95_latency,
+           stats.p99_latency, stats.p999_latency, stats.max_latency);
+    fflush(stdout);
+}
+
+int rioc_bench_workload_main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: rioc_bench --workload <file> <host> <port> "
+                "[tls_cert_path] [tls_key_path] [tls_ca_path]\n");
+        return 1;
+    }
+
+    const char *path = argv[1];
+    const char *host = argv[2];
+    int port = atoi(argv[3]);
+    const char *tls_cert_path = (argc > 4) ? argv[4] : NULL;
+    const char *tls_key_path = (argc > 5) ? argv[5] : NULL;
+    const char *tls_ca_path = (argc > 6) ? argv[6] : NULL;
+
+    struct workload_spec spec;
+    if (load_workload(path, &spec) != 0) {
+        return 1;
+    }
+    if ((tls_cert_path && !tls_key_path) || (!tls_cert_path && tls_key_path)) {
+        fprintf(stderr, "Both TLS certificate and key paths must be provided for TLS mode\n");
+        return 1;
+    }
+
+    rioc_tls_config tls_config;
+    memset(&tls_config, 0, sizeof(tls_config));
+    tls_config.cert_path = tls_cert_path;
+    tls_config.key_path = tls_key_path;
+    tls_config.ca_path = tls_ca_path;
+    tls_config.verify_hostname = host;
+    tls_config.verify_peer = tls_ca_path != NULL;
+
+    rioc_client_config config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = 5000,
+        .tls = tls_cert_path ? &tls_config : NULL
+    };
+
+    struct rioc_client *client = NULL;
+    int ret = rioc_client_connect_with_config(&config, &client);
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to connect to %s:%d (error code: %d)\n", host, port, ret);
+        return 1;
+    }
+
+    char *value = malloc(spec.value_size);
+    struct workload_context *contexts = calloc(spec.threads, sizeof(*contexts));
+    pthread_t *threads = calloc(spec.threads, sizeof(pthread_t));
+    if (!value || !contexts || !threads) {
+        free(value);
+        free(contexts);
+        free(threads);
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+    memset(value, 'x', spec.value_size);
+
+    fprintf(stderr, "Workload %s: %d threads x %d ops, batch size %d, %d keys, %d byte values\n",
+            spec.name, spec.threads, spec.ops_per_thread, spec.batch_size, spec.key_count, spec.value_size);
+    ret = prepare_keys(client, &spec, value, 0);
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to preload keys (error code: %d)\n", ret);
+    }
+
+    struct start_gate gate = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .cond = PTHREAD_COND_INITIALIZER,
+        .waiting = 0,
+        .released = 0
+    };
+
+    int threads_started = 0;
+    size_t ops_per_thread = (size_t)spec.warmup_ops + spec.ops_per_thread;
+    for (int i = 0; i < spec.threads && ret == RIOC_SUCCESS; i++) {
+        struct workload_context *ctx = &contexts[i];
+        ctx->thread_id = i;
+        ctx->spec = &spec;
+        ctx->config = &config;
+        ctx->gate = &gate;
+        ctx->value = value;
+        ctx->ops = malloc(sizeof(struct workload_op) * ops_per_thread);
+        ctx->latencies = malloc(sizeof(double) * spec.ops_per_thread);
+        if (!ctx->ops || !ctx->latencies) {
+            fprintf(stderr, "Failed to allocate operations for thread %d\n", i);
+            break;
+        }
+        generate_ops(&spec, i, ctx->ops);
+        if (pthread_create(&threads[i], NULL, workload_thread, ctx) != 0) {
+            fprintf(stderr, "Failed to create thread %d\n", i);
+            break;
+        }
+        threads_started++;
+    }
+
+    int failed = ret != RIOC_SUCCESS || threads_started < spec.threads;
+    if (threads_started > 0) {
+        uint64_t start_time = gate_release(&gate, threads_started);
+        uint64_t end_time = start_time;
+        for (int i = 0; i < threads_started; i++) {
+            pthread_join(threads[i], NULL);
+            if (contexts[i].end_time > end_time) end_time = contexts[i].end_time;
+            failed |= contexts[i].failed;
+        }
+        if (!failed) {
+            print_result(&spec, contexts, threads_started, (double)(end_time - start_time) / 1e9);
+        }
+    }
+
+    prepare_keys(client, &spec, value, 1);
+
+    for (int i = 0; i < spec.threads; i++) {
+        free(contexts[i].ops);
+        free(contexts[i].latencies);
+    }
+    free(threads);
+    free(contexts);
+    free(value);
+    rioc_client_disconnect_with_config(client);
+    return failed ? 1 : 0;
+}
@@ -29,6 +29,7 @@
 #endif
 
 #include "rioc.h"
+#include "rioc_alloc.h"
 #include "rioc_platform.h"
 
 // Define IPTOS_LOWDELAY if not available
@@ -49,6 +50,7 @@
 
 // Forward declarations
 static void* response_thread_func(void *arg);
+static void batch_receive(struct rioc_batch_tracker *tracker);
 
 // Helper function to send vectored I/O
 static ssize_t writev_all(rioc_socket_t fd, struct iovec *iov, int iovcnt) {
@@ -125,12 +127,32 @@ static ssize_t writev_all(rioc_socket_t fd, struct iovec *iov, int iovcnt) {
     return total;
 }
 
+// Receive exactly len bytes. A blocking socket waits in one MSG_WAITALL recv; a
+// busy-polling client's socket is non-blocking, so the loop spins until the rest arrives.
+static ssize_t recv_exact(rioc_socket_t fd, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = rioc_recv(fd, (char *)buf + got, len - got, 0);
+        if (n > 0) {
+            got += n;
+            continue;
+        }
+        if (n < 0 && (rioc_socket_error() == RIOC_EINTR || rioc_socket_error() == RIOC_EAGAIN ||
+                      rioc_socket_error() == RIOC_EWOULDBLOCK)) {
+            RIOC_CPU_RELAX();
+            continue;
+        }
+        return got > 0 ? (ssize_t)got : n;
+    }
+    return (ssize_t)got;
+}
+
 static ssize_t recv_all(rioc_socket_t fd, void *buf, size_t len) {
     // For small transfers (≤4KB), use pre-allocated aligned buffer
     static __thread char recv_buffer[4096] __attribute__((aligned(RIOC_CACHE_LINE_SIZE)));
     
     if (len <= 4096) {
-        ssize_t n = rioc_recv(fd, recv_buffer, len, 0);
+        ssize_t n = recv_exact(fd, recv_buffer, len);
         if (n > 0) {
             __builtin_prefetch(buf, 1, 3);  // Prefetch destination
             memcpy(buf, recv_buffer, n);
@@ -155,8 +177,11 @@ static ssize_t recv_all(rioc_socket_t fd, void *buf, size_t len) {
         
         ssize_t n = readv(fd, iov, 1);
         if (n <= 0) {
-            if (rioc_socket_error() == RIOC_EINTR) continue;
-            if (rioc_socket_error() == RIOC_EAGAIN || rioc_socket_error() == RIOC_EWOULDBLOCK) continue;
+            if (n < 0 && rioc_socket_error() == RIOC_EINTR) continue;
+            if (n < 0 && (rioc_socket_error() == RIOC_EAGAIN || rioc_socket_error() == RIOC_EWOULDBLOCK)) {
+                RIOC_CPU_RELAX();
+                continue;
+            }
             return -1;
         }
         
@@ -167,6 +192,78 @@ static ssize_t recv_all(rioc_socket_t fd, void *buf, size_t len) {
     return len;
 }
 
+// Read exactly len bytes from the client connection, TLS or plain
+static ssize_t client_read(struct rioc_client *client, void *buf, size_t len) {
+    if (client->tls) {
+        return rioc_tls_read(client->tls, buf, len);
+    }
+    return recv_all(client->fd, buf, len);
+}
+
+// Receive range query rows, reading each key and value straight into its own allocation
+static int recv_range_results(struct rioc_client *client, size_t count,
+                              struct rioc_range_result **results) {
+    if (count > SIZE_MAX / sizeof(struct rioc_range_result)) {
+        return RIOC_ERR_PROTO;
+    }
+    struct rioc_range_result *rows = rioc_value_alloc(count * sizeof(struct rioc_range_result));
+    if (!rows) {
+        return RIOC_ERR_MEM;
+    }
+    memset(rows, 0, count * sizeof(struct rioc_range_result));
+
+    int ret = RIOC_SUCCESS;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        uint16_t key_len;
+        size_t value_len;
+
+        if (client_read(client, &key_len, sizeof(key_len)) != sizeof(key_len)) {
+            ret = RIOC_ERR_IO;
+            break;
+        }
+        rows[i].key = rioc_value_alloc(key_len + 1);
+        if (!rows[i].key) {
+            ret = RIOC_ERR_MEM;
+            break;
+        }
+        if (client_read(client, rows[i].key, key_len) != key_len) {
+            ret = RIOC_ERR_IO;
+            break;
+        }
+        rows[i].key[key_len] = '\0';
+        rows[i].key_len = key_len;
+
+        if (client_read(client, &value_len, sizeof(value_len)) != sizeof(value_len)) {
+            ret = RIOC_ERR_IO;
+            break;
+        }
+        if (value_len > RIOC_MAX_VALUE_SIZE) {
+            ret = RIOC_ERR_PROTO;
+            break;
+        }
+        rows[i].value = rioc_value_alloc(value_len + 1);
+        if (!rows[i].value) {
+            ret = RIOC_ERR_MEM;
+            break;
+        }
+        if (client_read(client, rows[i].value, value_len) != (ssize_t)value_len) {
+            ret = RIOC_ERR_IO;
+            break;
+        }
+        rows[i].value[value_len] = '\0';
+        rows[i].value_len = value_len;
+    }
+
+    if (ret != RIOC_SUCCESS) {
+        rioc_free_range_results(rows, i + 1);
+        return ret;
+    }
+
+    *results = rows;
+    return RIOC_SUCCESS;
+}
+
 // Send a single operation header and data
 static int send_op(struct rioc_client *client, uint16_t command, const char *key, size_t key_len,
                   const char *value, size_t value_len, uint64_t timestamp) {
@@ -238,6 +335,7 @@ static int send_op(struct rioc_client *client, uint16_t command, const char *key
                 ssize_t n = rioc_send(client->fd, send_buffer + sent, total_size - sent, 0);
                 if (n <= 0) {
                     if (rioc_socket_error() == RIOC_EINTR) continue;
+                    if (rioc_socket_error() == RIOC_EAGAIN || rioc_socket_error() == RIOC_EWOULDBLOCK) continue;
                     return RIOC_ERR_IO;
                 }
                 sent += n;
@@ -280,7 +378,7 @@ static int recv_response(rioc_socket_t fd, struct rioc_response_header *response
     if (tls) {
         n = rioc_tls_read(tls, &header_buf, sizeof(header_buf));
     } else {
-        n = rioc_recv(fd, &header_buf, sizeof(header_buf), 0);
+        n = recv_exact(fd, &header_buf, sizeof(header_buf));
     }
     if (n != sizeof(header_buf)) {
         return RIOC_ERR_IO;
@@ -293,49 +391,25 @@ static int recv_response(rioc_socket_t fd, struct rioc_response_header *response
         return (int32_t)response->status;
     }
     
-    // Read value if present
+    // Read value if present, straight into the caller's allocation
     if (response->value_len > 0 && value && value_len) {
-        // Use pre-allocated buffer for small values
-        static __thread char value_buf[4096] __attribute__((aligned(RIOC_CACHE_LINE_SIZE)));
-        
-        if (response->value_len <= sizeof(value_buf)) {
-            // Fast path for small values
-            if (tls) {
-                n = rioc_tls_read(tls, value_buf, response->value_len);
-            } else {
-                n = rioc_recv(fd, value_buf, response->value_len, 0);
-            }
-            if (n != (ssize_t)response->value_len) {
-                return RIOC_ERR_IO;
-            }
-            
-            *value = malloc(response->value_len + 1);
-            if (!*value) {
-                return RIOC_ERR_MEM;
-            }
-            
-            memcpy(*value, value_buf, response->value_len);
-            (*value)[response->value_len] = '\0';
+        *value = rioc_value_alloc(response->value_len + 1);
+        if (!*value) {
+            return RIOC_ERR_MEM;
+        }
+
+        if (tls) {
+            n = rioc_tls_read(tls, *value, response->value_len);
         } else {
-            // Slow path for large values
-            *value = malloc(response->value_len + 1);
-            if (!*value) {
-                return RIOC_ERR_MEM;
-            }
-            
-            if (tls) {
-                n = rioc_tls_read(tls, *value, response->value_len);
-            } else {
-                n = rioc_recv(fd, *value, response->value_len, 0);
-            }
-            if (n != (ssize_t)response->value_len) {
-                free(*value);
-                return RIOC_ERR_IO;
-            }
-            
-            (*value)[response->value_len] = '\0';
+            n = recv_exact(fd, *value, response->value_len);
         }
-        
+        if (n != (ssize_t)response->value_len) {
+            rioc_value_free(*value);
+            *value = NULL;
+            return RIOC_ERR_IO;
+        }
+
+        (*value)[response->value_len] = '\0';
         *value_len = response->value_len;
     } else if (value && value_len) {
         *value = NULL;
@@ -415,7 +489,10 @@ struct rioc_batch *rioc_batch_create(struct rioc_client *client) {
     
     // Pre-allocate value buffer with full batch size plus padding for alignment
     batch->value_buffer_size = RIOC_MAX_VALUE_SIZE * RIOC_MAX_BATCH_SIZE + RIOC_CACHE_LINE_SIZE;
-    if (posix_memalign((void**)&batch->value_buffer, RIOC_CACHE_LINE_SIZE, batch->value_buffer_size) != 0) {
+    batch->value_buffer_flags = client ? client->flags : 0;
+    batch->value_buffer = rioc_buffer_alloc(&batch->value_buffer_size, batch->value_buffer_flags,
+                                            client ? client->cpu : 0);
+    if (!batch->value_buffer) {
         free(batch);
         return NULL;
     }
@@ -558,31 +635,79 @@ int rioc_batch_add_atomic_inc_dec(struct rioc_batch *batch, const char *key, siz
                        (const char*)&increment, sizeof(increment), timestamp);
 }
 
+// Add every op of a packed request to the batch; on error the batch is left unchanged
+int rioc_batch_add_packed(struct rioc_batch *batch, const char *packed, size_t packed_len) {
+    if (!batch || (!packed && packed_len > 0)) {
+        return RIOC_ERR_PARAM;
+    }
+
+    size_t start_count = batch->count;
+    size_t offset = 0;
+    int ret = RIOC_SUCCESS;
+
+    while (offset < packed_len) {
+        // Records are not padded, so the header may be unaligned
+        struct rioc_op_header header;
+        if (packed_len - offset < sizeof(header)) {
+            ret = RIOC_ERR_PARAM;
+            break;
+        }
+        memcpy(&header, packed + offset, sizeof(header));
+        offset += sizeof(header);
+
+        if (packed_len - offset < (size_t)header.key_len + header.value_len) {
+            ret = RIOC_ERR_PARAM;
+            break;
+        }
+        const char *key = packed + offset;
+        const char *value = key + header.key_len;
+        offset += (size_t)header.key_len + header.value_len;
+
+        switch (header.command) {
+            case RIOC_CMD_GET:
+                ret = batch_add_op(batch, RIOC_CMD_GET, key, header.key_len, NULL, 0, 0);
+                break;
+            case RIOC_CMD_INSERT:
+                ret = batch_add_op(batch, RIOC_CMD_INSERT, key, header.key_len,
+                                   value, header.value_len, header.timestamp);
+                break;
+            case RIOC_CMD_DELETE:
+                ret = batch_add_op(batch, RIOC_CMD_DELETE, key, header.key_len, NULL, 0,
+                                   header.timestamp);
+                break;
+            case RIOC_CMD_RANGE_QUERY:
+                ret = rioc_batch_add_range_query(batch, key, header.key_len, value, header.value_len);
+                break;
+            case RIOC_CMD_ATOMIC_INC_DEC:
+                ret = header.value_len == sizeof(int64_t) ?
+                      batch_add_op(batch, RIOC_CMD_ATOMIC_INC_DEC, key, header.key_len,
+                                   value, header.value_len, header.timestamp) :
+                      RIOC_ERR_PARAM;
+                break;
+            default:
+                ret = RIOC_ERR_PARAM;
+                break;
+        }
+        if (ret != RIOC_SUCCESS) {
+            break;
+        }
+    }
+
+    if (ret != RIOC_SUCCESS) {
+        batch->count = start_count;
+    }
+    return ret;
+}
+
 void rioc_batch_free(struct rioc_batch *batch) {
     if (batch) {
-        free(batch->value_buffer);
+        rioc_buffer_free(batch->value_buffer, batch->value_buffer_size, batch->value_buffer_flags);
         free(batch);
     }
 }
 
-// Execute batch asynchronously
-struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
-    if (!batch || batch->count == 0) {
-        return NULL;
-    }
-    
-    // Allocate and initialize tracker
-    struct rioc_batch_tracker *tracker;
-    if (posix_memalign((void**)&tracker, RIOC_CACHE_LINE_SIZE, sizeof(*tracker)) != 0) {
-        return NULL;
-    }
-    memset(tracker, 0, sizeof(*tracker));
-    
-    tracker->batch = batch;
-    atomic_init(&tracker->completed, 0);
-    atomic_init(&tracker->error, 0);
-    atomic_init(&tracker->responses_received, 0);
-    
+// Send every operation of a batch in one vectored write
+static int batch_send(struct rioc_batch *batch) {
     // Update batch header count
     batch->batch_header.count = batch->count;
     
@@ -598,8 +723,7 @@ struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
     // Allocate IOV array with cache alignment
     struct iovec *iovs;
     if (posix_memalign((void**)&iovs, RIOC_CACHE_LINE_SIZE, total_iovs * sizeof(struct iovec)) != 0) {
-        free(tracker);
-        return NULL;
+        return RIOC_ERR_MEM;
     }
     
     // Set up IOVs with prefetching
@@ -646,8 +770,7 @@ struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
         // Use TLS vectored I/O for TLS connections
         if (rioc_tls_writev(batch->client->tls, iovs, total_iovs) < 0) {
             free(iovs);
-            free(tracker);
-            return NULL;
+            return RIOC_ERR_IO;
         }
     } else {
         // Use regular vectored I/O for non-TLS connections
@@ -657,8 +780,7 @@ struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
             int cork = 0;
             setsockopt(batch->client->fd, IPPROTO_TCP, TCP_CORK, &cork, sizeof(cork));
 #endif
-            free(tracker);
-            return NULL;
+            return RIOC_ERR_IO;
         }
     }
 
@@ -671,6 +793,40 @@ struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
     }
     
     free(iovs);
+    return RIOC_SUCCESS;
+}
+
+// Send a batch and return a tracker for its responses, NULL if the send failed
+static struct rioc_batch_tracker *batch_send_tracked(struct rioc_batch *batch) {
+    if (!batch || batch->count == 0) {
+        return NULL;
+    }
+    
+    // Allocate and initialize tracker
+    struct rioc_batch_tracker *tracker;
+    if (posix_memalign((void**)&tracker, RIOC_CACHE_LINE_SIZE, sizeof(*tracker)) != 0) {
+        return NULL;
+    }
+    memset(tracker, 0, sizeof(*tracker));
+    
+    tracker->batch = batch;
+    atomic_init(&tracker->completed, 0);
+    atomic_init(&tracker->error, 0);
+    atomic_init(&tracker->responses_received, 0);
+    
+    if (batch_send(batch) != RIOC_SUCCESS) {
+        free(tracker);
+        return NULL;
+    }
+    return tracker;
+}
+
+// Execute batch asynchronously
+struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
+    struct rioc_batch_tracker *tracker = batch_send_tracked(batch);
+    if (!tracker) {
+        return NULL;
+    }
     
     // Start response thread
     if (pthread_create(&tracker->response_thread, NULL, response_thread_func, tracker) != 0) {
@@ -681,21 +837,24 @@ struct rioc_batch_tracker* rioc_batch_execute_async(struct rioc_batch *batch) {
     return tracker;
 }
 
-// Response thread function for async batch execution
-static void* response_thread_func(void *arg) {
-    struct rioc_batch_tracker *tracker = (struct rioc_batch_tracker *)arg;
+struct rioc_batch_tracker* rioc_batch_send(struct rioc_batch *batch) {
+    return batch_send_tracked(batch);
+}
+
+int rioc_batch_receive(struct rioc_batch_tracker *tracker) {
+    if (!tracker || tracker->response_thread ||
+        atomic_load_explicit(&tracker->completed, memory_order_acquire)) {
+        return RIOC_ERR_PARAM;
+    }
+    batch_receive(tracker);
+    return atomic_load_explicit(&tracker->error, memory_order_acquire);
+}
+
+// Read every response of a sent batch in the calling thread
+static void batch_receive(struct rioc_batch_tracker *tracker) {
     struct rioc_batch *batch = tracker->batch;
     struct rioc_response_header response;
-    
-    // Allocate aligned response buffer
-    char *response_buffer;
-    if (posix_memalign((void**)&response_buffer, RIOC_CACHE_LINE_SIZE, 
-                       RIOC_MAX_VALUE_SIZE + RIOC_CACHE_LINE_SIZE) != 0) {
-        atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
-        atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-        return NULL;
-    }
-    
+
     // Process all operations
     for (size_t i = 0; i < batch->count; i++) {
         struct rioc_batch_op *op = &batch->ops[i];
@@ -713,10 +872,9 @@ static void* response_thread_func(void *arg) {
             ret = recv_all(batch->client->fd, &response, sizeof(response));
         }
         if (ret != sizeof(response)) {
-            free(response_buffer);
             atomic_store_explicit(&tracker->error, RIOC_ERR_IO, memory_order_release);
             atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-            return NULL;
+            return;
         }
         
         // Store response
@@ -726,29 +884,31 @@ static void* response_thread_func(void *arg) {
         // Handle GET responses
         if ((op->header.command == RIOC_CMD_GET || op->header.command == RIOC_CMD_ATOMIC_INC_DEC) && 
             response.value_len > 0) {
-            // Receive value data directly into response buffer
+            if (response.value_len > RIOC_MAX_VALUE_SIZE) {
+                atomic_store_explicit(&tracker->error, RIOC_ERR_PROTO, memory_order_release);
+                atomic_store_explicit(&tracker->completed, 1, memory_order_release);
+                return;
+            }
+
+            // Receive the value straight into the allocation handed to the caller
+            char *value = rioc_value_alloc(response.value_len + 1);
+            if (!value) {
+                atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
+                atomic_store_explicit(&tracker->completed, 1, memory_order_release);
+                return;
+            }
             if (batch->client->tls) {
-                ret = rioc_tls_read(batch->client->tls, response_buffer, response.value_len);
+                ret = rioc_tls_read(batch->client->tls, value, response.value_len);
             } else {
-                ret = recv_all(batch->client->fd, response_buffer, response.value_len);
+                ret = recv_all(batch->client->fd, value, response.value_len);
             }
             if (ret != (ssize_t)response.value_len) {
-                free(response_buffer);
+                rioc_value_free(value);
                 atomic_store_explicit(&tracker->error, RIOC_ERR_IO, memory_order_release);
                 atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                return NULL;
-            }
-            
-            // Allocate and copy value
-            char *value = malloc(response.value_len + 1);
-            if (!value) {
-                free(response_buffer);
-                atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
-                atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                return NULL;
+                return;
             }
             
-            memcpy(value, response_buffer, response.value_len);
             // Only add null terminator for GET, not for atomic operations
             if (op->header.command == RIOC_CMD_GET) {
                 value[response.value_len] = '\0';
@@ -757,170 +917,34 @@ static void* response_thread_func(void *arg) {
         }
         // Handle RANGE_QUERY responses
         else if (op->header.command == RIOC_CMD_RANGE_QUERY && response.value_len > 0) {
-            // Allocate array for range results
-            size_t count = response.value_len;
-            struct rioc_range_result *results = malloc(count * sizeof(struct rioc_range_result));
-            if (!results) {
-                free(response_buffer);
-                atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
-                atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                return NULL;
-            }
-            memset(results, 0, count * sizeof(struct rioc_range_result));
-            
-            // Allocate buffer for results
-            size_t buffer_size = RIOC_MAX_VALUE_SIZE * 10;  // 10MB max
-            char *buffer = malloc(buffer_size);
-            if (!buffer) {
-                free(results);
-                free(response_buffer);
-                atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
+            struct rioc_range_result *results = NULL;
+            int range_ret = recv_range_results(batch->client, response.value_len, &results);
+            if (range_ret != RIOC_SUCCESS) {
+                atomic_store_explicit(&tracker->error, range_ret, memory_order_release);
                 atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                return NULL;
-            }
-            
-            // Receive results
-            size_t offset = 0;
-            
-            // Process each result
-            for (size_t j = 0; j < count; j++) {
-                uint16_t key_len;
-                size_t value_len;
-                
-                // Receive key length
-                if (batch->client->tls) {
-                    ret = rioc_tls_read(batch->client->tls, buffer + offset, sizeof(uint16_t));
-                } else {
-                    ret = recv_all(batch->client->fd, buffer + offset, sizeof(uint16_t));
-                }
-                if (ret != sizeof(uint16_t)) {
-                    free(buffer);
-                    for (size_t k = 0; k < j; k++) {
-                        if (results[k].key) free(results[k].key);
-                        if (results[k].value) free(results[k].value);
-                    }
-                    free(results);
-                    free(response_buffer);
-                    atomic_store_explicit(&tracker->error, RIOC_ERR_IO, memory_order_release);
-                    atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                    return NULL;
-                }
-                
-                memcpy(&key_len, buffer + offset, sizeof(uint16_t));
-                offset += sizeof(uint16_t);
-                
-                // Receive key
-                if (batch->client->tls) {
-                    ret = rioc_tls_read(batch->client->tls, buffer + offset, key_len);
-                } else {
-                    ret = recv_all(batch->client->fd, buffer + offset, key_len);
-                }
-                if (ret != key_len) {
-                    free(buffer);
-                    for (size_t k = 0; k < j; k++) {
-                        if (results[k].key) free(results[k].key);
-                        if (results[k].value) free(results[k].value);
-                    }
-                    free(results);
-                    free(response_buffer);
-                    atomic_store_explicit(&tracker->error, RIOC_ERR_IO, memory_order_release);
-                    atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                    return NULL;
-                }
-                
-                // Allocate and copy key
-                results[j].key = malloc(key_len + 1);
-                if (!results[j].key) {
-                    free(buffer);
-                    for (size_t k = 0; k < j; k++) {
-                        if (results[k].key) free(results[k].key);
-                        if (results[k].value) free(results[k].value);
-                    }
-                    free(results);
-                    free(response_buffer);
-                    atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
-                    atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                    return NULL;
-                }
-                
-                memcpy(results[j].key, buffer + offset, key_len);
-                results[j].key[key_len] = '\0';
-                results[j].key_len = key_len;
-                offset += key_len;
-                
-                // Receive value length
-                if (batch->client->tls) {
-                    ret = rioc_tls_read(batch->client->tls, buffer + offset, sizeof(size_t));
-                } else {
-                    ret = recv_all(batch->client->fd, buffer + offset, sizeof(size_t));
-                }
-                if (ret != sizeof(size_t)) {
-                    free(buffer);
-                    for (size_t k = 0; k <= j; k++) {
-                        if (results[k].key) free(results[k].key);
-                        if (results[k].value) free(results[k].value);
-                    }
-                    free(results);
-                    free(response_buffer);
-                    atomic_store_explicit(&tracker->error, RIOC_ERR_IO, memory_order_release);
-                    atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                    return NULL;
-                }
-                
-                memcpy(&value_len, buffer + offset, sizeof(size_t));
-                offset += sizeof(size_t);
-                
-                // Receive value
-                if (batch->client->tls) {
-                    ret = rioc_tls_read(batch->client->tls, buffer + offset, value_len);
-                } else {
-                    ret = recv_all(batch->client->fd, buffer + offset, value_len);
-                }
-                if (ret != value_len) {
-                    free(buffer);
-                    for (size_t k = 0; k <= j; k++) {
-                        if (results[k].key) free(results[k].key);
-                        if (results[k].value) free(results[k].value);
-                    }
-                    free(results);
-                    free(response_buffer);
-                    atomic_store_explicit(&tracker->error, RIOC_ERR_IO, memory_order_release);
-                    atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                    return NULL;
-                }
-                
-                // Allocate and copy value
-                results[j].value = malloc(value_len + 1);
-                if (!results[j].value) {
-                    free(buffer);
-                    for (size_t k = 0; k <= j; k++) {
-                        if (results[k].key) free(results[k].key);
-                        if (results[k].value) free(results[k].value);
-                    }
-                    free(results);
-                    free(response_buffer);
-                    atomic_store_explicit(&tracker->error, RIOC_ERR_MEM, memory_order_release);
-                    atomic_store_explicit(&tracker->completed, 1, memory_order_release);
-                    return NULL;
-                }
-                
-                memcpy(results[j].value, buffer + offset, value_len);
-                results[j].value[value_len] = '\0';
-                results[j].value_len = value_len;
-                offset += value_len;
+                return;
             }
             
             // Store results in the operation
             op->value_ptr = (char*)results;
-            free(buffer);
         }
         
         atomic_store_explicit(&tracker->responses_received, i + 1, memory_order_release);
     }
     
-    free(response_buffer);
     atomic_store_explicit(&tracker->error, RIOC_SUCCESS, memory_order_release);
     atomic_store_explicit(&tracker->completed, 1, memory_order_release);
+}
+
+// Response thread function for async batch execution
+static void* response_thread_func(void *arg) {
+    struct rioc_batch_tracker *tracker = (struct rioc_batch_tracker *)arg;
+
+    // Best effort: a CPU outside the process's affinity mask leaves the thread unpinned
+    if (tracker->batch->client->flags & RIOC_CLIENT_PIN_CPU) {
+        rioc_pin_thread_to_cpu(tracker->batch->client->cpu);
+    }
+    batch_receive(tracker);
     return NULL;
 }
 
@@ -932,6 +956,7 @@ int rioc_batch_wait(struct rioc_batch_tracker *tracker, int timeout_ms) {
     
     struct timeval start, now;
     gettimeofday(&start, NULL);
+    bool spin = tracker->batch->client->flags & RIOC_CLIENT_BUSY_POLL;
     
     while (!atomic_load_explicit(&tracker->completed, memory_order_acquire)) {
         if (timeout_ms > 0) {
@@ -941,9 +966,10 @@ int rioc_batch_wait(struct rioc_batch_tracker *tracker, int timeout_ms) {
             if (elapsed_ms >= timeout_ms) {
                 return RIOC_ERR_IO;  // Timeout
             }
-            // Short sleep to avoid busy waiting
-            struct timespec ts = {.tv_sec = 0, .tv_nsec = 100000};  // 100 microseconds
-            nanosleep(&ts, NULL);
+        }
+        if (spin) {
+            // Busy-polling clients see the completion as soon as it lands
+            RIOC_CPU_RELAX();
         } else {
             // Short sleep to avoid busy waiting
             struct timespec ts = {.tv_sec = 0, .tv_nsec = 100000};  // 100 microseconds
@@ -954,6 +980,19 @@ int rioc_batch_wait(struct rioc_batch_tracker *tracker, int timeout_ms) {
     return atomic_load_explicit(&tracker->error, memory_order_acquire);
 }
 
+static bool batch_owns_value(const struct rioc_batch *batch, const char *ptr) {
+    return ptr >= batch->value_buffer && ptr < batch->value_buffer + batch->value_buffer_size;
+}
+
+// Value received for an op. Until a value arrives, value_ptr still points at the
+// request's value or end key in the batch buffer, which is not part of the response.
+static char *op_response_value(const struct rioc_batch *batch, const struct rioc_batch_op *op) {
+    if (!op->value_ptr || batch_owns_value(batch, op->value_ptr)) {
+        return NULL;
+    }
+    return (char *)op->value_ptr;
+}
+
 // Get response for a specific operation in the batch
 int rioc_batch_get_response_async(struct rioc_batch_tracker *tracker, size_t index, 
                                 char **value, size_t *value_len) {
@@ -967,12 +1006,126 @@ int rioc_batch_get_response_async(struct rioc_batch_tracker *tracker, size_t ind
     }
     
     struct rioc_batch_op *op = &tracker->batch->ops[index];
-    *value = (char *)op->value_ptr;
+    *value = op_response_value(tracker->batch, op);
     *value_len = op->response.value_len;
     
     return op->response.status;
 }
 
+// Get a response and take ownership of its value, so the caller can keep it without a copy
+int rioc_batch_take_response_async(struct rioc_batch_tracker *tracker, size_t index,
+                                   char **value, size_t *value_len) {
+    int status = rioc_batch_get_response_async(tracker, index, value, value_len);
+    if (status == RIOC_ERR_PARAM || (status == RIOC_ERR_IO &&
+        index >= atomic_load_explicit(&tracker->responses_received, memory_order_acquire))) {
+        return status;
+    }
+
+    if (*value) {
+        // The tracker no longer frees the value
+        tracker->batch->ops[index].value_ptr = NULL;
+    } else {
+        // Nothing was received: INSERT, DELETE, an empty range or a failed op
+        *value_len = 0;
+    }
+
+    return status;
+}
+
+// Bytes an op contributes to a packed response after its rioc_packed_result
+static size_t packed_data_len(const struct rioc_batch_op *op) {
+    if (op->response.status != RIOC_SUCCESS || !op->value_ptr) {
+        return 0;
+    }
+    if (op->header.command == RIOC_CMD_RANGE_QUERY) {
+        const struct rioc_range_result *results = (const struct rioc_range_result *)op->value_ptr;
+        size_t len = 0;
+        for (size_t j = 0; j < op->response.value_len; j++) {
+            len += 2 * sizeof(uint32_t) + results[j].key_len + results[j].value_len;
+        }
+        return len;
+    }
+    if (op->header.command == RIOC_CMD_GET || op->header.command == RIOC_CMD_ATOMIC_INC_DEC) {
+        return op->response.value_len;
+    }
+    return 0;
+}
+
+// Get every response of a completed batch as one packed buffer owned by the tracker
+int rioc_batch_get_packed_responses(struct rioc_batch_tracker *tracker,
+                                    const char **packed, size_t *packed_len) {
+    if (!tracker || !packed || !packed_len) {
+        return RIOC_ERR_PARAM;
+    }
+    if (!atomic_load_explicit(&tracker->completed, memory_order_acquire)) {
+        return RIOC_ERR_BUSY;
+    }
+
+    if (!tracker->packed) {
+        struct rioc_batch *batch = tracker->batch;
+        size_t received = atomic_load_explicit(&tracker->responses_received, memory_order_acquire);
+        int error = atomic_load_explicit(&tracker->error, memory_order_acquire);
+
+        size_t total = batch->count * sizeof(struct rioc_packed_result);
+        for (size_t i = 0; i < received; i++) {
+            total += packed_data_len(&batch->ops[i]);
+        }
+
+        char *buffer = malloc(total);
+        if (!buffer) {
+            return RIOC_ERR_MEM;
+        }
+
+        char *pos = buffer;
+        for (size_t i = 0; i < batch->count; i++) {
+            struct rioc_batch_op *op = &batch->ops[i];
+            struct rioc_packed_result result = {0};
+
+            if (i >= received) {
+                // The response never arrived
+                result.status = error != RIOC_SUCCESS ? error : RIOC_ERR_IO;
+                memcpy(pos, &result, sizeof(result));
+                pos += sizeof(result);
+                continue;
+            }
+
+            result.status = op->response.status;
+            result.data_len = packed_data_len(op);
+            if (op->header.command == RIOC_CMD_RANGE_QUERY && result.data_len > 0) {
+                result.count = op->response.value_len;
+            }
+            memcpy(pos, &result, sizeof(result));
+            pos += sizeof(result);
+
+            if (result.data_len == 0) {
+                continue;
+            }
+            if (op->header.command == RIOC_CMD_RANGE_QUERY) {
+                const struct rioc_range_result *results = (const struct rioc_range_result *)op->value_ptr;
+                for (size_t j = 0; j < result.count; j++) {
+                    uint32_t lens[2] = {(uint32_t)results[j].key_len, (uint32_t)results[j].value_len};
+                    memcpy(pos, lens, sizeof(lens));
+                    pos += sizeof(lens);
+                    memcpy(pos, results[j].key, results[j].key_len);
+                    pos += results[j].key_len;
+                    memcpy(pos, results[j].value, results[j].value_len);
+                    pos += results[j].value_len;
+                }
+            } else {
+                memcpy(pos, op->value_ptr, result.data_len);
+                pos += result.data_len;
+            }
+        }
+
+        tracker->packed = buffer;
+        tracker->packed_len = total;
+    }
+
+    *packed = tracker->packed;
+    *packed_len = tracker->packed_len;
+    return RIOC_SUCCESS;
+}
+
 // Free the tracker and associated resources
 void rioc_batch_tracker_free(struct rioc_batch_tracker *tracker) {
     if (!tracker) {
@@ -983,43 +1136,111 @@ void rioc_batch_tracker_free(struct rioc_batch_tracker *tracker) {
         pthread_join(tracker->response_thread, NULL);
     }
     
-    // Free GET operation values and RANGE_QUERY results
+    // Free received GET and ATOMIC_INC_DEC values and RANGE_QUERY results
     struct rioc_batch *batch = tracker->batch;
     for (size_t i = 0; i < batch->count; i++) {
         struct rioc_batch_op *op = &batch->ops[i];
-        if ((op->header.command == RIOC_CMD_GET || op->header.command == RIOC_CMD_ATOMIC_INC_DEC) && op->value_ptr) {
-            free((void*)op->value_ptr);
-        } else if (op->header.command == RIOC_CMD_RANGE_QUERY && op->value_ptr) {
-            // Free range query results
-            struct rioc_range_result *results = (struct rioc_range_result *)op->value_ptr;
-            size_t count = op->response.value_len;
-            
-            for (size_t j = 0; j < count; j++) {
-                if (results[j].key) {
-                    free(results[j].key);
-                }
-                if (results[j].value) {
-                    free(results[j].value);
-                }
-            }
-            
-            free(results);
+        char *value = op_response_value(batch, op);
+        if (!value) {
+            continue;
         }
+        if (op->header.command == RIOC_CMD_RANGE_QUERY) {
+            rioc_free_range_results((struct rioc_range_result *)value, op->response.value_len);
+        } else if (op->header.command == RIOC_CMD_GET || op->header.command == RIOC_CMD_ATOMIC_INC_DEC) {
+            rioc_value_free(value);
+        }
+        op->value_ptr = NULL;
     }
     
+    free(tracker->packed);
     free(tracker);
 }
 
-// Single operation functions
-int rioc_get(struct rioc_client *client, const char *key, size_t key_len,
-             char **value, size_t *value_len) {
-    if (!client || !key || !value || !value_len || key_len > RIOC_MAX_KEY_SIZE) {
+// Memory accounting
+int rioc_client_memory_usage(const struct rioc_client *client, rioc_memory_usage *usage) {
+    if (!client || !usage) {
         return RIOC_ERR_PARAM;
     }
-    
-    // Send GET operation
-    int ret = send_op(client, RIOC_CMD_GET, key, key_len, NULL, 0, 0);
-    if (ret != RIOC_SUCCESS) {
+
+    usage->allocated = sizeof(struct rioc_client);
+    usage->allocations = 1;
+    if (client->tls) {
+        usage->allocated += sizeof(struct rioc_tls_context);
+        usage->allocations++;
+    }
+    usage->in_use = usage->allocated;
+    return RIOC_SUCCESS;
+}
+
+int rioc_batch_memory_usage(const struct rioc_batch *batch, rioc_memory_usage *usage) {
+    if (!batch || !usage) {
+        return RIOC_ERR_PARAM;
+    }
+
+    usage->allocated = sizeof(struct rioc_batch) + batch->value_buffer_size;
+    usage->allocations = 2;
+    usage->in_use = sizeof(struct rioc_batch);
+    for (size_t i = 0; i < batch->count; i++) {
+        const struct rioc_batch_op *op = &batch->ops[i];
+        if (op->value_ptr && batch_owns_value(batch, op->value_ptr)) {
+            usage->in_use += op->header.value_len;
+        }
+    }
+    return RIOC_SUCCESS;
+}
+
+int rioc_batch_tracker_memory_usage(struct rioc_batch_tracker *tracker, rioc_memory_usage *usage) {
+    if (!tracker || !usage) {
+        return RIOC_ERR_PARAM;
+    }
+
+    usage->allocated = sizeof(struct rioc_batch_tracker);
+    usage->in_use = sizeof(struct rioc_batch_tracker);
+    usage->allocations = 1;
+
+    if (tracker->packed) {
+        usage->allocated += tracker->packed_len;
+        usage->in_use += tracker->packed_len;
+        usage->allocations++;
+    }
+
+    // Only responses published by the response thread are safe to inspect
+    struct rioc_batch *batch = tracker->batch;
+    size_t received = atomic_load_explicit(&tracker->responses_received, memory_order_acquire);
+    for (size_t i = 0; i < received && i < batch->count; i++) {
+        struct rioc_batch_op *op = &batch->ops[i];
+        if (!op->value_ptr || batch_owns_value(batch, op->value_ptr)) {
+            continue;
+        }
+        if (op->header.command == RIOC_CMD_RANGE_QUERY) {
+            struct rioc_range_result *results = (struct rioc_range_result *)op->value_ptr;
+            size_t count = op->response.value_len;
+            usage->allocated += count * sizeof(struct rioc_range_result);
+            usage->in_use += count * sizeof(struct rioc_range_result);
+            usage->allocations += 1 + 2 * count;
+            for (size_t j = 0; j < count; j++) {
+                usage->allocated += results[j].key_len + 1 + results[j].value_len + 1;
+                usage->in_use += results[j].key_len + results[j].value_len;
+            }
+        } else {
+            usage->allocated += op->response.value_len + 1;
+            usage->in_use += op->response.value_len;
+            usage->allocations++;
+        }
+    }
+    return RIOC_SUCCESS;
+}
+
+// Single operation functions
+int rioc_get(struct rioc_client *client, const char *key, size_t key_len,
+             char **value, size_t *value_len) {
+    if (!client || !key || !value || !value_len || key_len > RIOC_MAX_KEY_SIZE) {
+        return RIOC_ERR_PARAM;
+    }
+    
+    // Send GET operation
+    int ret = send_op(client, RIOC_CMD_GET, key, key_len, NULL, 0, 0);
+    if (ret != RIOC_SUCCESS) {
         return ret;
     }
     
@@ -1069,18 +1290,9 @@ int rioc_delete(struct rioc_client *client, const char *key, size_t key_len, uin
 }
 
 // Range query implementation
-int rioc_range_query(struct rioc_client *client, const char *start_key, size_t start_key_len,
-                    const char *end_key, size_t end_key_len, 
-                    struct rioc_range_result **results, size_t *result_count) {
-    if (!client || !start_key || !end_key || !results || !result_count || 
-        start_key_len > RIOC_MAX_KEY_SIZE || end_key_len > RIOC_MAX_KEY_SIZE) {
-        return RIOC_ERR_PARAM;
-    }
-    
-    // Initialize result count
-    *result_count = 0;
-    *results = NULL;
-    
+// Send a range query and receive its response header; the rows follow on the connection
+static int range_query_request(struct rioc_client *client, const char *start_key, size_t start_key_len,
+                               const char *end_key, size_t end_key_len, size_t *count) {
     // Use vectored I/O for better performance
     struct iovec iovs[4];  // batch_header + op_header + start_key + end_key
     int iov_count = 0;
@@ -1150,7 +1362,7 @@ int rioc_range_query(struct rioc_client *client, const char *start_key, size_t s
     if (client->tls) {
         n = rioc_tls_read(client->tls, &response, sizeof(response));
     } else {
-        n = rioc_recv(client->fd, &response, sizeof(response), 0);
+        n = recv_exact(client->fd, &response, sizeof(response));
     }
     if (n != sizeof(response)) {
         return RIOC_ERR_IO;
@@ -1161,8 +1373,27 @@ int rioc_range_query(struct rioc_client *client, const char *start_key, size_t s
         return (int32_t)response.status;
     }
     
-    // Get result count
-    size_t count = response.value_len;
+    *count = response.value_len;
+    return RIOC_SUCCESS;
+}
+
+int rioc_range_query(struct rioc_client *client, const char *start_key, size_t start_key_len,
+                    const char *end_key, size_t end_key_len, 
+                    struct rioc_range_result **results, size_t *result_count) {
+    if (!client || !start_key || !end_key || !results || !result_count || 
+        start_key_len > RIOC_MAX_KEY_SIZE || end_key_len > RIOC_MAX_KEY_SIZE) {
+        return RIOC_ERR_PARAM;
+    }
+    
+    // Initialize result count
+    *result_count = 0;
+    *results = NULL;
+    
+    size_t count;
+    int ret = range_query_request(client, start_key, start_key_len, end_key, end_key_len, &count);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
     *result_count = count;
     
     if (count == 0) {
@@ -1170,145 +1401,384 @@ int rioc_range_query(struct rioc_client *client, const char *start_key, size_t s
         return RIOC_SUCCESS;
     }
     
-    // Allocate result array
-    *results = malloc(count * sizeof(struct rioc_range_result));
-    if (!*results) {
-        return RIOC_ERR_MEM;
-    }
-    memset(*results, 0, count * sizeof(struct rioc_range_result));
-    
-    // Allocate buffer for results
-    size_t buffer_size = RIOC_MAX_VALUE_SIZE * 10;  // 10MB max
-    char *buffer = malloc(buffer_size);
-    if (!buffer) {
-        free(*results);
+    // Receive result rows
+    ret = recv_range_results(client, count, results);
+    if (ret != RIOC_SUCCESS) {
         *results = NULL;
         *result_count = 0;
-        return RIOC_ERR_MEM;
+        return ret;
     }
     
-    // Receive results
-    size_t total_received = 0;
-    size_t offset = 0;
+    return RIOC_SUCCESS;
+}
+
+// Free range query results
+void rioc_free_range_results(struct rioc_range_result *results, size_t count) {
+    if (!results) {
+        return;
+    }
     
-    // Calculate total size to receive
     for (size_t i = 0; i < count; i++) {
+        rioc_value_free(results[i].key);
+        rioc_value_free(results[i].value);
+    }
+    
+    rioc_value_free(results);
+}
+
+// Append len bytes read from the connection to a growable column
+static int recv_column_bytes(struct rioc_client *client, char **data, size_t *capacity,
+                             int64_t used, size_t len) {
+    if ((size_t)used + len > *capacity) {
+        size_t new_capacity = *capacity ? *capacity : 4096;
+        while ((size_t)used + len > new_capacity) {
+            new_capacity *= 2;
+        }
+        char *grown = rioc_value_realloc(*data, new_capacity);
+        if (!grown) {
+            return RIOC_ERR_MEM;
+        }
+        *data = grown;
+        *capacity = new_capacity;
+    }
+    if (len > 0 && client_read(client, *data + used, len) != (ssize_t)len) {
+        return RIOC_ERR_IO;
+    }
+    return RIOC_SUCCESS;
+}
+
+int rioc_range_query_columns(struct rioc_client *client,
+                             const char *start_key, size_t start_key_len,
+                             const char *end_key, size_t end_key_len,
+                             struct rioc_range_columns *columns) {
+    if (!client || !start_key || !end_key || !columns ||
+        start_key_len > RIOC_MAX_KEY_SIZE || end_key_len > RIOC_MAX_KEY_SIZE) {
+        return RIOC_ERR_PARAM;
+    }
+    memset(columns, 0, sizeof(*columns));
+
+    size_t count;
+    int ret = range_query_request(client, start_key, start_key_len, end_key, end_key_len, &count);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+
+    columns->key_offsets = rioc_value_alloc((count + 1) * sizeof(int64_t));
+    columns->value_offsets = rioc_value_alloc((count + 1) * sizeof(int64_t));
+    if (!columns->key_offsets || !columns->value_offsets) {
+        // The rows are still on the connection, which is unusable from here on
+        rioc_free_range_columns(columns);
+        return RIOC_ERR_MEM;
+    }
+    columns->key_offsets[0] = 0;
+    columns->value_offsets[0] = 0;
+
+    size_t key_capacity = 0, value_capacity = 0;
+    for (size_t i = 0; i < count && ret == RIOC_SUCCESS; i++) {
         uint16_t key_len;
         size_t value_len;
-        
-        // Receive key length
-        if (client->tls) {
-            n = rioc_tls_read(client->tls, buffer + offset, sizeof(uint16_t));
-        } else {
-            n = rioc_recv(client->fd, buffer + offset, sizeof(uint16_t), 0);
+
+        if (client_read(client, &key_len, sizeof(key_len)) != sizeof(key_len)) {
+            ret = RIOC_ERR_IO;
+            break;
         }
-        if (n != sizeof(uint16_t)) {
-            free(buffer);
-            rioc_free_range_results(*results, i);
-            *results = NULL;
-            *result_count = 0;
-            return RIOC_ERR_IO;
+        ret = recv_column_bytes(client, &columns->key_data, &key_capacity,
+                                columns->key_offsets[i], key_len);
+        if (ret != RIOC_SUCCESS) {
+            break;
         }
-        
-        memcpy(&key_len, buffer + offset, sizeof(uint16_t));
-        offset += sizeof(uint16_t);
-        
-        // Receive key
-        if (client->tls) {
-            n = rioc_tls_read(client->tls, buffer + offset, key_len);
-        } else {
-            n = rioc_recv(client->fd, buffer + offset, key_len, 0);
+        columns->key_offsets[i + 1] = columns->key_offsets[i] + key_len;
+
+        if (client_read(client, &value_len, sizeof(value_len)) != sizeof(value_len)) {
+            ret = RIOC_ERR_IO;
+            break;
         }
-        if (n != key_len) {
-            free(buffer);
-            rioc_free_range_results(*results, i);
-            *results = NULL;
-            *result_count = 0;
-            return RIOC_ERR_IO;
+        if (value_len > RIOC_MAX_VALUE_SIZE) {
+            ret = RIOC_ERR_PROTO;
+            break;
         }
-        
-        // Allocate and copy key
-        (*results)[i].key = malloc(key_len + 1);
-        if (!(*results)[i].key) {
-            free(buffer);
-            rioc_free_range_results(*results, i);
-            *results = NULL;
-            *result_count = 0;
+        ret = recv_column_bytes(client, &columns->value_data, &value_capacity,
+                                columns->value_offsets[i], value_len);
+        columns->value_offsets[i + 1] = columns->value_offsets[i] + value_len;
+    }
+
+    if (ret != RIOC_SUCCESS) {
+        rioc_free_range_columns(columns);
+        return ret;
+    }
+    columns->count = count;
+    return RIOC_SUCCESS;
+}
+
+void rioc_free_range_columns(struct rioc_range_columns *columns) {
+    if (!columns) {
+        return;
+    }
+    rioc_value_free(columns->key_offsets);
+    rioc_value_free(columns->key_data);
+    rioc_value_free(columns->value_offsets);
+    rioc_value_free(columns->value_data);
+    memset(columns, 0, sizeof(*columns));
+}
+
+// Streaming range query: rows stay on the connection until rioc_range_cursor_next reads them
+struct rioc_range_cursor {
+    struct rioc_client *client;
+    size_t remaining;       // Rows announced by the server and not yet read
+    char *buffer;           // Current row's key and value, each NUL-terminated
+    size_t capacity;
+    uint32_t buffer_flags;  // RIOC_CLIENT_* placement of buffer
+    atomic_bool cancelled;
+};
+
+// Largest row a cursor buffer holds
+#define CURSOR_BUFFER_SIZE (RIOC_MAX_KEY_SIZE + 1 + RIOC_MAX_VALUE_SIZE + 1)
+
+// Only placed buffers come from rioc_buffer_alloc; the others are grown with realloc
+static void cursor_buffer_free(struct rioc_range_cursor *cursor) {
+    if (cursor->buffer_flags) {
+        rioc_buffer_free(cursor->buffer, cursor->capacity, cursor->buffer_flags);
+    } else {
+        free(cursor->buffer);
+    }
+}
+
+int rioc_range_cursor_open(struct rioc_client *client,
+                           const char *start_key, size_t start_key_len,
+                           const char *end_key, size_t end_key_len,
+                           struct rioc_range_cursor **cursor) {
+    if (!client || !start_key || !end_key || !cursor ||
+        start_key_len > RIOC_MAX_KEY_SIZE || end_key_len > RIOC_MAX_KEY_SIZE) {
+        return RIOC_ERR_PARAM;
+    }
+    *cursor = NULL;
+
+    struct rioc_range_cursor *c = calloc(1, sizeof(*c));
+    if (!c) {
+        return RIOC_ERR_MEM;
+    }
+    c->client = client;
+    atomic_init(&c->cancelled, false);
+
+    // A buffer on the client's NUMA node is sized for the largest row up front, since
+    // placed memory is not grown with realloc. Huge pages would mostly go unused.
+    if (client->flags & RIOC_CLIENT_PIN_CPU) {
+        c->buffer_flags = RIOC_CLIENT_PIN_CPU;
+        c->capacity = CURSOR_BUFFER_SIZE;
+        c->buffer = rioc_buffer_alloc(&c->capacity, c->buffer_flags, client->cpu);
+        if (!c->buffer) {
+            free(c);
             return RIOC_ERR_MEM;
         }
-        
-        memcpy((*results)[i].key, buffer + offset, key_len);
-        (*results)[i].key[key_len] = '\0';
-        (*results)[i].key_len = key_len;
-        offset += key_len;
-        
-        // Receive value length
-        if (client->tls) {
-            n = rioc_tls_read(client->tls, buffer + offset, sizeof(size_t));
-        } else {
-            n = rioc_recv(client->fd, buffer + offset, sizeof(size_t), 0);
+    }
+
+    int ret = range_query_request(client, start_key, start_key_len, end_key, end_key_len, &c->remaining);
+    if (ret != RIOC_SUCCESS) {
+        cursor_buffer_free(c);
+        free(c);
+        return ret;
+    }
+
+    *cursor = c;
+    return RIOC_SUCCESS;
+}
+
+int rioc_range_cursor_next(struct rioc_range_cursor *cursor, struct rioc_range_result *row) {
+    if (!cursor || !row) {
+        return RIOC_ERR_PARAM;
+    }
+    if (atomic_load_explicit(&cursor->cancelled, memory_order_acquire)) {
+        return RIOC_ERR_IO;
+    }
+    if (cursor->remaining == 0) {
+        return RIOC_ERR_NOENT;
+    }
+
+    struct rioc_client *client = cursor->client;
+    uint16_t key_len;
+    size_t value_len;
+
+    if (client_read(client, &key_len, sizeof(key_len)) != sizeof(key_len)) {
+        return RIOC_ERR_IO;
+    }
+    if (key_len > RIOC_MAX_KEY_SIZE) {
+        return RIOC_ERR_PROTO;
+    }
+    // The value length follows the key, so size the buffer for the largest value up front
+    size_t needed = (size_t)key_len + 1 + RIOC_MAX_VALUE_SIZE + 1;
+    if (needed > cursor->capacity) {
+        char *grown = realloc(cursor->buffer, needed);
+        if (!grown) {
+            return RIOC_ERR_MEM;
         }
-        if (n != sizeof(size_t)) {
-            free(buffer);
-            rioc_free_range_results(*results, i + 1);
-            *results = NULL;
-            *result_count = 0;
+        cursor->buffer = grown;
+        cursor->capacity = needed;
+    }
+    if (client_read(client, cursor->buffer, key_len) != key_len) {
+        return RIOC_ERR_IO;
+    }
+    cursor->buffer[key_len] = '\0';
+
+    if (client_read(client, &value_len, sizeof(value_len)) != sizeof(value_len)) {
+        return RIOC_ERR_IO;
+    }
+    if (value_len > RIOC_MAX_VALUE_SIZE) {
+        return RIOC_ERR_PROTO;
+    }
+    char *value = cursor->buffer + key_len + 1;
+    if (value_len > 0 && client_read(client, value, value_len) != (ssize_t)value_len) {
+        return RIOC_ERR_IO;
+    }
+    value[value_len] = '\0';
+
+    cursor->remaining--;
+    row->key = cursor->buffer;
+    row->key_len = key_len;
+    row->value = value;
+    row->value_len = value_len;
+    return RIOC_SUCCESS;
+}
+
+size_t rioc_range_cursor_remaining(const struct rioc_range_cursor *cursor) {
+    return cursor ? cursor->remaining : 0;
+}
+
+void rioc_range_cursor_cancel(struct rioc_range_cursor *cursor) {
+    if (!cursor || atomic_exchange_explicit(&cursor->cancelled, true, memory_order_acq_rel)) {
+        return;
+    }
+    // The protocol has no cancel request; shutting the connection down makes the
+    // server's next send fail, which ends the scan on its side, and wakes up a
+    // rioc_range_cursor_next blocked in a read
+    rioc_socket_shutdown(cursor->client->fd);
+}
+
+int rioc_range_cursor_close(struct rioc_range_cursor *cursor) {
+    if (!cursor) {
+        return RIOC_ERR_PARAM;
+    }
+
+    // Discard unread rows so the next request on the client reads its own response
+    int ret = RIOC_SUCCESS;
+    struct rioc_range_result row;
+    while (!atomic_load_explicit(&cursor->cancelled, memory_order_acquire) && cursor->remaining > 0) {
+        ret = rioc_range_cursor_next(cursor, &row);
+        if (ret != RIOC_SUCCESS) {
+            break;
+        }
+    }
+    if (atomic_load_explicit(&cursor->cancelled, memory_order_acquire)) {
+        ret = RIOC_ERR_IO;
+    }
+
+    cursor_buffer_free(cursor);
+    free(cursor);
+    return ret;
+}
+
+// Read the response headers of a sent batch of INSERTs; returns the first failed status
+// and its index, or RIOC_SUCCESS
+static int recv_insert_statuses(struct rioc_batch *batch, size_t *failed) {
+    for (size_t i = 0; i < batch->count; i++) {
+        struct rioc_response_header response;
+        if (client_read(batch->client, &response, sizeof(response)) != sizeof(response)) {
+            *failed = i;
             return RIOC_ERR_IO;
         }
-        
-        memcpy(&value_len, buffer + offset, sizeof(size_t));
-        offset += sizeof(size_t);
-        
-        // Receive value
-        if (client->tls) {
-            n = rioc_tls_read(client->tls, buffer + offset, value_len);
-        } else {
-            n = rioc_recv(client->fd, buffer + offset, value_len, 0);
+        if ((int32_t)response.status != RIOC_SUCCESS) {
+            // Later responses are left unread, the connection is not reused after a failure
+            *failed = i;
+            return (int32_t)response.status;
         }
-        if (n != value_len) {
-            free(buffer);
-            rioc_free_range_results(*results, i + 1);
-            *results = NULL;
-            *result_count = 0;
-            return RIOC_ERR_IO;
+    }
+    return RIOC_SUCCESS;
+}
+
+// Fill a batch with INSERTs of items [first, first + batch size) of the columns
+static int fill_insert_batch(struct rioc_batch *batch, size_t first, size_t count,
+                             const int64_t *key_offsets, const char *key_data,
+                             const int64_t *value_offsets, const char *value_data,
+                             uint64_t timestamp) {
+    batch->count = 0;
+    for (size_t i = first; i < count && batch->count < RIOC_MAX_BATCH_SIZE; i++) {
+        int64_t key_len = key_offsets[i + 1] - key_offsets[i];
+        int64_t value_len = value_offsets[i + 1] - value_offsets[i];
+        if (key_len < 0 || value_len < 0) {
+            return RIOC_ERR_PARAM;
         }
-        
-        // Allocate and copy value
-        (*results)[i].value = malloc(value_len + 1);
-        if (!(*results)[i].value) {
-            free(buffer);
-            rioc_free_range_results(*results, i + 1);
-            *results = NULL;
-            *result_count = 0;
-            return RIOC_ERR_MEM;
+        int ret = rioc_batch_add_insert(batch, key_data + key_offsets[i], (size_t)key_len,
+                                        value_data + value_offsets[i], (size_t)value_len, timestamp);
+        if (ret != RIOC_SUCCESS) {
+            return ret;
         }
-        
-        memcpy((*results)[i].value, buffer + offset, value_len);
-        (*results)[i].value[value_len] = '\0';
-        (*results)[i].value_len = value_len;
-        offset += value_len;
     }
-    
-    free(buffer);
     return RIOC_SUCCESS;
 }
 
-// Free range query results
-void rioc_free_range_results(struct rioc_range_result *results, size_t count) {
-    if (!results) {
-        return;
+int rioc_insert_bulk(struct rioc_client *client, size_t count,
+                     const int64_t *key_offsets, const char *key_data,
+                     const int64_t *value_offsets, const char *value_data,
+                     uint64_t timestamp, size_t *inserted) {
+    if (!client || !key_offsets || !value_offsets || !inserted ||
+        (count > 0 && (!key_data || !value_data))) {
+        return RIOC_ERR_PARAM;
     }
-    
-    for (size_t i = 0; i < count; i++) {
-        if (results[i].key) {
-            free(results[i].key);
+    *inserted = 0;
+    if (count == 0) {
+        return RIOC_SUCCESS;
+    }
+
+    // Two batches alternate: one is filled and sent while the other's responses are read
+    struct rioc_batch *batches[2] = {rioc_batch_create(client), rioc_batch_create(client)};
+    if (!batches[0] || !batches[1]) {
+        rioc_batch_free(batches[0]);
+        rioc_batch_free(batches[1]);
+        return RIOC_ERR_MEM;
+    }
+
+    size_t sent = 0;        // Items sent
+    size_t done = 0;        // Items acknowledged
+    size_t in_flight = 0;   // Batches sent and not yet acknowledged, oldest is batches[done_index]
+    size_t done_index = 0;
+    int ret = RIOC_SUCCESS;
+
+    while (done < count) {
+        // Keep both batches in flight while items remain
+        while (ret == RIOC_SUCCESS && in_flight < 2 && sent < count) {
+            struct rioc_batch *batch = batches[(done_index + in_flight) % 2];
+            ret = fill_insert_batch(batch, sent, count, key_offsets, key_data,
+                                    value_offsets, value_data, timestamp);
+            if (ret == RIOC_SUCCESS) {
+                ret = batch_send(batch);
+            }
+            if (ret == RIOC_SUCCESS) {
+                sent += batch->count;
+                in_flight++;
+            }
         }
-        if (results[i].value) {
-            free(results[i].value);
+        // After a failed fill or send, batches already in flight are still acknowledged
+        if (in_flight == 0) {
+            break;
         }
+
+        // Responses arrive in order, so the oldest batch completes first
+        struct rioc_batch *batch = batches[done_index];
+        size_t failed = 0;
+        int status = recv_insert_statuses(batch, &failed);
+        if (status != RIOC_SUCCESS) {
+            done += failed;
+            ret = status;
+            break;
+        }
+        done += batch->count;
+        done_index = (done_index + 1) % 2;
+        in_flight--;
     }
-    
-    free(results);
+
+    rioc_batch_free(batches[0]);
+    rioc_batch_free(batches[1]);
+    *inserted = done;
+    return ret;
 }
 
 int rioc_atomic_inc_dec(struct rioc_client *client, const char *key, size_t key_len,
@@ -1336,53 +1806,33 @@ int rioc_atomic_inc_dec(struct rioc_client *client, const char *key, size_t key_
 
     // Check response status
     if (response.status != RIOC_SUCCESS) {
-        if (value) free(value);
+        rioc_value_free(value);
         return response.status;
     }
 
     // Extract result from response
     if (value_len != sizeof(int64_t)) {
-        if (value) free(value);
+        rioc_value_free(value);
         return RIOC_ERR_PROTO;
     }
 
     memcpy(result, value, sizeof(int64_t));
-    free(value);
+    rioc_value_free(value);
 
     return RIOC_SUCCESS;
 }
 
-int rioc_client_connect_with_config(rioc_client_config* config, struct rioc_client** client) {
-    if (!config || !config->host || config->port <= 0 || !client) {
-        return RIOC_ERR_PARAM;
-    }
-
-    // Allocate client structure
-    *client = malloc(sizeof(struct rioc_client));
-    if (!*client) {
-        return RIOC_ERR_MEM;
-    }
-    memset(*client, 0, sizeof(struct rioc_client));
-
-    // Initialize platform
-    int ret = rioc_platform_init();
-    if (ret != 0) {
-        free(*client);
-        return RIOC_ERR_IO;
-    }
-
+static rioc_socket_t connect_tcp(const char *host, uint32_t port) {
     // Create socket
-    (*client)->fd = rioc_socket_create();
-    if ((*client)->fd == RIOC_INVALID_SOCKET) {
-        free(*client);
-        return RIOC_ERR_IO;
+    rioc_socket_t fd = rioc_socket_create();
+    if (fd == RIOC_INVALID_SOCKET) {
+        return RIOC_INVALID_SOCKET;
     }
 
     // Set socket options
-    if (rioc_set_socket_options((*client)->fd) != 0) {
-        rioc_socket_close((*client)->fd);
-        free(*client);
-        return RIOC_ERR_IO;
+    if (rioc_set_socket_options(fd) != 0) {
+        rioc_socket_close(fd);
+        return RIOC_INVALID_SOCKET;
     }
 
     // Set up address resolution hints
@@ -1392,26 +1842,63 @@ int rioc_client_connect_with_config(rioc_client_config* config, struct rioc_clie
     hints.ai_socktype = SOCK_STREAM;
 
     // Convert port to string for getaddrinfo
-    char port_str[8];
-    snprintf(port_str, sizeof(port_str), "%d", config->port);
+    char port_str[12];
+    snprintf(port_str, sizeof(port_str), "%u", port);
 
     // Resolve address
-    ret = getaddrinfo(config->host, port_str, &hints, &result);
-    if (ret != 0) {
-        rioc_socket_close((*client)->fd);
-        free(*client);
-        return RIOC_ERR_IO;
+    if (getaddrinfo(host, port_str, &hints, &result) != 0) {
+        rioc_socket_close(fd);
+        return RIOC_INVALID_SOCKET;
     }
 
     // Connect to server
-    if (connect((*client)->fd, result->ai_addr, result->ai_addrlen) < 0) {
+    if (connect(fd, result->ai_addr, result->ai_addrlen) < 0) {
         freeaddrinfo(result);
-        rioc_socket_close((*client)->fd);
+        rioc_socket_close(fd);
+        return RIOC_INVALID_SOCKET;
+    }
+
+    freeaddrinfo(result);
+    return fd;
+}
+
+int rioc_client_connect_with_config(rioc_client_config* config, struct rioc_client** client) {
+    return rioc_client_connect_with_session(config, NULL, client);
+}
+
+int rioc_client_connect_with_session(rioc_client_config* config, rioc_tls_session* session,
+                                     struct rioc_client** client) {
+    if (!config || !config->host || (config->host[0] != '/' && config->port <= 0) || !client ||
+        ((config->flags & RIOC_CLIENT_PIN_CPU) && config->cpu < 0)) {
+        return RIOC_ERR_PARAM;
+    }
+
+    // Allocate client structure
+    *client = malloc(sizeof(struct rioc_client));
+    if (!*client) {
+        return RIOC_ERR_MEM;
+    }
+    memset(*client, 0, sizeof(struct rioc_client));
+    (*client)->flags = config->flags;
+    (*client)->cpu = config->cpu;
+
+    // Initialize platform
+    int ret = rioc_platform_init();
+    if (ret != 0) {
         free(*client);
         return RIOC_ERR_IO;
     }
 
-    freeaddrinfo(result);
+    // A host that is a path names a Unix domain socket, such as a local rioc_proxy
+    if (config->host[0] == '/') {
+        (*client)->fd = rioc_unix_socket_connect(config->host);
+    } else {
+        (*client)->fd = connect_tcp(config->host, config->port);
+    }
+    if ((*client)->fd == RIOC_INVALID_SOCKET) {
+        free(*client);
+        return RIOC_ERR_IO;
+    }
 
     // Initialize TLS if configured
     if (config->tls) {
@@ -1430,6 +1917,8 @@ int rioc_client_connect_with_config(rioc_client_config* config, struct rioc_clie
             return ret;
         }
 
+        (*client)->tls->session = (SSL_SESSION *)session;
+
         ret = rioc_tls_client_connect((*client)->tls, (*client)->fd, config->host);
         if (ret != RIOC_SUCCESS) {
             rioc_tls_client_ctx_free((*client)->tls);
@@ -1438,6 +1927,14 @@ int rioc_client_connect_with_config(rioc_client_config* config, struct rioc_clie
             free(*client);
             return ret;
         }
+        (*client)->tls->session = NULL;  // Not owned past the handshake
+    }
+
+    // After the handshake, which expects a blocking socket
+    if ((config->flags & RIOC_CLIENT_BUSY_POLL) && rioc_enable_busy_poll((*client)->fd) < 0) {
+        rioc_client_disconnect_with_config(*client);
+        *client = NULL;
+        return RIOC_ERR_IO;
     }
 
     return RIOC_SUCCESS;
@@ -1454,4 +1951,32 @@ void rioc_client_disconnect_with_config(struct rioc_client* client) {
         }
         free(client);
     }
-}
\ No newline at end of file
+}
+
+rioc_tls_session* rioc_client_get_tls_session(struct rioc_client* client) {
+    if (!client || !client->tls || !client->tls->ssl) {
+        return NULL;
+    }
+
+    // SSL_get1_session returns the latest ticket received; under TLS 1.3 that is only
+    // resumable once the server's NewSessionTicket has been read with the first response
+    SSL_SESSION *session = SSL_get1_session(client->tls->ssl);
+    if (session && !SSL_SESSION_is_resumable(session)) {
+        SSL_SESSION_free(session);
+        return NULL;
+    }
+    return (rioc_tls_session *)session;
+}
+
+bool rioc_client_tls_session_reused(struct rioc_client* client) {
+    if (!client || !client->tls || !client->tls->ssl) {
+        return false;
+    }
+    return SSL_session_reused(client->tls->ssl) == 1;
+}
+
+void rioc_tls_session_free(rioc_tls_session* session) {
+    if (session) {
+        SSL_SESSION_free((SSL_SESSION *)session);
+    }
+}
@@ -0,0 +1,304 @@
+// Coroutine concurrency benchmark
+//
+// Each thread owns one async_client and keeps N coroutines waiting on it, each doing
+// insert/get round trips. N steps up by powers of ten to max_outstanding, showing how
+// throughput scales with waiting operations when no thread parks per request. Waiting
+// is not the same as on the connection: the engine queues operations and pipelines at
+// most a few batches of RIOC_MAX_BATCH_SIZE, so the report gives both figures.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+#include <inttypes.h>
+#include "rioc.hpp"
+
+#define CORO_MAX_THREADS 64
+#define CORO_OPS_PER_LEVEL 200000   // Target ops per thread at each concurrency level
+
+// Starts a task without awaiting it and reports when it finishes
+struct detached {
+    struct promise_type {
+        detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+struct countdown {
+    std::atomic<size_t> left{0};
+    std::binary_semaphore zero{0};
+
+    void arrive() {
+        if (left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            zero.release();
+        }
+    }
+};
+
+static detached spawn(rioc::task<void> t, countdown &done) {
+    co_await t;
+    done.arrive();
+}
+
+// Single-threaded executor: the I/O thread posts completions and the benchmark thread
+// resumes them, as an event loop in a coroutine server would
+class loop_executor {
+public:
+    void post(std::coroutine_handle<> h) {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            ready_.push_back(h);
+        }
+        cond_.notify_one();
+    }
+
+    void run_until(const countdown &done) {
+        std::deque<std::coroutine_handle<>> batch;
+        while (done.left.load(std::memory_order_acquire) != 0) {
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                cond_.wait(guard, [this] { return !ready_.empty(); });
+                batch.swap(ready_);
+            }
+            for (std::coroutine_handle<> h : batch) {
+                h.resume();
+            }
+            batch.clear();
+        }
+    }
+
+private:
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::deque<std::coroutine_handle<>> ready_;
+};
+
+struct thread_stats {
+    std::vector<uint32_t> latencies_ns;
+    std::atomic<size_t> samples{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<size_t> in_flight{0};
+    std::atomic<size_t> peak_in_flight{0};
+};
+
+static void enter(thread_stats &stats) {
+    size_t now = stats.in_flight.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = stats.peak_in_flight.load(std::memory_order_relaxed);
+    while (now > peak && !stats.peak_in_flight.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+static void leave(thread_stats &stats, uint64_t start_ns, bool ok) {
+    stats.in_flight.fetch_sub(1, std::memory_order_relaxed);
+    uint64_t elapsed = rioc::timestamp() - start_ns;
+    size_t i = stats.samples.fetch_add(1, std::memory_order_relaxed);
+    if (i < stats.latencies_ns.size()) {
+        stats.latencies_ns[i] = static_cast<uint32_t>(std::min<uint64_t>(elapsed, UINT32_MAX));
+    }
+    if (!ok) {
+        stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static rioc::task<void> worker(rioc::async_client &client, thread_stats &stats, int thread_id,
+                               size_t index, size_t rounds, const std::string &value) {
+    char key[48];
+    int key_len = snprintf(key, sizeof(key), "coro:%d:%zu", thread_id, index);
+    rioc::bytes k(reinterpret_cast<const std::byte *>(key), static_cast<size_t>(key_len));
+
+    for (size_t r = 0; r < rounds; r++) {
+        uint64_t start = rioc::timestamp();
+        enter(stats);
+        rioc::status inserted = co_await client.insert(k, rioc::bytes_of(value), start);
+        leave(stats, start, inserted.ok());
+
+        start = rioc::timestamp();
+        enter(stats);
+        auto got = co_await client.get(k);
+        leave(stats, start, got.ok() && got->size() == value.size());
+    }
+}
+
+struct level_result {
+    uint64_t ops;
+    uint64_t errors;
+    uint64_t elapsed_ns;
+    size_t peak_in_flight;
+    size_t peak_on_wire;        // Most ops the engine had sent and not yet completed
+    std::vector<uint32_t> latencies_ns;
+};
+
+struct thread_context {
+    int thread_id;
+    const char *host;
+    int port;
+    size_t outstanding;
+    bool loop;
+    const std::string *value;
+    level_result result;
+    int error;
+};
+
+static void run_level(thread_context *ctx) {
+    auto connected = rioc::client::connect(ctx->host, ctx->port);
+    if (!connected) {
+        ctx->error = connected.code();
+        return;
+    }
+
+    loop_executor loop;
+    auto async = rioc::async_client::create(std::move(connected).value(),
+                                            ctx->loop ? rioc::executor::from(loop) : rioc::executor());
+    if (!async) {
+        ctx->error = async.code();
+        return;
+    }
+
+    size_t rounds = std::max<size_t>(1, CORO_OPS_PER_LEVEL / (2 * ctx->outstanding));
+    thread_stats stats;
+    stats.latencies_ns.resize(2 * rounds * ctx->outstanding);
+
+    countdown done;
+    done.left.store(ctx->outstanding, std::memory_order_relaxed);
+    uint64_t start = rioc::timestamp();
+    for (size_t i = 0; i < ctx->outstanding; i++) {
+        spawn(worker(*async, stats, ctx->thread_id, i, rounds, *ctx->value), done);
+    }
+    if (ctx->loop) {
+        loop.run_until(done);
+    }
+    done.zero.acquire();
+    uint64_t elapsed = rioc::timestamp() - start;
+
+    size_t samples = std::min(stats.samples.load(), stats.latencies_ns.size());
+    stats.latencies_ns.resize(samples);
+    rioc_async_stats engine;
+    rioc_async_get_stats(async->native_handle(), &engine);
+    ctx->result = {samples, stats.errors.load(), elapsed, stats.peak_in_flight.load(),
+                   engine.max_in_flight, std::move(stats.latencies_ns)};
+    ctx->error = 0;
+
+    // Remove the keys with one batch per thread
+    auto cleanup = [](rioc::async_client &client, int thread_id, size_t count) -> rioc::task<void> {
+        std::vector<std::string> keys(count);
+        rioc::async_batch batch = client.make_batch();
+        for (size_t i = 0; i < count; i++) {
+            keys[i] = "coro:" + std::to_string(thread_id) + ":" + std::to_string(i);
+            (void)batch.remove(rioc::bytes_of(keys[i]));
+        }
+        rioc::async_batch_results removed = co_await batch.execute();
+        (void)removed;
+    };
+    if (ctx->loop) {
+        countdown cleaned;
+        cleaned.left.store(1, std::memory_order_relaxed);
+        spawn(cleanup(*async, ctx->thread_id, ctx->outstanding), cleaned);
+        loop.run_until(cleaned);
+        cleaned.zero.acquire();
+    } else {
+        rioc::sync_wait(cleanup(*async, ctx->thread_id, ctx->outstanding));
+    }
+}
+
+static double percentile_us(const std::vector<uint32_t> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t i = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[i] / 1000.0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <host> <port> [threads] [max_outstanding] [value_size] [resume]\n", argv[0]);
+        fprintf(stderr, "  resume is io (on the I/O thread, default) or loop (posted to the benchmark thread)\n");
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int port = atoi(argv[2]);
+    int num_threads = argc > 3 ? atoi(argv[3]) : 1;
+    size_t max_outstanding = argc > 4 ? strtoull(argv[4], nullptr, 10) : 100000;
+    int value_size = argc > 5 ? atoi(argv[5]) : 100;
+    bool loop = argc > 6 && strcmp(argv[6], "loop") == 0;
+
+    if (num_threads < 1 || num_threads > CORO_MAX_THREADS) {
+        fprintf(stderr, "threads must be between 1 and %d\n", CORO_MAX_THREADS);
+        return 1;
+    }
+    if (max_outstanding < 1) {
+        fprintf(stderr, "max_outstanding must be at least 1\n");
+        return 1;
+    }
+    if (value_size < 1 || value_size > RIOC_MAX_VALUE_SIZE) {
+        fprintf(stderr, "value_size must be between 1 and %d\n", RIOC_MAX_VALUE_SIZE);
+        return 1;
+    }
+
+    std::string value(value_size, 'v');
+
+    printf("\nCoroutine Benchmark Configuration:\n");
+    printf("  Host:            %s\n", host);
+    printf("  Port:            %d\n", port);
+    printf("  Threads:         %d (one connection each)\n", num_threads);
+    printf("  Max outstanding: %zu per thread\n", max_outstanding);
+    printf("  Value size:      %d bytes\n", value_size);
+    printf("  Resume on:       %s\n", loop ? "benchmark thread (executor)" : "I/O thread");
+
+    printf("\nINSERT/GET Performance:\n");
+    printf("  %12s %12s %14s %10s %10s %10s %10s %8s\n", "Outstanding", "Ops", "Ops/sec",
+           "p50 (us)", "p99 (us)", "Waiting", "On wire", "Errors");
+
+    std::vector<size_t> levels;
+    for (size_t n = 1; n < max_outstanding; n *= 10) {
+        levels.push_back(n);
+    }
+    levels.push_back(max_outstanding);
+
+    for (size_t outstanding : levels) {
+        std::vector<thread_context> contexts(num_threads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+            contexts[t] = {t, host, port, outstanding, loop, &value, {}, 0};
+            threads.emplace_back(run_level, &contexts[t]);
+        }
+        for (std::thread &t : threads) {
+            t.join();
+        }
+
+        uint64_t ops = 0, errors = 0, elapsed = 0;
+        size_t peak = 0, on_wire = 0;
+        std::vector<uint32_t> latencies;
+        for (thread_context &ctx : contexts) {
+            if (ctx.error != 0) {
+                fprintf(stderr, "Thread %d failed to connect (error code: %d)\n", ctx.thread_id, ctx.error);
+                return 1;
+            }
+            ops += ctx.result.ops;
+            errors += ctx.result.errors;
+            elapsed = std::max(elapsed, ctx.result.elapsed_ns);
+            peak = std::max(peak, ctx.result.peak_in_flight);
+            on_wire = std::max(on_wire, ctx.result.peak_on_wire);
+            latencies.insert(latencies.end(), ctx.result.latencies_ns.begin(), ctx.result.latencies_ns.end());
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        printf("  %12zu %12" PRIu64 " %14.0f %10.1f %10.1f %10zu %10zu %8" PRIu64 "\n", outstanding,
+               ops, elapsed ? ops * 1e9 / elapsed : 0.0, percentile_us(latencies, 0.50),
+               percentile_us(latencies, 0.99), peak, on_wire, errors);
+    }
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+#include <string.h>
+#include "rioc.h"
+
+// Field encodings. Integers are big-endian with the sign bit flipped for signed types.
+// Strings escape 0x00 as 0x00 0xFF and end with 0x00 0x01. Descending fields are the
+// bitwise complement of the ascending encoding. Every field encoding is prefix-free,
+// so concatenated fields compare field by field.
+
+#define KEY_ESCAPE      0xFF
+#define KEY_TERMINATOR  0x01
+
+static inline uint8_t key_flip(int flags) {
+    return (flags & RIOC_KEY_DESC) ? 0xFF : 0x00;
+}
+
+static inline void put_be(char *out, uint64_t value, size_t width, uint8_t flip) {
+    for (size_t i = 0; i < width; i++) {
+        out[i] = (char)((uint8_t)(value >> (8 * (width - 1 - i))) ^ flip);
+    }
+}
+
+static inline uint64_t get_be(const char *in, size_t width, uint8_t flip) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; i++) {
+        value = (value << 8) | (uint8_t)((uint8_t)in[i] ^ flip);
+    }
+    return value;
+}
+
+void rioc_key_init(struct rioc_key_builder *key, char *buf, size_t cap) {
+    if (!key) {
+        return;
+    }
+    key->buf = buf;
+    key->cap = cap;
+    key->len = 0;
+}
+
+static int key_add_int(struct rioc_key_builder *key, uint64_t value, size_t width, int flags) {
+    if (!key || !key->buf) {
+        return RIOC_ERR_PARAM;
+    }
+    if (key->cap - key->len < width) {
+        return RIOC_ERR_OVERFLOW;
+    }
+    put_be(key->buf + key->len, value, width, key_flip(flags));
+    key->len += width;
+    return RIOC_SUCCESS;
+}
+
+int rioc_key_add_u32(struct rioc_key_builder *key, uint32_t value, int flags) {
+    return key_add_int(key, value, sizeof(value), flags);
+}
+
+int rioc_key_add_u64(struct rioc_key_builder *key, uint64_t value, int flags) {
+    return key_add_int(key, value, sizeof(value), flags);
+}
+
+int rioc_key_add_i32(struct rioc_key_builder *key, int32_t value, int flags) {
+    return key_add_int(key, (uint32_t)value ^ 0x80000000u, sizeof(value), flags);
+}
+
+int rioc_key_add_i64(struct rioc_key_builder *key, int64_t value, int flags) {
+    return key_add_int(key, (uint64_t)value ^ 0x8000000000000000ull, sizeof(value), flags);
+}
+
+int rioc_key_add_string(struct rioc_key_builder *key, const char *value, size_t len, int flags) {
+    if (!key || !key->buf || (!value && len > 0)) {
+        return RIOC_ERR_PARAM;
+    }
+
+    size_t zeros = 0;
+    for (size_t i = 0; i < len; i++) {
+        zeros += value[i] == '\0';
+    }
+    if (key->cap - key->len < len + zeros + 2) {
+        return RIOC_ERR_OVERFLOW;
+    }
+
+    uint8_t flip = key_flip(flags);
+    char *out = key->buf + key->len;
+    for (size_t i = 0; i < len; i++) {
+        *out++ = (char)((uint8_t)value[i] ^ flip);
+        if (value[i] == '\0') {
+            *out++ = (char)(KEY_ESCAPE ^ flip);
+        }
+    }
+    *out++ = (char)(0x00 ^ flip);
+    *out++ = (char)(KEY_TERMINATOR ^ flip);
+    key->len = (size_t)(out - key->buf);
+    return RIOC_SUCCESS;
+}
+
+int rioc_key_add_raw(struct rioc_key_builder *key, const char *value, size_t len) {
+    if (!key || !key->buf || (!value && len > 0)) {
+        return RIOC_ERR_PARAM;
+    }
+    if (key->cap - key->len < len) {
+        return RIOC_ERR_OVERFLOW;
+    }
+    if (len > 0) {
+        memcpy(key->buf + key->len, value, len);
+    }
+    key->len += len;
+    return RIOC_SUCCESS;
+}
+
+void rioc_key_reader_init(struct rioc_key_reader *reader, const char *key, size_t len) {
+    if (!reader) {
+        return;
+    }
+    reader->data = key;
+    reader->len = key ? len : 0;
+    reader->pos = 0;
+}
+
+static int key_read_int(struct rioc_key_reader *reader, uint64_t *value, size_t width, int flags) {
+    if (!reader || !value) {
+        return RIOC_ERR_PARAM;
+    }
+    if (reader->len - reader->pos < width) {
+        return RIOC_ERR_PROTO;
+    }
+    *value = get_be(reader->data + reader->pos, width, key_flip(flags));
+    reader->pos += width;
+    return RIOC_SUCCESS;
+}
+
+int rioc_key_read_u32(struct rioc_key_reader *reader, uint32_t *value, int flags) {
+    uint64_t raw = 0;
+    int ret = key_read_int(reader, value ? &raw : NULL, sizeof(*value), flags);
+    if (ret == RIOC_SUCCESS) {
+        *value = (uint32_t)raw;
+    }
+    return ret;
+}
+
+int rioc_key_read_u64(struct rioc_key_reader *reader, uint64_t *value, int flags) {
+    return key_read_int(reader, value, sizeof(*value), flags);
+}
+
+int rioc_key_read_i32(struct rioc_key_reader *reader, int32_t *value, int flags) {
+    uint64_t raw = 0;
+    int ret = key_read_int(reader, value ? &raw : NULL, sizeof(*value), flags);
+    if (ret == RIOC_SUCCESS) {
+        *value = (int32_t)((uint32_t)raw ^ 0x80000000u);
+    }
+    return ret;
+}
+
+int rioc_key_read_i64(struct rioc_key_reader *reader, int64_t *value, int flags) {
+    uint64_t raw = 0;
+    int ret = key_read_int(reader, value ? &raw : NULL, sizeof(*value), flags);
+    if (ret == RIOC_SUCCESS) {
+        *value = (int64_t)(raw ^ 0x8000000000000000ull);
+    }
+    return ret;
+}
+
+int rioc_key_read_string(struct rioc_key_reader *reader, char *out, size_t cap, size_t *len,
+                         int flags) {
+    if (!reader || !len || (!out && cap > 0)) {
+        return RIOC_ERR_PARAM;
+    }
+
+    // Find the terminator and the decoded length before writing anything, so a
+    // failed read leaves the reader where it was
+    uint8_t flip = key_flip(flags);
+    const uint8_t *in = (const uint8_t *)reader->data + reader->pos;
+    size_t avail = reader->len - reader->pos;
+    size_t decoded = 0;
+    size_t end = 0;
+    for (;;) {
+        if (end >= avail) {
+            return RIOC_ERR_PROTO;
+        }
+        if ((uint8_t)(in[end] ^ flip) != 0x00) {
+            decoded++;
+            end++;
+            continue;
+        }
+        if (end + 1 >= avail) {
+            return RIOC_ERR_PROTO;
+        }
+        uint8_t next = in[end + 1] ^ flip;
+        if (next == KEY_TERMINATOR) {
+            break;
+        }
+        if (next != KEY_ESCAPE) {
+            return RIOC_ERR_PROTO;
+        }
+        decoded++;
+        end += 2;
+    }
+
+    *len = decoded;
+    if (decoded > cap) {
+        return RIOC_ERR_OVERFLOW;
+    }
+    for (size_t i = 0; i < end; i++) {
+        uint8_t b = in[i] ^ flip;
+        *out++ = (char)b;
+        if (b == 0x00) {
+            i++;    // Skip the escape byte
+        }
+    }
+    reader->pos += end + 2;
+    return RIOC_SUCCESS;
+}
+
+int rioc_key_prefix_successor(const char *prefix, size_t prefix_len, char *out, size_t *out_len) {
+    if ((!prefix && prefix_len > 0) || !out || !out_len) {
+        return RIOC_ERR_PARAM;
+    }
+
+    size_t len = prefix_len;
+    while (len > 0 && (uint8_t)prefix[len - 1] == 0xFF) {
+        len--;
+    }
+    if (len == 0) {
+        return RIOC_ERR_NOENT;
+    }
+
+    uint8_t last = (uint8_t)prefix[len - 1];
+    if (out != prefix) {
+        memmove(out, prefix, len - 1);
+    }
+    out[len - 1] = (char)(last + 1);
+    *out_len = len;
+    return RIOC_SUCCESS;
+}
+
+// Column encoders. The flip masks are computed once and the byte order is fixed at
+// compile time, so the loop bodies have no branches: when keys hold only the field
+// (stride equal to its width) they vectorize to byte shuffles.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KEY_BSWAP64(v) __builtin_bswap64(v)
+#define KEY_BSWAP32(v) __builtin_bswap32(v)
+#else
+static inline uint64_t key_bswap64(uint64_t v) {
+    v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+}
+
+static inline uint32_t key_bswap32(uint32_t v) {
+    v = ((v & 0x00FF00FFu) << 8) | ((v >> 8) & 0x00FF00FFu);
+    return (v << 16) | (v >> 16);
+}
+#define KEY_BSWAP64(v) key_bswap64(v)
+#define KEY_BSWAP32(v) key_bswap32(v)
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define KEY_TO_BE64(v) (v)
+#define KEY_TO_BE32(v) (v)
+#else
+#define KEY_TO_BE64(v) KEY_BSWAP64(v)
+#define KEY_TO_BE32(v) KEY_BSWAP32(v)
+#endif
+
+static int key_encode_column64(const uint64_t *values, size_t count, uint64_t sign, int flags,
+                               char *out, size_t stride) {
+    if (((!values || !out) && count > 0) || stride < sizeof(uint64_t)) {
+        return RIOC_ERR_PARAM;
+    }
+    uint64_t mask = sign ^ ((flags & RIOC_KEY_DESC) ? ~0ull : 0);
+    if (stride == sizeof(uint64_t)) {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t v = KEY_TO_BE64(values[i] ^ mask);
+            memcpy(out + i * sizeof(v), &v, sizeof(v));
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t v = KEY_TO_BE64(values[i] ^ mask);
+            memcpy(out + i * stride, &v, sizeof(v));
+        }
+    }
+    return RIOC_SUCCESS;
+}
+
+static int key_encode_column32(const uint32_t *values, size_t count, uint32_t sign, int flags,
+                               char *out, size_t stride) {
+    if (((!values || !out) && count > 0) || stride < sizeof(uint32_t)) {
+        return RIOC_ERR_PARAM;
+    }
+    uint32_t mask = sign ^ ((flags & RIOC_KEY_DESC) ? ~0u : 0);
+    if (stride == sizeof(uint32_t)) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t v = KEY_TO_BE32(values[i] ^ mask);
+            memcpy(out + i * sizeof(v), &v, sizeof(v));
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t v = KEY_TO_BE32(values[i] ^ mask);
+            memcpy(out + i * stride, &v, sizeof(v));
+        }
+    }
+    return RIOC_SUCCESS;
+}
+
+int rioc_key_encode_u64s(const uint64_t *values, size_t count, int flags, char *out, size_t stride) {
+    return key_encode_column64(values, count, 0, flags, out, stride);
+}
+
+int rioc_key_encode_i64s(const int64_t *values, size_t count, int flags, char *out, size_t stride) {
+    return key_encode_column64((const uint64_t *)values, count, 0x8000000000000000ull, flags, out, stride);
+}
+
+int rioc_key_encode_u32s(const uint32_t *values, size_t count, int flags, char *out, size_t stride) {
+    return key_encode_column32(values, count, 0, flags, out, stride);
+}
+
+int rioc_key_encode_i32s(const int32_t *values, size_t count, int flags, char *out, size_t stride) {
+    return key_encode_column32((const uint32_t *)values, count, 0x80000000u, flags, out, stride);
+}
+
+int rioc_key_fill_prefix(const char *prefix, size_t prefix_len, size_t count, char *out, size_t stride) {
+    if ((!prefix && prefix_len > 0) || (!out && count > 0) || stride < prefix_len) {
+        return RIOC_ERR_PARAM;
+    }
+    for (size_t i = 0; i < count && prefix_len > 0; i++) {
+        memcpy(out + i * stride, prefix, prefix_len);
+    }
+    return RIOC_SUCCESS;
+}
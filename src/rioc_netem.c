@@ -0,0 +1,563 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// Userspace network impairment proxy for tail-latency testing without root.
+//
+// Sits between a client and a server and forwards each direction through a delay
+// queue. TCP hands the application an in-order byte stream, so reordering and loss
+// surface as head-of-line blocking: a delayed or "lost" segment holds back every
+// byte behind it. The proxy models them exactly that way, by delaying a chunk and
+// keeping delivery in order, rather than by corrupting the stream.
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // SIGPIPE is ignored instead
+#endif
+
+#define NETEM_CHUNK_SIZE 16384
+#define NETEM_MAX_QUEUED (4 * 1024 * 1024)  // Per direction before reads pause
+#define NETEM_NS_PER_MS 1000000ULL
+
+struct netem_options {
+    const char *listen_host;
+    int listen_port;
+    const char *server_host;
+    const char *server_port;
+    uint64_t latency_ns;      // One-way delay added in each direction
+    uint64_t jitter_ns;       // Uniform extra delay in [0, jitter]
+    uint64_t bandwidth_bps;   // Per direction per connection, 0 for unlimited
+    double reorder_pct;       // Chance a chunk is held back by reorder_ns
+    uint64_t reorder_ns;
+    double loss_pct;          // Chance a chunk waits for a retransmit timeout
+    uint64_t rto_ns;
+    double reset_pct;         // Chance a connection is reset when forwarding a chunk
+    uint64_t seed;
+};
+
+struct netem_chunk {
+    struct netem_chunk *next;
+    uint64_t deliver_at;
+    size_t len;
+    size_t offset;
+    char data[];
+};
+
+// One direction of a proxied connection
+struct netem_pipe {
+    struct netem_chunk *head;
+    struct netem_chunk *tail;
+    size_t queued;
+    uint64_t last_deliver;   // Keeps delivery in order
+    uint64_t link_free_at;   // Serialization delay for the bandwidth limit
+    uint64_t bytes;
+    bool src_eof;
+    bool dst_shut;
+    bool dst_blocked;        // Last write hit EAGAIN
+};
+
+struct netem_conn {
+    struct netem_conn *next;
+    int client_fd;
+    int server_fd;
+    bool connecting;
+    bool dead;
+    struct netem_pipe up;    // Client to server
+    struct netem_pipe down;  // Server to client
+};
+
+struct netem_stats {
+    uint64_t accepted;
+    uint64_t closed;
+    uint64_t resets;
+    uint64_t reordered;
+    uint64_t lost;
+    uint64_t bytes_up;
+    uint64_t bytes_down;
+};
+
+static volatile sig_atomic_t running = 1;
+static uint64_t rng_state;
+static struct netem_stats stats;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// xorshift64*, seeded from the command line for reproducible runs
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static double rng_unit(void) {
+    return (double)(rng_next() >> 11) / (double)(1ULL << 53);
+}
+
+static bool rng_chance(double pct) {
+    return pct > 0 && rng_unit() * 100.0 < pct;
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) ? -1 : 0;
+}
+
+static void set_nodelay(int fd) {
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+static void pipe_free(struct netem_pipe *pipe) {
+    struct netem_chunk *chunk = pipe->head;
+    while (chunk) {
+        struct netem_chunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    pipe->head = pipe->tail = NULL;
+    pipe->queued = 0;
+}
+
+// Closing with a zero linger timeout sends RST instead of FIN
+static void reset_fd(int fd) {
+    if (fd < 0) {
+        return;
+    }
+    struct linger lg = {.l_onoff = 1, .l_linger = 0};
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    close(fd);
+}
+
+static void conn_close(struct netem_conn *conn, bool reset) {
+    if (reset) {
+        reset_fd(conn->client_fd);
+        reset_fd(conn->server_fd);
+    } else {
+        if (conn->client_fd >= 0) close(conn->client_fd);
+        if (conn->server_fd >= 0) close(conn->server_fd);
+    }
+    conn->client_fd = conn->server_fd = -1;
+    pipe_free(&conn->up);
+    pipe_free(&conn->down);
+    conn->dead = true;
+    stats.closed++;
+}
+
+// Reads one chunk from src and schedules it on pipe according to the impairments
+static int pipe_read(const struct netem_options *opts, struct netem_pipe *pipe, int src_fd) {
+    struct netem_chunk *chunk = malloc(sizeof(struct netem_chunk) + NETEM_CHUNK_SIZE);
+    if (!chunk) {
+        return -1;
+    }
+
+    ssize_t n = recv(src_fd, chunk->data, NETEM_CHUNK_SIZE, 0);
+    if (n <= 0) {
+        free(chunk);
+        if (n == 0) {
+            pipe->src_eof = true;
+            return 0;
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+
+    uint64_t now = now_ns();
+    uint64_t deliver_at = now + opts->latency_ns;
+    if (opts->jitter_ns > 0) {
+        deliver_at += (uint64_t)(rng_unit() * (double)opts->jitter_ns);
+    }
+    if (rng_chance(opts->reorder_pct)) {
+        deliver_at += opts->reorder_ns;
+        stats.reordered++;
+    }
+    if (rng_chance(opts->loss_pct)) {
+        deliver_at += opts->rto_ns;
+        stats.lost++;
+    }
+    if (opts->bandwidth_bps > 0) {
+        uint64_t start = pipe->link_free_at > now ? pipe->link_free_at : now;
+        pipe->link_free_at = start + (uint64_t)n * 8ULL * 1000000000ULL / opts->bandwidth_bps;
+        if (pipe->link_free_at > deliver_at) {
+            deliver_at = pipe->link_free_at;
+        }
+    }
+    // The byte stream stays in order: a delayed chunk blocks the ones behind it
+    if (deliver_at < pipe->last_deliver) {
+        deliver_at = pipe->last_deliver;
+    }
+    pipe->last_deliver = deliver_at;
+
+    chunk->next = NULL;
+    chunk->deliver_at = deliver_at;
+    chunk->len = (size_t)n;
+    chunk->offset = 0;
+    if (pipe->tail) {
+        pipe->tail->next = chunk;
+    } else {
+        pipe->head = chunk;
+    }
+    pipe->tail = chunk;
+    pipe->queued += (size_t)n;
+    pipe->bytes += (size_t)n;
+    return 1;
+}
+
+// Writes every due chunk to dst; returns -1 if the destination failed
+static int pipe_flush(struct netem_pipe *pipe, int dst_fd, uint64_t now) {
+    pipe->dst_blocked = false;
+    while (pipe->head && pipe->head->deliver_at <= now) {
+        struct netem_chunk *chunk = pipe->head;
+        ssize_t n = send(dst_fd, chunk->data + chunk->offset, chunk->len - chunk->offset, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                pipe->dst_blocked = true;
+                return 0;
+            }
+            return -1;
+        }
+        chunk->offset += (size_t)n;
+        pipe->queued -= (size_t)n;
+        if (chunk->offset < chunk->len) {
+            pipe->dst_blocked = true;
+            return 0;
+        }
+        pipe->head = chunk->next;
+        if (!pipe->head) {
+            pipe->tail = NULL;
+        }
+        free(chunk);
+    }
+
+    // Propagate half-close once everything before the FIN has been delivered
+    if (pipe->src_eof && !pipe->head && !pipe->dst_shut) {
+        shutdown(dst_fd, SHUT_WR);
+        pipe->dst_shut = true;
+    }
+    return 0;
+}
+
+static int open_listener(const struct netem_options *opts) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int flag = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(opts->listen_port);
+    if (inet_pton(AF_INET, opts->listen_host, &addr.sin_addr) != 1 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, 4096) < 0 || set_nonblocking(fd) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static struct netem_conn *accept_conn(int listen_fd, const struct addrinfo *server_addr) {
+    int client_fd = accept(listen_fd, NULL, NULL);
+    if (client_fd < 0) {
+        return NULL;
+    }
+
+    int server_fd = socket(server_addr->ai_family, SOCK_STREAM, 0);
+    struct netem_conn *conn = calloc(1, sizeof(struct netem_conn));
+    if (server_fd < 0 || !conn || set_nonblocking(client_fd) < 0 || set_nonblocking(server_fd) < 0) {
+        close(client_fd);
+        if (server_fd >= 0) close(server_fd);
+        free(conn);
+        return NULL;
+    }
+    set_nodelay(client_fd);
+    set_nodelay(server_fd);
+
+    conn->client_fd = client_fd;
+    conn->server_fd = server_fd;
+    if (connect(server_fd, server_addr->ai_addr, server_addr->ai_addrlen) < 0) {
+        if (errno != EINPROGRESS) {
+            close(client_fd);
+            close(server_fd);
+            free(conn);
+            return NULL;
+        }
+        conn->connecting = true;
+    }
+    stats.accepted++;
+    return conn;
+}
+
+// Handles readability on one side, queueing what arrives on its outbound pipe
+static void service_fd(const struct netem_options *opts, struct netem_conn *conn, short revents,
+                       int fd, struct netem_pipe *out) {
+    if (conn->dead) {
+        return;
+    }
+    if (revents & (POLLIN | POLLHUP | POLLERR)) {
+        int ret = pipe_read(opts, out, fd);
+        if (ret < 0) {
+            conn_close(conn, true);
+            return;
+        }
+        if (ret > 0 && rng_chance(opts->reset_pct)) {
+            conn_close(conn, true);
+            stats.resets++;
+        }
+    }
+}
+
+static uint64_t parse_ms(const char *arg) {
+    return (uint64_t)(strtod(arg, NULL) * (double)NETEM_NS_PER_MS);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s <listen_port> <server_host> <server_port> [options]\n"
+            "  --listen HOST         Listen address (default 127.0.0.1)\n"
+            "  --latency MS          One-way delay added in each direction\n"
+            "  --jitter MS           Uniform random extra delay per chunk, 0..MS\n"
+            "  --bandwidth KBPS      Rate limit per direction per connection (kbit/s)\n"
+            "  --reorder PCT         Percent of chunks held back (head-of-line blocking)\n"
+            "  --reorder-delay MS    Hold-back time for reordered chunks (default 10)\n"
+            "  --loss PCT            Percent of chunks delayed by a retransmit timeout\n"
+            "  --rto MS              Retransmit timeout for lost chunks (default 200)\n"
+            "  --reset PCT           Percent chance per forwarded chunk to reset the connection\n"
+            "  --seed N              Random seed (default 1)\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    struct netem_options opts = {
+        .listen_host = "127.0.0.1",
+        .listen_port = atoi(argv[1]),
+        .server_host = argv[2],
+        .server_port = argv[3],
+        .reorder_ns = 10 * NETEM_NS_PER_MS,
+        .rto_ns = 200 * NETEM_NS_PER_MS,
+        .seed = 1
+    };
+
+    for (int i = 4; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *opt = argv[i];
+        const char *val = argv[++i];
+        if (strcmp(opt, "--listen") == 0) opts.listen_host = val;
+        else if (strcmp(opt, "--latency") == 0) opts.latency_ns = parse_ms(val);
+        else if (strcmp(opt, "--jitter") == 0) opts.jitter_ns = parse_ms(val);
+        else if (strcmp(opt, "--bandwidth") == 0) opts.bandwidth_bps = strtoull(val, NULL, 10) * 1000ULL;
+        else if (strcmp(opt, "--reorder") == 0) opts.reorder_pct = strtod(val, NULL);
+        else if (strcmp(opt, "--reorder-delay") == 0) opts.reorder_ns = parse_ms(val);
+        else if (strcmp(opt, "--loss") == 0) opts.loss_pct = strtod(val, NULL);
+        else if (strcmp(opt, "--rto") == 0) opts.rto_ns = parse_ms(val);
+        else if (strcmp(opt, "--reset") == 0) opts.reset_pct = strtod(val, NULL);
+        else if (strcmp(opt, "--seed") == 0) opts.seed = strtoull(val, NULL, 10);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    rng_state = opts.seed ? opts.seed : 1;
+
+    struct addrinfo hints, *server_addr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(opts.server_host, opts.server_port, &hints, &server_addr) != 0) {
+        fprintf(stderr, "Failed to resolve %s:%s\n", opts.server_host, opts.server_port);
+        return 1;
+    }
+
+    int listen_fd = open_listener(&opts);
+    if (listen_fd < 0) {
+        fprintf(stderr, "Failed to listen on %s:%d: %s\n", opts.listen_host, opts.listen_port,
+                strerror(errno));
+        freeaddrinfo(server_addr);
+        return 1;
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("rioc_netem: %s:%d -> %s:%s latency=%.1fms jitter=%.1fms bandwidth=%llukbps "
+           "reorder=%.2f%% loss=%.2f%% reset=%.2f%%\n",
+           opts.listen_host, opts.listen_port, opts.server_host, opts.server_port,
+           (double)opts.latency_ns / NETEM_NS_PER_MS, (double)opts.jitter_ns / NETEM_NS_PER_MS,
+           (unsigned long long)(opts.bandwidth_bps / 1000), opts.reorder_pct, opts.loss_pct,
+           opts.reset_pct);
+    fflush(stdout);
+
+    struct netem_conn *conns = NULL;
+    size_t num_conns = 0;
+    struct pollfd *pfds = NULL;
+    struct netem_conn **pconns = NULL;
+    size_t pfd_capacity = 0;
+
+    while (running) {
+        uint64_t now = now_ns();
+        uint64_t next_due = UINT64_MAX;
+
+        // Deliver due data and drop finished connections
+        struct netem_conn **link = &conns;
+        while (*link) {
+            struct netem_conn *conn = *link;
+            if (!conn->dead && !conn->connecting) {
+                if (pipe_flush(&conn->up, conn->server_fd, now) < 0 ||
+                    pipe_flush(&conn->down, conn->client_fd, now) < 0) {
+                    conn_close(conn, true);
+                } else if (conn->up.dst_shut && conn->down.dst_shut) {
+                    conn_close(conn, false);
+                }
+            }
+            if (conn->dead) {
+                stats.bytes_up += conn->up.bytes;
+                stats.bytes_down += conn->down.bytes;
+                *link = conn->next;
+                free(conn);
+                num_conns--;
+                continue;
+            }
+            if (conn->up.head && !conn->up.dst_blocked && conn->up.head->deliver_at < next_due) {
+                next_due = conn->up.head->deliver_at;
+            }
+            if (conn->down.head && !conn->down.dst_blocked && conn->down.head->deliver_at < next_due) {
+                next_due = conn->down.head->deliver_at;
+            }
+            link = &conn->next;
+        }
+
+        size_t needed = 1 + 2 * num_conns;
+        if (needed > pfd_capacity) {
+            size_t capacity = needed * 2;
+            struct pollfd *new_pfds = realloc(pfds, capacity * sizeof(struct pollfd));
+            if (!new_pfds) break;
+            pfds = new_pfds;
+            struct netem_conn **new_pconns = realloc(pconns, capacity * sizeof(struct netem_conn *));
+            if (!new_pconns) break;
+            pconns = new_pconns;
+            pfd_capacity = capacity;
+        }
+
+        size_t n = 0;
+        pfds[n].fd = listen_fd;
+        pfds[n].events = POLLIN;
+        pconns[n++] = NULL;
+        for (struct netem_conn *conn = conns; conn; conn = conn->next) {
+            short client_events = 0, server_events = 0;
+            if (conn->connecting) {
+                server_events = POLLOUT;
+            } else {
+                if (!conn->up.src_eof && conn->up.queued < NETEM_MAX_QUEUED) client_events |= POLLIN;
+                if (!conn->down.src_eof && conn->down.queued < NETEM_MAX_QUEUED) server_events |= POLLIN;
+                if (conn->down.dst_blocked) client_events |= POLLOUT;
+                if (conn->up.dst_blocked) server_events |= POLLOUT;
+            }
+            // Idle descriptors are left out so a hang-up cannot spin the loop while
+            // delayed data is still queued
+            pfds[n].fd = client_events ? conn->client_fd : -1;
+            pfds[n].events = client_events;
+            pconns[n++] = conn;
+            pfds[n].fd = server_events ? conn->server_fd : -1;
+            pfds[n].events = server_events;
+            pconns[n++] = conn;
+        }
+
+        int timeout_ms = -1;
+        if (next_due != UINT64_MAX) {
+            now = now_ns();
+            timeout_ms = next_due <= now ? 0 : (int)((next_due - now + NETEM_NS_PER_MS - 1) / NETEM_NS_PER_MS);
+        }
+
+        int ready = poll(pfds, n, timeout_ms);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        for (size_t i = 1; i < n; i += 2) {
+            struct netem_conn *conn = pconns[i];
+            short client_revents = pfds[i].revents;
+            short server_revents = pfds[i + 1].revents;
+
+            if (conn->connecting && server_revents) {
+                int err = 0;
+                socklen_t len = sizeof(err);
+                getsockopt(conn->server_fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0) {
+                    conn_close(conn, true);
+                    continue;
+                }
+                conn->connecting = false;
+                continue;
+            }
+            service_fd(&opts, conn, client_revents, conn->client_fd, &conn->up);
+            service_fd(&opts, conn, server_revents, conn->server_fd, &conn->down);
+        }
+
+        if (pfds[0].revents & POLLIN) {
+            struct netem_conn *conn;
+            while ((conn = accept_conn(listen_fd, server_addr)) != NULL) {
+                conn->next = conns;
+                conns = conn;
+                num_conns++;
+            }
+        }
+    }
+
+    while (conns) {
+        struct netem_conn *next = conns->next;
+        stats.bytes_up += conns->up.bytes;
+        stats.bytes_down += conns->down.bytes;
+        if (!conns->dead) {
+            conn_close(conns, false);
+        }
+        free(conns);
+        conns = next;
+    }
+    free(pfds);
+    free(pconns);
+    close(listen_fd);
+    freeaddrinfo(server_addr);
+
+    printf("\nrioc_netem summary:\n");
+    printf("  Connections:      %llu accepted, %llu closed\n",
+           (unsigned long long)stats.accepted, (unsigned long long)stats.closed);
+    printf("  Injected resets:  %llu\n", (unsigned long long)stats.resets);
+    printf("  Reordered chunks: %llu\n", (unsigned long long)stats.reordered);
+    printf("  Lost chunks:      %llu\n", (unsigned long long)stats.lost);
+    printf("  Bytes up/down:    %llu / %llu\n",
+           (unsigned long long)stats.bytes_up, (unsigned long long)stats.bytes_down);
+    return 0;
+}
@@ -13,6 +13,7 @@
 typedef struct rioc_tls_context {
     SSL_CTX *ctx;
     SSL *ssl;
+    SSL_SESSION *session;  // Session to resume on connect (client only, not owned)
     bool is_server;
 } rioc_tls_context;
 
@@ -32,6 +33,15 @@ typedef struct rioc_tls_context {
     #define RIOC_USE_DISPATCH_SEMAPHORE 1
 #endif
 
+// Spin-wait hint for busy-polling loops
+#if defined(__x86_64__) || defined(__i386__)
+    #define RIOC_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+    #define RIOC_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+    #define RIOC_CPU_RELAX() ((void)0)
+#endif
+
 // Socket types and constants
 #ifdef RIOC_PLATFORM_WINDOWS
     #include <winsock2.h>
@@ -62,7 +72,10 @@ int rioc_platform_init(void);
 void rioc_platform_cleanup(void);
 rioc_socket_t rioc_socket_create(void);
 int rioc_socket_close(rioc_socket_t socket);
+int rioc_socket_shutdown(rioc_socket_t socket);
 int rioc_set_socket_options(rioc_socket_t socket);
+// Connects to a Unix domain socket, RIOC_INVALID_SOCKET on failure or where unsupported
+rioc_socket_t rioc_unix_socket_connect(const char *path);
 ssize_t rioc_send(rioc_socket_t socket, const void* buf, size_t len, int flags);
 ssize_t rioc_recv(rioc_socket_t socket, void* buf, size_t len, int flags);
 int rioc_socket_error(void);
@@ -74,10 +87,20 @@ void rioc_sleep_us(unsigned int usec);
 // Platform-specific TCP optimizations
 void rioc_enable_tcp_cork(rioc_socket_t socket);
 void rioc_disable_tcp_cork(rioc_socket_t socket);
+// Makes the socket non-blocking, so receives can spin, and asks the kernel to busy poll
+// the device queue (SO_BUSY_POLL, SO_PREFER_BUSY_POLL). Only the first is required;
+// returns 1 if the kernel accepted busy polling, 0 if not, -1 on failure.
+int rioc_enable_busy_poll(rioc_socket_t socket);
 
 // Platform-specific thread operations
 int rioc_pin_thread_to_cpu(int cpu);
 
+// Platform-specific memory operations
+// A client's large buffers, placed as its RIOC_CLIENT_* flags ask. *size is rounded up
+// to what was reserved; pass the same size and flags to rioc_buffer_free.
+void *rioc_buffer_alloc(size_t *size, uint32_t flags, int cpu);
+void rioc_buffer_free(void *buffer, size_t size, uint32_t flags);
+
 // TLS operations
 int rioc_tls_init(void);
 void rioc_tls_cleanup(void);
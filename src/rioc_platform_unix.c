@@ -10,6 +10,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/tcp.h>
 #include <sys/types.h>
 #include <netinet/in.h>
@@ -18,6 +19,13 @@
 #include <string.h>
 #include <arpa/inet.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#ifdef RIOC_PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
 
 #ifdef RIOC_PLATFORM_MACOS
 #include <mach/mach.h>
@@ -64,6 +72,34 @@ int rioc_socket_close(rioc_socket_t socket) {
     return close(socket);
 }
 
+// Ends both directions of a connection without releasing the socket
+int rioc_socket_shutdown(rioc_socket_t socket) {
+    return shutdown(socket, SHUT_RDWR);
+}
+
+rioc_socket_t rioc_unix_socket_connect(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return RIOC_INVALID_SOCKET;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return RIOC_INVALID_SOCKET;
+    }
+    int buf_size = 1024 * 1024;  // Same as TCP connections
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf_size, sizeof(buf_size));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf_size, sizeof(buf_size));
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return RIOC_INVALID_SOCKET;
+    }
+    return fd;
+}
+
 int rioc_set_socket_options(rioc_socket_t socket) {
     int flag = 1;
     int ret;
@@ -179,6 +215,37 @@ void rioc_disable_tcp_cork(rioc_socket_t socket) {
 #endif
 }
 
+#ifdef RIOC_PLATFORM_LINUX
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#define RIOC_BUSY_POLL_USEC 50
+#endif
+
+int rioc_enable_busy_poll(rioc_socket_t socket) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return -1;
+    }
+
+#ifdef RIOC_PLATFORM_LINUX
+    // Raising SO_BUSY_POLL above net.core.busy_read needs CAP_NET_ADMIN, and
+    // SO_PREFER_BUSY_POLL needs Linux 5.11; without them the spin is user-space only
+    int usec = RIOC_BUSY_POLL_USEC;
+    if (setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) < 0) {
+        return 0;
+    }
+    int prefer = 1;
+    setsockopt(socket, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 int rioc_pin_thread_to_cpu(int cpu) {
 #ifdef RIOC_PLATFORM_LINUX
     cpu_set_t cpuset;
@@ -197,4 +264,96 @@ int rioc_pin_thread_to_cpu(int cpu) {
 #endif
 }
 
+#ifdef RIOC_PLATFORM_LINUX
+#define RIOC_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+#define RIOC_MPOL_PREFERRED 1     // From linux/mempolicy.h
+#define RIOC_MAX_NUMA_NODES 1024
+
+// The NUMA node cpu belongs to, from its nodeN entry in sysfs; -1 if unknown
+static int cpu_numa_node(int cpu) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return -1;
+    }
+
+    int node = -1;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && isdigit((unsigned char)entry->d_name[4])) {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+// Prefer node for the mapping's pages; must run before they are first touched
+static void bind_to_node(void *buffer, size_t size, int node) {
+    if (node < 0 || node >= RIOC_MAX_NUMA_NODES) {
+        return;
+    }
+    unsigned long mask[RIOC_MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = {0};
+    mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    // The kernel reads maxnode - 1 bits; a failure (no NUMA support) leaves the default policy
+    syscall(SYS_mbind, buffer, size, RIOC_MPOL_PREFERRED, mask, RIOC_MAX_NUMA_NODES + 1, 0);
+}
+#endif
+
+void *rioc_buffer_alloc(size_t *size, uint32_t flags, int cpu) {
+#ifdef RIOC_PLATFORM_LINUX
+    if (flags & (RIOC_CLIENT_HUGE_PAGES | RIOC_CLIENT_PIN_CPU)) {
+        size_t page = (flags & RIOC_CLIENT_HUGE_PAGES) ? RIOC_HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+        size_t len = (*size + page - 1) & ~(page - 1);
+        void *buffer = MAP_FAILED;
+        if (flags & RIOC_CLIENT_HUGE_PAGES) {
+            // Fails unless enough huge pages are reserved
+            buffer = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+        if (buffer == MAP_FAILED) {
+            buffer = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buffer == MAP_FAILED) {
+                return NULL;
+            }
+#ifdef MADV_HUGEPAGE
+            if (flags & RIOC_CLIENT_HUGE_PAGES) {
+                madvise(buffer, len, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (flags & RIOC_CLIENT_PIN_CPU) {
+            bind_to_node(buffer, len, cpu_numa_node(cpu));
+        }
+        *size = len;
+        return buffer;
+    }
+#else
+    (void)flags;
+    (void)cpu;
+#endif
+    void *buffer;
+    if (posix_memalign(&buffer, RIOC_CACHE_LINE_SIZE, *size) != 0) {
+        return NULL;
+    }
+    return buffer;
+}
+
+void rioc_buffer_free(void *buffer, size_t size, uint32_t flags) {
+    if (!buffer) {
+        return;
+    }
+#ifdef RIOC_PLATFORM_LINUX
+    if (flags & (RIOC_CLIENT_HUGE_PAGES | RIOC_CLIENT_PIN_CPU)) {
+        munmap(buffer, size);
+        return;
+    }
+#else
+    (void)flags;
+#endif
+    (void)size;
+    free(buffer);
+}
+
 #endif // !RIOC_PLATFORM_WINDOWS 
@@ -3,6 +3,7 @@
 #ifdef RIOC_PLATFORM_WINDOWS
 
 #include <mmsystem.h>
+#include <malloc.h>
 #pragma comment(lib, "winmm.lib")
 
 static LARGE_INTEGER performance_frequency;
@@ -54,6 +55,16 @@ int rioc_socket_close(rioc_socket_t socket) {
     return closesocket(socket);
 }
 
+// Ends both directions of a connection without releasing the socket
+int rioc_socket_shutdown(rioc_socket_t socket) {
+    return shutdown(socket, SD_BOTH);
+}
+
+rioc_socket_t rioc_unix_socket_connect(const char *path) {
+    (void)path;
+    return RIOC_INVALID_SOCKET;
+}
+
 int rioc_set_socket_options(rioc_socket_t socket) {
     BOOL flag = TRUE;
     int ret;
@@ -114,4 +125,23 @@ void rioc_sleep_us(unsigned int usec) {
     } while ((now.QuadPart - start.QuadPart) < counts.QuadPart);
 }
 
+// Windows has no socket busy polling; the socket still goes non-blocking so receives spin
+int rioc_enable_busy_poll(rioc_socket_t socket) {
+    u_long mode = 1;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0 ? 0 : -1;
+}
+
+// Large pages need SeLockMemoryPrivilege, so client buffers always use ordinary memory
+void *rioc_buffer_alloc(size_t *size, uint32_t flags, int cpu) {
+    (void)flags;
+    (void)cpu;
+    return _aligned_malloc(*size, RIOC_CACHE_LINE_SIZE);
+}
+
+void rioc_buffer_free(void *buffer, size_t size, uint32_t flags) {
+    (void)size;
+    (void)flags;
+    _aligned_free(buffer);
+}
+
 #endif // RIOC_PLATFORM_WINDOWS 
\ No newline at end of file
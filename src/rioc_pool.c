@@ -0,0 +1,505 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include "rioc.h"
+#include "rioc_platform.h"
+
+// Every op locks one connection for its round trip. A key hashes to a home slot in
+// [0, active), so ops on one key run one after another on one socket; when the home
+// connection is down the op moves to the next live slot. Resizing changes active with
+// every slot in the old range locked, so an op that observed the old active either
+// finished first or sees the new value after locking and hashes again.
+
+#define POOL_DEFAULT_HEALTH_MS   1000
+#define POOL_PROBE_KEY           "__rioc_pool_health"
+#define POOL_GROW_WAIT_PERCENT   5     // Grow once more than this share of ops waited
+#define POOL_SHRINK_INTERVALS    10    // Shrink after this many intervals without waits
+
+struct rioc_pool_conn {
+    pthread_mutex_t lock;
+    struct rioc_client *client;     // NULL while down, protected by lock
+    uint64_t ops;                   // Ops run, protected by lock
+    uint64_t probed_ops;            // ops at the last health check (health thread)
+    atomic_bool down;               // Unlocked hint that client is NULL
+} RIOC_ALIGNED;
+
+struct rioc_pool {
+    rioc_client_config client_config;   // Deep copy used for every connect
+    rioc_tls_config tls;
+    struct rioc_pool_conn *conns;       // max_connections entries
+    uint32_t min_connections;
+    uint32_t max_connections;
+    uint32_t health_check_ms;
+    atomic_uint active;                 // Slots ops hash over
+
+    pthread_t health_thread;
+    pthread_mutex_t health_lock;
+    pthread_cond_t health_cond;
+    bool health_started;
+    bool stopping;                      // Protected by health_lock
+    uint64_t last_ops;                  // Health thread only
+    uint64_t last_waits;
+    uint32_t quiet_intervals;
+
+    atomic_uint_fast64_t ops;
+    atomic_uint_fast64_t waits;
+    atomic_uint_fast64_t failovers;
+    atomic_uint_fast64_t reconnects;
+    atomic_uint_fast64_t grows;
+    atomic_uint_fast64_t shrinks;
+};
+
+static void *pool_health_thread(void *arg);
+
+// FNV-1a; only needs to spread keys evenly over a handful of slots
+static inline uint64_t pool_hash(const char *key, size_t key_len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < key_len; i++) {
+        hash ^= (uint8_t)key[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static char *pool_strdup(const char *s, bool *failed) {
+    if (!s) {
+        return NULL;
+    }
+    char *copy = strdup(s);
+    if (!copy) {
+        *failed = true;
+    }
+    return copy;
+}
+
+static void pool_free_config(struct rioc_pool *pool) {
+    free((char *)pool->client_config.host);
+    free((char *)pool->tls.cert_path);
+    free((char *)pool->tls.key_path);
+    free((char *)pool->tls.ca_path);
+    free((char *)pool->tls.verify_hostname);
+}
+
+static int pool_copy_config(struct rioc_pool *pool, const rioc_client_config *config) {
+    bool failed = false;
+    pool->client_config = *config;
+    pool->client_config.host = pool_strdup(config->host, &failed);
+    pool->client_config.tls = NULL;
+    if (config->tls) {
+        pool->tls.cert_path = pool_strdup(config->tls->cert_path, &failed);
+        pool->tls.key_path = pool_strdup(config->tls->key_path, &failed);
+        pool->tls.ca_path = pool_strdup(config->tls->ca_path, &failed);
+        pool->tls.verify_hostname = pool_strdup(config->tls->verify_hostname, &failed);
+        pool->tls.verify_peer = config->tls->verify_peer;
+        pool->client_config.tls = &pool->tls;
+    }
+    return failed ? RIOC_ERR_MEM : RIOC_SUCCESS;
+}
+
+// Caller holds conn->lock
+static void pool_conn_mark_down(struct rioc_pool *pool, struct rioc_pool_conn *conn) {
+    rioc_client_disconnect_with_config(conn->client);
+    conn->client = NULL;
+    atomic_store(&conn->down, true);
+
+    // Reconnect now rather than at the next interval
+    pthread_mutex_lock(&pool->health_lock);
+    pthread_cond_signal(&pool->health_cond);
+    pthread_mutex_unlock(&pool->health_lock);
+}
+
+// Locks the connection for key, or the next live one if it is down
+static int pool_lock_conn(struct rioc_pool *pool, const char *key, size_t key_len,
+                          struct rioc_pool_conn **out) {
+    uint64_t hash = pool_hash(key, key_len);
+
+retry:;
+    uint32_t active = atomic_load(&pool->active);
+    uint32_t home = (uint32_t)(hash % active);
+
+    for (uint32_t i = 0; i < active; i++) {
+        struct rioc_pool_conn *conn = &pool->conns[(home + i) % active];
+        if (i > 0 && atomic_load_explicit(&conn->down, memory_order_relaxed)) {
+            continue;
+        }
+
+        if (pthread_mutex_trylock(&conn->lock) != 0) {
+            atomic_fetch_add_explicit(&pool->waits, 1, memory_order_relaxed);
+            pthread_mutex_lock(&conn->lock);
+        }
+        if (atomic_load(&pool->active) != active) {
+            pthread_mutex_unlock(&conn->lock);
+            goto retry;
+        }
+        if (conn->client) {
+            if (i > 0) {
+                atomic_fetch_add_explicit(&pool->failovers, 1, memory_order_relaxed);
+            }
+            conn->ops++;
+            atomic_fetch_add_explicit(&pool->ops, 1, memory_order_relaxed);
+            *out = conn;
+            return RIOC_SUCCESS;
+        }
+        pthread_mutex_unlock(&conn->lock);
+    }
+
+    // Every connection is down
+    return RIOC_ERR_IO;
+}
+
+// A failed read or a malformed response leaves the stream out of step with the server
+static void pool_unlock_conn(struct rioc_pool *pool, struct rioc_pool_conn *conn, int status) {
+    if (status == RIOC_ERR_IO || status == RIOC_ERR_PROTO) {
+        pool_conn_mark_down(pool, conn);
+    }
+    pthread_mutex_unlock(&conn->lock);
+}
+
+int rioc_pool_create(const rioc_pool_config *config, struct rioc_pool **pool_out) {
+    if (!config || !config->client || !pool_out || config->connections == 0 ||
+        (config->max_connections && config->max_connections < config->connections)) {
+        return RIOC_ERR_PARAM;
+    }
+    *pool_out = NULL;
+
+    struct rioc_pool *pool = calloc(1, sizeof(*pool));
+    if (!pool) {
+        return RIOC_ERR_MEM;
+    }
+    if (pool_copy_config(pool, config->client) != RIOC_SUCCESS) {
+        pool_free_config(pool);
+        free(pool);
+        return RIOC_ERR_MEM;
+    }
+
+    pool->min_connections = config->connections;
+    pool->max_connections = config->max_connections ? config->max_connections
+                                                    : config->connections;
+    pool->health_check_ms = config->health_check_ms ? config->health_check_ms
+                                                    : POOL_DEFAULT_HEALTH_MS;
+
+    if (posix_memalign((void**)&pool->conns, RIOC_CACHE_LINE_SIZE,
+                       pool->max_connections * sizeof(*pool->conns)) != 0) {
+        pool_free_config(pool);
+        free(pool);
+        return RIOC_ERR_MEM;
+    }
+    memset(pool->conns, 0, pool->max_connections * sizeof(*pool->conns));
+    for (uint32_t i = 0; i < pool->max_connections; i++) {
+        pthread_mutex_init(&pool->conns[i].lock, NULL);
+        atomic_init(&pool->conns[i].down, true);
+    }
+    atomic_init(&pool->active, pool->min_connections);
+    pthread_mutex_init(&pool->health_lock, NULL);
+    pthread_cond_init(&pool->health_cond, NULL);
+
+    // Connections that fail here start down and are retried by the health thread;
+    // the pool is only refused when the server cannot be reached at all
+    int ret = RIOC_ERR_IO;
+    uint32_t connected = 0;
+    for (uint32_t i = 0; i < pool->min_connections; i++) {
+        struct rioc_client *client = NULL;
+        ret = rioc_client_connect_with_config(&pool->client_config, &client);
+        if (ret == RIOC_SUCCESS) {
+            pool->conns[i].client = client;
+            atomic_store(&pool->conns[i].down, false);
+            connected++;
+        }
+    }
+    if (connected == 0) {
+        rioc_pool_free(pool);
+        return ret;
+    }
+    if (pthread_create(&pool->health_thread, NULL, pool_health_thread, pool) != 0) {
+        rioc_pool_free(pool);
+        return RIOC_ERR_MEM;
+    }
+    pool->health_started = true;
+
+    *pool_out = pool;
+    return RIOC_SUCCESS;
+}
+
+void rioc_pool_free(struct rioc_pool *pool) {
+    if (!pool) {
+        return;
+    }
+
+    if (pool->health_started) {
+        pthread_mutex_lock(&pool->health_lock);
+        pool->stopping = true;
+        pthread_cond_signal(&pool->health_cond);
+        pthread_mutex_unlock(&pool->health_lock);
+        pthread_join(pool->health_thread, NULL);
+    }
+
+    for (uint32_t i = 0; i < pool->max_connections; i++) {
+        rioc_client_disconnect_with_config(pool->conns[i].client);
+        pthread_mutex_destroy(&pool->conns[i].lock);
+    }
+    pthread_cond_destroy(&pool->health_cond);
+    pthread_mutex_destroy(&pool->health_lock);
+    free(pool->conns);
+    pool_free_config(pool);
+    free(pool);
+}
+
+int rioc_pool_get(struct rioc_pool *pool, const char *key, size_t key_len,
+                  char **value, size_t *value_len) {
+    if (!pool || !key) {
+        return RIOC_ERR_PARAM;
+    }
+    struct rioc_pool_conn *conn;
+    int ret = pool_lock_conn(pool, key, key_len, &conn);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+    ret = rioc_get(conn->client, key, key_len, value, value_len);
+    pool_unlock_conn(pool, conn, ret);
+    return ret;
+}
+
+int rioc_pool_insert(struct rioc_pool *pool, const char *key, size_t key_len,
+                     const char *value, size_t value_len, uint64_t timestamp) {
+    if (!pool || !key) {
+        return RIOC_ERR_PARAM;
+    }
+    struct rioc_pool_conn *conn;
+    int ret = pool_lock_conn(pool, key, key_len, &conn);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+    ret = rioc_insert(conn->client, key, key_len, value, value_len, timestamp);
+    pool_unlock_conn(pool, conn, ret);
+    return ret;
+}
+
+int rioc_pool_delete(struct rioc_pool *pool, const char *key, size_t key_len,
+                     uint64_t timestamp) {
+    if (!pool || !key) {
+        return RIOC_ERR_PARAM;
+    }
+    struct rioc_pool_conn *conn;
+    int ret = pool_lock_conn(pool, key, key_len, &conn);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+    ret = rioc_delete(conn->client, key, key_len, timestamp);
+    pool_unlock_conn(pool, conn, ret);
+    return ret;
+}
+
+int rioc_pool_range_query(struct rioc_pool *pool, const char *start_key, size_t start_key_len,
+                          const char *end_key, size_t end_key_len,
+                          struct rioc_range_result **results, size_t *result_count) {
+    if (!pool || !start_key) {
+        return RIOC_ERR_PARAM;
+    }
+    struct rioc_pool_conn *conn;
+    int ret = pool_lock_conn(pool, start_key, start_key_len, &conn);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+    ret = rioc_range_query(conn->client, start_key, start_key_len, end_key, end_key_len,
+                           results, result_count);
+    pool_unlock_conn(pool, conn, ret);
+    return ret;
+}
+
+int rioc_pool_atomic_inc_dec(struct rioc_pool *pool, const char *key, size_t key_len,
+                             int64_t increment, uint64_t timestamp, int64_t *result) {
+    if (!pool || !key) {
+        return RIOC_ERR_PARAM;
+    }
+    struct rioc_pool_conn *conn;
+    int ret = pool_lock_conn(pool, key, key_len, &conn);
+    if (ret != RIOC_SUCCESS) {
+        return ret;
+    }
+    ret = rioc_atomic_inc_dec(conn->client, key, key_len, increment, timestamp, result);
+    pool_unlock_conn(pool, conn, ret);
+    return ret;
+}
+
+int rioc_pool_acquire(struct rioc_pool *pool, const char *key, size_t key_len,
+                      struct rioc_client **client) {
+    if (!pool || !key || !client) {
+        return RIOC_ERR_PARAM;
+    }
+    struct rioc_pool_conn *conn;
+    int ret = pool_lock_conn(pool, key, key_len, &conn);
+    if (ret != RIOC_SUCCESS) {
+        *client = NULL;
+        return ret;
+    }
+    *client = conn->client;
+    return RIOC_SUCCESS;
+}
+
+void rioc_pool_release(struct rioc_pool *pool, struct rioc_client *client, int status) {
+    if (!pool || !client) {
+        return;
+    }
+    // The caller holds the lock, so client cannot change under the scan
+    for (uint32_t i = 0; i < pool->max_connections; i++) {
+        struct rioc_pool_conn *conn = &pool->conns[i];
+        if (conn->client == client) {
+            pool_unlock_conn(pool, conn, status);
+            return;
+        }
+    }
+}
+
+int rioc_pool_get_stats(struct rioc_pool *pool, rioc_pool_stats *stats) {
+    if (!pool || !stats) {
+        return RIOC_ERR_PARAM;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->connections = atomic_load(&pool->active);
+    for (uint32_t i = 0; i < stats->connections; i++) {
+        if (!atomic_load_explicit(&pool->conns[i].down, memory_order_relaxed)) {
+            stats->healthy++;
+        }
+    }
+    stats->ops = atomic_load_explicit(&pool->ops, memory_order_relaxed);
+    stats->waits = atomic_load_explicit(&pool->waits, memory_order_relaxed);
+    stats->failovers = atomic_load_explicit(&pool->failovers, memory_order_relaxed);
+    stats->reconnects = atomic_load_explicit(&pool->reconnects, memory_order_relaxed);
+    stats->grows = atomic_load_explicit(&pool->grows, memory_order_relaxed);
+    stats->shrinks = atomic_load_explicit(&pool->shrinks, memory_order_relaxed);
+    return RIOC_SUCCESS;
+}
+
+// Connects outside the lock so ops failing over past a down slot are not held up
+static bool pool_conn_reconnect(struct rioc_pool *pool, struct rioc_pool_conn *conn) {
+    struct rioc_client *client = NULL;
+    if (rioc_client_connect_with_config(&pool->client_config, &client) != RIOC_SUCCESS) {
+        return false;
+    }
+    pthread_mutex_lock(&conn->lock);
+    if (conn->client) {
+        rioc_client_disconnect_with_config(conn->client);
+    }
+    conn->client = client;
+    conn->probed_ops = conn->ops;
+    atomic_store(&conn->down, false);
+    pthread_mutex_unlock(&conn->lock);
+    return true;
+}
+
+// Probes a connection no op has used since the last check; busy connections are
+// known to be working
+static void pool_conn_probe(struct rioc_pool *pool, struct rioc_pool_conn *conn) {
+    if (pthread_mutex_trylock(&conn->lock) != 0) {
+        return;
+    }
+    if (conn->client && conn->ops == conn->probed_ops) {
+        char *value = NULL;
+        size_t value_len = 0;
+        int ret = rioc_get(conn->client, POOL_PROBE_KEY, sizeof(POOL_PROBE_KEY) - 1,
+                           &value, &value_len);
+        if (ret == RIOC_SUCCESS) {
+            rioc_value_free(value);
+        } else if (ret != RIOC_ERR_NOENT) {
+            pool_conn_mark_down(pool, conn);
+        }
+    }
+    conn->probed_ops = conn->ops;
+    pthread_mutex_unlock(&conn->lock);
+}
+
+// Moves active to target with every slot either side of the change locked
+static void pool_set_active(struct rioc_pool *pool, uint32_t current, uint32_t target) {
+    uint32_t span = current > target ? current : target;
+    for (uint32_t i = 0; i < span; i++) {
+        pthread_mutex_lock(&pool->conns[i].lock);
+    }
+    atomic_store(&pool->active, target);
+    for (uint32_t i = span; i > 0; i--) {
+        pthread_mutex_unlock(&pool->conns[i - 1].lock);
+    }
+}
+
+static void pool_resize(struct rioc_pool *pool) {
+    uint64_t ops = atomic_load_explicit(&pool->ops, memory_order_relaxed);
+    uint64_t waits = atomic_load_explicit(&pool->waits, memory_order_relaxed);
+    uint64_t interval_ops = ops - pool->last_ops;
+    uint64_t interval_waits = waits - pool->last_waits;
+    pool->last_ops = ops;
+    pool->last_waits = waits;
+
+    uint32_t active = atomic_load(&pool->active);
+    if (interval_waits * 100 > interval_ops * POOL_GROW_WAIT_PERCENT &&
+        active < pool->max_connections) {
+        // The new slot is unreachable until active covers it
+        pool->quiet_intervals = 0;
+        if (pool_conn_reconnect(pool, &pool->conns[active])) {
+            pool_set_active(pool, active, active + 1);
+            atomic_fetch_add_explicit(&pool->grows, 1, memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (interval_waits > 0) {
+        pool->quiet_intervals = 0;
+        return;
+    }
+    if (++pool->quiet_intervals < POOL_SHRINK_INTERVALS || active <= pool->min_connections) {
+        return;
+    }
+    pool->quiet_intervals = 0;
+    pool_set_active(pool, active, active - 1);
+
+    // Ops that hashed to the retired slot have finished or will hash again
+    struct rioc_pool_conn *conn = &pool->conns[active - 1];
+    pthread_mutex_lock(&conn->lock);
+    rioc_client_disconnect_with_config(conn->client);
+    conn->client = NULL;
+    atomic_store(&conn->down, true);
+    pthread_mutex_unlock(&conn->lock);
+    atomic_fetch_add_explicit(&pool->shrinks, 1, memory_order_relaxed);
+}
+
+static void *pool_health_thread(void *arg) {
+    struct rioc_pool *pool = arg;
+
+    for (;;) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        uint64_t nsec = (uint64_t)deadline.tv_nsec + (uint64_t)pool->health_check_ms * 1000000ULL;
+        deadline.tv_sec += (time_t)(nsec / 1000000000ULL);
+        deadline.tv_nsec = (long)(nsec % 1000000000ULL);
+
+        // A signal means a connection went down; reconnect it without a full check
+        pthread_mutex_lock(&pool->health_lock);
+        int wait = 0;
+        if (!pool->stopping) {
+            wait = pthread_cond_timedwait(&pool->health_cond, &pool->health_lock, &deadline);
+        }
+        bool stopping = pool->stopping;
+        pthread_mutex_unlock(&pool->health_lock);
+        if (stopping) {
+            break;
+        }
+
+        uint32_t active = atomic_load(&pool->active);
+        for (uint32_t i = 0; i < active; i++) {
+            struct rioc_pool_conn *conn = &pool->conns[i];
+            if (atomic_load(&conn->down)) {
+                if (pool_conn_reconnect(pool, conn)) {
+                    atomic_fetch_add_explicit(&pool->reconnects, 1, memory_order_relaxed);
+                }
+            } else if (wait == ETIMEDOUT) {
+                pool_conn_probe(pool, conn);
+            }
+        }
+        if (wait == ETIMEDOUT) {
+            pool_resize(pool);
+        }
+    }
+    return NULL;
+}
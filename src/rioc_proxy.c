@@ -0,0 +1,1143 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "rioc.h"
+
+// Local RIOC proxy that multiplexes many client connections onto a few server
+// connections.
+//
+// Each client is attached to one upstream connection, so its ops reach the server in
+// the order it sent them. Ops from every client on an upstream wait in one queue and
+// are written as RIOC batches of up to RIOC_MAX_BATCH_SIZE ops, with at most `window`
+// batches awaiting responses; while those are in flight, new ops pile up and leave in
+// the next batch. A GET for a key that already has a GET waiting in the same queue,
+// with no write to the key queued since, is answered from that GET's response.
+// Responses are matched to ops by position, as the server returns them in order, and
+// handed back to each client in the order of its requests.
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // SIGPIPE is ignored instead
+#endif
+
+#define PROXY_READ_SIZE 65536
+#define PROXY_MAX_CLIENT_OUT (4 * 1024 * 1024)  // Unsent responses before a client's reads pause
+#define PROXY_MAX_QUEUED 65536                  // Queued ops before an upstream's clients pause
+#define PROXY_MAX_UPSTREAMS 64
+#define PROXY_MAX_WINDOW 64
+#define PROXY_DEDUPE_BUCKETS 4096
+#define PROXY_STATS_REQUEST 4096
+#define PROXY_RECONNECT_NS (1000 * 1000000ULL)
+#define PROXY_NS_PER_MS 1000000ULL
+
+struct proxy_options {
+    const char *listen_host;
+    int listen_port;
+    const char *listen_path;      // Unix socket instead of TCP
+    const char *server_host;
+    const char *server_port;
+    int upstreams;
+    int window;                   // Batches in flight per upstream
+    int stats_port;               // 0 for no stats page
+    bool dedupe;
+};
+
+struct proxy_buf {
+    char *data;
+    size_t off;                   // Consumed bytes at the front
+    size_t len;
+    size_t cap;
+};
+
+// One op from a client, in the client's response order
+struct proxy_op {
+    struct proxy_op *next;
+    struct proxy_op *next_waiter; // Other ops answered by the same request
+    struct proxy_client *client;
+    char *response;
+    size_t response_len;
+    bool done;
+};
+
+// One op as sent upstream, with the client ops waiting for its response
+struct proxy_request {
+    struct proxy_request *next;
+    struct proxy_request *table_next;
+    struct proxy_op *waiters;
+    uint64_t hash;
+    uint16_t command;
+    bool batch_end;               // Last op of its upstream batch
+    bool in_table;
+    size_t len;
+    char data[];                  // Op header, key, value
+};
+
+enum upstream_state {
+    UPSTREAM_DOWN = 0,
+    UPSTREAM_CONNECTING,
+    UPSTREAM_READY
+};
+
+struct proxy_upstream {
+    int id;
+    int fd;
+    enum upstream_state state;
+    uint64_t retry_at;
+    int clients;
+    struct proxy_request *queued_head;  // Not yet written
+    struct proxy_request *queued_tail;
+    size_t queued;
+    struct proxy_request *sent_head;    // Written, awaiting responses in this order
+    struct proxy_request *sent_tail;
+    int in_flight;                      // Batches awaiting responses
+    struct proxy_buf in;
+    struct proxy_buf out;
+    uint32_t rows_left;                 // Range response parse state
+    size_t scanned;
+    struct proxy_request *table[PROXY_DEDUPE_BUCKETS];  // Queued GETs by key
+};
+
+struct proxy_client {
+    struct proxy_client *next;
+    int fd;
+    bool dead;
+    struct proxy_upstream *upstream;
+    struct proxy_op *ops_head;
+    struct proxy_op *ops_tail;
+    struct proxy_buf in;
+    struct proxy_buf out;
+};
+
+struct proxy_stats_conn {
+    struct proxy_stats_conn *next;
+    int fd;
+    size_t len;
+    char request[PROXY_STATS_REQUEST];
+};
+
+struct proxy_stats {
+    uint64_t accepted;
+    uint64_t closed;
+    uint64_t protocol_errors;     // Clients dropped for malformed requests
+    uint64_t requests;            // Batches received from clients
+    uint64_t ops;                 // Ops received from clients
+    uint64_t deduped;             // GETs answered by another queued GET
+    uint64_t failed;              // Ops failed with RIOC_ERR_IO, upstream unavailable
+    uint64_t batches;             // Batches written upstream
+    uint64_t upstream_ops;        // Ops written upstream
+    uint64_t upstream_failures;
+};
+
+static volatile sig_atomic_t running = 1;
+static struct proxy_stats stats;
+static struct proxy_upstream *upstreams;
+static struct proxy_client *clients;
+static size_t num_clients;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) ? -1 : 0;
+}
+
+static void set_nodelay(int fd) {
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+static uint64_t key_hash(const char *key, size_t key_len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < key_len; i++) {
+        hash ^= (uint8_t)key[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static size_t buf_avail(const struct proxy_buf *buf) {
+    return buf->len - buf->off;
+}
+
+static void buf_free(struct proxy_buf *buf) {
+    free(buf->data);
+    memset(buf, 0, sizeof(*buf));
+}
+
+// Makes room for extra bytes past len, moving unconsumed bytes to the front first
+static int buf_reserve(struct proxy_buf *buf, size_t extra) {
+    if (buf->off > 0 && (buf->off == buf->len || buf->cap - buf->len < extra)) {
+        memmove(buf->data, buf->data + buf->off, buf->len - buf->off);
+        buf->len -= buf->off;
+        buf->off = 0;
+    }
+    if (buf->cap - buf->len >= extra) {
+        return 0;
+    }
+    size_t cap = buf->cap ? buf->cap : PROXY_READ_SIZE;
+    while (cap - buf->len < extra) {
+        cap *= 2;
+    }
+    char *data = realloc(buf->data, cap);
+    if (!data) {
+        return -1;
+    }
+    buf->data = data;
+    buf->cap = cap;
+    return 0;
+}
+
+static int buf_append(struct proxy_buf *buf, const void *data, size_t len) {
+    if (buf_reserve(buf, len) < 0) {
+        return -1;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return 0;
+}
+
+// Reads what the socket has; returns 0 on EOF, -1 on error
+static int buf_read(struct proxy_buf *buf, int fd) {
+    if (buf_reserve(buf, PROXY_READ_SIZE) < 0) {
+        return -1;
+    }
+    ssize_t n = recv(fd, buf->data + buf->len, buf->cap - buf->len, 0);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 1 : -1;
+    }
+    buf->len += (size_t)n;
+    return n > 0 ? 1 : 0;
+}
+
+// Writes what the socket takes; returns -1 on error
+static int buf_write(struct proxy_buf *buf, int fd) {
+    while (buf_avail(buf) > 0) {
+        ssize_t n = send(fd, buf->data + buf->off, buf_avail(buf), MSG_NOSIGNAL);
+        if (n < 0) {
+            return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+        }
+        buf->off += (size_t)n;
+    }
+    buf->off = buf->len = 0;
+    return 0;
+}
+
+static void client_close(struct proxy_client *client) {
+    if (client->dead) {
+        return;
+    }
+    close(client->fd);
+    client->fd = -1;
+    client->dead = true;
+    client->upstream->clients--;
+    buf_free(&client->in);
+    buf_free(&client->out);
+    stats.closed++;
+}
+
+// Queues the responses at the front of the client's order that are complete. Ops of a
+// closed client are still answered by the server and are dropped here.
+static void client_deliver(struct proxy_client *client) {
+    while (client->ops_head && client->ops_head->done) {
+        struct proxy_op *op = client->ops_head;
+        if (!client->dead && buf_append(&client->out, op->response, op->response_len) < 0) {
+            client_close(client);
+        }
+        client->ops_head = op->next;
+        if (!client->ops_head) {
+            client->ops_tail = NULL;
+        }
+        free(op->response);
+        free(op);
+    }
+}
+
+static void op_complete(struct proxy_op *op, const char *response, size_t len) {
+    op->response = malloc(len);
+    if (op->response) {
+        memcpy(op->response, response, len);
+        op->response_len = len;
+    } else {
+        // Skipping a response would hand every later one to the wrong op
+        client_close(op->client);
+    }
+    op->done = true;
+    client_deliver(op->client);
+}
+
+static void op_fail(struct proxy_op *op, int status) {
+    struct rioc_response_header header = {(uint32_t)status, 0};
+    op_complete(op, (const char *)&header, sizeof(header));
+}
+
+static void request_complete(struct proxy_request *req, const char *response, size_t len) {
+    struct proxy_op *op = req->waiters;
+    while (op) {
+        struct proxy_op *next = op->next_waiter;
+        op_complete(op, response, len);
+        op = next;
+    }
+    free(req);
+}
+
+static void request_fail(struct proxy_request *req, int status) {
+    struct rioc_response_header header = {(uint32_t)status, 0};
+    request_complete(req, (const char *)&header, sizeof(header));
+}
+
+static const char *request_key(const struct proxy_request *req, size_t *key_len) {
+    struct rioc_op_header header;
+    memcpy(&header, req->data, sizeof(header));
+    *key_len = header.key_len;
+    return req->data + sizeof(header);
+}
+
+static struct proxy_request **table_find(struct proxy_upstream *up, uint64_t hash,
+                                         const char *key, size_t key_len) {
+    struct proxy_request **link = &up->table[hash % PROXY_DEDUPE_BUCKETS];
+    for (; *link; link = &(*link)->table_next) {
+        size_t req_key_len;
+        const char *req_key = request_key(*link, &req_key_len);
+        if ((*link)->hash == hash && req_key_len == key_len &&
+            memcmp(req_key, key, key_len) == 0) {
+            return link;
+        }
+    }
+    return NULL;
+}
+
+static void table_remove(struct proxy_upstream *up, struct proxy_request *req) {
+    if (!req->in_table) {
+        return;
+    }
+    size_t key_len;
+    const char *key = request_key(req, &key_len);
+    struct proxy_request **link = table_find(up, req->hash, key, key_len);
+    if (link) {
+        *link = req->table_next;
+    }
+    req->in_table = false;
+}
+
+static void upstream_fail(struct proxy_upstream *up) {
+    if (up->fd >= 0) {
+        close(up->fd);
+        up->fd = -1;
+    }
+    if (up->state == UPSTREAM_READY) {
+        stats.upstream_failures++;
+        fprintf(stderr, "rioc_proxy: upstream %d lost, retrying\n", up->id);
+    }
+    up->state = UPSTREAM_DOWN;
+    up->retry_at = now_ns() + PROXY_RECONNECT_NS;
+
+    struct proxy_request *lists[2] = {up->sent_head, up->queued_head};
+    for (int i = 0; i < 2; i++) {
+        struct proxy_request *req = lists[i];
+        while (req) {
+            struct proxy_request *next = req->next;
+            for (struct proxy_op *op = req->waiters; op; op = op->next_waiter) {
+                stats.failed++;
+            }
+            request_fail(req, RIOC_ERR_IO);
+            req = next;
+        }
+    }
+    up->sent_head = up->sent_tail = NULL;
+    up->queued_head = up->queued_tail = NULL;
+    up->queued = 0;
+    up->in_flight = 0;
+    up->rows_left = 0;
+    up->scanned = 0;
+    memset(up->table, 0, sizeof(up->table));
+    buf_free(&up->in);
+    buf_free(&up->out);
+}
+
+static void upstream_connect(struct proxy_upstream *up, const struct addrinfo *server_addr) {
+    up->fd = socket(server_addr->ai_family, SOCK_STREAM, 0);
+    if (up->fd < 0 || set_nonblocking(up->fd) < 0) {
+        upstream_fail(up);
+        return;
+    }
+    set_nodelay(up->fd);
+    if (connect(up->fd, server_addr->ai_addr, server_addr->ai_addrlen) < 0) {
+        if (errno != EINPROGRESS) {
+            upstream_fail(up);
+            return;
+        }
+        up->state = UPSTREAM_CONNECTING;
+        return;
+    }
+    up->state = UPSTREAM_READY;
+}
+
+// Writes queued ops as batches while the window has room
+static void upstream_flush(struct proxy_upstream *up, int window) {
+    while (up->queued_head && up->in_flight < window) {
+        struct rioc_batch_header header = {
+            .magic = RIOC_MAGIC,
+            .version = RIOC_VERSION,
+            .count = 0,
+            .flags = RIOC_FLAG_PIPELINE | RIOC_FLAG_MORE
+        };
+        size_t header_at = up->out.len;
+        if (buf_append(&up->out, &header, sizeof(header)) < 0) {
+            upstream_fail(up);
+            return;
+        }
+
+        struct proxy_request *req = NULL;
+        while (up->queued_head && header.count < RIOC_MAX_BATCH_SIZE) {
+            req = up->queued_head;
+            if (buf_append(&up->out, req->data, req->len) < 0) {
+                upstream_fail(up);
+                return;
+            }
+            up->queued_head = req->next;
+            up->queued--;
+            table_remove(up, req);
+            req->next = NULL;
+            if (up->sent_tail) {
+                up->sent_tail->next = req;
+            } else {
+                up->sent_head = req;
+            }
+            up->sent_tail = req;
+            header.count++;
+        }
+        if (!up->queued_head) {
+            up->queued_tail = NULL;
+        }
+        req->batch_end = true;
+        memcpy(up->out.data + header_at, &header, sizeof(header));
+        up->in_flight++;
+        stats.batches++;
+        stats.upstream_ops += header.count;
+    }
+    if (buf_write(&up->out, up->fd) < 0) {
+        upstream_fail(up);
+    }
+}
+
+// Length of the response at the front of in for a request of this command, 0 while
+// incomplete, -1 if the stream is malformed. Range rows are scanned once, across calls.
+static ssize_t upstream_response_len(struct proxy_upstream *up, uint16_t command) {
+    const char *data = up->in.data + up->in.off;
+    size_t avail = buf_avail(&up->in);
+
+    if (up->scanned == 0) {
+        struct rioc_response_header header;
+        if (avail < sizeof(header)) {
+            return 0;
+        }
+        memcpy(&header, data, sizeof(header));
+        if ((int32_t)header.status != RIOC_SUCCESS) {
+            return (ssize_t)sizeof(header);
+        }
+        if (command != RIOC_CMD_RANGE_QUERY) {
+            if (header.value_len > RIOC_MAX_VALUE_SIZE) {
+                return -1;
+            }
+            size_t len = sizeof(header) + header.value_len;
+            return avail >= len ? (ssize_t)len : 0;
+        }
+        up->rows_left = header.value_len;
+        up->scanned = sizeof(header);
+    }
+
+    // Each row is a uint16_t key length, the key, a uint64_t value length and the value
+    while (up->rows_left > 0) {
+        uint16_t key_len;
+        uint64_t value_len;
+        if (avail < up->scanned + sizeof(key_len)) {
+            return 0;
+        }
+        memcpy(&key_len, data + up->scanned, sizeof(key_len));
+        size_t value_at = up->scanned + sizeof(key_len) + key_len;
+        if (avail < value_at + sizeof(value_len)) {
+            return 0;
+        }
+        memcpy(&value_len, data + value_at, sizeof(value_len));
+        if (value_len > RIOC_MAX_VALUE_SIZE) {
+            return -1;
+        }
+        size_t row_end = value_at + sizeof(value_len) + (size_t)value_len;
+        if (avail < row_end) {
+            return 0;
+        }
+        up->scanned = row_end;
+        up->rows_left--;
+    }
+    size_t len = up->scanned;
+    up->scanned = 0;
+    return (ssize_t)len;
+}
+
+static void upstream_read(struct proxy_upstream *up) {
+    int ret = buf_read(&up->in, up->fd);
+    if (ret <= 0) {
+        upstream_fail(up);
+        return;
+    }
+
+    while (up->sent_head) {
+        struct proxy_request *req = up->sent_head;
+        ssize_t len = upstream_response_len(up, req->command);
+        if (len < 0) {
+            upstream_fail(up);
+            return;
+        }
+        if (len == 0) {
+            break;
+        }
+        up->sent_head = req->next;
+        if (!up->sent_head) {
+            up->sent_tail = NULL;
+        }
+        if (req->batch_end) {
+            up->in_flight--;
+        }
+        request_complete(req, up->in.data + up->in.off, (size_t)len);
+        up->in.off += (size_t)len;
+    }
+    if (!up->sent_head && buf_avail(&up->in) > 0) {
+        // Bytes nobody asked for
+        upstream_fail(up);
+    }
+}
+
+static struct proxy_upstream *pick_upstream(const struct proxy_options *opts) {
+    struct proxy_upstream *best = NULL;
+    for (int i = 0; i < opts->upstreams; i++) {
+        struct proxy_upstream *up = &upstreams[i];
+        if (up->state == UPSTREAM_DOWN) {
+            continue;
+        }
+        if (!best || up->clients < best->clients) {
+            best = up;
+        }
+    }
+    return best ? best : &upstreams[0];
+}
+
+// Queues one op on the client's upstream, or joins it to a queued GET of the same key
+static int client_submit(const struct proxy_options *opts, struct proxy_client *client,
+                         const char *data, size_t len) {
+    struct proxy_upstream *up = client->upstream;
+    struct rioc_op_header header;
+    memcpy(&header, data, sizeof(header));
+    const char *key = data + sizeof(header);
+
+    struct proxy_op *op = calloc(1, sizeof(struct proxy_op));
+    if (!op) {
+        return -1;
+    }
+    op->client = client;
+    if (client->ops_tail) {
+        client->ops_tail->next = op;
+    } else {
+        client->ops_head = op;
+    }
+    client->ops_tail = op;
+    stats.ops++;
+
+    if (up->state == UPSTREAM_DOWN) {
+        stats.failed++;
+        op_fail(op, RIOC_ERR_IO);
+        return 0;
+    }
+
+    uint64_t hash = key_hash(key, header.key_len);
+    struct proxy_request **queued = table_find(up, hash, key, header.key_len);
+    if (header.command == RIOC_CMD_GET && queued) {
+        op->next_waiter = (*queued)->waiters;
+        (*queued)->waiters = op;
+        stats.deduped++;
+        return 0;
+    }
+    if (queued && header.command != RIOC_CMD_RANGE_QUERY) {
+        // A GET queued before this write must not answer GETs queued after it
+        (*queued)->in_table = false;
+        *queued = (*queued)->table_next;
+    }
+
+    struct proxy_request *req = malloc(sizeof(struct proxy_request) + len);
+    if (!req) {
+        // The op is already in the client's order: answer it, or the client is never freed
+        stats.failed++;
+        op_fail(op, RIOC_ERR_MEM);
+        return -1;
+    }
+    memset(req, 0, sizeof(*req));
+    req->waiters = op;
+    req->hash = hash;
+    req->command = header.command;
+    req->len = len;
+    memcpy(req->data, data, len);
+    if (opts->dedupe && header.command == RIOC_CMD_GET) {
+        struct proxy_request **bucket = &up->table[hash % PROXY_DEDUPE_BUCKETS];
+        req->table_next = *bucket;
+        *bucket = req;
+        req->in_table = true;
+    }
+    if (up->queued_tail) {
+        up->queued_tail->next = req;
+    } else {
+        up->queued_head = req;
+    }
+    up->queued_tail = req;
+    up->queued++;
+    return 0;
+}
+
+// Length of the complete request at the front of in, 0 while incomplete, -1 if malformed
+static ssize_t client_request_len(const struct proxy_client *client) {
+    const char *data = client->in.data + client->in.off;
+    size_t avail = buf_avail(&client->in);
+    struct rioc_batch_header header;
+    if (avail < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != RIOC_MAGIC || header.version != RIOC_VERSION ||
+        header.count == 0 || header.count > RIOC_MAX_BATCH_SIZE) {
+        return -1;
+    }
+
+    size_t pos = sizeof(header);
+    for (uint16_t i = 0; i < header.count; i++) {
+        struct rioc_op_header op;
+        if (avail < pos + sizeof(op)) {
+            return 0;
+        }
+        memcpy(&op, data + pos, sizeof(op));
+        if (op.key_len > RIOC_MAX_KEY_SIZE || op.value_len > RIOC_MAX_VALUE_SIZE) {
+            return -1;
+        }
+        pos += sizeof(op) + op.key_len + op.value_len;
+    }
+    return avail >= pos ? (ssize_t)pos : 0;
+}
+
+static void client_read(const struct proxy_options *opts, struct proxy_client *client) {
+    int ret = buf_read(&client->in, client->fd);
+    if (ret <= 0) {
+        client_close(client);
+        return;
+    }
+
+    ssize_t len;
+    while ((len = client_request_len(client)) > 0) {
+        // A client whose upstream failed moves once nothing of its is left in flight
+        if (client->upstream->state == UPSTREAM_DOWN && !client->ops_head) {
+            struct proxy_upstream *up = pick_upstream(opts);
+            client->upstream->clients--;
+            up->clients++;
+            client->upstream = up;
+        }
+
+        const char *data = client->in.data + client->in.off;
+        struct rioc_batch_header header;
+        memcpy(&header, data, sizeof(header));
+        size_t pos = sizeof(header);
+        for (uint16_t i = 0; i < header.count; i++) {
+            struct rioc_op_header op;
+            memcpy(&op, data + pos, sizeof(op));
+            size_t op_len = sizeof(op) + op.key_len + op.value_len;
+            if (client_submit(opts, client, data + pos, op_len) < 0) {
+                client_close(client);
+            }
+            if (client->dead) {
+                return;
+            }
+            pos += op_len;
+        }
+        client->in.off += (size_t)len;
+        stats.requests++;
+    }
+    if (len < 0) {
+        stats.protocol_errors++;
+        client_close(client);
+    }
+}
+
+static int open_listener(const char *host, int port, const char *path) {
+    int fd;
+    if (path) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(path) >= sizeof(addr.sun_path)) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy(addr.sun_path, path);
+        unlink(path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        int flag = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, host, &addr.sin_addr) != 1 ||
+            bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    if (listen(fd, 4096) < 0 || set_nonblocking(fd) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_clients(const struct proxy_options *opts, int listen_fd, bool tcp) {
+    int fd;
+    while ((fd = accept(listen_fd, NULL, NULL)) >= 0) {
+        struct proxy_client *client = calloc(1, sizeof(struct proxy_client));
+        if (!client || set_nonblocking(fd) < 0) {
+            close(fd);
+            free(client);
+            continue;
+        }
+        if (tcp) {
+            set_nodelay(fd);
+        }
+        client->fd = fd;
+        client->upstream = pick_upstream(opts);
+        client->upstream->clients++;
+        client->next = clients;
+        clients = client;
+        num_clients++;
+        stats.accepted++;
+    }
+}
+
+static void write_stats_page(const struct proxy_options *opts, int fd) {
+    char body[8192];
+    size_t live = 0;
+    for (struct proxy_client *client = clients; client; client = client->next) {
+        if (!client->dead) live++;
+    }
+    int n = snprintf(body, sizeof(body),
+                     "clients %zu\n"
+                     "accepted %llu\n"
+                     "protocol_errors %llu\n"
+                     "requests %llu\n"
+                     "ops %llu\n"
+                     "deduped_gets %llu\n"
+                     "failed_ops %llu\n"
+                     "upstream_batches %llu\n"
+                     "upstream_ops %llu\n"
+                     "upstream_failures %llu\n"
+                     "requests_per_batch %.2f\n"
+                     "ops_per_batch %.2f\n",
+                     live,
+                     (unsigned long long)stats.accepted,
+                     (unsigned long long)stats.protocol_errors,
+                     (unsigned long long)stats.requests,
+                     (unsigned long long)stats.ops,
+                     (unsigned long long)stats.deduped,
+                     (unsigned long long)stats.failed,
+                     (unsigned long long)stats.batches,
+                     (unsigned long long)stats.upstream_ops,
+                     (unsigned long long)stats.upstream_failures,
+                     stats.batches ? (double)stats.requests / (double)stats.batches : 0.0,
+                     stats.batches ? (double)stats.upstream_ops / (double)stats.batches : 0.0);
+    static const char *state_names[] = {"down", "connecting", "ready"};
+    for (int i = 0; i < opts->upstreams && n > 0 && (size_t)n < sizeof(body); i++) {
+        const struct proxy_upstream *up = &upstreams[i];
+        n += snprintf(body + n, sizeof(body) - (size_t)n,
+                      "upstream %d %s clients=%d queued=%zu in_flight=%d\n",
+                      up->id, state_names[up->state], up->clients, up->queued, up->in_flight);
+    }
+    if (n < 0 || (size_t)n >= sizeof(body)) {
+        n = (int)strlen(body);
+    }
+
+    char page[8192 + 128];
+    int len = snprintf(page, sizeof(page),
+                       "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\n"
+                       "Connection: close\r\n\r\n%.*s", n, n, body);
+    if (len > 0) {
+        // Small enough for an empty socket buffer
+        send(fd, page, (size_t)len, MSG_NOSIGNAL);
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s <listen_port|unix_path> <server_host> <server_port> [options]\n"
+            "  --listen HOST         Listen address for a TCP port (default 127.0.0.1)\n"
+            "  --upstreams N         Server connections (default 2)\n"
+            "  --window N            Batches in flight per server connection (default 2)\n"
+            "  --stats-port PORT     Serve counters over HTTP on 127.0.0.1:PORT\n"
+            "  --no-dedupe           Send every GET, even when an identical one is queued\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    struct proxy_options opts = {
+        .listen_host = "127.0.0.1",
+        .server_host = argv[2],
+        .server_port = argv[3],
+        .upstreams = 2,
+        .window = 2,
+        .dedupe = true
+    };
+    // A path listens on a Unix socket, as clients connect to a host starting with '/'
+    if (argv[1][0] == '/') {
+        opts.listen_path = argv[1];
+    } else {
+        opts.listen_port = atoi(argv[1]);
+    }
+
+    for (int i = 4; i < argc; i++) {
+        const char *opt = argv[i];
+        if (strcmp(opt, "--no-dedupe") == 0) {
+            opts.dedupe = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *val = argv[++i];
+        if (strcmp(opt, "--listen") == 0) opts.listen_host = val;
+        else if (strcmp(opt, "--upstreams") == 0) opts.upstreams = atoi(val);
+        else if (strcmp(opt, "--window") == 0) opts.window = atoi(val);
+        else if (strcmp(opt, "--stats-port") == 0) opts.stats_port = atoi(val);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (opts.upstreams < 1 || opts.upstreams > PROXY_MAX_UPSTREAMS ||
+        opts.window < 1 || opts.window > PROXY_MAX_WINDOW) {
+        fprintf(stderr, "Upstreams must be 1-%d and window 1-%d\n",
+                PROXY_MAX_UPSTREAMS, PROXY_MAX_WINDOW);
+        return 1;
+    }
+
+    struct addrinfo hints, *server_addr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(opts.server_host, opts.server_port, &hints, &server_addr) != 0) {
+        fprintf(stderr, "Failed to resolve %s:%s\n", opts.server_host, opts.server_port);
+        return 1;
+    }
+
+    int listen_fd = open_listener(opts.listen_host, opts.listen_port, opts.listen_path);
+    if (listen_fd < 0) {
+        if (opts.listen_path) {
+            fprintf(stderr, "Failed to listen on %s: %s\n", opts.listen_path, strerror(errno));
+        } else {
+            fprintf(stderr, "Failed to listen on %s:%d: %s\n", opts.listen_host,
+                    opts.listen_port, strerror(errno));
+        }
+        freeaddrinfo(server_addr);
+        return 1;
+    }
+    int stats_fd = -1;
+    if (opts.stats_port > 0) {
+        stats_fd = open_listener("127.0.0.1", opts.stats_port, NULL);
+        if (stats_fd < 0) {
+            fprintf(stderr, "Failed to listen on 127.0.0.1:%d: %s\n", opts.stats_port,
+                    strerror(errno));
+            close(listen_fd);
+            freeaddrinfo(server_addr);
+            return 1;
+        }
+    }
+
+    upstreams = calloc((size_t)opts.upstreams, sizeof(struct proxy_upstream));
+    if (!upstreams) {
+        fprintf(stderr, "Failed to allocate upstreams\n");
+        return 1;
+    }
+    for (int i = 0; i < opts.upstreams; i++) {
+        upstreams[i].id = i;
+        upstreams[i].fd = -1;
+        upstream_connect(&upstreams[i], server_addr);
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("rioc_proxy: %s%s%s -> %s:%s upstreams=%d window=%d dedupe=%s",
+           opts.listen_path ? opts.listen_path : opts.listen_host,
+           opts.listen_path ? "" : ":", opts.listen_path ? "" : argv[1],
+           opts.server_host, opts.server_port, opts.upstreams, opts.window,
+           opts.dedupe ? "on" : "off");
+    if (opts.stats_port > 0) {
+        printf(" stats=http://127.0.0.1:%d/", opts.stats_port);
+    }
+    printf("\n");
+    fflush(stdout);
+
+    struct proxy_stats_conn *stats_conns = NULL;
+    size_t num_stats_conns = 0;
+    struct pollfd *pfds = NULL;
+    void **prefs = NULL;
+    size_t pfd_capacity = 0;
+
+    while (running) {
+        uint64_t now = now_ns();
+        uint64_t next_retry = UINT64_MAX;
+
+        for (int i = 0; i < opts.upstreams; i++) {
+            struct proxy_upstream *up = &upstreams[i];
+            if (up->state == UPSTREAM_DOWN && up->retry_at <= now) {
+                upstream_connect(up, server_addr);
+            }
+            if (up->state == UPSTREAM_READY) {
+                upstream_flush(up, opts.window);
+            }
+            if (up->state == UPSTREAM_DOWN && up->retry_at < next_retry) {
+                next_retry = up->retry_at;
+            }
+        }
+
+        // Send responses and drop finished clients
+        struct proxy_client **link = &clients;
+        while (*link) {
+            struct proxy_client *client = *link;
+            if (!client->dead && buf_write(&client->out, client->fd) < 0) {
+                client_close(client);
+            }
+            if (client->dead && !client->ops_head) {
+                *link = client->next;
+                free(client);
+                num_clients--;
+                continue;
+            }
+            link = &client->next;
+        }
+
+        size_t needed = 2 + (size_t)opts.upstreams + num_clients + num_stats_conns;
+        if (needed > pfd_capacity) {
+            size_t capacity = needed * 2;
+            struct pollfd *new_pfds = realloc(pfds, capacity * sizeof(struct pollfd));
+            if (!new_pfds) break;
+            pfds = new_pfds;
+            void **new_prefs = realloc(prefs, capacity * sizeof(void *));
+            if (!new_prefs) break;
+            prefs = new_prefs;
+            pfd_capacity = capacity;
+        }
+
+        // Listeners first, then upstreams, clients and stats connections in list order
+        size_t n = 0;
+        pfds[n].fd = listen_fd;
+        pfds[n].events = POLLIN;
+        prefs[n++] = NULL;
+        pfds[n].fd = stats_fd;
+        pfds[n].events = POLLIN;
+        prefs[n++] = NULL;
+        for (int i = 0; i < opts.upstreams; i++) {
+            struct proxy_upstream *up = &upstreams[i];
+            short events = 0;
+            if (up->state == UPSTREAM_CONNECTING) {
+                events = POLLOUT;
+            } else if (up->state == UPSTREAM_READY) {
+                events = POLLIN;
+                if (buf_avail(&up->out) > 0) events |= POLLOUT;
+            }
+            pfds[n].fd = events ? up->fd : -1;
+            pfds[n].events = events;
+            prefs[n++] = up;
+        }
+        for (struct proxy_client *client = clients; client; client = client->next) {
+            short events = 0;
+            if (!client->dead) {
+                if (buf_avail(&client->out) < PROXY_MAX_CLIENT_OUT &&
+                    client->upstream->queued < PROXY_MAX_QUEUED) {
+                    events |= POLLIN;
+                }
+                if (buf_avail(&client->out) > 0) events |= POLLOUT;
+            }
+            pfds[n].fd = events ? client->fd : -1;
+            pfds[n].events = events;
+            prefs[n++] = client;
+        }
+        for (struct proxy_stats_conn *conn = stats_conns; conn; conn = conn->next) {
+            pfds[n].fd = conn->fd;
+            pfds[n].events = POLLIN;
+            prefs[n++] = conn;
+        }
+
+        int timeout_ms = -1;
+        if (next_retry != UINT64_MAX) {
+            now = now_ns();
+            timeout_ms = next_retry <= now ? 0 : (int)((next_retry - now + PROXY_NS_PER_MS - 1) / PROXY_NS_PER_MS);
+        }
+
+        int ready = poll(pfds, n, timeout_ms);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        size_t i = 2;
+        for (int u = 0; u < opts.upstreams; u++, i++) {
+            struct proxy_upstream *up = prefs[i];
+            short revents = pfds[i].revents;
+            if (!revents) {
+                continue;
+            }
+            if (up->state == UPSTREAM_CONNECTING) {
+                int err = 0;
+                socklen_t len = sizeof(err);
+                getsockopt(up->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0) {
+                    upstream_fail(up);
+                } else {
+                    up->state = UPSTREAM_READY;
+                }
+                continue;
+            }
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                upstream_read(up);
+            }
+        }
+        for (size_t c = 0; c < num_clients; c++, i++) {
+            struct proxy_client *client = prefs[i];
+            if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                client_read(&opts, client);
+            }
+        }
+
+        // Answer a stats request once its headers are in, then hang up
+        struct proxy_stats_conn **conn_link = &stats_conns;
+        size_t polled_stats_conns = num_stats_conns;
+        for (size_t s = 0; s < polled_stats_conns; s++, i++) {
+            struct proxy_stats_conn *conn = *conn_link;
+            bool done = false;
+            if (pfds[i].revents) {
+                ssize_t got = recv(conn->fd, conn->request + conn->len,
+                                   sizeof(conn->request) - 1 - conn->len, 0);
+                if (got > 0) {
+                    conn->len += (size_t)got;
+                    conn->request[conn->len] = '\0';
+                }
+                done = got <= 0 || strstr(conn->request, "\r\n\r\n") ||
+                       conn->len == sizeof(conn->request) - 1;
+                if (got < 0 && (errno == EAGAIN || errno == EINTR)) {
+                    done = false;
+                }
+            }
+            if (done) {
+                write_stats_page(&opts, conn->fd);
+                close(conn->fd);
+                *conn_link = conn->next;
+                free(conn);
+                num_stats_conns--;
+                continue;
+            }
+            conn_link = &conn->next;
+        }
+
+        if (pfds[0].revents & POLLIN) {
+            accept_clients(&opts, listen_fd, opts.listen_path == NULL);
+        }
+        if (stats_fd >= 0 && (pfds[1].revents & POLLIN)) {
+            int fd;
+            while ((fd = accept(stats_fd, NULL, NULL)) >= 0) {
+                struct proxy_stats_conn *conn = calloc(1, sizeof(struct proxy_stats_conn));
+                if (!conn || set_nonblocking(fd) < 0) {
+                    close(fd);
+                    free(conn);
+                    continue;
+                }
+                conn->fd = fd;
+                conn->next = stats_conns;
+                stats_conns = conn;
+                num_stats_conns++;
+            }
+        }
+    }
+
+    for (int i = 0; i < opts.upstreams; i++) {
+        upstreams[i].state = UPSTREAM_DOWN;  // Shutting down, not lost
+        upstream_fail(&upstreams[i]);
+    }
+    while (clients) {
+        struct proxy_client *next = clients->next;
+        client_close(clients);
+        free(clients);
+        clients = next;
+    }
+    while (stats_conns) {
+        struct proxy_stats_conn *next = stats_conns->next;
+        close(stats_conns->fd);
+        free(stats_conns);
+        stats_conns = next;
+    }
+    free(upstreams);
+    free(pfds);
+    free(prefs);
+    close(listen_fd);
+    if (stats_fd >= 0) close(stats_fd);
+    if (opts.listen_path) unlink(opts.listen_path);
+    freeaddrinfo(server_addr);
+
+    printf("\nrioc_proxy summary:\n");
+    printf("  Clients:          %llu accepted, %llu dropped for malformed requests\n",
+           (unsigned long long)stats.accepted, (unsigned long long)stats.protocol_errors);
+    printf("  Requests/ops:     %llu / %llu\n",
+           (unsigned long long)stats.requests, (unsigned long long)stats.ops);
+    printf("  Deduped GETs:     %llu\n", (unsigned long long)stats.deduped);
+    printf("  Failed ops:       %llu\n", (unsigned long long)stats.failed);
+    printf("  Upstream batches: %llu carrying %llu ops (%.2f requests, %.2f ops per batch)\n",
+           (unsigned long long)stats.batches, (unsigned long long)stats.upstream_ops,
+           stats.batches ? (double)stats.requests / (double)stats.batches : 0.0,
+           stats.batches ? (double)stats.upstream_ops / (double)stats.batches : 0.0);
+    return 0;
+}
@@ -40,13 +40,224 @@ static void warmup_connection(struct rioc_client *client) {
         rioc_insert(client, key, strlen(key), value, strlen(value), get_current_timestamp_ns());
         rioc_get(client, key, strlen(key), &retrieved_value, &retrieved_len);
         if (retrieved_value) {
-            free(retrieved_value);
+            rioc_value_free(retrieved_value);
             retrieved_value = NULL;
         }
         rioc_delete(client, key, strlen(key), get_current_timestamp_ns());
     }
 }
 
+// Compares a built key with the hex vector the SDK ports are checked against
+static int key_matches(const struct rioc_key_builder *key, const char *hex) {
+    size_t hex_len = strlen(hex);
+    if (key->len * 2 != hex_len) {
+        return 0;
+    }
+    for (size_t i = 0; i < key->len; i++) {
+        unsigned int byte;
+        if (sscanf(hex + i * 2, "%2x", &byte) != 1 || (uint8_t)key->buf[i] != byte) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Byte order of two keys as a range query compares them
+static int key_compare(const char *a, size_t a_len, const char *b, size_t b_len) {
+    int ret = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (ret != 0) {
+        return ret;
+    }
+    return a_len < b_len ? -1 : a_len > b_len;
+}
+
+// Order-preserving key encoding; needs no server
+static int test_key_encoding(void) {
+    char buf[64];
+    struct rioc_key_builder key;
+
+    // Golden vectors shared with the Python, Node.js and .NET ports
+    rioc_key_init(&key, buf, sizeof(buf));
+    rioc_key_add_u32(&key, 7, 0);
+    rioc_key_add_string(&key, "a\0b", 3, 0);
+    rioc_key_add_i64(&key, -9, RIOC_KEY_DESC);
+    if (!key_matches(&key, "000000076100ff6200018000000000000008")) {
+        fprintf(stderr, "Key (u32 7, \"a\\0b\", desc i64 -9) does not match its golden vector\n");
+        return 1;
+    }
+
+    // Round trip of the same key
+    struct rioc_key_reader reader;
+    uint32_t u32_value = 0;
+    int64_t i64_value = 0;
+    char str[8];
+    size_t str_len = 0;
+    rioc_key_reader_init(&reader, key.buf, key.len);
+    if (rioc_key_read_u32(&reader, &u32_value, 0) != RIOC_SUCCESS || u32_value != 7 ||
+        rioc_key_read_string(&reader, str, sizeof(str), &str_len, 0) != RIOC_SUCCESS ||
+        str_len != 3 || memcmp(str, "a\0b", 3) != 0 ||
+        rioc_key_read_i64(&reader, &i64_value, RIOC_KEY_DESC) != RIOC_SUCCESS || i64_value != -9 ||
+        reader.pos != key.len) {
+        fprintf(stderr, "Key (u32 7, \"a\\0b\", desc i64 -9) did not decode to its fields\n");
+        return 1;
+    }
+
+    rioc_key_init(&key, buf, sizeof(buf));
+    rioc_key_add_i32(&key, -1, 0);
+    rioc_key_add_u64(&key, 1, RIOC_KEY_DESC);
+    rioc_key_add_string(&key, "hi", 2, RIOC_KEY_DESC);
+    int32_t i32_value = 0;
+    uint64_t u64_value = 0;
+    rioc_key_reader_init(&reader, key.buf, key.len);
+    if (!key_matches(&key, "7ffffffffffffffffffffffe9796fffe") ||
+        rioc_key_read_i32(&reader, &i32_value, 0) != RIOC_SUCCESS || i32_value != -1 ||
+        rioc_key_read_u64(&reader, &u64_value, RIOC_KEY_DESC) != RIOC_SUCCESS || u64_value != 1 ||
+        rioc_key_read_string(&reader, str, sizeof(str), &str_len, RIOC_KEY_DESC) != RIOC_SUCCESS ||
+        str_len != 2 || memcmp(str, "hi", 2) != 0 || reader.pos != key.len) {
+        fprintf(stderr, "Key (i32 -1, desc u64 1, desc \"hi\") does not match its golden vector\n");
+        return 1;
+    }
+
+    rioc_key_init(&key, buf, sizeof(buf));
+    rioc_key_add_i64(&key, 0, 0);
+    rioc_key_add_string(&key, "", 0, 0);
+    if (!key_matches(&key, "80000000000000000001")) {
+        fprintf(stderr, "Key (i64 0, \"\") does not match its golden vector\n");
+        return 1;
+    }
+
+    // Keys listed in field order must sort the same way as bytes
+    static const struct {
+        int32_t id;
+        const char *name;
+        size_t name_len;
+        uint64_t version;       // Descending
+    } ordered[] = {
+        {INT32_MIN, "", 0, 0},
+        {-2, "b", 1, 0},
+        {-1, "", 0, 0},
+        {-1, "a", 1, 5},
+        {-1, "a", 1, 4},
+        {-1, "a\0", 2, 0},
+        {-1, "a\0\0", 3, 0},
+        {-1, "a\x01", 2, 0},
+        {-1, "ab", 2, UINT64_MAX},
+        {-1, "ab", 2, 0},
+        {0, "", 0, 0},
+        {1, "a", 1, 0},
+        {INT32_MAX, "\xff", 1, 0},
+    };
+    size_t count = sizeof(ordered) / sizeof(ordered[0]);
+    char prev[64];
+    size_t prev_len = 0;
+    for (size_t i = 0; i < count; i++) {
+        rioc_key_init(&key, buf, sizeof(buf));
+        if (rioc_key_add_i32(&key, ordered[i].id, 0) != RIOC_SUCCESS ||
+            rioc_key_add_string(&key, ordered[i].name, ordered[i].name_len, 0) != RIOC_SUCCESS ||
+            rioc_key_add_u64(&key, ordered[i].version, RIOC_KEY_DESC) != RIOC_SUCCESS) {
+            fprintf(stderr, "Failed to build ordered key %zu\n", i);
+            return 1;
+        }
+        if (i > 0 && key_compare(prev, prev_len, key.buf, key.len) >= 0) {
+            fprintf(stderr, "Ordered key %zu does not sort after key %zu\n", i, i - 1);
+            return 1;
+        }
+        memcpy(prev, key.buf, key.len);
+        prev_len = key.len;
+    }
+
+    // A full buffer rejects the field and keeps the key as it was
+    char small[6];
+    rioc_key_init(&key, small, sizeof(small));
+    if (rioc_key_add_u32(&key, 1, 0) != RIOC_SUCCESS ||
+        rioc_key_add_u32(&key, 2, 0) != RIOC_ERR_OVERFLOW || key.len != 4 ||
+        rioc_key_add_string(&key, "a", 1, 0) != RIOC_ERR_OVERFLOW || key.len != 4 ||
+        rioc_key_add_raw(&key, "ab", 2) != RIOC_SUCCESS || key.len != 6 ||
+        rioc_key_add_raw(&key, "c", 1) != RIOC_ERR_OVERFLOW || key.len != 6) {
+        fprintf(stderr, "Key builder did not reject fields beyond its buffer\n");
+        return 1;
+    }
+
+    // Reads fail on short or malformed input and leave the reader in place
+    rioc_key_init(&key, buf, sizeof(buf));
+    rioc_key_add_string(&key, "abc", 3, 0);
+    rioc_key_reader_init(&reader, key.buf, key.len);
+    if (rioc_key_read_string(&reader, str, 2, &str_len, 0) != RIOC_ERR_OVERFLOW || str_len != 3 ||
+        reader.pos != 0 ||
+        rioc_key_read_u64(&reader, &u64_value, 0) != RIOC_ERR_PROTO || reader.pos != 0) {
+        fprintf(stderr, "Key reader accepted a field that does not fit\n");
+        return 1;
+    }
+    rioc_key_reader_init(&reader, "ab\0", 3);
+    if (rioc_key_read_string(&reader, str, sizeof(str), &str_len, 0) != RIOC_ERR_PROTO) {
+        fprintf(stderr, "Key reader accepted an unterminated string\n");
+        return 1;
+    }
+
+    // Prefix successors bound prefix scans from above
+    char succ[8];
+    size_t succ_len = 0;
+    if (rioc_key_prefix_successor("ab\xff\xff", 4, succ, &succ_len) != RIOC_SUCCESS ||
+        succ_len != 2 || memcmp(succ, "ac", 2) != 0 ||
+        rioc_key_prefix_successor("a\xfe", 2, succ, &succ_len) != RIOC_SUCCESS ||
+        succ_len != 2 || memcmp(succ, "a\xff", 2) != 0 ||
+        rioc_key_prefix_successor("\xff\xff", 2, succ, &succ_len) != RIOC_ERR_NOENT ||
+        rioc_key_prefix_successor("", 0, succ, &succ_len) != RIOC_ERR_NOENT) {
+        fprintf(stderr, "Prefix successors are wrong\n");
+        return 1;
+    }
+    memcpy(succ, "k\x01\xff", 3);
+    if (rioc_key_prefix_successor(succ, 3, succ, &succ_len) != RIOC_SUCCESS ||
+        succ_len != 2 || memcmp(succ, "k\x02", 2) != 0) {
+        fprintf(stderr, "In-place prefix successor is wrong\n");
+        return 1;
+    }
+    rioc_key_init(&key, buf, sizeof(buf));
+    rioc_key_add_u32(&key, 7, 0);
+    rioc_key_prefix_successor(key.buf, key.len, succ, &succ_len);
+    rioc_key_add_string(&key, "\xff\xff", 2, 0);
+    if (key_compare(key.buf, key.len, succ, succ_len) >= 0) {
+        fprintf(stderr, "Key with the prefix sorts after the prefix successor\n");
+        return 1;
+    }
+
+    // Column encoders write the same bytes as the builder
+    const int64_t columns[] = {INT64_MIN, -1, 0, 42};
+    char encoded[4 * 12];
+    if (rioc_key_fill_prefix("kv:a", 4, 4, encoded, 12) != RIOC_SUCCESS ||
+        rioc_key_encode_i64s(columns, 4, RIOC_KEY_DESC, encoded + 4, 12) != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to encode key columns\n");
+        return 1;
+    }
+    for (size_t i = 0; i < 4; i++) {
+        rioc_key_init(&key, buf, sizeof(buf));
+        rioc_key_add_raw(&key, "kv:a", 4);
+        rioc_key_add_i64(&key, columns[i], RIOC_KEY_DESC);
+        if (key.len != 12 || memcmp(key.buf, encoded + i * 12, 12) != 0) {
+            fprintf(stderr, "Column-encoded key %zu differs from the builder's\n", i);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Completion of an async op; rioc_async_free() returns after every callback has run
+struct async_result {
+    int done;
+    int status;
+    char *value;
+    size_t value_len;
+};
+
+static void async_result_callback(void *arg, int status, char *value, size_t value_len) {
+    struct async_result *result = arg;
+    result->done = 1;
+    result->status = status;
+    result->value = value;
+    result->value_len = value_len;
+}
+
 int main(int argc, char *argv[]) {
     if (argc != 3) {
         fprintf(stderr, "Usage: %s <host> <port>\n", argv[0]);
@@ -61,6 +272,12 @@ int main(int argc, char *argv[]) {
     size_t retrieved_len = 0;
     struct timespec start_time, end_time;
 
+    printf("Testing key encoding...\n");
+    if (test_key_encoding() != 0) {
+        return 1;
+    }
+    printf("Key encoding tests passed\n\n");
+
     // Initialize TLS config
     rioc_tls_config tls_config = {
         .ca_path = "../certs/ca.crt",  // CA certificate for verification
@@ -437,6 +654,61 @@ int main(int argc, char *argv[]) {
     // Free batch resources
     rioc_batch_tracker_free(tracker);
 
+    // Ops that complete without a value must not hand the caller the request's end key
+    // or increment, which live in the batch buffer
+    printf("\n11. Testing async operations that return no value\n");
+    const char *text_key = "test_not_a_counter";
+    const char *text_value = "not a counter";
+    ret = rioc_insert(client, text_key, strlen(text_key), text_value, strlen(text_value),
+                      get_current_timestamp_ns());
+    if (ret != RIOC_SUCCESS) {
+        fprintf(stderr, "Failed to insert non-counter value (error code: %d)\n", ret);
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+
+    struct rioc_async *async = rioc_async_create(client);
+    if (!async) {
+        fprintf(stderr, "Failed to create async client\n");
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+
+    struct async_result empty_range = {0};
+    struct async_result failed_atomic = {0};
+    ret = rioc_async_range_query(async, "test_empty_range_a", strlen("test_empty_range_a"),
+                                 "test_empty_range_b", strlen("test_empty_range_b"),
+                                 async_result_callback, &empty_range);
+    if (ret == RIOC_SUCCESS) {
+        ret = rioc_async_atomic_inc_dec(async, text_key, strlen(text_key), 1,
+                                        get_current_timestamp_ns(), async_result_callback,
+                                        &failed_atomic);
+    }
+    rioc_async_free(async);
+    if (ret != RIOC_SUCCESS || !empty_range.done || !failed_atomic.done) {
+        fprintf(stderr, "Failed to complete async operations (error code: %d)\n", ret);
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+
+    if (empty_range.status != RIOC_SUCCESS || empty_range.value || empty_range.value_len != 0) {
+        fprintf(stderr, "Empty async range query returned status %d with %zu results\n",
+                empty_range.status, empty_range.value_len);
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+    printf("Empty async range query returned no results\n");
+
+    if (failed_atomic.status == RIOC_SUCCESS || failed_atomic.value) {
+        fprintf(stderr, "Async atomic on a non-counter value returned status %d with a value\n",
+                failed_atomic.status);
+        rioc_client_disconnect_with_config(client);
+        return 1;
+    }
+    printf("Async atomic on a non-counter value failed without a value (status: %d)\n",
+           failed_atomic.status);
+    rioc_delete(client, text_key, strlen(text_key), get_current_timestamp_ns());
+
     clock_gettime(CLOCK_MONOTONIC, &start_time);
     rioc_client_disconnect_with_config(client);
     clock_gettime(CLOCK_MONOTONIC, &end_time);
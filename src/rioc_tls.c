@@ -108,6 +108,7 @@ int rioc_tls_server_ctx_create(rioc_tls_context *tls_ctx, const rioc_tls_config
 
     tls_ctx->is_server = true;
     tls_ctx->ssl = NULL;
+    tls_ctx->session = NULL;
 
     return RIOC_SUCCESS;
 }
@@ -180,6 +181,7 @@ int rioc_tls_client_ctx_create(rioc_tls_context *tls_ctx, const rioc_tls_config
 
     tls_ctx->is_server = false;
     tls_ctx->ssl = NULL;
+    tls_ctx->session = NULL;
 
     return RIOC_SUCCESS;
 }
@@ -254,6 +256,12 @@ int rioc_tls_client_connect(rioc_tls_context *tls_ctx, int fd, const char *hostn
 // #endif
 //     }
 
+    // Offer a previous session for abbreviated handshake; the server may decline
+    // and fall back to a full handshake, which SSL_session_reused() reports.
+    if (tls_ctx->session && !SSL_set_session(tls_ctx->ssl, tls_ctx->session)) {
+        log_ssl_error("Failed to set TLS session");
+    }
+
     // Set socket for SSL
     if (!SSL_set_fd(tls_ctx->ssl, fd)) {
         log_ssl_error("Failed to set SSL file descriptor");
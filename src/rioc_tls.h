@@ -9,6 +9,7 @@
 struct rioc_tls_context {
     SSL_CTX *ctx;      // OpenSSL context
     SSL *ssl;          // OpenSSL connection
+    SSL_SESSION *session; // Session to resume on connect (client only)
     bool is_server;    // Whether this is a server context
 };
 